@@ -0,0 +1,99 @@
+#include "async.h"
+#include "memutils.h"
+
+#if !defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <unistd.h>
+#endif
+
+typedef struct
+{
+	void (*func)(void*);
+	void* state;
+} async_thread_start;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+static DWORD WINAPI async_thread_entry(LPVOID arg)
+#else
+static void* async_thread_entry(void* arg)
+#endif
+{
+	async_thread_start* pstart = (async_thread_start*)arg;
+	void (*func)(void*) = pstart->func;
+	void* state = pstart->state;
+
+	/* the start parameters are owned by the new thread */
+	qsc_memutils_alloc_free(pstart);
+	func(state);
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+bool qsc_async_thread_create(qsc_thread* instance, void (*func)(void*), void* state)
+{
+	assert(instance != NULL);
+	assert(func != NULL);
+
+	async_thread_start* pstart;
+	bool res;
+
+	res = false;
+	pstart = (async_thread_start*)qsc_memutils_malloc(sizeof(async_thread_start));
+
+	if (pstart != NULL)
+	{
+		pstart->func = func;
+		pstart->state = state;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		*instance = CreateThread(NULL, 0, async_thread_entry, pstart, 0, NULL);
+		res = (*instance != NULL);
+#else
+		res = (pthread_create(instance, NULL, async_thread_entry, pstart) == 0);
+#endif
+
+		if (res == false)
+		{
+			qsc_memutils_alloc_free(pstart);
+		}
+	}
+
+	return res;
+}
+
+void qsc_async_thread_wait(qsc_thread instance)
+{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	WaitForSingleObject(instance, INFINITE);
+	CloseHandle(instance);
+#else
+	pthread_join(instance, NULL);
+#endif
+}
+
+size_t qsc_async_processor_count(void)
+{
+	size_t res;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	SYSTEM_INFO sinf;
+
+	GetSystemInfo(&sinf);
+	res = (size_t)sinf.dwNumberOfProcessors;
+#else
+	long ncpu;
+
+	ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+	res = (ncpu > 0) ? (size_t)ncpu : 1;
+#endif
+
+	if (res == 0)
+	{
+		res = 1;
+	}
+
+	return res;
+}
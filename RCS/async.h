@@ -0,0 +1,99 @@
+#ifndef QSC_ASYNC_H
+#define QSC_ASYNC_H
+
+/* The GPL version 3 License (GPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* \file async.h
+* \brief Thread creation, processor count, and atomic publication primitives.
+* Wraps the Windows thread api, or the posix threads library on posix systems.
+*/
+
+#include "common.h"
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
+#else
+#	include <pthread.h>
+#endif
+
+/*!
+* \def QSC_ASYNC_THREADS_MAX
+* \brief The maximum number of worker threads launched by a parallel call
+*/
+#define QSC_ASYNC_THREADS_MAX 64
+
+/*!
+* \def QSC_ASYNC_POINTER_LOAD
+* \brief Read a shared pointer with acquire ordering
+*/
+/*!
+* \def QSC_ASYNC_POINTER_STORE
+* \brief Publish a shared pointer with release ordering
+*/
+/*!
+* \def QSC_ASYNC_FLAG_CLAIM
+* \brief Atomically change a zeroed 32-bit flag to one, evaluates to true for the caller that changed it
+*/
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+#	define QSC_ASYNC_POINTER_LOAD(target) ReadPointerAcquire((PVOID const volatile*)(target))
+#	define QSC_ASYNC_POINTER_STORE(target, value) WritePointerRelease((PVOID volatile*)(target), (PVOID)(value))
+#	define QSC_ASYNC_FLAG_CLAIM(target) (InterlockedCompareExchange((volatile LONG*)(target), 1, 0) == 0)
+#else
+#	define QSC_ASYNC_POINTER_LOAD(target) __atomic_load_n((target), __ATOMIC_ACQUIRE)
+#	define QSC_ASYNC_POINTER_STORE(target, value) __atomic_store_n((target), (value), __ATOMIC_RELEASE)
+#	define QSC_ASYNC_FLAG_CLAIM(target) (__sync_bool_compare_and_swap((target), 0, 1))
+#endif
+
+/*!
+* \typedef qsc_thread
+* \brief The native thread handle
+*/
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+typedef HANDLE qsc_thread;
+#else
+typedef pthread_t qsc_thread;
+#endif
+
+/**
+* \brief Launch a function on a new thread.
+*
+* \param instance: A pointer to the thread handle, set if the thread is created
+* \param func: The function to run on the thread
+* \param state: [struct] The argument passed to the function
+* \return Returns true if the thread was created
+*/
+QSC_EXPORT_API bool qsc_async_thread_create(qsc_thread* instance, void (*func)(void*), void* state);
+
+/**
+* \brief Wait for a thread to complete, and release its handle.
+*
+* \param instance: The thread handle
+*/
+QSC_EXPORT_API void qsc_async_thread_wait(qsc_thread instance);
+
+/**
+* \brief Get the number of online logical processors.
+*
+* \return Returns the processor count, or one if it can not be determined
+*/
+QSC_EXPORT_API size_t qsc_async_processor_count(void);
+
+#endif
@@ -1,14 +1,50 @@
 #include "benchmark.h"
+#include "async.h"
 #include "csp.h"
+#include "intutils.h"
+#include "memutils.h"
 #include "testutils.h"
 #include "timerex.h"
 #include "rcs.h"
+#include "rcsdgram.h"
+#include "rcsdgram_test.h"
+#include "rcsfile.h"
+#include "rcsipc.h"
+#include "rcslog.h"
+#include "rcsrec.h"
+#include "rcsrec_test.h"
+#include "rcsuring.h"
+#include "rcsvol.h"
 #include "sha3.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(QSC_RCSIPC_ENABLED)
+#	include <sys/wait.h>
+#	include <unistd.h>
+#endif
 
 /* bs*sc = 1GB */
 #define BUFFER_SIZE 1024
 #define SAMPLE_COUNT 1000000
 #define ONE_GIGABYTE 1024000000
+#define FILE_BENCH_SIZE (512 * 1024 * 1024)
+#define RECORD_BENCH_SIZE (256 * 1024 * 1024)
+#define RECORD_BENCH_BUFFER (64 * 1024)
+#define DATAGRAM_BENCH_COUNT 100000
+#define DATAGRAM_BENCH_PAYLOAD 1200
+#define RING_BENCH_SIZE (256 * 1024 * 1024)
+#define VOLUME_BENCH_SECTORS 32768
+#define SECTOR_BENCH_SIZE (256 * 1024)
+#define LOG_BENCH_RECORDS 65536
+#define LOG_BENCH_RECORD 1024
+
+typedef struct
+{
+	qsc_rcsrec_state* rec;
+	const uint8_t* message;
+	size_t chunk;
+} rcsrec_bench_state;
 
 static void rcs256_speed_test()
 {
@@ -82,6 +118,701 @@ static void rcs512_speed_test()
 	qsctest_print_line(" seconds");
 }
 
+static void rcs_sector_speed_test()
+{
+	/* 1GB encrypted and decrypted in place, in runs of 256KB, with 4KB and 512 byte sectors */
+	const size_t SLENS[] = { 4096, 512 };
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	qsc_rcs_sector_key skey;
+	uint8_t* buf;
+	uint64_t start;
+	uint64_t elapsed;
+	size_t ops;
+
+	buf = (uint8_t*)qsc_memutils_malloc(SECTOR_BENCH_SIZE);
+
+	if (buf != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(buf, SECTOR_BENCH_SIZE);
+		qsc_rcs_keyparams kp = { key, sizeof(key), NULL, NULL, 0 };
+		qsc_rcs_sector_key_expand(&skey, &kp);
+		ops = ONE_GIGABYTE / SECTOR_BENCH_SIZE;
+
+		for (size_t i = 0; i < sizeof(SLENS) / sizeof(SLENS[0]); ++i)
+		{
+			const size_t SCNT = SECTOR_BENCH_SIZE / SLENS[i];
+
+			for (size_t j = 0; j < 2; ++j)
+			{
+				start = qsc_timerex_monotonic_nanoseconds();
+
+				for (size_t k = 0; k < ops; ++k)
+				{
+					if (j == 0)
+					{
+						qsc_rcs_sector_encrypt(&skey, buf, buf, (uint64_t)k * SCNT, SLENS[i], SCNT);
+					}
+					else
+					{
+						qsc_rcs_sector_decrypt(&skey, buf, buf, (uint64_t)k * SCNT, SLENS[i], SCNT);
+					}
+				}
+
+				elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+				qsctest_print_safe((j == 0) ? "Encrypt, " : "Decrypt, ");
+				qsctest_print_ulong(SLENS[i]);
+				qsctest_print_safe(" byte sectors: ");
+				qsctest_print_double((elapsed != 0) ? (double)ops * SECTOR_BENCH_SIZE / (double)elapsed : 0.0);
+				qsctest_print_line(" GB/s");
+			}
+		}
+
+		qsc_rcs_sector_key_dispose(&skey);
+		qsc_memutils_alloc_free(buf);
+	}
+}
+
+static void rcsrec_speed_sender(void* state)
+{
+	rcsrec_bench_state* pbs;
+	size_t pos;
+
+	pbs = (rcsrec_bench_state*)state;
+
+	for (pos = 0; pos < RECORD_BENCH_SIZE; pos += pbs->chunk)
+	{
+		if (qsc_rcsrec_write(pbs->rec, pbs->message, pbs->chunk) != qsc_rcsrec_status_success)
+		{
+			break;
+		}
+	}
+
+	qsc_rcsrec_flush(pbs->rec);
+}
+
+static void rcsrec_speed_test()
+{
+	const size_t RECSIZES[] = { QSC_RCSREC_RECORD_MTU, QSC_RCSREC_RECORD_MTU, QSC_RCSREC_RECORD_DEFAULT, QSC_RCSREC_RECORD_DEFAULT };
+	const size_t CHUNKS[] = { 256, RECORD_BENCH_BUFFER, 256, RECORD_BENCH_BUFFER };
+	const char* NAMES[] =
+	{
+		"MTU records, 256 byte writes: ",
+		"MTU records, 64KB writes: ",
+		"16KB records, 256 byte writes: ",
+		"16KB records, 64KB writes: ",
+	};
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcsrec_socket socks[2];
+	qsc_rcsrec_state reca;
+	qsc_rcsrec_state recb;
+	rcsrec_bench_state bst;
+	qsc_thread thd;
+	uint8_t* msg;
+	uint8_t* dec;
+	uint64_t start;
+	uint64_t elapsed;
+	size_t rlen;
+	size_t rtot;
+
+	msg = (uint8_t*)qsc_memutils_malloc(RECORD_BENCH_BUFFER);
+	dec = (uint8_t*)qsc_memutils_malloc(RECORD_BENCH_BUFFER);
+
+	if (msg != NULL && dec != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(nonce, sizeof(nonce));
+		qsc_csp_generate(msg, RECORD_BENCH_BUFFER);
+
+		for (size_t i = 0; i < sizeof(RECSIZES) / sizeof(RECSIZES[0]); ++i)
+		{
+			qsctest_print_safe(NAMES[i]);
+
+			if (qsctest_rcsrec_loopback(socks) == true)
+			{
+				qsc_rcsrec_initialize(&reca, socks[0], key, sizeof(key), nonce, true, RECSIZES[i]);
+				qsc_rcsrec_initialize(&recb, socks[1], key, sizeof(key), nonce, false, RECSIZES[i]);
+				bst.rec = &reca;
+				bst.message = msg;
+				bst.chunk = CHUNKS[i];
+				rtot = 0;
+				start = qsc_timerex_monotonic_nanoseconds();
+
+				if (qsc_async_thread_create(&thd, rcsrec_speed_sender, &bst) == true)
+				{
+					while (rtot < RECORD_BENCH_SIZE && qsc_rcsrec_read(&recb, dec, RECORD_BENCH_BUFFER, &rlen) == qsc_rcsrec_status_success)
+					{
+						rtot += rlen;
+					}
+
+					if (rtot != RECORD_BENCH_SIZE)
+					{
+						/* reset the connection, so the sender returns */
+						qsctest_rcsrec_close(socks[1]);
+						socks[1] = (qsc_rcsrec_socket)-1;
+					}
+
+					qsc_async_thread_wait(thd);
+				}
+
+				elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+
+				if (rtot == RECORD_BENCH_SIZE && elapsed != 0)
+				{
+					qsctest_print_double((double)RECORD_BENCH_SIZE / (double)elapsed);
+					qsctest_print_line(" GB/s");
+				}
+				else
+				{
+					qsctest_print_line("failed");
+				}
+
+				qsc_rcsrec_dispose(&reca);
+				qsc_rcsrec_dispose(&recb);
+				qsctest_rcsrec_close(socks[0]);
+				qsctest_rcsrec_close(socks[1]);
+			}
+			else
+			{
+				qsctest_print_line("failed");
+			}
+		}
+	}
+
+	if (msg != NULL)
+	{
+		qsc_memutils_alloc_free(msg);
+	}
+
+	if (dec != NULL)
+	{
+		qsc_memutils_alloc_free(dec);
+	}
+}
+
+static int rcsdgram_latency_compare(const void* a, const void* b)
+{
+	const uint64_t VA = *(const uint64_t*)a;
+	const uint64_t VB = *(const uint64_t*)b;
+
+	return (VA > VB) - (VA < VB);
+}
+
+static void rcsdgram_speed_test()
+{
+	const size_t BATCHES[] = { 1, 8, 32, QSC_RCSDGRAM_BATCH_MAX };
+	const char* NAMES[] =
+	{
+		"1 packet per call: ",
+		"8 packets per call: ",
+		"32 packets per call: ",
+		"64 packets per call: ",
+	};
+	const size_t CAPACITY = DATAGRAM_BENCH_PAYLOAD + QSC_RCSDGRAM_OVERHEAD_MAX;
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcsdgram_packet spkt[QSC_RCSDGRAM_BATCH_MAX];
+	qsc_rcsdgram_packet rpkt[QSC_RCSDGRAM_BATCH_MAX];
+	qsc_rcsrec_socket socks[2];
+	qsc_rcsdgram_state sender;
+	qsc_rcsdgram_state receiver;
+	uint64_t* lats;
+	uint8_t* rbufs;
+	uint8_t* sbufs;
+	uint64_t elapsed;
+	uint64_t start;
+	uint64_t tbat;
+	size_t bcnt;
+	size_t rcnt;
+	size_t rtot;
+	size_t total;
+
+	lats = (uint64_t*)qsc_memutils_malloc(DATAGRAM_BENCH_COUNT * sizeof(uint64_t));
+	rbufs = (uint8_t*)qsc_memutils_malloc(QSC_RCSDGRAM_BATCH_MAX * CAPACITY);
+	sbufs = (uint8_t*)qsc_memutils_malloc(QSC_RCSDGRAM_BATCH_MAX * CAPACITY);
+
+	if (lats != NULL && rbufs != NULL && sbufs != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(nonce, sizeof(nonce));
+
+		for (size_t i = 0; i < sizeof(BATCHES) / sizeof(BATCHES[0]); ++i)
+		{
+			qsctest_print_safe(NAMES[i]);
+
+			if (qsctest_rcsdgram_loopback(socks) == true)
+			{
+				qsc_rcsdgram_initialize(&sender, key, sizeof(key), nonce, true);
+				qsc_rcsdgram_initialize(&receiver, key, sizeof(key), nonce, false);
+				total = 0;
+				start = qsc_timerex_monotonic_nanoseconds();
+
+				/* each batch is sent, then received and opened; a packet's latency is the time its batch takes */
+				while (total < DATAGRAM_BENCH_COUNT)
+				{
+					bcnt = qsc_intutils_min(BATCHES[i], DATAGRAM_BENCH_COUNT - total);
+					tbat = qsc_timerex_monotonic_nanoseconds();
+
+					for (size_t j = 0; j < bcnt; ++j)
+					{
+						spkt[j].buffer = sbufs + (j * CAPACITY);
+						spkt[j].capacity = CAPACITY;
+						spkt[j].length = DATAGRAM_BENCH_PAYLOAD;
+						rpkt[j].buffer = rbufs + (j * CAPACITY);
+						rpkt[j].capacity = CAPACITY;
+					}
+
+					if (qsc_rcsdgram_send(&sender, socks[0], spkt, bcnt) != bcnt)
+					{
+						break;
+					}
+
+					rtot = 0;
+					rcnt = 1;
+
+					while (rtot < bcnt && rcnt != 0)
+					{
+						rcnt = qsc_rcsdgram_receive(&receiver, socks[1], rpkt + rtot, bcnt - rtot);
+						rtot += rcnt;
+					}
+
+					if (rtot != bcnt)
+					{
+						break;
+					}
+
+					tbat = qsc_timerex_monotonic_nanoseconds() - tbat;
+
+					for (size_t j = 0; j < bcnt; ++j)
+					{
+						lats[total + j] = tbat;
+					}
+
+					total += bcnt;
+				}
+
+				elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+
+				if (total == DATAGRAM_BENCH_COUNT && elapsed != 0)
+				{
+					qsort(lats, DATAGRAM_BENCH_COUNT, sizeof(uint64_t), rcsdgram_latency_compare);
+					qsctest_print_double((double)DATAGRAM_BENCH_COUNT * 1000000000.0 / (double)elapsed);
+					qsctest_print_safe(" packets/s, p99 latency ");
+					qsctest_print_double((double)lats[(DATAGRAM_BENCH_COUNT * 99) / 100] / 1000.0);
+					qsctest_print_line(" us");
+				}
+				else
+				{
+					qsctest_print_line("failed");
+				}
+
+				qsc_rcsdgram_dispose(&sender);
+				qsc_rcsdgram_dispose(&receiver);
+				qsctest_rcsrec_close(socks[0]);
+				qsctest_rcsrec_close(socks[1]);
+			}
+			else
+			{
+				qsctest_print_line("failed");
+			}
+		}
+	}
+
+	if (lats != NULL)
+	{
+		qsc_memutils_alloc_free(lats);
+	}
+
+	if (rbufs != NULL)
+	{
+		qsc_memutils_alloc_free(rbufs);
+	}
+
+	if (sbufs != NULL)
+	{
+		qsc_memutils_alloc_free(sbufs);
+	}
+}
+
+#if defined(QSC_RCSIPC_ENABLED)
+static int rcsipc_speed_consumer(int handle, const uint8_t* key, size_t keylen)
+{
+	qsc_rcsipc_state cons;
+	uint8_t* msg;
+	size_t mlen;
+	size_t rtot;
+
+	rtot = 0;
+
+	if (qsc_rcsipc_attach(&cons, handle, key, keylen) == qsc_rcsipc_status_success)
+	{
+		while (qsc_rcsipc_receive(&cons, &msg, &mlen) == qsc_rcsipc_status_success)
+		{
+			rtot += mlen;
+			qsc_rcsipc_release(&cons);
+		}
+
+		qsc_rcsipc_dispose(&cons);
+	}
+
+	return (rtot == RING_BENCH_SIZE) ? 0 : 1;
+}
+
+static void rcsipc_speed_test()
+{
+	const size_t MSGSIZES[] = { 4096, QSC_RCSIPC_SLOT_DEFAULT };
+	const char* NAMES[] =
+	{
+		"4KB messages: ",
+		"64KB messages: ",
+	};
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	qsc_rcsipc_state prod;
+	uint8_t* msg;
+	uint64_t start;
+	uint64_t elapsed;
+	size_t stot;
+	pid_t pid;
+	int wst;
+
+	msg = (uint8_t*)qsc_memutils_malloc(QSC_RCSIPC_SLOT_DEFAULT);
+
+	if (msg != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(msg, QSC_RCSIPC_SLOT_DEFAULT);
+
+		for (size_t i = 0; i < sizeof(MSGSIZES) / sizeof(MSGSIZES[0]); ++i)
+		{
+			qsctest_print_safe(NAMES[i]);
+			pid = -1;
+
+			if (qsc_rcsipc_create(&prod, key, sizeof(key), QSC_RCSIPC_SLOTS_DEFAULT, MSGSIZES[i]) == qsc_rcsipc_status_success)
+			{
+				/* the consumer decrypts in a second process */
+				fflush(stdout);
+				pid = fork();
+
+				if (pid == 0)
+				{
+					_exit(rcsipc_speed_consumer(dup(qsc_rcsipc_handle(&prod)), key, sizeof(key)));
+				}
+
+				if (pid > 0)
+				{
+					start = qsc_timerex_monotonic_nanoseconds();
+
+					for (stot = 0; stot < RING_BENCH_SIZE; stot += MSGSIZES[i])
+					{
+						qsc_rcsipc_send(&prod, msg, MSGSIZES[i]);
+					}
+
+					qsc_rcsipc_close(&prod);
+
+					if (waitpid(pid, &wst, 0) != pid || WIFEXITED(wst) == 0 || WEXITSTATUS(wst) != 0)
+					{
+						pid = -1;
+					}
+
+					elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+				}
+
+				qsc_rcsipc_dispose(&prod);
+			}
+
+			if (pid > 0 && elapsed != 0)
+			{
+				qsctest_print_double((double)RING_BENCH_SIZE / (double)elapsed);
+				qsctest_print_line(" GB/s");
+			}
+			else
+			{
+				qsctest_print_line("failed");
+			}
+		}
+
+		qsc_memutils_alloc_free(msg);
+	}
+}
+#endif
+
+static void rcsvol_speed_test()
+{
+	/* fio-style jobs on a 128MB volume; every job moves the size of the volume */
+	const size_t SPANS[] = { QSC_RCSVOL_BATCH_MAX, QSC_RCSVOL_BATCH_MAX, 1, 1, 16, QSC_RCSVOL_BATCH_MAX, QSC_RCSVOL_BATCH_MAX };
+	const bool RANDOM[] = { false, false, true, true, true, true, true };
+	const bool LISTS[] = { false, false, false, false, false, true, true };
+	const bool WRITES[] = { true, false, false, true, false, false, true };
+	const char* NAMES[] =
+	{
+		"Sequential write, 256KB runs: ",
+		"Sequential read, 256KB runs: ",
+		"Random read, 4KB: ",
+		"Random write, 4KB: ",
+		"Random read, 64KB runs: ",
+		"Random read, lists of 64 sectors: ",
+		"Random write, lists of 64 sectors: ",
+	};
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	uint64_t list[QSC_RCSVOL_BATCH_MAX];
+	qsc_rcsvol_state vol;
+	qsc_rcsvol_status res;
+	uint32_t* rnd;
+	uint8_t* buf;
+	uint64_t start;
+	uint64_t elapsed;
+	uint64_t sector;
+	size_t ops;
+	size_t j;
+
+	buf = (uint8_t*)qsc_memutils_malloc(QSC_RCSVOL_BATCH_MAX * QSC_RCSVOL_SECTOR_SIZE);
+	rnd = (uint32_t*)qsc_memutils_malloc(VOLUME_BENCH_SECTORS * sizeof(uint32_t));
+	qsc_csp_generate(key, sizeof(key));
+
+	if (buf != NULL && rnd != NULL && qsc_rcsvol_create(&vol, "rcsvol_bench.vol", key, sizeof(key), VOLUME_BENCH_SECTORS) == qsc_rcsvol_status_success)
+	{
+		qsc_csp_generate(buf, QSC_RCSVOL_BATCH_MAX * QSC_RCSVOL_SECTOR_SIZE);
+		qsc_csp_generate((uint8_t*)rnd, VOLUME_BENCH_SECTORS * sizeof(uint32_t));
+
+		for (size_t i = 0; i < sizeof(SPANS) / sizeof(SPANS[0]); ++i)
+		{
+			qsctest_print_safe(NAMES[i]);
+			ops = VOLUME_BENCH_SECTORS / SPANS[i];
+			res = qsc_rcsvol_status_success;
+			start = qsc_timerex_monotonic_nanoseconds();
+
+			for (size_t k = 0; k < ops && res == qsc_rcsvol_status_success; ++k)
+			{
+				if (LISTS[i] == true)
+				{
+					for (j = 0; j < SPANS[i]; ++j)
+					{
+						list[j] = rnd[((k * SPANS[i]) + j) % VOLUME_BENCH_SECTORS] % VOLUME_BENCH_SECTORS;
+					}
+
+					/* a sector can appear in a written list only once */
+					if (WRITES[i] == true)
+					{
+						for (j = 0; j < SPANS[i]; ++j)
+						{
+							list[j] = ((list[j] / SPANS[i]) * SPANS[i]) + j;
+						}
+					}
+
+					res = (WRITES[i] == true) ? qsc_rcsvol_write_list(&vol, list, buf, SPANS[i]) : qsc_rcsvol_read_list(&vol, list, buf, SPANS[i]);
+				}
+				else
+				{
+					sector = (RANDOM[i] == true) ? (rnd[k] % ops) * SPANS[i] : k * SPANS[i];
+					res = (WRITES[i] == true) ? qsc_rcsvol_write(&vol, sector, buf, SPANS[i]) : qsc_rcsvol_read(&vol, sector, buf, SPANS[i]);
+				}
+			}
+
+			elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+
+			if (res == qsc_rcsvol_status_success && elapsed != 0)
+			{
+				qsctest_print_double((double)VOLUME_BENCH_SECTORS * QSC_RCSVOL_SECTOR_SIZE / (double)elapsed);
+				qsctest_print_safe(" GB/s, ");
+				qsctest_print_double((double)ops * 1000000000.0 / (double)elapsed);
+				qsctest_print_line(" IOPS");
+			}
+			else
+			{
+				qsctest_print_line("failed");
+			}
+		}
+
+		qsc_rcsvol_dispose(&vol);
+		remove("rcsvol_bench.vol");
+	}
+
+	if (buf != NULL)
+	{
+		qsc_memutils_alloc_free(buf);
+	}
+
+	if (rnd != NULL)
+	{
+		qsc_memutils_alloc_free(rnd);
+	}
+}
+
+static void rcslog_speed_print(qsc_rcslog_status status, uint64_t length, uint64_t records, uint64_t elapsed)
+{
+	if (status == qsc_rcslog_status_success && elapsed != 0)
+	{
+		qsctest_print_double((double)length / (double)elapsed);
+		qsctest_print_safe(" GB/s, ");
+		qsctest_print_double((double)records * 1000000000.0 / (double)elapsed);
+		qsctest_print_line(" records/s");
+	}
+	else
+	{
+		qsctest_print_line("failed");
+	}
+}
+
+static void rcslog_speed_test()
+{
+	/* 1KB records with a commit after every record, the cost of one transform and one sync per record,
+	   then in growing groups; the last log holds 64MB, and is scanned by the recovery and read back */
+	const size_t GROUPS[] = { 1, 16, 256, LOG_BENCH_RECORDS };
+	const char* NAMES[] =
+	{
+		"Append, commit every record: ",
+		"Append, commit every 16 records: ",
+		"Append, commit every 256 records: ",
+		"Append, one commit of 64MB: ",
+	};
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	uint8_t rec[LOG_BENCH_RECORD] = { 0 };
+	qsc_rcslog_state log;
+	qsc_rcslog_status res;
+	uint64_t start;
+	uint64_t elapsed;
+	size_t count;
+	size_t rlen;
+
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(rec, sizeof(rec));
+	count = 0;
+
+	for (size_t i = 0; i < sizeof(GROUPS) / sizeof(GROUPS[0]); ++i)
+	{
+		qsctest_print_safe(NAMES[i]);
+		/* the short groups write fewer records, so the sync-bound jobs finish in a few seconds */
+		count = qsc_intutils_min(LOG_BENCH_RECORDS, GROUPS[i] * 1024);
+		res = qsc_rcslog_create(&log, "rcslog_bench.log", key, sizeof(key), QSC_RCSLOG_SEGMENT_DEFAULT);
+		start = qsc_timerex_monotonic_nanoseconds();
+
+		for (size_t k = 0; k < count && res == qsc_rcslog_status_success; ++k)
+		{
+			res = qsc_rcslog_append(&log, rec, sizeof(rec), NULL);
+
+			if (res == qsc_rcslog_status_success && (k + 1) % GROUPS[i] == 0)
+			{
+				res = qsc_rcslog_commit(&log);
+			}
+		}
+
+		if (res == qsc_rcslog_status_success)
+		{
+			res = qsc_rcslog_commit(&log);
+		}
+
+		elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+		rcslog_speed_print(res, (uint64_t)count * LOG_BENCH_RECORD, count, elapsed);
+		qsc_rcslog_dispose(&log);
+	}
+
+	qsctest_print_safe("Recovery scan of 64MB: ");
+	start = qsc_timerex_monotonic_nanoseconds();
+	res = qsc_rcslog_open(&log, "rcslog_bench.log", key, sizeof(key));
+	elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+	rcslog_speed_print((res == qsc_rcslog_status_success && qsc_rcslog_sequence(&log) == count) ? res : qsc_rcslog_status_read_failure,
+		(uint64_t)count * LOG_BENCH_RECORD, count, elapsed);
+
+	if (res == qsc_rcslog_status_success)
+	{
+		qsctest_print_safe("Sequential read of 64MB: ");
+		start = qsc_timerex_monotonic_nanoseconds();
+		res = qsc_rcslog_seek(&log, 0);
+
+		for (size_t k = 0; k < count && res == qsc_rcslog_status_success; ++k)
+		{
+			res = qsc_rcslog_read(&log, rec, sizeof(rec), &rlen, NULL);
+		}
+
+		elapsed = qsc_timerex_monotonic_nanoseconds() - start;
+		rcslog_speed_print(res, (uint64_t)count * LOG_BENCH_RECORD, count, elapsed);
+	}
+
+	qsc_rcslog_dispose(&log);
+	remove("rcslog_bench.log");
+}
+
+#if defined(QSC_RCSURING_ENABLED)
+static void rcsfile_speed_print(const char* name, qsc_rcsfile_status status, const qsc_rcsfile_statistics* stats)
+{
+	qsctest_print_safe(name);
+
+	if (status == qsc_rcsfile_status_success && stats->nanoseconds != 0)
+	{
+		qsctest_print_double((double)stats->length / (double)stats->nanoseconds);
+		qsctest_print_line(" GB/s");
+	}
+	else
+	{
+		qsctest_print_line("failed");
+	}
+}
+
+static void rcsfile_speed_test(const char* directory)
+{
+	const qsc_rcsuring_params PARAMS[] =
+	{
+		{ 1, 1, false, true },
+		{ QSC_RCSURING_DEPTH_DEFAULT, 1, false, false },
+		{ 1, 0, false, true },
+		{ QSC_RCSURING_DEPTH_DEFAULT, 0, false, false },
+		{ QSC_RCSURING_DEPTH_DEFAULT, 0, true, false },
+	};
+	const char* NAMES[] =
+	{
+		"synchronous, 1 thread: ",
+		"io_uring, 1 thread: ",
+		"synchronous, all cores: ",
+		"io_uring, all cores: ",
+		"io_uring direct, all cores: ",
+	};
+	char cpath[256] = { 0 };
+	char ppath[256] = { 0 };
+	char dpath[256] = { 0 };
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	qsc_rcsfile_map fmap;
+	qsc_rcsfile_statistics stats;
+	qsc_rcsfile_status res;
+
+	snprintf(ppath, sizeof(ppath), "%srcsbench.pln", directory);
+	snprintf(cpath, sizeof(cpath), "%srcsbench.rcs", directory);
+	snprintf(dpath, sizeof(dpath), "%srcsbench.dec", directory);
+	qsc_csp_generate(key, sizeof(key));
+
+	if (qsc_rcsfile_map_output(&fmap, ppath, FILE_BENCH_SIZE) == true)
+	{
+		for (size_t i = 0; i < FILE_BENCH_SIZE; i += QSC_CSP_SEED_MAX)
+		{
+			qsc_csp_generate(fmap.data + i, QSC_CSP_SEED_MAX);
+		}
+
+		qsc_rcsfile_unmap(&fmap);
+
+		for (size_t i = 0; i < sizeof(PARAMS) / sizeof(PARAMS[0]); ++i)
+		{
+			qsctest_print_safe("Encrypt, ");
+			res = qsc_rcsuring_encrypt(ppath, cpath, key, sizeof(key), QSC_RCSSEG_SEGMENT_DEFAULT, &PARAMS[i], &stats);
+			rcsfile_speed_print(NAMES[i], res, &stats);
+			qsctest_print_safe("Decrypt, ");
+			res = qsc_rcsuring_decrypt(cpath, dpath, key, sizeof(key), &PARAMS[i], &stats);
+			rcsfile_speed_print(NAMES[i], res, &stats);
+		}
+
+		qsctest_print_safe("Encrypt, memory-mapped, all cores: ");
+		res = qsc_rcsfile_encrypt(ppath, cpath, key, sizeof(key), QSC_RCSSEG_SEGMENT_DEFAULT, &stats);
+		rcsfile_speed_print("", res, &stats);
+		qsctest_print_safe("Decrypt, memory-mapped, all cores: ");
+		res = qsc_rcsfile_decrypt(cpath, dpath, key, sizeof(key), &stats);
+		rcsfile_speed_print("", res, &stats);
+	}
+
+	remove(ppath);
+	remove(cpath);
+	remove(dpath);
+}
+#endif
+
 void qsctest_rcs_speed_run()
 {
 	qsctest_print_line("Running the RCS-256 performance benchmarks.");
@@ -89,4 +820,32 @@ void qsctest_rcs_speed_run()
 
 	qsctest_print_line("Running the RCS-512 performance benchmarks.");
 	rcs512_speed_test();
+
+	qsctest_print_line("Running the RCS-256 sector mode benchmarks, 1GB in place in runs of 256KB.");
+	rcs_sector_speed_test();
+
+	qsctest_print_line("Running the RCS record layer benchmarks, 256MB over a loopback TCP connection.");
+	rcsrec_speed_test();
+
+	qsctest_print_line("Running the RCS datagram benchmarks, 100000 packets of 1200 bytes over a loopback UDP connection.");
+	rcsdgram_speed_test();
+
+#if defined(QSC_RCSIPC_ENABLED)
+	qsctest_print_line("Running the RCS shared memory ring benchmarks, 256MB from a producer to a consumer process.");
+	rcsipc_speed_test();
+#endif
+
+	qsctest_print_line("Running the RCS sector volume benchmarks, random and sequential I/O on a 128MB volume in the working directory.");
+	rcsvol_speed_test();
+
+	qsctest_print_line("Running the RCS encrypted log benchmarks, 1KB records with group commits in the working directory.");
+	rcslog_speed_test();
+
+#if defined(QSC_RCSURING_ENABLED)
+	qsctest_print_line("Running the RCS file pipeline benchmarks on a 512MB file in the working directory.");
+	rcsfile_speed_test("");
+
+	qsctest_print_line("Running the RCS file pipeline benchmarks on a 512MB file in /dev/shm (tmpfs).");
+	rcsfile_speed_test("/dev/shm/");
+#endif
 }
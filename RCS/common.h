@@ -634,6 +634,14 @@
 #	define QSC_SYSTEM_HAS_XOP
 #endif
 
+#if defined(__VAES__)
+	/*!
+	\def QSC_SYSTEM_HAS_VAES
+	* \brief The system supports the 256 and 512-bit vector AES instructions
+	*/
+#	define QSC_SYSTEM_HAS_VAES
+#endif
+
 #if defined(QSC_SYSTEM_HAS_AVX) || defined(QSC_SYSTEM_HAS_AVX2) || defined(QSC_SYSTEM_HAS_AVX512)
 	/*!
 	\def QSC_SYSTEM_AVX_INTRINSICS
@@ -642,6 +650,29 @@
 #	define QSC_SYSTEM_AVX_INTRINSICS
 #endif
 
+/*!
+* \def QSC_SYSTEM_RUNTIME_DISPATCH
+* \brief Compile the AES-NI, AVX2, VAES and AVX-512 kernel variants regardless of the compiler flags,
+* and select between them at runtime using the CPU features.
+* The kernels enable their instruction sets with QSC_SYSTEM_TARGET, so a baseline x86-64 build (no -mavx) dispatches them.
+* Add QSC_SYSTEM_NO_RUNTIME_DISPATCH to the preprocessor definitions to select kernels with the compiler flags only.
+*/
+#if !defined(QSC_SYSTEM_NO_RUNTIME_DISPATCH) && defined(QSC_SYSTEM_ARCH_X64)
+#	if defined(QSC_SYSTEM_COMPILER_MSC) || defined(QSC_SYSTEM_COMPILER_GCC)
+#		define QSC_SYSTEM_RUNTIME_DISPATCH
+#	endif
+#endif
+
+/*!
+* \def QSC_SYSTEM_TARGET
+* \brief Enables an instruction set for a single function; MSVC allows any intrinsic without it
+*/
+#if defined(QSC_SYSTEM_COMPILER_GCC) || defined(QSC_SYSTEM_COMPILER_CLANG)
+#	define QSC_SYSTEM_TARGET(isa) __attribute__((target(isa)))
+#else
+#	define QSC_SYSTEM_TARGET(isa)
+#endif
+
 /*!
 *\def QSC_ASM_ENABLED
 * \brief Enables global ASM processing
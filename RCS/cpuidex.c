@@ -1,4 +1,5 @@
 #include "cpuidex.h"
+#include "async.h"
 #include "consoleutils.h"
 #include "memutils.h"
 #include "stringutils.h"
@@ -7,6 +8,7 @@
 QSC_SYSTEM_CONDITION_IGNORE(5105)
 
 #include <stdio.h>
+#include <stdlib.h>
 #if defined(QSC_SYSTEM_OS_WINDOWS) && defined(QSC_SYSTEM_COMPILER_MSC)
 #   include <Windows.h>
 #	include <intrin.h>
@@ -152,6 +154,24 @@ static void osx_get_features(qsc_cpuidex_cpu_features* features)
 		features->avx512f = (pval == 1);
 	}
 
+	pval = 0;
+	plen = sizeof(pval);
+
+	if (sysctlbyname("hw.optional.avx512bw", &pval, &plen, NULL, 0) == 0)
+	{
+		features->avx512bw = (pval == 1);
+	}
+
+	pval = 0;
+	plen = sizeof(pval);
+
+	if (sysctlbyname("hw.optional.avx512vbmi", &pval, &plen, NULL, 0) == 0)
+	{
+		features->avx512vbmi = (pval == 1);
+	}
+
+	features->osxsave = features->avx;
+
 	features->pcmul = features->avx;
 
 	pval = 0;
@@ -167,6 +187,14 @@ static void osx_get_features(qsc_cpuidex_cpu_features* features)
 	pval = 0;
 	plen = sizeof(pval);
 
+	if (sysctlbyname("hw.optional.supplementalsse3", &pval, &plen, NULL, 0) == 0)
+	{
+		features->ssse3 = (pval == 1);
+	}
+
+	pval = 0;
+	plen = sizeof(pval);
+
 	if (sysctlbyname("hw.optional.rdrand", &pval, &plen, NULL, 0) == 0)
 	{
 		features->rdrand = (pval == 1);
@@ -224,6 +252,9 @@ static void osx_get_features(qsc_cpuidex_cpu_features* features)
 #define CPUID_EDX_SSE2      	0x04000000UL
 #define CPUID_EDX_RDTCSP    	0x0000001BUL
 #define CPUID_EDX_HYPER     	0x0000001CUL
+#define CPUID_ECX7_AVX512VBMI	(1UL <<  1)
+#define CPUID_ECX7_VAES     	(1UL <<  9)
+#define CPUID_ECX7_VPCLMULQDQ	(1UL << 10)
 #define XCR0_SSE            	0x00000002UL
 #define XCR0_AVX            	0x00000004UL
 #define XCR0_OPMASK         	0x00000020UL
@@ -239,6 +270,35 @@ static void cpuid_info(uint32_t info[4], const uint32_t infotype)
 #endif
 }
 
+static void cpuid_info_ex(uint32_t info[4], const uint32_t infotype, const uint32_t subtype)
+{
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+    __cpuidex((int*)info, infotype, subtype);
+#elif defined(QSC_SYSTEM_COMPILER_GCC)
+    __cpuid_count(infotype, subtype, info[0], info[1], info[2], info[3]);
+#endif
+}
+
+static uint64_t xcr_info(const uint32_t index)
+{
+    uint64_t xcr;
+
+    xcr = 0;
+
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+    xcr = (uint64_t)_xgetbv(index);
+#elif defined(QSC_SYSTEM_COMPILER_GCC)
+    uint32_t eax;
+    uint32_t edx;
+
+    /* xgetbv is encoded directly, so the file does not need to be compiled with xsave enabled */
+    __asm__ __volatile__(".byte 0x0F, 0x01, 0xD0" : "=a"(eax), "=d"(edx) : "c"(index));
+    xcr = ((uint64_t)edx << 32) | eax;
+#endif
+
+    return xcr;
+}
+
 static uint32_t read_bits(uint32_t value, int index, int length)
 {
     int mask = ((1L << length) - 1) << index;
@@ -327,30 +387,7 @@ static void cpu_topology(qsc_cpuidex_cpu_features* features)
     features->aesni = ((info[2] & CPUID_ECX_AESNI) != 0x00000000UL);
     features->rdrand = ((info[2] & CPUID_ECX_RDRAND) != 0x00000000UL);
     features->rdtcsp = ((info[3] & CPUID_EDX_RDTCSP) != 0x00000000UL);
-
-#if defined(QSC_SYSTEM_HAS_AVX)
-    bool havx;
-
-    havx = (info[2] & CPUID_ECX_AVX) != 0x00000000UL;
-
-    if (havx == true)
-    {
-    	uint32_t xcr0;
-
-    	xcr0 = 0;
-
-		if ((info[2] & (CPUID_ECX_AVX | CPUID_ECX_XSAVE | CPUID_ECX_OSXSAVE)) ==
-				(CPUID_ECX_AVX | CPUID_ECX_XSAVE | CPUID_ECX_OSXSAVE))
-		{
-			xcr0 = (uint32_t)_xgetbv(0);
-		}
-
-		if ((xcr0 & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX))
-		{
-			features->avx = true;
-		}
-    }
-#endif
+    features->ssse3 = ((info[2] & CPUID_ECX_SSSE3) != 0x00000000UL);
 
     if (features->cputype == qsc_cpuid_intel)
     {
@@ -362,47 +399,42 @@ static void cpu_topology(qsc_cpuidex_cpu_features* features)
         features->cacheline = read_bits(info[2], 24, 8);
     }
 
-    if (features->avx == true)
-    {
-#if defined(QSC_SYSTEM_HAS_AVX2)
-    	bool havx2;
-
-#	if defined(QSC_SYSTEM_COMPILER_GCC)
-		__builtin_cpu_init();
-		havx2 = __builtin_cpu_supports("avx2") != 0;
-#	else
-        qsc_memutils_clear(info, sizeof(info));
-        cpuid_info(info, 0x00000007UL);
-		havx2 = ((info[1] & CPUID_EBX_AVX2) != 0x00000000UL);
-		features->adx = ((info[1] & CPUID_EBX_ADX) != 0x00000000UL);
-#	endif
+    /* the avx register state must be enabled by the operating system, as well as supported by the cpu */
+    qsc_memutils_clear(info, sizeof(info));
+    cpuid_info(info, 0x00000001UL);
+    features->osxsave = ((info[2] & (CPUID_ECX_XSAVE | CPUID_ECX_OSXSAVE)) == (CPUID_ECX_XSAVE | CPUID_ECX_OSXSAVE));
 
-		if (havx2 == true)
-		{
-			features->avx2 = (_xgetbv(0) & 0xE6) != 0;
-		}
-#endif
+    if (features->osxsave == true)
+    {
+        uint32_t ecx1;
+        uint64_t xcr0;
+        bool avxstate;
+        bool zmmstate;
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-		bool havx512;
-#	if defined(QSC_SYSTEM_COMPILER_GCC)
-		havx512 = __builtin_cpu_supports("avx512f") != 0;
-#	else
-		havx512 = ((info[1] & CPUID_EBX_AVX512F) != 0x00000000UL);
-#	endif
-		if (havx512 == true)
-		{
-			uint32_t xcr2;
+        ecx1 = info[2];
+        xcr0 = xcr_info(0);
+        avxstate = ((xcr0 & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX));
+        zmmstate = avxstate && ((xcr0 & (XCR0_OPMASK | XCR0_ZMM_HI256 | XCR0_HI16_ZMM)) ==
+            (XCR0_OPMASK | XCR0_ZMM_HI256 | XCR0_HI16_ZMM));
 
-			xcr2 = (uint32_t)_xgetbv(0);
+        features->avx = avxstate && ((ecx1 & CPUID_ECX_AVX) != 0x00000000UL);
 
-			if ((xcr2 & (XCR0_OPMASK | XCR0_ZMM_HI256 | XCR0_HI16_ZMM)) ==
-					(XCR0_OPMASK | XCR0_ZMM_HI256 | XCR0_HI16_ZMM))
-			{
-				features->avx512f = true;
-			}
-		}
-#endif
+        qsc_memutils_clear(info, sizeof(info));
+        cpuid_info(info, 0x00000000UL);
+
+        if (info[0] >= 0x00000007UL)
+        {
+            qsc_memutils_clear(info, sizeof(info));
+            cpuid_info_ex(info, 0x00000007UL, 0x00000000UL);
+
+            features->adx = ((info[1] & CPUID_EBX_ADX) != 0x00000000UL);
+            features->avx2 = features->avx && ((info[1] & CPUID_EBX_AVX2) != 0x00000000UL);
+            features->vaes = features->avx && ((info[2] & CPUID_ECX7_VAES) != 0x00000000UL);
+            features->vpclmulqdq = features->avx && ((info[2] & CPUID_ECX7_VPCLMULQDQ) != 0x00000000UL);
+            features->avx512f = zmmstate && ((info[1] & CPUID_EBX_AVX512F) != 0x00000000UL);
+            features->avx512bw = features->avx512f && ((info[1] & CPUID_EBX_AVX512BW) != 0x00000000UL);
+            features->avx512vbmi = features->avx512f && ((info[2] & CPUID_ECX7_AVX512VBMI) != 0x00000000UL);
+        }
     }
 }
 
@@ -450,10 +482,16 @@ bool qsc_cpuidex_features_set(qsc_cpuidex_cpu_features* features)
     features->avx = false;
     features->avx2 = false;
     features->avx512f = false;
+    features->avx512bw = false;
+    features->avx512vbmi = false;
     features->hyperthread = false;
+    features->osxsave = false;
     features->pcmul = false;
     features->rdrand = false;
     features->rdtcsp = false;
+    features->ssse3 = false;
+    features->vaes = false;
+    features->vpclmulqdq = false;
     features->cacheline = 0;
     features->cores = 0;
     features->cpus = 1;
@@ -486,6 +524,133 @@ bool qsc_cpuidex_features_set(qsc_cpuidex_cpu_features* features)
     return res;
 }
 
+static void cpuidex_dispatch_limit(qsc_cpuidex_cpu_features* features)
+{
+	char level[16] = { 0 };
+#if defined(QSC_SYSTEM_COMPILER_MSC)
+	char* penv;
+	size_t plen;
+
+	penv = NULL;
+
+	if (_dupenv_s(&penv, &plen, QSC_CPUIDEX_DISPATCH_VARIABLE) == 0 && penv != NULL)
+	{
+		qsc_stringutils_copy_string(level, sizeof(level) - 1, penv);
+		free(penv);
+	}
+#else
+	const char* penv;
+
+	penv = getenv(QSC_CPUIDEX_DISPATCH_VARIABLE);
+
+	if (penv != NULL)
+	{
+		qsc_stringutils_copy_string(level, sizeof(level) - 1, penv);
+	}
+#endif
+
+	qsc_stringutils_to_lowercase(level);
+
+	/* each level removes the features above it, the kernels are then selected from what remains */
+	if (qsc_stringutils_compare_strings(level, "avx512", sizeof("avx512")) == true)
+	{
+		/* no limit, the avx-512 kernels are used if supported */
+	}
+	else if (qsc_stringutils_compare_strings(level, "vaes", sizeof("vaes")) == true)
+	{
+		features->avx512f = false;
+		features->avx512bw = false;
+		features->avx512vbmi = false;
+	}
+	else if (qsc_stringutils_compare_strings(level, "avx2", sizeof("avx2")) == true)
+	{
+		features->avx512f = false;
+		features->avx512bw = false;
+		features->avx512vbmi = false;
+		features->vaes = false;
+		features->vpclmulqdq = false;
+	}
+	else if (qsc_stringutils_compare_strings(level, "aesni", sizeof("aesni")) == true)
+	{
+		features->avx2 = false;
+		features->avx512f = false;
+		features->avx512bw = false;
+		features->avx512vbmi = false;
+		features->vaes = false;
+		features->vpclmulqdq = false;
+	}
+	else if (qsc_stringutils_compare_strings(level, "vperm", sizeof("vperm")) == true)
+	{
+		features->aesni = false;
+		features->avx512f = false;
+		features->avx512bw = false;
+		features->avx512vbmi = false;
+		features->pcmul = false;
+		features->vaes = false;
+		features->vpclmulqdq = false;
+	}
+	else if (qsc_stringutils_compare_strings(level, "ssse3", sizeof("ssse3")) == true)
+	{
+		features->aesni = false;
+		features->avx2 = false;
+		features->avx512f = false;
+		features->avx512bw = false;
+		features->avx512vbmi = false;
+		features->pcmul = false;
+		features->vaes = false;
+		features->vpclmulqdq = false;
+	}
+	else if (qsc_stringutils_compare_strings(level, "generic", sizeof("generic")) == true)
+	{
+		features->aesni = false;
+		features->avx2 = false;
+		features->avx512f = false;
+		features->avx512bw = false;
+		features->avx512vbmi = false;
+		features->pcmul = false;
+		features->ssse3 = false;
+		features->vaes = false;
+		features->vpclmulqdq = false;
+	}
+}
+
+const qsc_cpuidex_cpu_features* qsc_cpuidex_dispatch_features()
+{
+	/* the detection runs before the set is claimed, so a nested call made through memutils completes on its own,
+	   and a concurrent caller that loses the claim only waits on the copy of the winning set */
+	static qsc_cpuidex_cpu_features dfeat;
+	static const qsc_cpuidex_cpu_features* pdisp = NULL;
+	static int32_t dclaim = 0;
+	const qsc_cpuidex_cpu_features* pfeat;
+
+	pfeat = QSC_ASYNC_POINTER_LOAD(&pdisp);
+
+	if (pfeat == NULL)
+	{
+		qsc_cpuidex_cpu_features tfeat;
+
+		qsc_cpuidex_features_set(&tfeat);
+		cpuidex_dispatch_limit(&tfeat);
+
+		if (QSC_ASYNC_FLAG_CLAIM(&dclaim) == true)
+		{
+			dfeat = tfeat;
+			pfeat = &dfeat;
+			QSC_ASYNC_POINTER_STORE(&pdisp, pfeat);
+		}
+		else
+		{
+			do
+			{
+				pfeat = QSC_ASYNC_POINTER_LOAD(&pdisp);
+			}
+			while (pfeat == NULL);
+		}
+	}
+
+	return pfeat;
+}
+
 void qsc_cpuidex_print_stats()
 {
 	qsc_cpuidex_cpu_features cfeat;
@@ -513,9 +678,18 @@ void qsc_cpuidex_print_stats()
 		qsc_consoleutils_print_safe("AVX512: ");
 		qsc_consoleutils_print_line(cfeat.avx512f == true ? st : sf);
 
+		qsc_consoleutils_print_safe("AVX512BW: ");
+		qsc_consoleutils_print_line(cfeat.avx512bw == true ? st : sf);
+
+		qsc_consoleutils_print_safe("AVX512VBMI: ");
+		qsc_consoleutils_print_line(cfeat.avx512vbmi == true ? st : sf);
+
 		qsc_consoleutils_print_safe("Hyperthread: ");
 		qsc_consoleutils_print_line(cfeat.hyperthread == true ? st : sf);
 
+		qsc_consoleutils_print_safe("OSXSAVE: ");
+		qsc_consoleutils_print_line(cfeat.osxsave == true ? st : sf);
+
 		qsc_consoleutils_print_safe("PCLMULQDQ: ");
 		qsc_consoleutils_print_line(cfeat.pcmul == true ? st : sf);
 
@@ -525,6 +699,15 @@ void qsc_cpuidex_print_stats()
 		qsc_consoleutils_print_safe("RDTCSP: ");
 		qsc_consoleutils_print_line(cfeat.rdtcsp == true ? st : sf);
 
+		qsc_consoleutils_print_safe("SSSE3: ");
+		qsc_consoleutils_print_line(cfeat.ssse3 == true ? st : sf);
+
+		qsc_consoleutils_print_safe("VAES: ");
+		qsc_consoleutils_print_line(cfeat.vaes == true ? st : sf);
+
+		qsc_consoleutils_print_safe("VPCLMULQDQ: ");
+		qsc_consoleutils_print_line(cfeat.vpclmulqdq == true ? st : sf);
+
 		qsc_consoleutils_print_safe("Cacheline size: ");
 		qsc_stringutils_int_to_string((int32_t)cfeat.cacheline, vstr, sizeof(vstr));
 		qsc_consoleutils_print_line(vstr);
@@ -44,6 +44,12 @@
 #	define QSC_CPUIDEX_VENDOR_LENGTH 12
 #endif
 
+/*!
+* \def QSC_CPUIDEX_DISPATCH_VARIABLE
+* \brief The environment variable used to limit the dispatched SIMD kernels
+*/
+#define QSC_CPUIDEX_DISPATCH_VARIABLE "QSC_CPUIDEX_DISPATCH"
+
 /*!
 * \enum qsc_cpuidex_cpu_type
 * \brief The detectable CPU architectures
@@ -66,10 +72,16 @@ QSC_EXPORT_API typedef struct
     bool avx;                               	/*!< The AVX flag */
     bool avx2;                              	/*!< The AVX2 flag */
     bool avx512f;                           	/*!< The AVX512F flag */
+    bool avx512bw;                          	/*!< The AVX512BW flag */
+    bool avx512vbmi;                        	/*!< The AVX512-VBMI flag */
     bool hyperthread;                       	/*!< The hyper-thread flag */
+    bool osxsave;                           	/*!< The OS has enabled XSAVE, and the AVX register state */
     bool pcmul;                             	/*!< The PCLMULQDQ flag */
     bool rdrand;                            	/*!< The RDRAND flag */
     bool rdtcsp;                            	/*!< The RDTCSP flag */
+    bool ssse3;                             	/*!< The SSSE3 flag */
+    bool vaes;                              	/*!< The VAES flag */
+    bool vpclmulqdq;                        	/*!< The VPCLMULQDQ flag */
     uint32_t cacheline;                     	/*!< The number of cache lines */
     uint32_t cores;                         	/*!< The number of cores */
     uint32_t cpus;                          	/*!< The number of CPUs */
@@ -94,6 +106,16 @@ QSC_EXPORT_API typedef struct
 */
 QSC_EXPORT_API bool qsc_cpuidex_features_set(qsc_cpuidex_cpu_features* const features);
 
+/**
+* \brief Get the CPU features used to select the SIMD kernel variants.
+* The features are detected once and cached. The QSC_CPUIDEX_DISPATCH environment variable
+* can limit the selected kernels to: generic, ssse3, vperm, aesni, avx2, vaes, or avx512.
+* The ssse3 and vperm levels hide AES-NI, and select the vector-permute kernels.
+*
+* \return Returns a pointer to the cached qsc_cpuidex_cpu_features structure
+*/
+QSC_EXPORT_API const qsc_cpuidex_cpu_features* qsc_cpuidex_dispatch_features();
+
 /**
 * \brief Print a list of supported CPU features
 */
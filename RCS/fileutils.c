@@ -0,0 +1,193 @@
+#include "fileutils.h"
+#include "intutils.h"
+#include "memutils.h"
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
+#else
+#	include <errno.h>
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#define FILEUTILS_IO_MAX (1024 * 1024 * 1024)
+
+qsc_fileutils_handle qsc_fileutils_open(const char* path, bool create)
+{
+	assert(path != NULL);
+
+	qsc_fileutils_handle res;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	res = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, (create == true) ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+	res = (create == true) ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0600) : open(path, O_RDWR);
+#endif
+
+	return res;
+}
+
+void qsc_fileutils_close(qsc_fileutils_handle* handle)
+{
+	assert(handle != NULL);
+
+	if (*handle != QSC_FILEUTILS_INVALID_HANDLE)
+	{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		CloseHandle(*handle);
+#else
+		close(*handle);
+#endif
+		*handle = QSC_FILEUTILS_INVALID_HANDLE;
+	}
+}
+
+bool qsc_fileutils_read_at(qsc_fileutils_handle handle, uint8_t* output, size_t length, uint64_t offset)
+{
+	assert(output != NULL || length == 0);
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	OVERLAPPED ovl;
+	DWORD rlen;
+#else
+	ssize_t rlen;
+#endif
+	size_t plen;
+	bool res;
+
+	res = true;
+
+	while (length != 0 && res == true)
+	{
+		plen = qsc_intutils_min(length, FILEUTILS_IO_MAX);
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		qsc_memutils_clear((uint8_t*)&ovl, sizeof(ovl));
+		ovl.Offset = (DWORD)offset;
+		ovl.OffsetHigh = (DWORD)(offset >> 32);
+		res = (ReadFile(handle, output, (DWORD)plen, &rlen, &ovl) == TRUE && rlen != 0);
+		plen = (size_t)rlen;
+#else
+		rlen = pread(handle, output, plen, (off_t)offset);
+
+		if (rlen < 0 && errno == EINTR)
+		{
+			rlen = 0;
+		}
+		else
+		{
+			res = (rlen > 0);
+		}
+
+		plen = (rlen > 0) ? (size_t)rlen : 0;
+#endif
+		output += plen;
+		offset += plen;
+		length -= plen;
+	}
+
+	return res;
+}
+
+bool qsc_fileutils_write_at(qsc_fileutils_handle handle, const uint8_t* input, size_t length, uint64_t offset)
+{
+	assert(input != NULL || length == 0);
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	OVERLAPPED ovl;
+	DWORD wlen;
+#else
+	ssize_t wlen;
+#endif
+	size_t plen;
+	bool res;
+
+	res = true;
+
+	while (length != 0 && res == true)
+	{
+		plen = qsc_intutils_min(length, FILEUTILS_IO_MAX);
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		qsc_memutils_clear((uint8_t*)&ovl, sizeof(ovl));
+		ovl.Offset = (DWORD)offset;
+		ovl.OffsetHigh = (DWORD)(offset >> 32);
+		res = (WriteFile(handle, input, (DWORD)plen, &wlen, &ovl) == TRUE && wlen != 0);
+		plen = (size_t)wlen;
+#else
+		wlen = pwrite(handle, input, plen, (off_t)offset);
+
+		if (wlen < 0 && errno == EINTR)
+		{
+			wlen = 0;
+		}
+		else
+		{
+			res = (wlen > 0);
+		}
+
+		plen = (wlen > 0) ? (size_t)wlen : 0;
+#endif
+		input += plen;
+		offset += plen;
+		length -= plen;
+	}
+
+	return res;
+}
+
+uint64_t qsc_fileutils_size(qsc_fileutils_handle handle)
+{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	LARGE_INTEGER fsz;
+#else
+	struct stat fst;
+#endif
+	uint64_t flen;
+
+	flen = 0;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	if (GetFileSizeEx(handle, &fsz) == TRUE)
+	{
+		flen = (uint64_t)fsz.QuadPart;
+	}
+#else
+	if (fstat(handle, &fst) == 0)
+	{
+		flen = (uint64_t)fst.st_size;
+	}
+#endif
+
+	return flen;
+}
+
+bool qsc_fileutils_sync(qsc_fileutils_handle handle)
+{
+	bool res;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	res = (FlushFileBuffers(handle) == TRUE);
+#elif defined(QSC_SYSTEM_OS_LINUX)
+	res = (fdatasync(handle) == 0);
+#else
+	res = (fsync(handle) == 0);
+#endif
+
+	return res;
+}
+
+bool qsc_fileutils_truncate(qsc_fileutils_handle handle, uint64_t length)
+{
+	bool res;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	LARGE_INTEGER fpos;
+
+	fpos.QuadPart = (LONGLONG)length;
+	res = (SetFilePointerEx(handle, fpos, NULL, FILE_BEGIN) == TRUE && SetEndOfFile(handle) == TRUE);
+#else
+	res = (ftruncate(handle, (off_t)length) == 0);
+#endif
+
+	return res;
+}
@@ -0,0 +1,121 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef QSC_FILEUTILS_H
+#define QSC_FILEUTILS_H
+
+#include "common.h"
+
+/*
+* \file fileutils.h
+* \brief Positional file I/O; the read, write, size, sync, and truncate calls shared by the file formats
+*/
+
+/*!
+* \typedef qsc_fileutils_handle
+* \brief An open file; a file handle on Windows, and a file descriptor on other systems
+*/
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+typedef void* qsc_fileutils_handle;
+#else
+typedef int qsc_fileutils_handle;
+#endif
+
+/*!
+* \def QSC_FILEUTILS_INVALID_HANDLE
+* \brief The value of a handle that is not open
+*/
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	define QSC_FILEUTILS_INVALID_HANDLE ((qsc_fileutils_handle)(intptr_t)-1)
+#else
+#	define QSC_FILEUTILS_INVALID_HANDLE -1
+#endif
+
+/**
+* \brief Open a file for reading and writing, with exclusive access on Windows
+*
+* \param path: [const] The full path to the file
+* \param create: Create the file, replacing an existing file, or open an existing file
+*
+* \return Returns the file handle, or QSC_FILEUTILS_INVALID_HANDLE on failure
+*/
+QSC_EXPORT_API qsc_fileutils_handle qsc_fileutils_open(const char* path, bool create);
+
+/**
+* \brief Close an open file, and set the handle to QSC_FILEUTILS_INVALID_HANDLE
+*
+* \param handle: A pointer to the file handle; an invalid handle is ignored
+*/
+QSC_EXPORT_API void qsc_fileutils_close(qsc_fileutils_handle* handle);
+
+/**
+* \brief Read an array from a file position; interrupted and partial reads are continued
+*
+* \param handle: The file handle
+* \param output: The array receiving the bytes
+* \param length: The number of bytes to read
+* \param offset: The file position of the first byte
+*
+* \return Returns false if the read fails or the end of the file is reached
+*/
+QSC_EXPORT_API bool qsc_fileutils_read_at(qsc_fileutils_handle handle, uint8_t* output, size_t length, uint64_t offset);
+
+/**
+* \brief Write an array to a file position; interrupted and partial writes are continued
+*
+* \param handle: The file handle
+* \param input: [const] The array to write
+* \param length: The number of bytes to write
+* \param offset: The file position of the first byte
+*
+* \return Returns false if the write fails
+*/
+QSC_EXPORT_API bool qsc_fileutils_write_at(qsc_fileutils_handle handle, const uint8_t* input, size_t length, uint64_t offset);
+
+/**
+* \brief Get the size of a file
+*
+* \param handle: The file handle
+*
+* \return Returns the file size in bytes, or zero on failure
+*/
+QSC_EXPORT_API uint64_t qsc_fileutils_size(qsc_fileutils_handle handle);
+
+/**
+* \brief Flush the written data of a file to the storage device.
+* On Linux only the data and the file size are flushed; the other metadata is not needed to read the file back.
+*
+* \param handle: The file handle
+*
+* \return Returns false if the flush fails
+*/
+QSC_EXPORT_API bool qsc_fileutils_sync(qsc_fileutils_handle handle);
+
+/**
+* \brief Set the size of a file; a file that is extended is filled with zeros, and left sparse where the file system allows
+*
+* \param handle: The file handle
+* \param length: The new file size in bytes
+*
+* \return Returns false if the size can not be set
+*/
+QSC_EXPORT_API bool qsc_fileutils_truncate(qsc_fileutils_handle handle, uint64_t length);
+
+#endif
@@ -1,7 +1,10 @@
 #include "memutils.h"
+#include "async.h"
+#include "cpuidex.h"
 
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+#if defined(QSC_SYSTEM_AVX_INTRINSICS) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
 #	include "intrinsics.h"
+#	define MEMUTILS_SIMD_ENABLED
 #endif
 #if defined(QSC_SYSTEM_OS_WINDOWS)
 #	include <malloc.h>
@@ -116,10 +119,10 @@ void* qsc_memutils_aligned_alloc(int32_t align, size_t length)
 
 	if (length != 0)
 	{
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+#if defined(MEMUTILS_SIMD_ENABLED)
 #	if defined(QSC_SYSTEM_OS_WINDOWS)
 		ret = _aligned_malloc(length, align);
-#	elif defined(QSC_SYSTEM_OS_POSIX)
+#	elif defined(QSC_SYSTEM_OS_POSIX) || defined(QSC_SYSTEM_OS_LINUX)
 		int res;
 
 		res = posix_memalign(&ret, align, length);
@@ -143,7 +146,7 @@ void qsc_memutils_aligned_free(void* block)
 {
 	if (block != NULL)
 	{
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+#if defined(MEMUTILS_SIMD_ENABLED)
 #	if defined(QSC_SYSTEM_OS_WINDOWS)
 		_aligned_free(block);
 #	else
@@ -155,341 +158,419 @@ void qsc_memutils_aligned_free(void* block)
 	}
 }
 
-#if defined(QSC_SYSTEM_HAS_AVX)
-static void qsc_memutils_clear128(void* output)
+/* simd block functions, each processes whole vectors and returns the number of bytes processed */
+
+#if defined(MEMUTILS_SIMD_ENABLED)
+
+static size_t qsc_memutils_clear128(uint8_t* output, size_t length)
 {
-	_mm_storeu_si128((__m128i*)output, _mm_setzero_si128());
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 16)
+	{
+		_mm_storeu_si128((__m128i*)(output + pctr), _mm_setzero_si128());
+		pctr += 16;
+	}
+
+	return pctr;
 }
-#endif
 
-#if defined(QSC_SYSTEM_HAS_AVX2)
-static void qsc_memutils_clear256(void* output)
+static size_t qsc_memutils_copy128(uint8_t* output, const uint8_t* input, size_t length)
 {
-	_mm256_storeu_si256((__m256i*)output, _mm256_setzero_si256());
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 16)
+	{
+		_mm_storeu_si128((__m128i*)(output + pctr), _mm_loadu_si128((const __m128i*)(input + pctr)));
+		pctr += 16;
+	}
+
+	return pctr;
 }
-#endif
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-static void qsc_memutils_clear512(void* output)
+static size_t qsc_memutils_setval128(uint8_t* output, uint8_t value, size_t length)
 {
-	_mm512_storeu_si512((__m512i*)output, _mm512_setzero_si512());
+	const __m128i V = _mm_set1_epi8((char)value);
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 16)
+	{
+		_mm_storeu_si128((__m128i*)(output + pctr), V);
+		pctr += 16;
+	}
+
+	return pctr;
 }
-#endif
 
-void qsc_memutils_clear(void* output, size_t length)
+static size_t qsc_memutils_xor128(uint8_t* output, const uint8_t* input, size_t length)
 {
 	size_t pctr;
 
-	if (length != 0)
+	pctr = 0;
+
+	while (length - pctr >= 16)
 	{
-		pctr = 0;
+		_mm_storeu_si128((__m128i*)(output + pctr), _mm_xor_si128(_mm_loadu_si128((const __m128i*)(input + pctr)), _mm_loadu_si128((const __m128i*)(output + pctr))));
+		pctr += 16;
+	}
 
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-		const size_t SMDBLK = 64;
-#	elif defined(QSC_SYSTEM_HAS_AVX2)
-		const size_t SMDBLK = 32;
-#	else
-		const size_t SMDBLK = 16;
-#	endif
+	return pctr;
+}
 
-		if (length >= SMDBLK)
-		{
-			const size_t ALNLEN = (length / SMDBLK) * SMDBLK;
+static size_t qsc_memutils_xorv128(uint8_t* output, uint8_t value, size_t length)
+{
+	const __m128i V = _mm_set1_epi8((char)value);
+	size_t pctr;
 
-			while (pctr != ALNLEN)
-			{
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-				qsc_memutils_clear512(((uint8_t*)output + pctr));
-#	elif defined(QSC_SYSTEM_HAS_AVX2)
-				qsc_memutils_clear256(((uint8_t*)output + pctr));
-#	elif defined(QSC_SYSTEM_HAS_AVX)
-				qsc_memutils_clear128(((uint8_t*)output + pctr));
-#	endif
-				pctr += SMDBLK;
-			}
-		}
-#endif
+	pctr = 0;
+
+	while (length - pctr >= 16)
+	{
+		_mm_storeu_si128((__m128i*)(output + pctr), _mm_xor_si128(V, _mm_loadu_si128((const __m128i*)(output + pctr))));
+		pctr += 16;
+	}
+
+	return pctr;
+}
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-		if (length - pctr >= 32)
-		{
-			qsc_memutils_clear256(((uint8_t*)output + pctr));
-			pctr += 32;
-		}
-		else if (length - pctr >= 16)
-		{
-			qsc_memutils_clear128(((uint8_t*)output + pctr));
-			pctr += 16;
-		}
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-		if (length - pctr >= 16)
-		{
-			qsc_memutils_clear128(((uint8_t*)output + pctr));
-			pctr += 16;
-		}
 #endif
 
-		if (pctr != length)
-		{
-			for (size_t i = pctr; i < length; ++i)
-			{
-				((uint8_t*)output)[i] = 0x00;
-			}
-		}
+#if defined(QSC_SYSTEM_HAS_AVX2) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+
+QSC_SYSTEM_TARGET("avx2")
+static size_t qsc_memutils_clear256(uint8_t* output, size_t length)
+{
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 32)
+	{
+		_mm256_storeu_si256((__m256i*)(output + pctr), _mm256_setzero_si256());
+		pctr += 32;
 	}
+
+	return pctr + qsc_memutils_clear128(output + pctr, length - pctr);
 }
 
-#if defined(QSC_SYSTEM_HAS_AVX)
-static void qsc_memutils_copy128(const void* input, void* output)
+QSC_SYSTEM_TARGET("avx2")
+static size_t qsc_memutils_copy256(uint8_t* output, const uint8_t* input, size_t length)
 {
-	_mm_storeu_si128((__m128i*)output, _mm_loadu_si128((const __m128i*)input));
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 32)
+	{
+		_mm256_storeu_si256((__m256i*)(output + pctr), _mm256_loadu_si256((const __m256i*)(input + pctr)));
+		pctr += 32;
+	}
+
+	return pctr + qsc_memutils_copy128(output + pctr, input + pctr, length - pctr);
 }
-#endif
 
-#if defined(QSC_SYSTEM_HAS_AVX2)
-static void qsc_memutils_copy256(const void* input, void* output)
+QSC_SYSTEM_TARGET("avx2")
+static size_t qsc_memutils_setval256(uint8_t* output, uint8_t value, size_t length)
 {
-	_mm256_storeu_si256((__m256i*)output, _mm256_loadu_si256((const __m256i*)input));
+	const __m256i V = _mm256_set1_epi8((char)value);
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 32)
+	{
+		_mm256_storeu_si256((__m256i*)(output + pctr), V);
+		pctr += 32;
+	}
+
+	return pctr + qsc_memutils_setval128(output + pctr, value, length - pctr);
 }
-#endif
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-static void qsc_memutils_copy512(const void* input, void* output)
+QSC_SYSTEM_TARGET("avx2")
+static size_t qsc_memutils_xor256(uint8_t* output, const uint8_t* input, size_t length)
 {
-	_mm512_storeu_si512((__m512i*)output, _mm512_loadu_si512((const __m512i*)input));
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 32)
+	{
+		_mm256_storeu_si256((__m256i*)(output + pctr), _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(input + pctr)), _mm256_loadu_si256((const __m256i*)(output + pctr))));
+		pctr += 32;
+	}
+
+	return pctr + qsc_memutils_xor128(output + pctr, input + pctr, length - pctr);
 }
-#endif
 
-void qsc_memutils_copy(void* output, const void* input, size_t length)
+QSC_SYSTEM_TARGET("avx2")
+static size_t qsc_memutils_xorv256(uint8_t* output, uint8_t value, size_t length)
 {
+	const __m256i V = _mm256_set1_epi8((char)value);
 	size_t pctr;
 
-	if (length != 0)
-	{
-		pctr = 0;
+	pctr = 0;
 
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-		const size_t SMDBLK = 64;
-#	elif defined(QSC_SYSTEM_HAS_AVX2)
-		const size_t SMDBLK = 32;
-#	else
-		const size_t SMDBLK = 16;
-#	endif
+	while (length - pctr >= 32)
+	{
+		_mm256_storeu_si256((__m256i*)(output + pctr), _mm256_xor_si256(V, _mm256_loadu_si256((const __m256i*)(output + pctr))));
+		pctr += 32;
+	}
 
-		if (length >= SMDBLK)
-		{
-			const size_t ALNLEN = (length / SMDBLK) * SMDBLK;
+	return pctr + qsc_memutils_xorv128(output + pctr, value, length - pctr);
+}
 
-			while (pctr != ALNLEN)
-			{
-#if defined(QSC_SYSTEM_HAS_AVX512)
-				qsc_memutils_copy512((const uint8_t*)input + pctr, (uint8_t*)output + pctr);
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-				qsc_memutils_copy256((const uint8_t*)input + pctr, (uint8_t*)output + pctr);
-#elif defined(QSC_SYSTEM_HAS_AVX)
-				qsc_memutils_copy128((const uint8_t*)input + pctr, (uint8_t*)output + pctr);
-#endif
-				pctr += SMDBLK;
-			}
-		}
 #endif
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-		if (length - pctr >= 32)
-		{
-			qsc_memutils_copy256((uint8_t*)input + pctr, (uint8_t*)output + pctr);
-			pctr += 32;
-		}
-		else if (length - pctr >= 16)
-		{
-			qsc_memutils_copy128((uint8_t*)input + pctr, (uint8_t*)output + pctr);
-			pctr += 16;
-		}
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-		if (length - pctr >= 16)
-		{
-			qsc_memutils_copy128((const uint8_t*)input + pctr, (uint8_t*)output + pctr);
-			pctr += 16;
-		}
-#endif
+#if defined(QSC_SYSTEM_HAS_AVX512) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
 
-		if (pctr != length)
-		{
-			for (size_t i = pctr; i < length; ++i)
-			{
-				((uint8_t*)output)[i] = ((const uint8_t*)input)[i];
-			}
-		}
+QSC_SYSTEM_TARGET("avx512f")
+static size_t qsc_memutils_clear512(uint8_t* output, size_t length)
+{
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 64)
+	{
+		_mm512_storeu_si512((__m512i*)(output + pctr), _mm512_setzero_si512());
+		pctr += 64;
 	}
-}
 
-void qsc_memutils_move(void* output, const void* input, size_t length)
-{
-#if defined(QSC_SYSTEM_OS_WINDOWS)
-	memmove_s(output, length, input, length);
-#else
-	memmove(output, input, length);
-#endif
+	return pctr + qsc_memutils_clear256(output + pctr, length - pctr);
 }
 
-#if defined(QSC_SYSTEM_HAS_AVX)
-static void qsc_memutils_setval128(void* output, uint8_t value)
+QSC_SYSTEM_TARGET("avx512f")
+static size_t qsc_memutils_copy512(uint8_t* output, const uint8_t* input, size_t length)
 {
-	_mm_storeu_si128((__m128i*)output, _mm_set1_epi8(value));
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 64)
+	{
+		_mm512_storeu_si512((__m512i*)(output + pctr), _mm512_loadu_si512((const __m512i*)(input + pctr)));
+		pctr += 64;
+	}
+
+	return pctr + qsc_memutils_copy256(output + pctr, input + pctr, length - pctr);
 }
-#endif
 
-#if defined(QSC_SYSTEM_HAS_AVX2)
-static void qsc_memutils_setval256(void* output, uint8_t value)
+QSC_SYSTEM_TARGET("avx512f")
+static size_t qsc_memutils_setval512(uint8_t* output, uint8_t value, size_t length)
 {
-	_mm256_storeu_si256((__m256i*)output, _mm256_set1_epi8(value));
+	const __m512i V = _mm512_set1_epi8((char)value);
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 64)
+	{
+		_mm512_storeu_si512((__m512i*)(output + pctr), V);
+		pctr += 64;
+	}
+
+	return pctr + qsc_memutils_setval256(output + pctr, value, length - pctr);
 }
-#endif
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-static void qsc_memutils_setval512(void* output, uint8_t value)
+QSC_SYSTEM_TARGET("avx512f")
+static size_t qsc_memutils_xor512(uint8_t* output, const uint8_t* input, size_t length)
 {
-	_mm512_storeu_si512((__m512i*)output, _mm512_set1_epi8(value));
+	size_t pctr;
+
+	pctr = 0;
+
+	while (length - pctr >= 64)
+	{
+		_mm512_storeu_si512((__m512i*)(output + pctr), _mm512_xor_si512(_mm512_loadu_si512((const __m512i*)(input + pctr)), _mm512_loadu_si512((const __m512i*)(output + pctr))));
+		pctr += 64;
+	}
+
+	return pctr + qsc_memutils_xor256(output + pctr, input + pctr, length - pctr);
 }
-#endif
 
-void qsc_memutils_setvalue(void* output, uint8_t value, size_t length)
+QSC_SYSTEM_TARGET("avx512f")
+static size_t qsc_memutils_xorv512(uint8_t* output, uint8_t value, size_t length)
 {
+	const __m512i V = _mm512_set1_epi8((char)value);
 	size_t pctr;
 
-	if (length != 0)
+	pctr = 0;
+
+	while (length - pctr >= 64)
 	{
-		pctr = 0;
+		_mm512_storeu_si512((__m512i*)(output + pctr), _mm512_xor_si512(V, _mm512_loadu_si512((const __m512i*)(output + pctr))));
+		pctr += 64;
+	}
 
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-		const size_t SMDBLK = 64;
-#	elif defined(QSC_SYSTEM_HAS_AVX2)
-		const size_t SMDBLK = 32;
-#	else
-		const size_t SMDBLK = 16;
-#	endif
+	return pctr + qsc_memutils_xorv256(output + pctr, value, length - pctr);
+}
 
-		if (length >= SMDBLK)
-		{
-			const size_t ALNLEN = (length / SMDBLK) * SMDBLK;
+#endif
 
-			while (pctr != ALNLEN)
-			{
-#if defined(QSC_SYSTEM_HAS_AVX512)
-				qsc_memutils_setval512((uint8_t*)output + pctr, value);
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-				qsc_memutils_setval256((uint8_t*)output + pctr, value);
-#elif defined(QSC_SYSTEM_HAS_AVX)
-				qsc_memutils_setval128((uint8_t*)output + pctr, value);
+#if defined(MEMUTILS_SIMD_ENABLED)
+
+/* the simd dispatch table, bound once to the widest vector width supported by the cpu */
+typedef struct
+{
+	size_t (*clear)(uint8_t* output, size_t length);
+	size_t (*copy)(uint8_t* output, const uint8_t* input, size_t length);
+	size_t (*setvalue)(uint8_t* output, uint8_t value, size_t length);
+	size_t (*xorblock)(uint8_t* output, const uint8_t* input, size_t length);
+	size_t (*xorvalue)(uint8_t* output, uint8_t value, size_t length);
+} memutils_simd_table;
+
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH) || !defined(QSC_SYSTEM_HAS_AVX2)
+static const memutils_simd_table memutils_simd128 =
+{
+	qsc_memutils_clear128, qsc_memutils_copy128, qsc_memutils_setval128, qsc_memutils_xor128, qsc_memutils_xorv128
+};
 #endif
-				pctr += SMDBLK;
-			}
-		}
+
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH) || (defined(QSC_SYSTEM_HAS_AVX2) && !defined(QSC_SYSTEM_HAS_AVX512))
+static const memutils_simd_table memutils_simd256 =
+{
+	qsc_memutils_clear256, qsc_memutils_copy256, qsc_memutils_setval256, qsc_memutils_xor256, qsc_memutils_xorv256
+};
 #endif
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-		if (length - pctr >= 32)
+#if defined(QSC_SYSTEM_HAS_AVX512) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+static const memutils_simd_table memutils_simd512 =
+{
+	qsc_memutils_clear512, qsc_memutils_copy512, qsc_memutils_setval512, qsc_memutils_xor512, qsc_memutils_xorv512
+};
+#endif
+
+static const memutils_simd_table* memutils_simd_select()
+{
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+	/* the table is published atomically; racing initializers select the same table, and the baseline is
+	   bound first rather than guarded by a once, because the cpu feature detection calls these functions */
+	static const memutils_simd_table* table = NULL;
+	const memutils_simd_table* ptbl;
+
+	ptbl = QSC_ASYNC_POINTER_LOAD(&table);
+
+	if (ptbl == NULL)
+	{
+		const qsc_cpuidex_cpu_features* pfeat;
+
+		ptbl = &memutils_simd128;
+		QSC_ASYNC_POINTER_STORE(&table, ptbl);
+		pfeat = qsc_cpuidex_dispatch_features();
+
+		if (pfeat->avx512f == true)
 		{
-			qsc_memutils_setval256((uint8_t*)output + pctr, value);
-			pctr += 32;
+			ptbl = &memutils_simd512;
 		}
-		else if (length - pctr >= 16)
+		else if (pfeat->avx2 == true)
 		{
-			qsc_memutils_setval128((uint8_t*)output + pctr, value);
-			pctr += 16;
+			ptbl = &memutils_simd256;
 		}
+
+		QSC_ASYNC_POINTER_STORE(&table, ptbl);
+	}
+
+	return ptbl;
+#elif defined(QSC_SYSTEM_HAS_AVX512)
+	return &memutils_simd512;
 #elif defined(QSC_SYSTEM_HAS_AVX2)
-		if (length - pctr >= 16)
-		{
-			qsc_memutils_setval128((uint8_t*)output + pctr, value);
-			pctr += 16;
-		}
+	return &memutils_simd256;
+#else
+	return &memutils_simd128;
+#endif
+}
+
+#endif
+
+void qsc_memutils_clear(void* output, size_t length)
+{
+	size_t pctr;
+
+	if (length != 0)
+	{
+		pctr = 0;
+
+#if defined(MEMUTILS_SIMD_ENABLED)
+		pctr = memutils_simd_select()->clear((uint8_t*)output, length);
 #endif
 
 		if (pctr != length)
 		{
 			for (size_t i = pctr; i < length; ++i)
 			{
-				((uint8_t*)output)[i] = value;
+				((uint8_t*)output)[i] = 0x00;
 			}
 		}
 	}
 }
 
-#if defined(QSC_SYSTEM_HAS_AVX)
-static void qsc_memutils_xor128(const uint8_t* input, uint8_t* output)
+void qsc_memutils_copy(void* output, const void* input, size_t length)
 {
-	_mm_storeu_si128((__m128i*)output, _mm_xor_si128(_mm_loadu_si128((const __m128i*)input), _mm_loadu_si128((const __m128i*)output)));
-}
+	size_t pctr;
+
+	if (length != 0)
+	{
+		pctr = 0;
+
+#if defined(MEMUTILS_SIMD_ENABLED)
+		pctr = memutils_simd_select()->copy((uint8_t*)output, (const uint8_t*)input, length);
 #endif
 
-#if defined(QSC_SYSTEM_HAS_AVX2)
-static void qsc_memutils_xor256(const uint8_t* input, uint8_t* output)
-{
-	_mm256_storeu_si256((__m256i*)output, _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)input), _mm256_loadu_si256((const __m256i*)output)));
+		if (pctr != length)
+		{
+			for (size_t i = pctr; i < length; ++i)
+			{
+				((uint8_t*)output)[i] = ((const uint8_t*)input)[i];
+			}
+		}
+	}
 }
-#endif
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-static void qsc_memutils_xor512(const uint8_t* input, uint8_t* output)
+void qsc_memutils_move(void* output, const void* input, size_t length)
 {
-	_mm512_storeu_si512((__m512i*)output, _mm512_xor_si512(_mm512_loadu_si512((const __m512i*)input), _mm512_loadu_si512((__m512i*)output)));
-}
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	memmove_s(output, length, input, length);
+#else
+	memmove(output, input, length);
 #endif
+}
 
-void qsc_memutils_xor(uint8_t* output, const uint8_t* input, size_t length)
+void qsc_memutils_setvalue(void* output, uint8_t value, size_t length)
 {
 	size_t pctr;
 
-	pctr = 0;
-
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-	const size_t SMDBLK = 64;
-#	elif defined(QSC_SYSTEM_HAS_AVX2)
-	const size_t SMDBLK = 32;
-#	else
-	const size_t SMDBLK = 16;
-#	endif
-
-	if (length >= SMDBLK)
+	if (length != 0)
 	{
-		const size_t ALNLEN = length - (length % SMDBLK);
+		pctr = 0;
 
-		while (pctr != ALNLEN)
-		{
-#if defined(QSC_SYSTEM_HAS_AVX512)
-			qsc_memutils_xor512((input + pctr), output + pctr);
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-			qsc_memutils_xor256((input + pctr), output + pctr);
-#elif defined(QSC_SYSTEM_HAS_AVX)
-			qsc_memutils_xor128((input + pctr), output + pctr);
+#if defined(MEMUTILS_SIMD_ENABLED)
+		pctr = memutils_simd_select()->setvalue((uint8_t*)output, value, length);
 #endif
-			pctr += SMDBLK;
+
+		if (pctr != length)
+		{
+			for (size_t i = pctr; i < length; ++i)
+			{
+				((uint8_t*)output)[i] = value;
+			}
 		}
 	}
-#endif
+}
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-	if (length - pctr >= 32)
-	{
-		qsc_memutils_xor256((input + pctr), output + pctr);
-		pctr += 32;
-	}
-	else if (length - pctr >= 16)
-	{
-		qsc_memutils_xor128((input + pctr), output + pctr);
-		pctr += 16;
-	}
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-	if (length - pctr >= 16)
-	{
-		qsc_memutils_xor128((input + pctr), output + pctr);
-		pctr += 16;
-	}
+void qsc_memutils_xor(uint8_t* output, const uint8_t* input, size_t length)
+{
+	size_t pctr;
+
+	pctr = 0;
+
+#if defined(MEMUTILS_SIMD_ENABLED)
+	pctr = memutils_simd_select()->xorblock(output, input, length);
 #endif
 
 	if (pctr != length)
@@ -501,57 +582,14 @@ void qsc_memutils_xor(uint8_t* output, const uint8_t* input, size_t length)
 	}
 }
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
-inline static void qsc_memutils_xorv512(const uint8_t value, uint8_t* output)
-{
-	__m512i v = _mm512_set1_epi8(value);
-	_mm512_storeu_si512((__m512i*)output, _mm512_xor_si512(_mm512_loadu_si512((const __m512i*)&v), _mm512_loadu_si512((__m512i*)output)));
-}
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-inline static void qsc_memutils_xorv256(const uint8_t value, uint8_t* output)
-{
-	__m256i v = _mm256_set1_epi8(value);
-	_mm256_storeu_si256((__m256i*)output, _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) & v), _mm256_loadu_si256((const __m256i*)output)));
-}
-#elif defined(QSC_SYSTEM_HAS_AVX)
-inline static void qsc_memutils_xorv128(const uint8_t value, uint8_t* output)
-{
-	__m128i v = _mm_set1_epi8(value);
-	_mm_storeu_si128((__m128i*)output, _mm_xor_si128(_mm_loadu_si128((const __m128i*) & v), _mm_loadu_si128((const __m128i*)output)));
-}
-#endif
-
 void qsc_memutils_xorv(uint8_t* output, const uint8_t value, size_t length)
 {
 	size_t pctr;
 
 	pctr = 0;
 
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-	const size_t SMDBLK = 64;
-#	elif defined(QSC_SYSTEM_HAS_AVX2)
-	const size_t SMDBLK = 32;
-#	else
-	const size_t SMDBLK = 16;
-#	endif
-
-	if (length >= SMDBLK)
-	{
-		const size_t ALNLEN = length - (length % SMDBLK);
-
-		while (pctr != ALNLEN)
-		{
-#if defined(QSC_SYSTEM_HAS_AVX512)
-			qsc_memutils_xorv512(value, (output + pctr));
-#elif defined(QSC_SYSTEM_HAS_AVX2)
-			qsc_memutils_xorv256(value, (output + pctr));
-#elif defined(QSC_SYSTEM_HAS_AVX)
-			qsc_memutils_xorv128(value, (output + pctr));
-#endif
-			pctr += SMDBLK;
-		}
-	}
+#if defined(MEMUTILS_SIMD_ENABLED)
+	pctr = memutils_simd_select()->xorvalue(output, value, length);
 #endif
 
 	if (pctr != length)
@@ -1,4 +1,6 @@
 #include "rcs.h"
+#include "async.h"
+#include "cpuidex.h"
 #include "intutils.h"
 #include "memutils.h"
 
@@ -21,11 +23,102 @@
 #ifdef QSC_RCS_AESNI_ENABLED
 #	define RCS_ROUNDKEY_ELEMENT_SIZE 16
 #	define RCS_AVX512_BLOCK 64
+#	define RCS_AVX512X4_BLOCK 256
+#	define RCS_PARALLEL4_BLOCK 128
+#	define RCS_PARALLEL8_BLOCK 256
+#	define RCS_AVX2X4_BLOCK 128
+#	define RCS_TARGET_AESNI QSC_SYSTEM_TARGET("aes,sse4.1")
+#	define RCS_TARGET_VAES256 QSC_SYSTEM_TARGET("avx2,aes,vaes")
+#	define RCS_TARGET_VAES512 QSC_SYSTEM_TARGET("avx512f,avx512bw,aes,vaes")
+#	define RCS_TARGET_VPERM128 QSC_SYSTEM_TARGET("ssse3")
+#	define RCS_TARGET_VPERM256 QSC_SYSTEM_TARGET("avx2")
+#	define RCS_VPERM128_BLOCK 64
+#	if defined(QSC_SYSTEM_RUNTIME_DISPATCH) || !defined(QSC_RCS_VAES512_ENABLED)
+		/* the 128-bit kernels run the aes-ni table, the vaes256 tails, and the vaes256 ecb transform */
+#		define RCS_AESNI128_ENABLED
+#	endif
 #else
 #	define RCS_ROUNDKEY_ELEMENT_SIZE 4
-#	define RCS_PREFETCH_TABLES
 #endif
 
+/*!
+\def RCS_MAC_TILE_SIZE
+* The number of bytes encrypted and then absorbed by the mac in each step of the single-pass transform.
+* The tile is a multiple of the widest kernel block, and small enough to stay in the L1 cache.
+*/
+#define RCS_MAC_TILE_SIZE 8192
+
+/*!
+\def RCS_MAC_LANES_MAX
+* The widest multi-lane mac; the kmac codes of a batch are computed in four or eight interleaved keccak states.
+* With runtime dispatch both permutations are compiled, and the kernel table selects one with the cpu features.
+*/
+#if defined(QSC_RCS_AUTHENTICATED) && !defined(QSC_RCS_KPA_AUTHENTICATION)
+#	if defined(QSC_RCS_AESNI_ENABLED) && defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+#		define RCS_MAC_LANES_X4
+#		define RCS_MAC_LANES_X8
+#	elif defined(QSC_SYSTEM_HAS_AVX512)
+#		define RCS_MAC_LANES_X8
+#	elif defined(QSC_SYSTEM_HAS_AVX2)
+#		define RCS_MAC_LANES_X4
+#	endif
+#endif
+
+#if defined(RCS_MAC_LANES_X4) || defined(RCS_MAC_LANES_X8)
+#	define RCS_MAC_LANES_ENABLED
+#	define RCS_MAC_LANES_MAX 8
+#	if defined(QSC_RCS_AUTH_KMACR12)
+#		define RCS_MAC_ROUNDS QSC_KECCAK_PERMUTATION_MIN_ROUNDS
+#	else
+#		define RCS_MAC_ROUNDS QSC_KECCAK_PERMUTATION_ROUNDS
+#	endif
+#endif
+
+/*!
+\def RCS_PARALLEL_MINIMUM
+* The smallest input that the parallel transform splits between threads;
+* below this size the cost of starting the threads outweighs the gain.
+*/
+#define RCS_PARALLEL_MINIMUM (1024 * 1024)
+
+/*!
+\def RCS_PARALLEL_ALIGNMENT
+* The segment length of each thread is a multiple of this size, so every kernel stays on its widest path.
+*/
+#define RCS_PARALLEL_ALIGNMENT 256
+
+/*!
+\def RCS_BATCH_MAXIMUM
+* The number of messages the batch transform processes in each pass; the per-message state lives on the stack.
+*/
+#define RCS_BATCH_MAXIMUM 64
+
+/*!
+\def RCS_BATCH_STREAM_MINIMUM
+* Messages of this length or longer reach the eight-block path of the aes-ni kernel,
+* so the batch transform encrypts them on their own rather than interleaving their blocks.
+*/
+#define RCS_BATCH_STREAM_MINIMUM 256
+
+/*!
+\def RCS_BITSLICED_BLOCK
+* The number of bytes transformed by one call to the bitsliced kernel.
+*/
+#define RCS_BITSLICED_BLOCK 64
+
+/*!
+\def RCS_SECTOR_BATCH
+* The number of blocks the sector mode passes to the block kernels in each call;
+* eight blocks fill the widest aes-ni and vaes kernels.
+*/
+#define RCS_SECTOR_BATCH 8
+
+/*!
+\def RCS_SECTOR_NAME_LENGTH
+* The sector mode key-schedule name array length.
+*/
+#define RCS_SECTOR_NAME_LENGTH 17
+
 /*!
 \def RCS256_ROUNDKEY_SIZE
 * The size of the RCS-256 internal round-key array in bytes.
@@ -82,7 +175,10 @@ static const uint8_t rcs512_name[RCS_NAME_LENGTH] =
 	0x32
 };
 
-#	if defined(QSC_RCS_AUTH_KMACR12)
+#	if defined(QSC_RCS_KPA_AUTHENTICATION)
+#		define RCS_KPA_NAME_LENGTH 6
+		static const uint8_t rcs_kpa_name[RCS_KPA_NAME_LENGTH] = { 0x52, 0x43, 0x53, 0x4B, 0x50, 0x41 };
+#	elif defined(QSC_RCS_AUTH_KMACR12)
 #		define RCS_KMACR12_NAME_LENGTH 7
 		static const uint8_t rcs_kmacr24_name[RCS_KMACR12_NAME_LENGTH] = { 0x4B, 0x4D, 0x41, 0x43, 0x52, 0x31, 0x32 };
 #	endif
@@ -101,492 +197,3694 @@ static const uint8_t rcs512_name[RCS_NAME_LENGTH] =
 
 #endif
 
-/* aes-ni and table-based fallback functions */
-
-#if defined(QSC_RCS_AESNI_ENABLED)
-
-static void rcs_transform_256(qsc_rcs_state* ctx, __m128i output[2], const __m128i input[2])
+/* the sector mode key schedule is named apart from the stream cipher, so the two never share a round-key array */
+static const uint8_t rcs256_sector_name[RCS_SECTOR_NAME_LENGTH] =
 {
-	const __m128i BLEND_MASK = _mm_set_epi32(0x80000000UL, 0x80800000UL, 0x80800000UL, 0x80808000UL);
-	const __m128i SHIFT_MASK = _mm_set_epi8(0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3);
-	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
-	const size_t RNDCNT = ctx->roundkeylen - 3;
-	size_t kctr;
+	0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x52, 0x43, 0x53, 0x58, 0x32, 0x35,
+	0x36
+};
 
-	__m128i blk1 = _mm_loadu_si128(&input[0]);
-	__m128i blk2 = _mm_loadu_si128(&input[1]);
-	__m128i tmp1;
-	__m128i tmp2;
+static const uint8_t rcs512_sector_name[RCS_SECTOR_NAME_LENGTH] =
+{
+	0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x52, 0x43, 0x53, 0x58, 0x35, 0x31,
+	0x32
+};
 
-	kctr = 0;
-	blk1 = _mm_xor_si128(blk1, ctx->roundkeys[kctr]);
-	++kctr;
-	blk2 = _mm_xor_si128(blk2, ctx->roundkeys[kctr]);
+/* constant-time bitsliced functions */
 
-	while (kctr != RNDCNT)
-	{
-		/* mix the blocks */
-		tmp1 = _mm_blendv_epi8(blk1, blk2, BLEND_MASK);
-		tmp2 = _mm_blendv_epi8(blk2, blk1, BLEND_MASK);
-		/* shuffle */
-		tmp1 = _mm_shuffle_epi8(tmp1, SHIFT_MASK);
-		tmp2 = _mm_shuffle_epi8(tmp2, SHIFT_MASK);
-		++kctr;
-		/* encrypt the first half-block */
-		blk1 = _mm_aesenc_si128(tmp1, ctx->roundkeys[kctr]);
-		++kctr;
-		/* encrypt the second half-block */
-		blk2 = _mm_aesenc_si128(tmp2, ctx->roundkeys[kctr]);
-	}
+#if defined(QSC_RCS_BITSLICED_ENABLED)
 
-	/* final block */
-	tmp1 = _mm_blendv_epi8(blk1, blk2, BLEND_MASK);
-	tmp2 = _mm_blendv_epi8(blk2, blk1, BLEND_MASK);
-	tmp1 = _mm_shuffle_epi8(tmp1, SHIFT_MASK);
-	tmp2 = _mm_shuffle_epi8(tmp2, SHIFT_MASK);
-	++kctr;
-	blk1 = _mm_aesenclast_si128(tmp1, ctx->roundkeys[kctr]);
-	++kctr;
-	blk2 = _mm_aesenclast_si128(tmp2, ctx->roundkeys[kctr]);
+/*
+* The bitsliced kernel processes two blocks at once in eight 64-bit bit-planes; plane q[b] holds bit b of every state byte.
+* Within a plane, the byte at column c and row r of block n is bit 16r + 8n + c, so each row is a 16-bit lane
+* and each block row is one byte. The AES-NI kernel feeds aesenc a byte permutation of the state that reverses the row order,
+* rotates the columns of each row, and reverses the column order within each half-block. The state is kept alternately in
+* the natural and in the row-reflected orientation, so that the row reversal is free, and the round-keys are stored
+* in the orientation of the round that consumes them. There are no secret-dependent memory accesses or branches.
+*/
 
-	/* store in output */
-	_mm_storeu_si128(&output[0], blk1);
-	_mm_storeu_si128(&output[1], blk2);
-}
+static uint64_t rcs_bitslice_swap(uint64_t x, uint64_t mask, uint32_t shift)
+{
+	uint64_t t;
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
+	t = ((x >> shift) ^ x) & mask;
 
-static void rcs_load2x128to512(const __m128i* k1, const __m128i* k2, __m512i* output)
-{
-	*output = _mm512_setzero_si512();
-	*output = _mm512_inserti32x4(*output, *k1, 0);
-	*output = _mm512_inserti32x4(*output, *k2, 1);
-	*output = _mm512_inserti32x4(*output, *k1, 2);
-	*output = _mm512_inserti32x4(*output, *k2, 3);
+	return x ^ t ^ (t << shift);
 }
 
-__m512i rcs_shuffle512(const __m512i* value, const __m512i* k0, const __m512i* k1, const __m512i* mask)
+static void rcs_bitslice_transpose_bits(uint64_t q[8])
 {
-	return _mm512_or_si512(_mm512_shuffle_epi8(*value, _mm512_add_epi8(*mask, *k0)),
-		_mm512_shuffle_epi8(_mm512_permutex_epi64(*value, 0x4E), _mm512_add_epi8(*mask, *k1)));
+	size_t i;
+
+	/* transpose the 8x8 bit matrix in each word */
+	for (i = 0; i < 8; ++i)
+	{
+		q[i] = rcs_bitslice_swap(q[i], 0x00AA00AA00AA00AAULL, 7);
+		q[i] = rcs_bitslice_swap(q[i], 0x0000CCCC0000CCCCULL, 14);
+		q[i] = rcs_bitslice_swap(q[i], 0x00000000F0F0F0F0ULL, 28);
+	}
 }
 
-static void rcs_transform_512(qsc_rcs_state* ctx, __m512i* output, const __m512i* input)
+static void rcs_bitslice_transpose_bytes(uint64_t q[8])
 {
-	const __m512i NI512K0 = _mm512_set_epi64(17361641481138401520, 17361641481138401520, 8102099357864587376, 8102099357864587376,
-		17361641481138401520, 17361641481138401520, 8102099357864587376, 8102099357864587376);
-	const __m512i NI512K1 = _mm512_set_epi64(8102099357864587376, 8102099357864587376, 17361641481138401520, 17361641481138401520,
-		8102099357864587376, 8102099357864587376, 17361641481138401520, 17361641481138401520);
-	const __m512i SWMASKL = _mm512_setr_epi8(0, 17, 22, 23, 4, 5, 26, 27, 8, 9, 14, 31, 12, 13, 18, 19,
-		16, 1, 6, 7, 20, 21, 10, 11, 24, 25, 30, 15, 28, 29, 2, 3,
-		0, 17, 22, 23, 4, 5, 26, 27, 8, 9, 14, 31, 12, 13, 18, 19, 
-		16, 1, 6, 7, 20, 21, 10, 11, 24, 25, 30, 15, 28, 29, 2, 3);
-
-	const size_t RNDCNT = (ctx->roundkeylen / 2) - 2;
-	size_t kctr;
-	__m512i x;
+	uint64_t t;
+	size_t i;
+	size_t j;
 
-	kctr = 0;
-	x = *input;
-	x = _mm512_xor_si512(x, ctx->roundkeysw[kctr]);
+	/* transpose the 8x8 byte matrix across the words */
+	for (i = 0; i < 4; ++i)
+	{
+		t = (q[i] >> 32) ^ (q[i + 4] & 0x00000000FFFFFFFFULL);
+		q[i] ^= t << 32;
+		q[i + 4] ^= t;
+	}
 
-	while (kctr < RNDCNT)
+	for (i = 0; i < 8; i += 4)
 	{
-		++kctr;
-		x = rcs_shuffle512(&x, &NI512K0, &NI512K1, &SWMASKL);
-		x = _mm512_aesenc_epi128(x, ctx->roundkeysw[kctr]);
+		for (j = i; j < i + 2; ++j)
+		{
+			t = ((q[j] >> 16) ^ q[j + 2]) & 0x0000FFFF0000FFFFULL;
+			q[j] ^= t << 16;
+			q[j + 2] ^= t;
+		}
 	}
 
-	++kctr;
-	x = rcs_shuffle512(&x, &NI512K0, &NI512K1, &SWMASKL);
-	*output = _mm512_aesenclast_epi128(x, ctx->roundkeysw[kctr]);
+	for (i = 0; i < 8; i += 2)
+	{
+		t = ((q[i] >> 8) ^ q[i + 1]) & 0x00FF00FF00FF00FFULL;
+		q[i] ^= t << 8;
+		q[i + 1] ^= t;
+	}
 }
 
-#endif
-
-static void rcs_ctr_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+static void rcs_bitslice_load(uint64_t q[8], const uint8_t* input)
 {
-	assert(ctx != NULL);
-	assert(input != NULL);
-	assert(output != NULL);
-
-	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
 	size_t i;
-	size_t oft;
-
-	oft = 0;
-
-#if defined(QSC_SYSTEM_HAS_AVX512)
 
-	if (length >= RCS_AVX512_BLOCK)
+	for (i = 0; i < 8; ++i)
 	{
-		uint8_t ctrblk[64];
-		__m512i ctrw;
-		__m512i inpw;
-		__m512i otpw;
+		q[i] = qsc_intutils_le8to64(input + (i * sizeof(uint64_t)));
+	}
 
-		/* initialize and pre-set the nonce */
-		ctrw = _mm512_set1_epi64(0);
-		qsc_memutils_copy(ctrblk, ctx->nonce, QSC_RCS_BLOCK_SIZE);
-		qsc_memutils_copy(((uint8_t*)ctrblk + QSC_RCS_BLOCK_SIZE), ctx->nonce, QSC_RCS_BLOCK_SIZE);
-		ctrw = _mm512_load_si512(ctrblk);
-		ctrw = _mm512_add_epi64(ctrw, _mm512_set_epi64(0, 0, 0, 1, 0, 0, 0, 0));
+	/* byte b of word i holds bit b of the eight bytes of word i, then word b holds bit b of every byte */
+	rcs_bitslice_transpose_bits(q);
+	rcs_bitslice_transpose_bytes(q);
 
-		/* process 2 blocks in parallel */
-		while (length >= RCS_AVX512_BLOCK)
-		{
-			/* encrypt the nonce */
-			rcs_transform_512(ctx, &otpw, &ctrw);
-			/* load the input */
-			inpw = _mm512_loadu_si512((const __m512i*)((uint8_t*)input + oft));
-			/* xor encrypted encrypted nonce with the input */
-			otpw = _mm512_xor_si512(otpw, inpw);
-			/* increments only the first 64 bits of the nonce; with ulong rollover that is 2^64 output blocks available */
-			ctrw = _mm512_add_epi64(ctrw, _mm512_set_epi64(0, 0, 0, 2, 0, 0, 0, 2));
-			/* store in output */
-			_mm512_storeu_si512((__m512i*)((uint8_t*)output + oft), otpw);
+	/* move the plane bits from byte order (block, column, row) to (row, block, column) */
+	for (i = 0; i < 8; ++i)
+	{
+		q[i] = rcs_bitslice_swap(q[i], 0x00000000CCCCCCCCULL, 30);
+		q[i] = rcs_bitslice_swap(q[i], 0x0000AAAA0000AAAAULL, 15);
+		q[i] = rcs_bitslice_swap(q[i], 0x00CC00CC00CC00CCULL, 6);
+		q[i] = rcs_bitslice_swap(q[i], 0x0A0A0A0A0A0A0A0AULL, 3);
+	}
+}
 
-			oft += RCS_AVX512_BLOCK;
-			length -= RCS_AVX512_BLOCK;
-		}
+static void rcs_bitslice_store(uint8_t* output, uint64_t q[8])
+{
+	size_t i;
 
-		/* store the last position of the nonce */
-		_mm512_storeu_si512((__m512i*)ctrblk, ctrw);
-		qsc_memutils_copy(ctx->nonce, ctrblk, QSC_RCS_BLOCK_SIZE);
+	for (i = 0; i < 8; ++i)
+	{
+		q[i] = rcs_bitslice_swap(q[i], 0x0A0A0A0A0A0A0A0AULL, 3);
+		q[i] = rcs_bitslice_swap(q[i], 0x00CC00CC00CC00CCULL, 6);
+		q[i] = rcs_bitslice_swap(q[i], 0x0000AAAA0000AAAAULL, 15);
+		q[i] = rcs_bitslice_swap(q[i], 0x00000000CCCCCCCCULL, 30);
 	}
 
-#endif
+	rcs_bitslice_transpose_bytes(q);
+	rcs_bitslice_transpose_bits(q);
 
-	while (length >= QSC_RCS_BLOCK_SIZE)
+	for (i = 0; i < 8; ++i)
 	{
-		__m128i tmpn[2] = { _mm_loadu_si128((const __m128i*)ctx->nonce), _mm_loadu_si128((const __m128i*)((uint8_t*)ctx->nonce + HLFBLK)) };
-		__m128i tmpo[2] = { 0 };
+		qsc_intutils_le64to8(output + (i * sizeof(uint64_t)), q[i]);
+	}
+}
 
-		rcs_transform_256(ctx, tmpo, tmpn);
+static void rcs_bitslice_sbox(uint64_t q[8])
+{
+	/* the Boyar-Peralta s-box circuit; x0 and s0 are the high bits */
+	const uint64_t x0 = q[7];
+	const uint64_t x1 = q[6];
+	const uint64_t x2 = q[5];
+	const uint64_t x3 = q[4];
+	const uint64_t x4 = q[3];
+	const uint64_t x5 = q[2];
+	const uint64_t x6 = q[1];
+	const uint64_t x7 = q[0];
+
+	/* top linear transformation */
+	const uint64_t y14 = x3 ^ x5;
+	const uint64_t y13 = x0 ^ x6;
+	const uint64_t y9 = x0 ^ x3;
+	const uint64_t y8 = x0 ^ x5;
+	const uint64_t t0 = x1 ^ x2;
+	const uint64_t y1 = t0 ^ x7;
+	const uint64_t y4 = y1 ^ x3;
+	const uint64_t y12 = y13 ^ y14;
+	const uint64_t y2 = y1 ^ x0;
+	const uint64_t y5 = y1 ^ x6;
+	const uint64_t y3 = y5 ^ y8;
+	const uint64_t t1 = x4 ^ y12;
+	const uint64_t y15 = t1 ^ x5;
+	const uint64_t y20 = t1 ^ x1;
+	const uint64_t y6 = y15 ^ x7;
+	const uint64_t y10 = y15 ^ t0;
+	const uint64_t y11 = y20 ^ y9;
+	const uint64_t y7 = x7 ^ y11;
+	const uint64_t y17 = y10 ^ y11;
+	const uint64_t y19 = y10 ^ y8;
+	const uint64_t y16 = t0 ^ y11;
+	const uint64_t y21 = y13 ^ y16;
+	const uint64_t y18 = x0 ^ y16;
+
+	/* non-linear section */
+	const uint64_t t2 = y12 & y15;
+	const uint64_t t3 = y3 & y6;
+	const uint64_t t4 = t3 ^ t2;
+	const uint64_t t5 = y4 & x7;
+	const uint64_t t6 = t5 ^ t2;
+	const uint64_t t7 = y13 & y16;
+	const uint64_t t8 = y5 & y1;
+	const uint64_t t9 = t8 ^ t7;
+	const uint64_t t10 = y2 & y7;
+	const uint64_t t11 = t10 ^ t7;
+	const uint64_t t12 = y9 & y11;
+	const uint64_t t13 = y14 & y17;
+	const uint64_t t14 = t13 ^ t12;
+	const uint64_t t15 = y8 & y10;
+	const uint64_t t16 = t15 ^ t12;
+	const uint64_t t17 = t4 ^ t14;
+	const uint64_t t18 = t6 ^ t16;
+	const uint64_t t19 = t9 ^ t14;
+	const uint64_t t20 = t11 ^ t16;
+	const uint64_t t21 = t17 ^ y20;
+	const uint64_t t22 = t18 ^ y19;
+	const uint64_t t23 = t19 ^ y21;
+	const uint64_t t24 = t20 ^ y18;
+
+	const uint64_t t25 = t21 ^ t22;
+	const uint64_t t26 = t21 & t23;
+	const uint64_t t27 = t24 ^ t26;
+	const uint64_t t28 = t25 & t27;
+	const uint64_t t29 = t28 ^ t22;
+	const uint64_t t30 = t23 ^ t24;
+	const uint64_t t31 = t22 ^ t26;
+	const uint64_t t32 = t31 & t30;
+	const uint64_t t33 = t32 ^ t24;
+	const uint64_t t34 = t23 ^ t33;
+	const uint64_t t35 = t27 ^ t33;
+	const uint64_t t36 = t24 & t35;
+	const uint64_t t37 = t36 ^ t34;
+	const uint64_t t38 = t27 ^ t36;
+	const uint64_t t39 = t29 & t38;
+	const uint64_t t40 = t25 ^ t39;
+
+	const uint64_t t41 = t40 ^ t37;
+	const uint64_t t42 = t29 ^ t33;
+	const uint64_t t43 = t29 ^ t40;
+	const uint64_t t44 = t33 ^ t37;
+	const uint64_t t45 = t42 ^ t41;
+	const uint64_t z0 = t44 & y15;
+	const uint64_t z1 = t37 & y6;
+	const uint64_t z2 = t33 & x7;
+	const uint64_t z3 = t43 & y16;
+	const uint64_t z4 = t40 & y1;
+	const uint64_t z5 = t29 & y7;
+	const uint64_t z6 = t42 & y11;
+	const uint64_t z7 = t45 & y17;
+	const uint64_t z8 = t41 & y10;
+	const uint64_t z9 = t44 & y12;
+	const uint64_t z10 = t37 & y3;
+	const uint64_t z11 = t33 & y4;
+	const uint64_t z12 = t43 & y13;
+	const uint64_t z13 = t40 & y5;
+	const uint64_t z14 = t29 & y2;
+	const uint64_t z15 = t42 & y9;
+	const uint64_t z16 = t45 & y14;
+	const uint64_t z17 = t41 & y8;
+
+	/* bottom linear transformation */
+	const uint64_t t46 = z15 ^ z16;
+	const uint64_t t47 = z10 ^ z11;
+	const uint64_t t48 = z5 ^ z13;
+	const uint64_t t49 = z9 ^ z10;
+	const uint64_t t50 = z2 ^ z12;
+	const uint64_t t51 = z2 ^ z5;
+	const uint64_t t52 = z7 ^ z8;
+	const uint64_t t53 = z0 ^ z3;
+	const uint64_t t54 = z6 ^ z7;
+	const uint64_t t55 = z16 ^ z17;
+	const uint64_t t56 = z12 ^ t48;
+	const uint64_t t57 = t50 ^ t53;
+	const uint64_t t58 = z4 ^ t46;
+	const uint64_t t59 = z3 ^ t54;
+	const uint64_t t60 = t46 ^ t57;
+	const uint64_t t61 = z14 ^ t57;
+	const uint64_t t62 = t52 ^ t58;
+	const uint64_t t63 = t49 ^ t58;
+	const uint64_t t64 = z4 ^ t59;
+	const uint64_t t65 = t61 ^ t62;
+	const uint64_t t66 = z1 ^ t63;
+	const uint64_t s0 = t59 ^ t63;
+	const uint64_t s6 = t56 ^ ~t62;
+	const uint64_t s7 = t48 ^ ~t60;
+	const uint64_t t67 = t64 ^ t65;
+	const uint64_t s3 = t53 ^ t66;
+	const uint64_t s4 = t51 ^ t66;
+	const uint64_t s5 = t47 ^ t65;
+	const uint64_t s1 = t64 ^ ~s3;
+	const uint64_t s2 = t55 ^ ~t67;
+
+	q[7] = s0;
+	q[6] = s1;
+	q[5] = s2;
+	q[4] = s3;
+	q[3] = s4;
+	q[2] = s5;
+	q[1] = s6;
+	q[0] = s7;
+}
 
-		__m128i tmpi[2] = { _mm_loadu_si128((const __m128i*)((uint8_t*)input + oft)) , _mm_loadu_si128((const __m128i*)((uint8_t*)input + HLFBLK + oft)) };
+static void rcs_bitslice_shift_rows(uint64_t q[8], bool reflected)
+{
+	uint64_t x;
+	size_t i;
 
-		tmpo[0] = _mm_xor_si128(tmpo[0], tmpi[0]);
-		tmpo[1] = _mm_xor_si128(tmpo[1], tmpi[1]);
+	if (reflected == false)
+	{
+		/* natural to reflected orientation; rotate the rows by 0, 1, 3 and 4 columns */
+		for (i = 0; i < 8; ++i)
+		{
+			x = q[i];
+			q[i] = (x & 0x000000000000FFFFULL)
+				| ((x >> 1) & 0x000000007F7F0000ULL) | ((x << 7) & 0x0000000080800000ULL)
+				| ((x >> 3) & 0x00001F1F00000000ULL) | ((x << 5) & 0x0000E0E000000000ULL)
+				| ((x >> 4) & 0x0F0F000000000000ULL) | ((x << 4) & 0xF0F0000000000000ULL);
+		}
+	}
+	else
+	{
+		/* reflected to natural orientation; rotate the rows by 4, 3, 1 and 0 columns */
+		for (i = 0; i < 8; ++i)
+		{
+			x = q[i];
+			q[i] = ((x >> 4) & 0x0000000000000F0FULL) | ((x << 4) & 0x000000000000F0F0ULL)
+				| ((x >> 3) & 0x000000001F1F0000ULL) | ((x << 5) & 0x00000000E0E00000ULL)
+				| ((x >> 1) & 0x00007F7F00000000ULL) | ((x << 7) & 0x0000808000000000ULL)
+				| (x & 0xFFFF000000000000ULL);
+		}
+	}
 
-		qsc_intutils_le8increment(ctx->nonce, QSC_RCS_BLOCK_SIZE);
+	/* reverse the column order within each half-block; columns 1 and 3, and 5 and 7 are exchanged */
+	for (i = 0; i < 8; ++i)
+	{
+		q[i] = rcs_bitslice_swap(q[i], 0x2222222222222222ULL, 2);
+	}
+}
 
-		/* store in output */
-		_mm_storeu_si128((__m128i*)((uint8_t*)output + oft), tmpo[0]);
-		_mm_storeu_si128((__m128i*)((uint8_t*)output + HLFBLK + oft), tmpo[1]);
+static void rcs_bitslice_mix_columns(uint64_t q[8], bool reflected)
+{
+	uint64_t a[8];
+	uint64_t b[8];
+	uint64_t x;
+	size_t i;
 
-		length -= QSC_RCS_BLOCK_SIZE;
-		oft += QSC_RCS_BLOCK_SIZE;
+	/* b is the next row of the column; the row order is reversed in the reflected orientation */
+	for (i = 0; i < 8; ++i)
+	{
+		x = q[i];
+		b[i] = (reflected == false) ? ((x >> 16) | (x << 48)) : ((x << 16) | (x >> 48));
+		a[i] = x ^ b[i];
 	}
 
-	if (length != 0)
+	/* 2a ^ 3b ^ c ^ d = xtime(a ^ b) ^ b ^ (c ^ d), where c ^ d is a ^ b rotated by two rows */
+	q[0] = a[7] ^ b[0] ^ ((a[0] >> 32) | (a[0] << 32));
+	q[1] = a[0] ^ a[7] ^ b[1] ^ ((a[1] >> 32) | (a[1] << 32));
+	q[2] = a[1] ^ b[2] ^ ((a[2] >> 32) | (a[2] << 32));
+	q[3] = a[2] ^ a[7] ^ b[3] ^ ((a[3] >> 32) | (a[3] << 32));
+	q[4] = a[3] ^ a[7] ^ b[4] ^ ((a[4] >> 32) | (a[4] << 32));
+	q[5] = a[4] ^ b[5] ^ ((a[5] >> 32) | (a[5] << 32));
+	q[6] = a[5] ^ b[6] ^ ((a[6] >> 32) | (a[6] << 32));
+	q[7] = a[6] ^ b[7] ^ ((a[7] >> 32) | (a[7] << 32));
+}
+
+static void rcs_bitslice_add_roundkey(uint64_t q[8], const uint64_t* rkeys)
+{
+	size_t i;
+
+	for (i = 0; i < 8; ++i)
 	{
-		__m128i tmpn[2] = { _mm_loadu_si128((const __m128i*)ctx->nonce), _mm_loadu_si128((const __m128i*)((uint8_t*)ctx->nonce + HLFBLK)) };
-		__m128i tmpo[2] = { 0 };
-		uint8_t tmpb[QSC_RCS_BLOCK_SIZE] = { 0 };
+		q[i] ^= rkeys[i];
+	}
+}
 
-		rcs_transform_256(ctx, tmpo, tmpn);
+static void rcs_bitslice_roundkeys(uint64_t* bkeys, const uint8_t* rkeys, size_t rounds)
+{
+	uint8_t tmpk[QSC_RCS_BLOCK_SIZE * 2];
+	size_t c;
+	size_t i;
+	size_t r;
 
-		/* store in tmp */
-		_mm_storeu_si128((__m128i*)tmpb, tmpo[0]);
-		_mm_storeu_si128((__m128i*)((uint8_t*)tmpb + HLFBLK), tmpo[1]);
+	for (i = 0; i <= rounds; ++i)
+	{
+		const uint8_t* pkey = rkeys + (i * QSC_RCS_BLOCK_SIZE);
 
-		for (i = 0; i < length; ++i)
+		if ((i & 1) == 0)
 		{
-			output[oft + i] = tmpb[i] ^ input[oft + i];
+			qsc_memutils_copy(tmpk, pkey, QSC_RCS_BLOCK_SIZE);
+		}
+		else
+		{
+			/* odd rounds output the reflected orientation; reverse the rows of each column */
+			for (c = 0; c < QSC_RCS_BLOCK_SIZE; c += 4)
+			{
+				for (r = 0; r < 4; ++r)
+				{
+					tmpk[c + r] = pkey[c + (3 - r)];
+				}
+			}
 		}
 
-		qsc_intutils_le8increment(ctx->nonce, QSC_RCS_BLOCK_SIZE);
+		/* the same key is applied to both blocks */
+		qsc_memutils_copy(tmpk + QSC_RCS_BLOCK_SIZE, tmpk, QSC_RCS_BLOCK_SIZE);
+		rcs_bitslice_load(bkeys + (i * 8), tmpk);
 	}
-}
 
-#else
+	qsc_memutils_clear(tmpk, sizeof(tmpk));
+}
 
-/* rijndael rcs_rcon, and s-box constant tables */
-
-static const uint8_t rcs_s_box[256] =
-{
-	0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
-	0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
-	0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
-	0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
-	0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
-	0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
-	0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
-	0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
-	0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
-	0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
-	0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
-	0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
-	0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
-	0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
-	0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
-	0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
-};
+static void rcs_transform_256b(const uint64_t* rkeys, size_t rounds, uint8_t* output, const uint8_t* input)
+{
+	/* transforms two blocks; the round count is even, so the output is in the natural orientation */
+	uint64_t q[8];
+	size_t i;
 
-static const uint8_t rcs_is_box[256] =
-{
-	0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38, 0xBF, 0x40, 0xA3, 0x9E, 0x81, 0xF3, 0xD7, 0xFB,
-	0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87, 0x34, 0x8E, 0x43, 0x44, 0xC4, 0xDE, 0xE9, 0xCB,
-	0x54, 0x7B, 0x94, 0x32, 0xA6, 0xC2, 0x23, 0x3D, 0xEE, 0x4C, 0x95, 0x0B, 0x42, 0xFA, 0xC3, 0x4E,
-	0x08, 0x2E, 0xA1, 0x66, 0x28, 0xD9, 0x24, 0xB2, 0x76, 0x5B, 0xA2, 0x49, 0x6D, 0x8B, 0xD1, 0x25,
-	0x72, 0xF8, 0xF6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xD4, 0xA4, 0x5C, 0xCC, 0x5D, 0x65, 0xB6, 0x92,
-	0x6C, 0x70, 0x48, 0x50, 0xFD, 0xED, 0xB9, 0xDA, 0x5E, 0x15, 0x46, 0x57, 0xA7, 0x8D, 0x9D, 0x84,
-	0x90, 0xD8, 0xAB, 0x00, 0x8C, 0xBC, 0xD3, 0x0A, 0xF7, 0xE4, 0x58, 0x05, 0xB8, 0xB3, 0x45, 0x06,
-	0xD0, 0x2C, 0x1E, 0x8F, 0xCA, 0x3F, 0x0F, 0x02, 0xC1, 0xAF, 0xBD, 0x03, 0x01, 0x13, 0x8A, 0x6B,
-	0x3A, 0x91, 0x11, 0x41, 0x4F, 0x67, 0xDC, 0xEA, 0x97, 0xF2, 0xCF, 0xCE, 0xF0, 0xB4, 0xE6, 0x73,
-	0x96, 0xAC, 0x74, 0x22, 0xE7, 0xAD, 0x35, 0x85, 0xE2, 0xF9, 0x37, 0xE8, 0x1C, 0x75, 0xDF, 0x6E,
-	0x47, 0xF1, 0x1A, 0x71, 0x1D, 0x29, 0xC5, 0x89, 0x6F, 0xB7, 0x62, 0x0E, 0xAA, 0x18, 0xBE, 0x1B,
-	0xFC, 0x56, 0x3E, 0x4B, 0xC6, 0xD2, 0x79, 0x20, 0x9A, 0xDB, 0xC0, 0xFE, 0x78, 0xCD, 0x5A, 0xF4,
-	0x1F, 0xDD, 0xA8, 0x33, 0x88, 0x07, 0xC7, 0x31, 0xB1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xEC, 0x5F,
-	0x60, 0x51, 0x7F, 0xA9, 0x19, 0xB5, 0x4A, 0x0D, 0x2D, 0xE5, 0x7A, 0x9F, 0x93, 0xC9, 0x9C, 0xEF,
-	0xA0, 0xE0, 0x3B, 0x4D, 0xAE, 0x2A, 0xF5, 0xB0, 0xC8, 0xEB, 0xBB, 0x3C, 0x83, 0x53, 0x99, 0x61,
-	0x17, 0x2B, 0x04, 0x7E, 0xBA, 0x77, 0xD6, 0x26, 0xE1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0C, 0x7D
-};
+	assert(rounds % 2 == 0);
 
-static void rcs_add_roundkey(uint8_t* state, const uint32_t *skeys)
-{
-	uint32_t k;
+	rcs_bitslice_load(q, input);
+	rcs_bitslice_add_roundkey(q, rkeys);
 
-	for (size_t i = 0; i < QSC_RCS_BLOCK_SIZE; i += sizeof(uint32_t))
+	for (i = 1; i < rounds; ++i)
 	{
-		k = *skeys;
-		state[i] ^= (uint8_t)(k >> 24);
-		state[i + 1] ^= (uint8_t)(k >> 16) & 0xFFU;
-		state[i + 2] ^= (uint8_t)(k >> 8) & 0xFFU;
-		state[i + 3] ^= (uint8_t)k & 0xFFU;
-		++skeys;
+		rcs_bitslice_shift_rows(q, (i & 1) == 0);
+		rcs_bitslice_sbox(q);
+		rcs_bitslice_mix_columns(q, (i & 1) != 0);
+		rcs_bitslice_add_roundkey(q, rkeys + (i * 8));
 	}
+
+	rcs_bitslice_shift_rows(q, true);
+	rcs_bitslice_sbox(q);
+	rcs_bitslice_add_roundkey(q, rkeys + (rounds * 8));
+	rcs_bitslice_store(output, q);
+	qsc_memutils_clear((uint8_t*)q, sizeof(q));
 }
 
-static void rcs_mix_columns(uint8_t* state)
+static void rcs_bitslice_inv_affine(uint64_t q[8])
 {
-	uint32_t s0;
-	uint32_t s1;
-	uint32_t s2;
-	uint32_t s3;
-	uint32_t t0;
-	uint32_t t1;
-	uint32_t t2;
-	uint32_t t3;
-
-	for (size_t i = 0; i < QSC_RCS_BLOCK_SIZE; i += sizeof(uint32_t))
-	{
-		s0 = state[i + 0];
-		s1 = state[i + 1];
-		s2 = state[i + 2];
-		s3 = state[i + 3];
-
-		t0 = (s0 << 1) ^ s1 ^ (s1 << 1) ^ s2 ^ s3;
-		t1 = s0 ^ (s1 << 1) ^ s2 ^ (s2 << 1) ^ s3;
-		t2 = s0 ^ s1 ^ (s2 << 1) ^ s3 ^ (s3 << 1);
-		t3 = s0 ^ (s0 << 1) ^ s1 ^ s2 ^ (s3 << 1);
+	/* the inverse of the s-box affine transform, applied to x ^ 0x63 */
+	const uint64_t x0 = ~q[0];
+	const uint64_t x1 = ~q[1];
+	const uint64_t x2 = q[2];
+	const uint64_t x3 = q[3];
+	const uint64_t x4 = q[4];
+	const uint64_t x5 = ~q[5];
+	const uint64_t x6 = ~q[6];
+	const uint64_t x7 = q[7];
+
+	q[7] = x1 ^ x4 ^ x6;
+	q[6] = x0 ^ x3 ^ x5;
+	q[5] = x7 ^ x2 ^ x4;
+	q[4] = x6 ^ x1 ^ x3;
+	q[3] = x5 ^ x0 ^ x2;
+	q[2] = x4 ^ x7 ^ x1;
+	q[1] = x3 ^ x6 ^ x0;
+	q[0] = x2 ^ x5 ^ x7;
+}
 
-		state[i + 0] = (uint8_t)(t0 ^ ((~(t0 >> 8) + 1) & 0x0000011BUL));
-		state[i + 1] = (uint8_t)(t1 ^ ((~(t1 >> 8) + 1) & 0x0000011BUL));
-		state[i + 2] = (uint8_t)(t2 ^ ((~(t2 >> 8) + 1) & 0x0000011BUL));
-		state[i + 3] = (uint8_t)(t3 ^ ((~(t3 >> 8) + 1) & 0x0000011BUL));
-	}
+static void rcs_bitslice_inv_sbox(uint64_t q[8])
+{
+	/* the s-box is S(x) = A(I(x)) ^ 0x63, and the field inversion I is an involution,
+	   so the inverse s-box is B(S(B(x ^ 0x63)) ^ 0x63), where B is the inverse of the affine transform A */
+	rcs_bitslice_inv_affine(q);
+	rcs_bitslice_sbox(q);
+	rcs_bitslice_inv_affine(q);
 }
 
-static void rcs_prefetch_sbox(bool encryption)
+static void rcs_bitslice_inv_shift_rows(uint64_t q[8], bool reflected)
 {
+	uint64_t x;
 	size_t i;
-	volatile uint32_t dmy;
 
-	dmy = 0;
+	/* restore the column order within each half-block */
+	for (i = 0; i < 8; ++i)
+	{
+		q[i] = rcs_bitslice_swap(q[i], 0x2222222222222222ULL, 2);
+	}
 
-	if (encryption)
+	if (reflected == false)
 	{
-		for (i = 0; i < 256; ++i)
+		/* reflected to natural orientation; undo the rotation of the rows by 0, 1, 3 and 4 columns */
+		for (i = 0; i < 8; ++i)
 		{
-			dmy |= rcs_s_box[i];
+			x = q[i];
+			q[i] = (x & 0x000000000000FFFFULL)
+				| ((x << 1) & 0x00000000FEFE0000ULL) | ((x >> 7) & 0x0000000001010000ULL)
+				| ((x << 3) & 0x0000F8F800000000ULL) | ((x >> 5) & 0x0000070700000000ULL)
+				| ((x >> 4) & 0x0F0F000000000000ULL) | ((x << 4) & 0xF0F0000000000000ULL);
 		}
 	}
 	else
 	{
-		for (i = 0; i < 256; ++i)
+		/* natural to reflected orientation; undo the rotation of the rows by 4, 3, 1 and 0 columns */
+		for (i = 0; i < 8; ++i)
 		{
-			dmy |= rcs_is_box[i];
+			x = q[i];
+			q[i] = ((x >> 4) & 0x0000000000000F0FULL) | ((x << 4) & 0x000000000000F0F0ULL)
+				| ((x << 3) & 0x00000000F8F80000ULL) | ((x >> 5) & 0x0000000007070000ULL)
+				| ((x << 1) & 0x0000FEFE00000000ULL) | ((x >> 7) & 0x0000010100000000ULL)
+				| (x & 0xFFFF000000000000ULL);
 		}
 	}
 }
 
-static void rcs_shift_rows(uint8_t* state)
+static void rcs_bitslice_xtime(uint64_t q[8])
 {
-	uint8_t tmp;
-
-	tmp = state[1];
-	state[1] = state[5];
-	state[5] = state[9];
-	state[9] = state[13];
-	state[13] = state[17];
-	state[17] = state[21];
-	state[21] = state[25];
-	state[25] = state[29];
-	state[29] = tmp;
-
-	tmp = state[2];
-	state[2] = state[14];
-	state[14] = state[26];
-	state[26] = state[6];
-	state[6] = state[18];
-	state[18] = state[30];
-	state[30] = state[10];
-	state[10] = state[22];
-	state[22] = tmp;
-
-	tmp = state[3];
-	state[3] = state[19];
-	state[19] = tmp;
+	const uint64_t x7 = q[7];
+
+	/* multiply every byte by x, reduced by the aes polynomial */
+	q[7] = q[6];
+	q[6] = q[5];
+	q[5] = q[4];
+	q[4] = q[3] ^ x7;
+	q[3] = q[2] ^ x7;
+	q[2] = q[1];
+	q[1] = q[0] ^ x7;
+	q[0] = x7;
+}
 
-	tmp = state[7];
-	state[7] = state[23];
-	state[23] = tmp;
+static void rcs_bitslice_inv_mix_columns(uint64_t q[8], bool reflected)
+{
+	/* the inverse matrix (e b d 9) is the forward matrix (2 3 1 1) times (5 0 4 0);
+	   each byte is first mixed with 4 times itself and the byte two rows away, which does not depend on the row order */
+	uint64_t t[8];
+	size_t i;
 
-	tmp = state[11];
-	state[11] = state[27];
-	state[27] = tmp;
+	for (i = 0; i < 8; ++i)
+	{
+		t[i] = q[i] ^ ((q[i] >> 32) | (q[i] << 32));
+	}
 
-	tmp = state[15];
-	state[15] = state[31];
-	state[31] = tmp;
-}
+	rcs_bitslice_xtime(t);
+	rcs_bitslice_xtime(t);
 
-static void rcs_sub_bytes(uint8_t* state, const uint8_t* sbox)
-{
-	for (size_t i = 0; i < QSC_RCS_BLOCK_SIZE; ++i)
+	for (i = 0; i < 8; ++i)
 	{
-		state[i] = sbox[state[i]];
+		q[i] ^= t[i];
 	}
+
+	rcs_bitslice_mix_columns(q, reflected);
 }
 
-static void rcs_transform_256(const qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input)
+static void rcs_inverse_256b(const uint64_t* rkeys, size_t rounds, uint8_t* output, const uint8_t* input)
 {
-	uint8_t buf[QSC_RCS_BLOCK_SIZE];
+	/* the inverse of rcs_transform_256b; the rounds are undone in reverse order, with the same round-keys */
+	uint64_t q[8];
+	size_t i;
 
-	qsc_memutils_copy(buf, input, QSC_RCS_BLOCK_SIZE);
-	rcs_add_roundkey(buf, ctx->roundkeys);
-	rcs_prefetch_sbox(true);
+	assert(rounds % 2 == 0);
 
-	for (size_t i = 1; i < ctx->rounds; ++i)
+	rcs_bitslice_load(q, input);
+	rcs_bitslice_add_roundkey(q, rkeys + (rounds * 8));
+	rcs_bitslice_inv_sbox(q);
+	rcs_bitslice_inv_shift_rows(q, true);
+
+	for (i = rounds - 1; i != 0; --i)
 	{
-		rcs_sub_bytes(buf, rcs_s_box);
-		rcs_shift_rows(buf);
-		rcs_mix_columns(buf);
-		rcs_add_roundkey(buf, ctx->roundkeys + (i << 3));
+		rcs_bitslice_add_roundkey(q, rkeys + (i * 8));
+		rcs_bitslice_inv_mix_columns(q, (i & 1) != 0);
+		rcs_bitslice_inv_sbox(q);
+		rcs_bitslice_inv_shift_rows(q, (i & 1) == 0);
 	}
 
-	rcs_sub_bytes(buf, rcs_s_box);
-	rcs_shift_rows(buf);
-	rcs_add_roundkey(buf, ctx->roundkeys + (ctx->rounds << 3));
-	qsc_memutils_copy(output, buf, QSC_RCS_BLOCK_SIZE);
+	rcs_bitslice_add_roundkey(q, rkeys);
+	rcs_bitslice_store(output, q);
+	qsc_memutils_clear((uint8_t*)q, sizeof(q));
 }
 
-static void rcs_ctr_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+static void rcs_ctr_transform_bitsliced(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
 {
 	assert(ctx != NULL);
 	assert(input != NULL);
 	assert(output != NULL);
 
+#if defined(QSC_RCS_AESNI_ENABLED)
+	const uint64_t* rkeys = ctx->roundkeysb;
+#else
+	const uint64_t* rkeys = ctx->roundkeys;
+#endif
+	uint8_t ctrs[RCS_BITSLICED_BLOCK];
+	uint8_t otp[RCS_BITSLICED_BLOCK];
 	size_t oft;
 
 	oft = 0;
 
-	while (length >= QSC_RCS_BLOCK_SIZE)
+	while (length >= RCS_BITSLICED_BLOCK)
 	{
-		rcs_transform_256(ctx, output + oft, ctx->nonce);
-		qsc_memutils_xor(output + oft, input + oft, QSC_RCS_BLOCK_SIZE);
-		qsc_intutils_le8increment(ctx->nonce, QSC_RCS_BLOCK_SIZE);
+		qsc_memutils_copy(ctrs, counter, QSC_RCS_BLOCK_SIZE);
+		qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+		qsc_memutils_copy(ctrs + QSC_RCS_BLOCK_SIZE, counter, QSC_RCS_BLOCK_SIZE);
+		qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
 
-		length -= QSC_RCS_BLOCK_SIZE;
-		oft += QSC_RCS_BLOCK_SIZE;
+		/* the key-stream is generated in a temporary so the input and output can overlap */
+		rcs_transform_256b(rkeys, ctx->rounds, otp, ctrs);
+
+		for (size_t i = 0; i < RCS_BITSLICED_BLOCK; ++i)
+		{
+			output[oft + i] = otp[i] ^ input[oft + i];
+		}
+
+		length -= RCS_BITSLICED_BLOCK;
+		oft += RCS_BITSLICED_BLOCK;
 	}
 
+	qsc_memutils_clear(otp, sizeof(otp));
+
 	if (length != 0)
 	{
-		uint8_t tmpb[QSC_RCS_BLOCK_SIZE] = { 0 };
+		uint8_t tmpb[RCS_BITSLICED_BLOCK] = { 0 };
+
+		/* the second counter is only consumed if the remainder spans it */
+		qsc_memutils_copy(ctrs, counter, QSC_RCS_BLOCK_SIZE);
+		qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+		qsc_memutils_copy(ctrs + QSC_RCS_BLOCK_SIZE, counter, QSC_RCS_BLOCK_SIZE);
+
+		if (length > QSC_RCS_BLOCK_SIZE)
+		{
+			qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+		}
 
-		rcs_transform_256(ctx, tmpb, ctx->nonce);
+		rcs_transform_256b(rkeys, ctx->rounds, tmpb, ctrs);
 
 		for (size_t i = 0; i < length; ++i)
 		{
 			output[oft + i] = tmpb[i] ^ input[oft + i];
 		}
 
-		qsc_intutils_le8increment(ctx->nonce, QSC_RCS_BLOCK_SIZE);
+		qsc_memutils_clear(tmpb, sizeof(tmpb));
 	}
 }
 
-#endif
-
-static void rcs_mac_finalize(qsc_rcs_state* ctx, uint8_t* output)
+static void rcs_ecb_transform_bitsliced(const qsc_rcs_sector_key* key, uint8_t* blocks, size_t nblocks, bool encrypt)
 {
-	uint8_t ctr[sizeof(uint64_t)] = { 0 };
-	uint64_t mctr = QSC_RCS_BLOCK_SIZE + ctx->counter + sizeof(uint64_t);
-
-	qsc_intutils_le64to8(ctr, mctr);
+	assert(key != NULL);
+	assert(blocks != NULL);
 
-	if (ctx->ctype == RCS256)
-	{
-#if defined(QSC_RCS_AUTH_KMACR12)
-		/* update the counter */
-		qsc_keccak_update(&ctx->kstate, qsc_keccak_rate_256, ctr, sizeof(ctr), QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
-		/* finalize the mac and append code to output */
-		qsc_keccak_finalize(&ctx->kstate, qsc_keccak_rate_256, output, QSC_RCS256_MAC_SIZE, QSC_KECCAK_KMAC_DOMAIN_ID, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+#if defined(QSC_RCS_AESNI_ENABLED)
+	const uint64_t* rkeys = key->state.roundkeysb;
 #else
-		/* update the counter */
-		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_256, ctr, sizeof(ctr));
-		/* finalize the mac and append code to output */
-		qsc_kmac_finalize(&ctx->kstate, qsc_keccak_rate_256, output, QSC_RCS256_MAC_SIZE);
+	const uint64_t* rkeys = key->state.roundkeys;
 #endif
-	}
-	else
+	uint8_t tmpb[RCS_BITSLICED_BLOCK] = { 0 };
+	size_t i;
+
+	/* the kernel transforms two blocks in place, an odd last block is padded in a temporary */
+	for (i = 0; i < nblocks; i += 2)
 	{
-#if defined(QSC_RCS_AUTH_KMACR12)
+		const size_t BLEN = (nblocks - i > 1) ? RCS_BITSLICED_BLOCK : QSC_RCS_BLOCK_SIZE;
+		uint8_t* pblk = (BLEN == RCS_BITSLICED_BLOCK) ? blocks + (i * QSC_RCS_BLOCK_SIZE) : tmpb;
+
+		if (BLEN != RCS_BITSLICED_BLOCK)
+		{
+			qsc_memutils_copy(tmpb, blocks + (i * QSC_RCS_BLOCK_SIZE), QSC_RCS_BLOCK_SIZE);
+		}
+
+		if (encrypt == true)
+		{
+			rcs_transform_256b(rkeys, key->state.rounds, pblk, pblk);
+		}
+		else
+		{
+			rcs_inverse_256b(rkeys, key->state.rounds, pblk, pblk);
+		}
+
+		if (BLEN != RCS_BITSLICED_BLOCK)
+		{
+			qsc_memutils_copy(blocks + (i * QSC_RCS_BLOCK_SIZE), tmpb, QSC_RCS_BLOCK_SIZE);
+		}
+	}
+
+	qsc_memutils_clear(tmpb, sizeof(tmpb));
+}
+
+#	if defined(QSC_RCS_AESNI_ENABLED)
+static void rcs_load_roundkeys_bitsliced(qsc_rcs_state* ctx)
+{
+	rcs_bitslice_roundkeys(ctx->roundkeysb, (const uint8_t*)ctx->roundkeys, ctx->rounds);
+}
+
+static void rcs_load_inverse_bitsliced(qsc_rcs_sector_key* key)
+{
+	/* the bitsliced kernels decrypt with the forward round-keys; they are loaded here when the stream kernel does not use them */
+	rcs_load_roundkeys_bitsliced(&key->state);
+}
+#	endif
+
+#endif
+
+/* multi-lane mac permutations */
+
+/* the keccak permutation of a multi-lane mac; word i of state j is at lanes[(i * lanes) + j] */
+typedef struct
+{
+	void (*permute)(uint64_t* lanes);
+	size_t lanes;
+} rcs_mac_kernel;
+
+#if defined(RCS_MAC_LANES_X4)
+
+QSC_SYSTEM_TARGET("avx2")
+static void rcs_mac_permute_x4(uint64_t* lanes)
+{
+	__m256i state[QSC_KECCAK_STATE_SIZE];
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm256_loadu_si256((const __m256i*)(lanes + (i * 4)));
+	}
+
+	qsc_keccak_permute_p4x1600(state, RCS_MAC_ROUNDS);
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		_mm256_storeu_si256((__m256i*)(lanes + (i * 4)), state[i]);
+	}
+}
+
+static const rcs_mac_kernel rcs_mac_kernel_x4 = { rcs_mac_permute_x4, 4 };
+#	define RCS_MAC_KERNEL_X4 &rcs_mac_kernel_x4
+#else
+#	define RCS_MAC_KERNEL_X4 NULL
+#endif
+
+#if defined(RCS_MAC_LANES_X8)
+
+QSC_SYSTEM_TARGET("avx512f")
+static void rcs_mac_permute_x8(uint64_t* lanes)
+{
+	__m512i state[QSC_KECCAK_STATE_SIZE];
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		state[i] = _mm512_loadu_si512((const void*)(lanes + (i * 8)));
+	}
+
+	qsc_keccak_permute_p8x1600(state, RCS_MAC_ROUNDS);
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		_mm512_storeu_si512((void*)(lanes + (i * 8)), state[i]);
+	}
+}
+
+static const rcs_mac_kernel rcs_mac_kernel_x8 = { rcs_mac_permute_x8, 8 };
+#	define RCS_MAC_KERNEL_X8 &rcs_mac_kernel_x8
+#else
+#	define RCS_MAC_KERNEL_X8 NULL
+#endif
+
+/* the lanes the compiler flags guarantee, used where the kernel does not imply a vector width */
+#if defined(RCS_MAC_LANES_X4) && defined(RCS_MAC_LANES_X8)
+#	define RCS_MAC_KERNEL_NATIVE NULL
+#elif defined(RCS_MAC_LANES_X8)
+#	define RCS_MAC_KERNEL_NATIVE RCS_MAC_KERNEL_X8
+#else
+#	define RCS_MAC_KERNEL_NATIVE RCS_MAC_KERNEL_X4
+#endif
+
+/* aes-ni functions */
+
+#if defined(QSC_RCS_AESNI_ENABLED)
+
+#if defined(RCS_AESNI128_ENABLED)
+
+RCS_TARGET_AESNI
+static void rcs_transform_256(const qsc_rcs_state* ctx, __m128i output[2], const __m128i input[2])
+{
+	const __m128i BLEND_MASK = _mm_set_epi32(0x80000000UL, 0x80800000UL, 0x80800000UL, 0x80808000UL);
+	const __m128i SHIFT_MASK = _mm_set_epi8(0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3);
+	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
+	const size_t RNDCNT = ctx->roundkeylen - 3;
+	size_t kctr;
+
+	__m128i blk1 = _mm_loadu_si128(&input[0]);
+	__m128i blk2 = _mm_loadu_si128(&input[1]);
+	__m128i tmp1;
+	__m128i tmp2;
+
+	kctr = 0;
+	blk1 = _mm_xor_si128(blk1, ctx->roundkeys[kctr]);
+	++kctr;
+	blk2 = _mm_xor_si128(blk2, ctx->roundkeys[kctr]);
+
+	while (kctr != RNDCNT)
+	{
+		/* mix the blocks */
+		tmp1 = _mm_blendv_epi8(blk1, blk2, BLEND_MASK);
+		tmp2 = _mm_blendv_epi8(blk2, blk1, BLEND_MASK);
+		/* shuffle */
+		tmp1 = _mm_shuffle_epi8(tmp1, SHIFT_MASK);
+		tmp2 = _mm_shuffle_epi8(tmp2, SHIFT_MASK);
+		++kctr;
+		/* encrypt the first half-block */
+		blk1 = _mm_aesenc_si128(tmp1, ctx->roundkeys[kctr]);
+		++kctr;
+		/* encrypt the second half-block */
+		blk2 = _mm_aesenc_si128(tmp2, ctx->roundkeys[kctr]);
+	}
+
+	/* final block */
+	tmp1 = _mm_blendv_epi8(blk1, blk2, BLEND_MASK);
+	tmp2 = _mm_blendv_epi8(blk2, blk1, BLEND_MASK);
+	tmp1 = _mm_shuffle_epi8(tmp1, SHIFT_MASK);
+	tmp2 = _mm_shuffle_epi8(tmp2, SHIFT_MASK);
+	++kctr;
+	blk1 = _mm_aesenclast_si128(tmp1, ctx->roundkeys[kctr]);
+	++kctr;
+	blk2 = _mm_aesenclast_si128(tmp2, ctx->roundkeys[kctr]);
+
+	/* store in output */
+	_mm_storeu_si128(&output[0], blk1);
+	_mm_storeu_si128(&output[1], blk2);
+}
+
+RCS_TARGET_AESNI
+static void rcs_transform_256x4(const qsc_rcs_state* ctx, __m128i output[8], const __m128i input[8])
+{
+	const __m128i BLEND_MASK = _mm_set_epi32(0x80000000UL, 0x80800000UL, 0x80800000UL, 0x80808000UL);
+	const __m128i SHIFT_MASK = _mm_set_epi8(0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3);
+	const size_t RNDCNT = ctx->roundkeylen - 3;
+	__m128i blk0;
+	__m128i blk1;
+	__m128i blk2;
+	__m128i blk3;
+	__m128i blk4;
+	__m128i blk5;
+	__m128i blk6;
+	__m128i blk7;
+	__m128i tmp0;
+	__m128i tmp1;
+	__m128i tmp2;
+	__m128i tmp3;
+	__m128i tmp4;
+	__m128i tmp5;
+	__m128i tmp6;
+	__m128i tmp7;
+	__m128i rk1;
+	__m128i rk2;
+	size_t kctr;
+
+	kctr = 0;
+	rk1 = ctx->roundkeys[kctr];
+	++kctr;
+	rk2 = ctx->roundkeys[kctr];
+
+	blk0 = _mm_xor_si128(_mm_loadu_si128(&input[0]), rk1);
+	blk1 = _mm_xor_si128(_mm_loadu_si128(&input[1]), rk2);
+	blk2 = _mm_xor_si128(_mm_loadu_si128(&input[2]), rk1);
+	blk3 = _mm_xor_si128(_mm_loadu_si128(&input[3]), rk2);
+	blk4 = _mm_xor_si128(_mm_loadu_si128(&input[4]), rk1);
+	blk5 = _mm_xor_si128(_mm_loadu_si128(&input[5]), rk2);
+	blk6 = _mm_xor_si128(_mm_loadu_si128(&input[6]), rk1);
+	blk7 = _mm_xor_si128(_mm_loadu_si128(&input[7]), rk2);
+
+	while (kctr != RNDCNT)
+	{
+		/* mix and shuffle the block pairs */
+		tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+		tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+		tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+		tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+		tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+		tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+		tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+		tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+		++kctr;
+		rk1 = ctx->roundkeys[kctr];
+		++kctr;
+		rk2 = ctx->roundkeys[kctr];
+		/* encrypt the half-blocks */
+		blk0 = _mm_aesenc_si128(tmp0, rk1);
+		blk1 = _mm_aesenc_si128(tmp1, rk2);
+		blk2 = _mm_aesenc_si128(tmp2, rk1);
+		blk3 = _mm_aesenc_si128(tmp3, rk2);
+		blk4 = _mm_aesenc_si128(tmp4, rk1);
+		blk5 = _mm_aesenc_si128(tmp5, rk2);
+		blk6 = _mm_aesenc_si128(tmp6, rk1);
+		blk7 = _mm_aesenc_si128(tmp7, rk2);
+	}
+
+	/* final round */
+	tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+	tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+	tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+	tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+	tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+	tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+	tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+	tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+	++kctr;
+	rk1 = ctx->roundkeys[kctr];
+	++kctr;
+	rk2 = ctx->roundkeys[kctr];
+	_mm_storeu_si128(&output[0], _mm_aesenclast_si128(tmp0, rk1));
+	_mm_storeu_si128(&output[1], _mm_aesenclast_si128(tmp1, rk2));
+	_mm_storeu_si128(&output[2], _mm_aesenclast_si128(tmp2, rk1));
+	_mm_storeu_si128(&output[3], _mm_aesenclast_si128(tmp3, rk2));
+	_mm_storeu_si128(&output[4], _mm_aesenclast_si128(tmp4, rk1));
+	_mm_storeu_si128(&output[5], _mm_aesenclast_si128(tmp5, rk2));
+	_mm_storeu_si128(&output[6], _mm_aesenclast_si128(tmp6, rk1));
+	_mm_storeu_si128(&output[7], _mm_aesenclast_si128(tmp7, rk2));
+}
+
+#endif
+
+RCS_TARGET_AESNI
+static void rcs_transform_256x4m(const __m128i* const rkeys[4], size_t roundkeylen, __m128i output[8], const __m128i input[8])
+{
+	/* the four block pairs are transformed with four independent round-key arrays of the same length */
+	const __m128i BLEND_MASK = _mm_set_epi32(0x80000000UL, 0x80800000UL, 0x80800000UL, 0x80808000UL);
+	const __m128i SHIFT_MASK = _mm_set_epi8(0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3);
+	const size_t RNDCNT = roundkeylen - 3;
+	__m128i blk0;
+	__m128i blk1;
+	__m128i blk2;
+	__m128i blk3;
+	__m128i blk4;
+	__m128i blk5;
+	__m128i blk6;
+	__m128i blk7;
+	__m128i tmp0;
+	__m128i tmp1;
+	__m128i tmp2;
+	__m128i tmp3;
+	__m128i tmp4;
+	__m128i tmp5;
+	__m128i tmp6;
+	__m128i tmp7;
+	size_t kctr;
+
+	kctr = 0;
+
+	blk0 = _mm_xor_si128(_mm_loadu_si128(&input[0]), rkeys[0][kctr]);
+	blk1 = _mm_xor_si128(_mm_loadu_si128(&input[1]), rkeys[0][kctr + 1]);
+	blk2 = _mm_xor_si128(_mm_loadu_si128(&input[2]), rkeys[1][kctr]);
+	blk3 = _mm_xor_si128(_mm_loadu_si128(&input[3]), rkeys[1][kctr + 1]);
+	blk4 = _mm_xor_si128(_mm_loadu_si128(&input[4]), rkeys[2][kctr]);
+	blk5 = _mm_xor_si128(_mm_loadu_si128(&input[5]), rkeys[2][kctr + 1]);
+	blk6 = _mm_xor_si128(_mm_loadu_si128(&input[6]), rkeys[3][kctr]);
+	blk7 = _mm_xor_si128(_mm_loadu_si128(&input[7]), rkeys[3][kctr + 1]);
+	++kctr;
+
+	while (kctr != RNDCNT)
+	{
+		/* mix and shuffle the block pairs */
+		tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+		tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+		tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+		tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+		tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+		tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+		tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+		tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+		kctr += 2;
+		/* encrypt the half-blocks, each pair with the round-keys of its own stream */
+		blk0 = _mm_aesenc_si128(tmp0, rkeys[0][kctr - 1]);
+		blk1 = _mm_aesenc_si128(tmp1, rkeys[0][kctr]);
+		blk2 = _mm_aesenc_si128(tmp2, rkeys[1][kctr - 1]);
+		blk3 = _mm_aesenc_si128(tmp3, rkeys[1][kctr]);
+		blk4 = _mm_aesenc_si128(tmp4, rkeys[2][kctr - 1]);
+		blk5 = _mm_aesenc_si128(tmp5, rkeys[2][kctr]);
+		blk6 = _mm_aesenc_si128(tmp6, rkeys[3][kctr - 1]);
+		blk7 = _mm_aesenc_si128(tmp7, rkeys[3][kctr]);
+	}
+
+	/* final round */
+	tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+	tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+	tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+	tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+	tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+	tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+	tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+	tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+	kctr += 2;
+	_mm_storeu_si128(&output[0], _mm_aesenclast_si128(tmp0, rkeys[0][kctr - 1]));
+	_mm_storeu_si128(&output[1], _mm_aesenclast_si128(tmp1, rkeys[0][kctr]));
+	_mm_storeu_si128(&output[2], _mm_aesenclast_si128(tmp2, rkeys[1][kctr - 1]));
+	_mm_storeu_si128(&output[3], _mm_aesenclast_si128(tmp3, rkeys[1][kctr]));
+	_mm_storeu_si128(&output[4], _mm_aesenclast_si128(tmp4, rkeys[2][kctr - 1]));
+	_mm_storeu_si128(&output[5], _mm_aesenclast_si128(tmp5, rkeys[2][kctr]));
+	_mm_storeu_si128(&output[6], _mm_aesenclast_si128(tmp6, rkeys[3][kctr - 1]));
+	_mm_storeu_si128(&output[7], _mm_aesenclast_si128(tmp7, rkeys[3][kctr]));
+}
+
+#if defined(RCS_AESNI128_ENABLED)
+
+RCS_TARGET_AESNI
+static void rcs_transform_256x8(const qsc_rcs_state* ctx, __m128i output[16], const __m128i input[16])
+{
+	const __m128i BLEND_MASK = _mm_set_epi32(0x80000000UL, 0x80800000UL, 0x80800000UL, 0x80808000UL);
+	const __m128i SHIFT_MASK = _mm_set_epi8(0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3);
+	const size_t RNDCNT = ctx->roundkeylen - 3;
+	__m128i blk0;
+	__m128i blk1;
+	__m128i blk2;
+	__m128i blk3;
+	__m128i blk4;
+	__m128i blk5;
+	__m128i blk6;
+	__m128i blk7;
+	__m128i blk8;
+	__m128i blk9;
+	__m128i blk10;
+	__m128i blk11;
+	__m128i blk12;
+	__m128i blk13;
+	__m128i blk14;
+	__m128i blk15;
+	__m128i tmp0;
+	__m128i tmp1;
+	__m128i tmp2;
+	__m128i tmp3;
+	__m128i tmp4;
+	__m128i tmp5;
+	__m128i tmp6;
+	__m128i tmp7;
+	__m128i tmp8;
+	__m128i tmp9;
+	__m128i tmp10;
+	__m128i tmp11;
+	__m128i tmp12;
+	__m128i tmp13;
+	__m128i tmp14;
+	__m128i tmp15;
+	__m128i rk1;
+	__m128i rk2;
+	size_t kctr;
+
+	kctr = 0;
+	rk1 = ctx->roundkeys[kctr];
+	++kctr;
+	rk2 = ctx->roundkeys[kctr];
+
+	blk0 = _mm_xor_si128(_mm_loadu_si128(&input[0]), rk1);
+	blk1 = _mm_xor_si128(_mm_loadu_si128(&input[1]), rk2);
+	blk2 = _mm_xor_si128(_mm_loadu_si128(&input[2]), rk1);
+	blk3 = _mm_xor_si128(_mm_loadu_si128(&input[3]), rk2);
+	blk4 = _mm_xor_si128(_mm_loadu_si128(&input[4]), rk1);
+	blk5 = _mm_xor_si128(_mm_loadu_si128(&input[5]), rk2);
+	blk6 = _mm_xor_si128(_mm_loadu_si128(&input[6]), rk1);
+	blk7 = _mm_xor_si128(_mm_loadu_si128(&input[7]), rk2);
+	blk8 = _mm_xor_si128(_mm_loadu_si128(&input[8]), rk1);
+	blk9 = _mm_xor_si128(_mm_loadu_si128(&input[9]), rk2);
+	blk10 = _mm_xor_si128(_mm_loadu_si128(&input[10]), rk1);
+	blk11 = _mm_xor_si128(_mm_loadu_si128(&input[11]), rk2);
+	blk12 = _mm_xor_si128(_mm_loadu_si128(&input[12]), rk1);
+	blk13 = _mm_xor_si128(_mm_loadu_si128(&input[13]), rk2);
+	blk14 = _mm_xor_si128(_mm_loadu_si128(&input[14]), rk1);
+	blk15 = _mm_xor_si128(_mm_loadu_si128(&input[15]), rk2);
+
+	while (kctr != RNDCNT)
+	{
+		/* mix and shuffle the block pairs */
+		tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+		tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+		tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+		tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+		tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+		tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+		tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+		tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+		tmp8 = _mm_shuffle_epi8(_mm_blendv_epi8(blk8, blk9, BLEND_MASK), SHIFT_MASK);
+		tmp9 = _mm_shuffle_epi8(_mm_blendv_epi8(blk9, blk8, BLEND_MASK), SHIFT_MASK);
+		tmp10 = _mm_shuffle_epi8(_mm_blendv_epi8(blk10, blk11, BLEND_MASK), SHIFT_MASK);
+		tmp11 = _mm_shuffle_epi8(_mm_blendv_epi8(blk11, blk10, BLEND_MASK), SHIFT_MASK);
+		tmp12 = _mm_shuffle_epi8(_mm_blendv_epi8(blk12, blk13, BLEND_MASK), SHIFT_MASK);
+		tmp13 = _mm_shuffle_epi8(_mm_blendv_epi8(blk13, blk12, BLEND_MASK), SHIFT_MASK);
+		tmp14 = _mm_shuffle_epi8(_mm_blendv_epi8(blk14, blk15, BLEND_MASK), SHIFT_MASK);
+		tmp15 = _mm_shuffle_epi8(_mm_blendv_epi8(blk15, blk14, BLEND_MASK), SHIFT_MASK);
+		++kctr;
+		rk1 = ctx->roundkeys[kctr];
+		++kctr;
+		rk2 = ctx->roundkeys[kctr];
+		/* encrypt the half-blocks */
+		blk0 = _mm_aesenc_si128(tmp0, rk1);
+		blk1 = _mm_aesenc_si128(tmp1, rk2);
+		blk2 = _mm_aesenc_si128(tmp2, rk1);
+		blk3 = _mm_aesenc_si128(tmp3, rk2);
+		blk4 = _mm_aesenc_si128(tmp4, rk1);
+		blk5 = _mm_aesenc_si128(tmp5, rk2);
+		blk6 = _mm_aesenc_si128(tmp6, rk1);
+		blk7 = _mm_aesenc_si128(tmp7, rk2);
+		blk8 = _mm_aesenc_si128(tmp8, rk1);
+		blk9 = _mm_aesenc_si128(tmp9, rk2);
+		blk10 = _mm_aesenc_si128(tmp10, rk1);
+		blk11 = _mm_aesenc_si128(tmp11, rk2);
+		blk12 = _mm_aesenc_si128(tmp12, rk1);
+		blk13 = _mm_aesenc_si128(tmp13, rk2);
+		blk14 = _mm_aesenc_si128(tmp14, rk1);
+		blk15 = _mm_aesenc_si128(tmp15, rk2);
+	}
+
+	/* final round */
+	tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+	tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+	tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+	tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+	tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+	tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+	tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+	tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+	tmp8 = _mm_shuffle_epi8(_mm_blendv_epi8(blk8, blk9, BLEND_MASK), SHIFT_MASK);
+	tmp9 = _mm_shuffle_epi8(_mm_blendv_epi8(blk9, blk8, BLEND_MASK), SHIFT_MASK);
+	tmp10 = _mm_shuffle_epi8(_mm_blendv_epi8(blk10, blk11, BLEND_MASK), SHIFT_MASK);
+	tmp11 = _mm_shuffle_epi8(_mm_blendv_epi8(blk11, blk10, BLEND_MASK), SHIFT_MASK);
+	tmp12 = _mm_shuffle_epi8(_mm_blendv_epi8(blk12, blk13, BLEND_MASK), SHIFT_MASK);
+	tmp13 = _mm_shuffle_epi8(_mm_blendv_epi8(blk13, blk12, BLEND_MASK), SHIFT_MASK);
+	tmp14 = _mm_shuffle_epi8(_mm_blendv_epi8(blk14, blk15, BLEND_MASK), SHIFT_MASK);
+	tmp15 = _mm_shuffle_epi8(_mm_blendv_epi8(blk15, blk14, BLEND_MASK), SHIFT_MASK);
+	++kctr;
+	rk1 = ctx->roundkeys[kctr];
+	++kctr;
+	rk2 = ctx->roundkeys[kctr];
+	_mm_storeu_si128(&output[0], _mm_aesenclast_si128(tmp0, rk1));
+	_mm_storeu_si128(&output[1], _mm_aesenclast_si128(tmp1, rk2));
+	_mm_storeu_si128(&output[2], _mm_aesenclast_si128(tmp2, rk1));
+	_mm_storeu_si128(&output[3], _mm_aesenclast_si128(tmp3, rk2));
+	_mm_storeu_si128(&output[4], _mm_aesenclast_si128(tmp4, rk1));
+	_mm_storeu_si128(&output[5], _mm_aesenclast_si128(tmp5, rk2));
+	_mm_storeu_si128(&output[6], _mm_aesenclast_si128(tmp6, rk1));
+	_mm_storeu_si128(&output[7], _mm_aesenclast_si128(tmp7, rk2));
+	_mm_storeu_si128(&output[8], _mm_aesenclast_si128(tmp8, rk1));
+	_mm_storeu_si128(&output[9], _mm_aesenclast_si128(tmp9, rk2));
+	_mm_storeu_si128(&output[10], _mm_aesenclast_si128(tmp10, rk1));
+	_mm_storeu_si128(&output[11], _mm_aesenclast_si128(tmp11, rk2));
+	_mm_storeu_si128(&output[12], _mm_aesenclast_si128(tmp12, rk1));
+	_mm_storeu_si128(&output[13], _mm_aesenclast_si128(tmp13, rk2));
+	_mm_storeu_si128(&output[14], _mm_aesenclast_si128(tmp14, rk1));
+	_mm_storeu_si128(&output[15], _mm_aesenclast_si128(tmp15, rk2));
+}
+
+RCS_TARGET_AESNI
+static void rcs_inverse_256(const __m128i* ikeys, size_t roundkeylen, __m128i output[2], const __m128i input[2])
+{
+	/* the inverse round undoes the blend and shuffle of the forward round between the InvShiftRows and InvSubBytes steps of aesdec;
+	   the permutation is moved ahead of aesdec, where the block pair is blended and shuffled as in the forward round, with other masks */
+	const __m128i BLEND_MASK = _mm_set_epi32(0x00008080UL, 0x00008080UL, 0x00808080UL, 0x00000080UL);
+	const __m128i SHIFT_MASK = _mm_set_epi8(8, 9, 6, 7, 12, 13, 10, 11, 0, 1, 14, 15, 4, 5, 2, 3);
+	const size_t RNDCNT = roundkeylen - 3;
+	size_t kctr;
+
+	__m128i blk1 = _mm_loadu_si128(&input[0]);
+	__m128i blk2 = _mm_loadu_si128(&input[1]);
+	__m128i tmp1;
+	__m128i tmp2;
+
+	kctr = 0;
+	blk1 = _mm_xor_si128(blk1, ikeys[kctr]);
+	++kctr;
+	blk2 = _mm_xor_si128(blk2, ikeys[kctr]);
+
+	while (kctr != RNDCNT)
+	{
+		/* mix the blocks */
+		tmp1 = _mm_blendv_epi8(blk1, blk2, BLEND_MASK);
+		tmp2 = _mm_blendv_epi8(blk2, blk1, BLEND_MASK);
+		/* shuffle */
+		tmp1 = _mm_shuffle_epi8(tmp1, SHIFT_MASK);
+		tmp2 = _mm_shuffle_epi8(tmp2, SHIFT_MASK);
+		++kctr;
+		/* decrypt the first half-block */
+		blk1 = _mm_aesdec_si128(tmp1, ikeys[kctr]);
+		++kctr;
+		/* decrypt the second half-block */
+		blk2 = _mm_aesdec_si128(tmp2, ikeys[kctr]);
+	}
+
+	/* final block */
+	tmp1 = _mm_blendv_epi8(blk1, blk2, BLEND_MASK);
+	tmp2 = _mm_blendv_epi8(blk2, blk1, BLEND_MASK);
+	tmp1 = _mm_shuffle_epi8(tmp1, SHIFT_MASK);
+	tmp2 = _mm_shuffle_epi8(tmp2, SHIFT_MASK);
+	++kctr;
+	blk1 = _mm_aesdeclast_si128(tmp1, ikeys[kctr]);
+	++kctr;
+	blk2 = _mm_aesdeclast_si128(tmp2, ikeys[kctr]);
+
+	/* store in output */
+	_mm_storeu_si128(&output[0], blk1);
+	_mm_storeu_si128(&output[1], blk2);
+}
+
+RCS_TARGET_AESNI
+static void rcs_inverse_256x4(const __m128i* ikeys, size_t roundkeylen, __m128i output[8], const __m128i input[8])
+{
+	const __m128i BLEND_MASK = _mm_set_epi32(0x00008080UL, 0x00008080UL, 0x00808080UL, 0x00000080UL);
+	const __m128i SHIFT_MASK = _mm_set_epi8(8, 9, 6, 7, 12, 13, 10, 11, 0, 1, 14, 15, 4, 5, 2, 3);
+	const size_t RNDCNT = roundkeylen - 3;
+	__m128i blk0;
+	__m128i blk1;
+	__m128i blk2;
+	__m128i blk3;
+	__m128i blk4;
+	__m128i blk5;
+	__m128i blk6;
+	__m128i blk7;
+	__m128i tmp0;
+	__m128i tmp1;
+	__m128i tmp2;
+	__m128i tmp3;
+	__m128i tmp4;
+	__m128i tmp5;
+	__m128i tmp6;
+	__m128i tmp7;
+	__m128i rk1;
+	__m128i rk2;
+	size_t kctr;
+
+	kctr = 0;
+	rk1 = ikeys[kctr];
+	++kctr;
+	rk2 = ikeys[kctr];
+
+	blk0 = _mm_xor_si128(_mm_loadu_si128(&input[0]), rk1);
+	blk1 = _mm_xor_si128(_mm_loadu_si128(&input[1]), rk2);
+	blk2 = _mm_xor_si128(_mm_loadu_si128(&input[2]), rk1);
+	blk3 = _mm_xor_si128(_mm_loadu_si128(&input[3]), rk2);
+	blk4 = _mm_xor_si128(_mm_loadu_si128(&input[4]), rk1);
+	blk5 = _mm_xor_si128(_mm_loadu_si128(&input[5]), rk2);
+	blk6 = _mm_xor_si128(_mm_loadu_si128(&input[6]), rk1);
+	blk7 = _mm_xor_si128(_mm_loadu_si128(&input[7]), rk2);
+
+	while (kctr != RNDCNT)
+	{
+		/* mix and shuffle the block pairs */
+		tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+		tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+		tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+		tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+		tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+		tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+		tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+		tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+		++kctr;
+		rk1 = ikeys[kctr];
+		++kctr;
+		rk2 = ikeys[kctr];
+		/* decrypt the half-blocks */
+		blk0 = _mm_aesdec_si128(tmp0, rk1);
+		blk1 = _mm_aesdec_si128(tmp1, rk2);
+		blk2 = _mm_aesdec_si128(tmp2, rk1);
+		blk3 = _mm_aesdec_si128(tmp3, rk2);
+		blk4 = _mm_aesdec_si128(tmp4, rk1);
+		blk5 = _mm_aesdec_si128(tmp5, rk2);
+		blk6 = _mm_aesdec_si128(tmp6, rk1);
+		blk7 = _mm_aesdec_si128(tmp7, rk2);
+	}
+
+	/* final round */
+	tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+	tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+	tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+	tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+	tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+	tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+	tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+	tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+	++kctr;
+	rk1 = ikeys[kctr];
+	++kctr;
+	rk2 = ikeys[kctr];
+	_mm_storeu_si128(&output[0], _mm_aesdeclast_si128(tmp0, rk1));
+	_mm_storeu_si128(&output[1], _mm_aesdeclast_si128(tmp1, rk2));
+	_mm_storeu_si128(&output[2], _mm_aesdeclast_si128(tmp2, rk1));
+	_mm_storeu_si128(&output[3], _mm_aesdeclast_si128(tmp3, rk2));
+	_mm_storeu_si128(&output[4], _mm_aesdeclast_si128(tmp4, rk1));
+	_mm_storeu_si128(&output[5], _mm_aesdeclast_si128(tmp5, rk2));
+	_mm_storeu_si128(&output[6], _mm_aesdeclast_si128(tmp6, rk1));
+	_mm_storeu_si128(&output[7], _mm_aesdeclast_si128(tmp7, rk2));
+}
+
+RCS_TARGET_AESNI
+static void rcs_inverse_256x8(const __m128i* ikeys, size_t roundkeylen, __m128i output[16], const __m128i input[16])
+{
+	const __m128i BLEND_MASK = _mm_set_epi32(0x00008080UL, 0x00008080UL, 0x00808080UL, 0x00000080UL);
+	const __m128i SHIFT_MASK = _mm_set_epi8(8, 9, 6, 7, 12, 13, 10, 11, 0, 1, 14, 15, 4, 5, 2, 3);
+	const size_t RNDCNT = roundkeylen - 3;
+	__m128i blk0;
+	__m128i blk1;
+	__m128i blk2;
+	__m128i blk3;
+	__m128i blk4;
+	__m128i blk5;
+	__m128i blk6;
+	__m128i blk7;
+	__m128i blk8;
+	__m128i blk9;
+	__m128i blk10;
+	__m128i blk11;
+	__m128i blk12;
+	__m128i blk13;
+	__m128i blk14;
+	__m128i blk15;
+	__m128i tmp0;
+	__m128i tmp1;
+	__m128i tmp2;
+	__m128i tmp3;
+	__m128i tmp4;
+	__m128i tmp5;
+	__m128i tmp6;
+	__m128i tmp7;
+	__m128i tmp8;
+	__m128i tmp9;
+	__m128i tmp10;
+	__m128i tmp11;
+	__m128i tmp12;
+	__m128i tmp13;
+	__m128i tmp14;
+	__m128i tmp15;
+	__m128i rk1;
+	__m128i rk2;
+	size_t kctr;
+
+	kctr = 0;
+	rk1 = ikeys[kctr];
+	++kctr;
+	rk2 = ikeys[kctr];
+
+	blk0 = _mm_xor_si128(_mm_loadu_si128(&input[0]), rk1);
+	blk1 = _mm_xor_si128(_mm_loadu_si128(&input[1]), rk2);
+	blk2 = _mm_xor_si128(_mm_loadu_si128(&input[2]), rk1);
+	blk3 = _mm_xor_si128(_mm_loadu_si128(&input[3]), rk2);
+	blk4 = _mm_xor_si128(_mm_loadu_si128(&input[4]), rk1);
+	blk5 = _mm_xor_si128(_mm_loadu_si128(&input[5]), rk2);
+	blk6 = _mm_xor_si128(_mm_loadu_si128(&input[6]), rk1);
+	blk7 = _mm_xor_si128(_mm_loadu_si128(&input[7]), rk2);
+	blk8 = _mm_xor_si128(_mm_loadu_si128(&input[8]), rk1);
+	blk9 = _mm_xor_si128(_mm_loadu_si128(&input[9]), rk2);
+	blk10 = _mm_xor_si128(_mm_loadu_si128(&input[10]), rk1);
+	blk11 = _mm_xor_si128(_mm_loadu_si128(&input[11]), rk2);
+	blk12 = _mm_xor_si128(_mm_loadu_si128(&input[12]), rk1);
+	blk13 = _mm_xor_si128(_mm_loadu_si128(&input[13]), rk2);
+	blk14 = _mm_xor_si128(_mm_loadu_si128(&input[14]), rk1);
+	blk15 = _mm_xor_si128(_mm_loadu_si128(&input[15]), rk2);
+
+	while (kctr != RNDCNT)
+	{
+		/* mix and shuffle the block pairs */
+		tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+		tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+		tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+		tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+		tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+		tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+		tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+		tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+		tmp8 = _mm_shuffle_epi8(_mm_blendv_epi8(blk8, blk9, BLEND_MASK), SHIFT_MASK);
+		tmp9 = _mm_shuffle_epi8(_mm_blendv_epi8(blk9, blk8, BLEND_MASK), SHIFT_MASK);
+		tmp10 = _mm_shuffle_epi8(_mm_blendv_epi8(blk10, blk11, BLEND_MASK), SHIFT_MASK);
+		tmp11 = _mm_shuffle_epi8(_mm_blendv_epi8(blk11, blk10, BLEND_MASK), SHIFT_MASK);
+		tmp12 = _mm_shuffle_epi8(_mm_blendv_epi8(blk12, blk13, BLEND_MASK), SHIFT_MASK);
+		tmp13 = _mm_shuffle_epi8(_mm_blendv_epi8(blk13, blk12, BLEND_MASK), SHIFT_MASK);
+		tmp14 = _mm_shuffle_epi8(_mm_blendv_epi8(blk14, blk15, BLEND_MASK), SHIFT_MASK);
+		tmp15 = _mm_shuffle_epi8(_mm_blendv_epi8(blk15, blk14, BLEND_MASK), SHIFT_MASK);
+		++kctr;
+		rk1 = ikeys[kctr];
+		++kctr;
+		rk2 = ikeys[kctr];
+		/* decrypt the half-blocks */
+		blk0 = _mm_aesdec_si128(tmp0, rk1);
+		blk1 = _mm_aesdec_si128(tmp1, rk2);
+		blk2 = _mm_aesdec_si128(tmp2, rk1);
+		blk3 = _mm_aesdec_si128(tmp3, rk2);
+		blk4 = _mm_aesdec_si128(tmp4, rk1);
+		blk5 = _mm_aesdec_si128(tmp5, rk2);
+		blk6 = _mm_aesdec_si128(tmp6, rk1);
+		blk7 = _mm_aesdec_si128(tmp7, rk2);
+		blk8 = _mm_aesdec_si128(tmp8, rk1);
+		blk9 = _mm_aesdec_si128(tmp9, rk2);
+		blk10 = _mm_aesdec_si128(tmp10, rk1);
+		blk11 = _mm_aesdec_si128(tmp11, rk2);
+		blk12 = _mm_aesdec_si128(tmp12, rk1);
+		blk13 = _mm_aesdec_si128(tmp13, rk2);
+		blk14 = _mm_aesdec_si128(tmp14, rk1);
+		blk15 = _mm_aesdec_si128(tmp15, rk2);
+	}
+
+	/* final round */
+	tmp0 = _mm_shuffle_epi8(_mm_blendv_epi8(blk0, blk1, BLEND_MASK), SHIFT_MASK);
+	tmp1 = _mm_shuffle_epi8(_mm_blendv_epi8(blk1, blk0, BLEND_MASK), SHIFT_MASK);
+	tmp2 = _mm_shuffle_epi8(_mm_blendv_epi8(blk2, blk3, BLEND_MASK), SHIFT_MASK);
+	tmp3 = _mm_shuffle_epi8(_mm_blendv_epi8(blk3, blk2, BLEND_MASK), SHIFT_MASK);
+	tmp4 = _mm_shuffle_epi8(_mm_blendv_epi8(blk4, blk5, BLEND_MASK), SHIFT_MASK);
+	tmp5 = _mm_shuffle_epi8(_mm_blendv_epi8(blk5, blk4, BLEND_MASK), SHIFT_MASK);
+	tmp6 = _mm_shuffle_epi8(_mm_blendv_epi8(blk6, blk7, BLEND_MASK), SHIFT_MASK);
+	tmp7 = _mm_shuffle_epi8(_mm_blendv_epi8(blk7, blk6, BLEND_MASK), SHIFT_MASK);
+	tmp8 = _mm_shuffle_epi8(_mm_blendv_epi8(blk8, blk9, BLEND_MASK), SHIFT_MASK);
+	tmp9 = _mm_shuffle_epi8(_mm_blendv_epi8(blk9, blk8, BLEND_MASK), SHIFT_MASK);
+	tmp10 = _mm_shuffle_epi8(_mm_blendv_epi8(blk10, blk11, BLEND_MASK), SHIFT_MASK);
+	tmp11 = _mm_shuffle_epi8(_mm_blendv_epi8(blk11, blk10, BLEND_MASK), SHIFT_MASK);
+	tmp12 = _mm_shuffle_epi8(_mm_blendv_epi8(blk12, blk13, BLEND_MASK), SHIFT_MASK);
+	tmp13 = _mm_shuffle_epi8(_mm_blendv_epi8(blk13, blk12, BLEND_MASK), SHIFT_MASK);
+	tmp14 = _mm_shuffle_epi8(_mm_blendv_epi8(blk14, blk15, BLEND_MASK), SHIFT_MASK);
+	tmp15 = _mm_shuffle_epi8(_mm_blendv_epi8(blk15, blk14, BLEND_MASK), SHIFT_MASK);
+	++kctr;
+	rk1 = ikeys[kctr];
+	++kctr;
+	rk2 = ikeys[kctr];
+	_mm_storeu_si128(&output[0], _mm_aesdeclast_si128(tmp0, rk1));
+	_mm_storeu_si128(&output[1], _mm_aesdeclast_si128(tmp1, rk2));
+	_mm_storeu_si128(&output[2], _mm_aesdeclast_si128(tmp2, rk1));
+	_mm_storeu_si128(&output[3], _mm_aesdeclast_si128(tmp3, rk2));
+	_mm_storeu_si128(&output[4], _mm_aesdeclast_si128(tmp4, rk1));
+	_mm_storeu_si128(&output[5], _mm_aesdeclast_si128(tmp5, rk2));
+	_mm_storeu_si128(&output[6], _mm_aesdeclast_si128(tmp6, rk1));
+	_mm_storeu_si128(&output[7], _mm_aesdeclast_si128(tmp7, rk2));
+	_mm_storeu_si128(&output[8], _mm_aesdeclast_si128(tmp8, rk1));
+	_mm_storeu_si128(&output[9], _mm_aesdeclast_si128(tmp9, rk2));
+	_mm_storeu_si128(&output[10], _mm_aesdeclast_si128(tmp10, rk1));
+	_mm_storeu_si128(&output[11], _mm_aesdeclast_si128(tmp11, rk2));
+	_mm_storeu_si128(&output[12], _mm_aesdeclast_si128(tmp12, rk1));
+	_mm_storeu_si128(&output[13], _mm_aesdeclast_si128(tmp13, rk2));
+	_mm_storeu_si128(&output[14], _mm_aesdeclast_si128(tmp14, rk1));
+	_mm_storeu_si128(&output[15], _mm_aesdeclast_si128(tmp15, rk2));
+}
+
+#endif
+
+RCS_TARGET_AESNI
+static void rcs_load_inverse_keys(qsc_rcs_sector_key* key)
+{
+	/* the decryption kernels read the round-keys in reverse order; the keys of the inner rounds are passed through InvMixColumns,
+	   because aesdec adds the round-key after its InvMixColumns step, and the forward round adds it after MixColumns */
+	const size_t RKLEN = key->state.roundkeylen;
+	size_t i;
+
+	for (i = 0; i < RKLEN; i += 2)
+	{
+		key->invkeys[i] = key->state.roundkeys[RKLEN - 2 - i];
+		key->invkeys[i + 1] = key->state.roundkeys[RKLEN - 1 - i];
+
+		if (i != 0 && i != RKLEN - 2)
+		{
+			key->invkeys[i] = _mm_aesimc_si128(key->invkeys[i]);
+			key->invkeys[i + 1] = _mm_aesimc_si128(key->invkeys[i + 1]);
+		}
+	}
+}
+
+#if defined(RCS_AESNI128_ENABLED)
+
+RCS_TARGET_AESNI
+static void rcs_ecb_transform_aesni(const qsc_rcs_sector_key* key, uint8_t* blocks, size_t nblocks, bool encrypt)
+{
+	assert(key != NULL);
+	assert(blocks != NULL);
+
+	__m128i* pblk = (__m128i*)blocks;
+	size_t i;
+
+	i = 0;
+
+	/* process 8 blocks in parallel */
+	while (nblocks - i >= 8)
+	{
+		if (encrypt == true)
+		{
+			rcs_transform_256x8(&key->state, pblk + (i * 2), pblk + (i * 2));
+		}
+		else
+		{
+			rcs_inverse_256x8(key->invkeys, key->state.roundkeylen, pblk + (i * 2), pblk + (i * 2));
+		}
+
+		i += 8;
+	}
+
+	/* process 4 blocks in parallel */
+	if (nblocks - i >= 4)
+	{
+		if (encrypt == true)
+		{
+			rcs_transform_256x4(&key->state, pblk + (i * 2), pblk + (i * 2));
+		}
+		else
+		{
+			rcs_inverse_256x4(key->invkeys, key->state.roundkeylen, pblk + (i * 2), pblk + (i * 2));
+		}
+
+		i += 4;
+	}
+
+	while (i != nblocks)
+	{
+		if (encrypt == true)
+		{
+			rcs_transform_256(&key->state, pblk + (i * 2), pblk + (i * 2));
+		}
+		else
+		{
+			rcs_inverse_256(key->invkeys, key->state.roundkeylen, pblk + (i * 2), pblk + (i * 2));
+		}
+
+		++i;
+	}
+}
+
+static void rcs_ctr_generate(uint8_t* counter, __m128i* counters, size_t nblocks)
+{
+	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
+	size_t i;
+
+	for (i = 0; i < nblocks; ++i)
+	{
+		counters[i * 2] = _mm_loadu_si128((const __m128i*)counter);
+		counters[(i * 2) + 1] = _mm_loadu_si128((const __m128i*)(counter + HLFBLK));
+		/* full 256-bit little-endian carry, identical to the sequential path */
+		qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+	}
+}
+
+#endif
+
+static void rcs_ctr_xorn(uint8_t* output, const uint8_t* input, __m128i* keystream, size_t hblocks)
+{
+	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
+	size_t i;
+
+	for (i = 0; i < hblocks; ++i)
+	{
+		keystream[i] = _mm_xor_si128(keystream[i], _mm_loadu_si128((const __m128i*)(input + (i * HLFBLK))));
+		_mm_storeu_si128((__m128i*)(output + (i * HLFBLK)), keystream[i]);
+	}
+}
+
+#if defined(QSC_RCS_VAES512_ENABLED)
+
+RCS_TARGET_VAES512
+static void rcs_load_roundkeys512(qsc_rcs_state* ctx)
+{
+	__m512i rk;
+
+	/* the even and odd keys are broadcast to the low and high lanes of both blocks */
+	qsc_memutils_clear((uint8_t*)ctx->roundkeysw, sizeof(ctx->roundkeysw));
+
+	for (size_t i = 0; i < ctx->roundkeylen; i += 2)
+	{
+		rk = _mm512_setzero_si512();
+		rk = _mm512_inserti32x4(rk, ctx->roundkeys[i], 0);
+		rk = _mm512_inserti32x4(rk, ctx->roundkeys[i + 1], 1);
+		rk = _mm512_inserti32x4(rk, ctx->roundkeys[i], 2);
+		rk = _mm512_inserti32x4(rk, ctx->roundkeys[i + 1], 3);
+		_mm512_storeu_si512(&ctx->roundkeysw[i / 2], rk);
+	}
+}
+
+RCS_TARGET_VAES512
+inline static __m512i rcs_shuffle512(__m512i value, __m512i mask0, __m512i mask1)
+{
+	return _mm512_or_si512(_mm512_shuffle_epi8(value, mask0),
+		_mm512_shuffle_epi8(_mm512_permutex_epi64(value, 0x4E), mask1));
+}
+
+RCS_TARGET_VAES512
+inline static void rcs_transform_512xn(const qsc_rcs_state* ctx, __m512i* output, const __m512i* input, size_t wblocks)
+{
+	const __m512i NI512K0 = _mm512_set_epi64(17361641481138401520ULL, 17361641481138401520ULL, 8102099357864587376ULL, 8102099357864587376ULL,
+		17361641481138401520ULL, 17361641481138401520ULL, 8102099357864587376ULL, 8102099357864587376ULL);
+	const __m512i NI512K1 = _mm512_set_epi64(8102099357864587376ULL, 8102099357864587376ULL, 17361641481138401520ULL, 17361641481138401520ULL,
+		8102099357864587376ULL, 8102099357864587376ULL, 17361641481138401520ULL, 17361641481138401520ULL);
+	/* the blend and shuffle of the 128-bit path, expressed as a 32-byte permutation of each block */
+	const __m512i SWMASKL = _mm512_broadcast_i64x4(_mm256_set_epi8(16, 1, 6, 7, 20, 21, 10, 11, 24, 25, 30, 15, 28, 29, 2, 3,
+		0, 17, 22, 23, 4, 5, 26, 27, 8, 9, 14, 31, 12, 13, 18, 19));
+	const __m512i SHFMSK0 = _mm512_add_epi8(SWMASKL, NI512K0);
+	const __m512i SHFMSK1 = _mm512_add_epi8(SWMASKL, NI512K1);
+	const size_t RNDCNT = (ctx->roundkeylen / 2) - 2;
+	__m512i x[4];
+	__m512i rk;
+	size_t i;
+	size_t kctr;
+
+	assert(wblocks <= 4);
+
+	kctr = 0;
+	rk = _mm512_loadu_si512(&ctx->roundkeysw[kctr]);
+
+	for (i = 0; i < wblocks; ++i)
+	{
+		x[i] = _mm512_xor_si512(_mm512_loadu_si512(&input[i]), rk);
+	}
+
+	/* the round key is broadcast across both blocks, and shared by every register in flight */
+	while (kctr < RNDCNT)
+	{
+		++kctr;
+		rk = _mm512_loadu_si512(&ctx->roundkeysw[kctr]);
+
+		for (i = 0; i < wblocks; ++i)
+		{
+			x[i] = _mm512_aesenc_epi128(rcs_shuffle512(x[i], SHFMSK0, SHFMSK1), rk);
+		}
+	}
+
+	++kctr;
+	rk = _mm512_loadu_si512(&ctx->roundkeysw[kctr]);
+
+	for (i = 0; i < wblocks; ++i)
+	{
+		_mm512_storeu_si512(&output[i], _mm512_aesenclast_epi128(rcs_shuffle512(x[i], SHFMSK0, SHFMSK1), rk));
+	}
+}
+
+RCS_TARGET_VAES512
+static void rcs_transform_512(const qsc_rcs_state* ctx, __m512i* output, const __m512i* input)
+{
+	rcs_transform_512xn(ctx, output, input, 1);
+}
+
+RCS_TARGET_VAES512
+static void rcs_transform_512x4(const qsc_rcs_state* ctx, __m512i output[4], const __m512i input[4])
+{
+	rcs_transform_512xn(ctx, output, input, 4);
+}
+
+RCS_TARGET_VAES512
+static void rcs_load_inverse_keys512(qsc_rcs_sector_key* key)
+{
+	__m512i rk;
+
+	/* the inverse keys of the 128-bit path, broadcast to the lanes of both blocks */
+	rcs_load_inverse_keys(key);
+	qsc_memutils_clear((uint8_t*)key->invkeysw, sizeof(key->invkeysw));
+
+	for (size_t i = 0; i < key->state.roundkeylen; i += 2)
+	{
+		rk = _mm512_setzero_si512();
+		rk = _mm512_inserti32x4(rk, key->invkeys[i], 0);
+		rk = _mm512_inserti32x4(rk, key->invkeys[i + 1], 1);
+		rk = _mm512_inserti32x4(rk, key->invkeys[i], 2);
+		rk = _mm512_inserti32x4(rk, key->invkeys[i + 1], 3);
+		_mm512_storeu_si512(&key->invkeysw[i / 2], rk);
+	}
+}
+
+RCS_TARGET_VAES512
+inline static void rcs_inverse_512xn(const qsc_rcs_sector_key* key, __m512i* output, const __m512i* input, size_t wblocks)
+{
+	const __m512i NI512K0 = _mm512_set_epi64(17361641481138401520ULL, 17361641481138401520ULL, 8102099357864587376ULL, 8102099357864587376ULL,
+		17361641481138401520ULL, 17361641481138401520ULL, 8102099357864587376ULL, 8102099357864587376ULL);
+	const __m512i NI512K1 = _mm512_set_epi64(8102099357864587376ULL, 8102099357864587376ULL, 17361641481138401520ULL, 17361641481138401520ULL,
+		8102099357864587376ULL, 8102099357864587376ULL, 17361641481138401520ULL, 17361641481138401520ULL);
+	/* the blend and shuffle of the 128-bit inverse path, expressed as a 32-byte permutation of each block */
+	const __m512i SWMASKL = _mm512_broadcast_i64x4(_mm256_set_epi8(8, 9, 6, 23, 12, 13, 26, 27, 0, 17, 30, 31, 4, 5, 18, 19,
+		24, 25, 22, 7, 28, 29, 10, 11, 16, 1, 14, 15, 20, 21, 2, 3));
+	const __m512i SHFMSK0 = _mm512_add_epi8(SWMASKL, NI512K0);
+	const __m512i SHFMSK1 = _mm512_add_epi8(SWMASKL, NI512K1);
+	const size_t RNDCNT = (key->state.roundkeylen / 2) - 2;
+	__m512i x[4];
+	__m512i rk;
+	size_t i;
+	size_t kctr;
+
+	assert(wblocks <= 4);
+
+	kctr = 0;
+	rk = _mm512_loadu_si512(&key->invkeysw[kctr]);
+
+	for (i = 0; i < wblocks; ++i)
+	{
+		x[i] = _mm512_xor_si512(_mm512_loadu_si512(&input[i]), rk);
+	}
+
+	while (kctr < RNDCNT)
+	{
+		++kctr;
+		rk = _mm512_loadu_si512(&key->invkeysw[kctr]);
+
+		for (i = 0; i < wblocks; ++i)
+		{
+			x[i] = _mm512_aesdec_epi128(rcs_shuffle512(x[i], SHFMSK0, SHFMSK1), rk);
+		}
+	}
+
+	++kctr;
+	rk = _mm512_loadu_si512(&key->invkeysw[kctr]);
+
+	for (i = 0; i < wblocks; ++i)
+	{
+		_mm512_storeu_si512(&output[i], _mm512_aesdeclast_epi128(rcs_shuffle512(x[i], SHFMSK0, SHFMSK1), rk));
+	}
+}
+
+RCS_TARGET_VAES512
+static void rcs_ecb_transform_vaes512(const qsc_rcs_sector_key* key, uint8_t* blocks, size_t nblocks, bool encrypt)
+{
+	assert(key != NULL);
+	assert(blocks != NULL);
+	assert(nblocks <= RCS_SECTOR_BATCH);
+
+	const size_t WBLKS = nblocks / 2;
+	__m512i x[4];
+	size_t i;
+
+	/* two blocks per register, up to eight blocks in flight */
+	if (WBLKS != 0)
+	{
+		for (i = 0; i < WBLKS; ++i)
+		{
+			x[i] = _mm512_loadu_si512((const __m512i*)(blocks + (i * RCS_AVX512_BLOCK)));
+		}
+
+		if (encrypt == true)
+		{
+			rcs_transform_512xn(&key->state, x, x, WBLKS);
+		}
+		else
+		{
+			rcs_inverse_512xn(key, x, x, WBLKS);
+		}
+
+		for (i = 0; i < WBLKS; ++i)
+		{
+			_mm512_storeu_si512((__m512i*)(blocks + (i * RCS_AVX512_BLOCK)), x[i]);
+		}
+	}
+
+	/* an odd last block is loaded and stored with a mask */
+	if ((nblocks & 1) != 0)
+	{
+		uint8_t* pblk = blocks + (WBLKS * RCS_AVX512_BLOCK);
+
+		x[0] = _mm512_maskz_loadu_epi8(0x00000000FFFFFFFFULL, pblk);
+
+		if (encrypt == true)
+		{
+			rcs_transform_512xn(&key->state, x, x, 1);
+		}
+		else
+		{
+			rcs_inverse_512xn(key, x, x, 1);
+		}
+
+		_mm512_mask_storeu_epi8(pblk, 0x00000000FFFFFFFFULL, x[0]);
+	}
+}
+
+RCS_TARGET_VAES512
+static __m512i rcs_ctr_add512(__m512i counter, __m512i value)
+{
+	const __m512i ONE = _mm512_set1_epi64(1);
+	const __m512i ZERO = _mm512_setzero_si512();
+	__m512i res;
+	__mmask8 carry;
+
+	/* the value is added to the low 64-bit word of each 256-bit counter */
+	res = _mm512_add_epi64(counter, value);
+	carry = _mm512_mask_cmplt_epu64_mask(0x11, res, value);
+
+	/* propagate the carry through the upper words of each counter, as the sequential path does */
+	while (carry != 0)
+	{
+		carry = (__mmask8)((carry << 1) & 0xEE);
+		res = _mm512_mask_add_epi64(res, carry, res, ONE);
+		carry = _mm512_mask_cmpeq_epu64_mask((__mmask8)(carry & 0x66), res, ZERO);
+	}
+
+	return res;
+}
+
+#endif
+
+#if defined(QSC_RCS_VAES256_ENABLED)
+
+RCS_TARGET_VAES256
+static void rcs_load_roundkeys256(qsc_rcs_state* ctx)
+{
+	/* the even and odd keys are stored in the low and high lanes */
+	qsc_memutils_clear((uint8_t*)ctx->roundkeysy, sizeof(ctx->roundkeysy));
+
+	for (size_t i = 0; i < ctx->roundkeylen; i += 2)
+	{
+		_mm256_storeu_si256(&ctx->roundkeysy[i / 2], _mm256_inserti128_si256(_mm256_castsi128_si256(ctx->roundkeys[i]), ctx->roundkeys[i + 1], 1));
+	}
+}
+
+RCS_TARGET_VAES256
+inline static __m256i rcs_shuffle256(__m256i value, __m256i mask0, __m256i mask1)
+{
+	/* bytes from the same lane are selected by mask0, bytes from the opposite lane by mask1 */
+	return _mm256_or_si256(_mm256_shuffle_epi8(value, mask0),
+		_mm256_shuffle_epi8(_mm256_permute4x64_epi64(value, 0x4E), mask1));
+}
+
+RCS_TARGET_VAES256
+static void rcs_transform_256y(const qsc_rcs_state* ctx, __m256i* output, const __m256i* input)
+{
+	/* the blend and shuffle of the 128-bit path, expressed as a 32-byte permutation of the block */
+	const __m256i SWMASK = _mm256_set_epi8(16, 1, 6, 7, 20, 21, 10, 11, 24, 25, 30, 15, 28, 29, 2, 3,
+		0, 17, 22, 23, 4, 5, 26, 27, 8, 9, 14, 31, 12, 13, 18, 19);
+	const __m256i SHFMSK0 = _mm256_add_epi8(SWMASK, _mm256_set_epi64x(0xF0F0F0F0F0F0F0F0LL, 0xF0F0F0F0F0F0F0F0LL, 0x7070707070707070LL, 0x7070707070707070LL));
+	const __m256i SHFMSK1 = _mm256_add_epi8(SWMASK, _mm256_set_epi64x(0x7070707070707070LL, 0x7070707070707070LL, 0xF0F0F0F0F0F0F0F0LL, 0xF0F0F0F0F0F0F0F0LL));
+	const size_t RNDCNT = (ctx->roundkeylen / 2) - 2;
+	__m256i blk;
+	size_t kctr;
+
+	kctr = 0;
+	blk = _mm256_xor_si256(_mm256_loadu_si256(input), _mm256_loadu_si256(&ctx->roundkeysy[kctr]));
+
+	while (kctr < RNDCNT)
+	{
+		++kctr;
+		blk = _mm256_aesenc_epi128(rcs_shuffle256(blk, SHFMSK0, SHFMSK1), _mm256_loadu_si256(&ctx->roundkeysy[kctr]));
+	}
+
+	++kctr;
+	_mm256_storeu_si256(output, _mm256_aesenclast_epi128(rcs_shuffle256(blk, SHFMSK0, SHFMSK1), _mm256_loadu_si256(&ctx->roundkeysy[kctr])));
+}
+
+RCS_TARGET_VAES256
+static void rcs_transform_256yx4(const qsc_rcs_state* ctx, __m256i output[4], const __m256i input[4])
+{
+	const __m256i SWMASK = _mm256_set_epi8(16, 1, 6, 7, 20, 21, 10, 11, 24, 25, 30, 15, 28, 29, 2, 3,
+		0, 17, 22, 23, 4, 5, 26, 27, 8, 9, 14, 31, 12, 13, 18, 19);
+	const __m256i SHFMSK0 = _mm256_add_epi8(SWMASK, _mm256_set_epi64x(0xF0F0F0F0F0F0F0F0LL, 0xF0F0F0F0F0F0F0F0LL, 0x7070707070707070LL, 0x7070707070707070LL));
+	const __m256i SHFMSK1 = _mm256_add_epi8(SWMASK, _mm256_set_epi64x(0x7070707070707070LL, 0x7070707070707070LL, 0xF0F0F0F0F0F0F0F0LL, 0xF0F0F0F0F0F0F0F0LL));
+	const size_t RNDCNT = (ctx->roundkeylen / 2) - 2;
+	__m256i blk0;
+	__m256i blk1;
+	__m256i blk2;
+	__m256i blk3;
+	__m256i rk;
+	size_t kctr;
+
+	kctr = 0;
+	rk = _mm256_loadu_si256(&ctx->roundkeysy[kctr]);
+	blk0 = _mm256_xor_si256(_mm256_loadu_si256(&input[0]), rk);
+	blk1 = _mm256_xor_si256(_mm256_loadu_si256(&input[1]), rk);
+	blk2 = _mm256_xor_si256(_mm256_loadu_si256(&input[2]), rk);
+	blk3 = _mm256_xor_si256(_mm256_loadu_si256(&input[3]), rk);
+
+	/* one block per register, the round key is shared by the four blocks in flight */
+	while (kctr < RNDCNT)
+	{
+		++kctr;
+		rk = _mm256_loadu_si256(&ctx->roundkeysy[kctr]);
+		blk0 = _mm256_aesenc_epi128(rcs_shuffle256(blk0, SHFMSK0, SHFMSK1), rk);
+		blk1 = _mm256_aesenc_epi128(rcs_shuffle256(blk1, SHFMSK0, SHFMSK1), rk);
+		blk2 = _mm256_aesenc_epi128(rcs_shuffle256(blk2, SHFMSK0, SHFMSK1), rk);
+		blk3 = _mm256_aesenc_epi128(rcs_shuffle256(blk3, SHFMSK0, SHFMSK1), rk);
+	}
+
+	++kctr;
+	rk = _mm256_loadu_si256(&ctx->roundkeysy[kctr]);
+	_mm256_storeu_si256(&output[0], _mm256_aesenclast_epi128(rcs_shuffle256(blk0, SHFMSK0, SHFMSK1), rk));
+	_mm256_storeu_si256(&output[1], _mm256_aesenclast_epi128(rcs_shuffle256(blk1, SHFMSK0, SHFMSK1), rk));
+	_mm256_storeu_si256(&output[2], _mm256_aesenclast_epi128(rcs_shuffle256(blk2, SHFMSK0, SHFMSK1), rk));
+	_mm256_storeu_si256(&output[3], _mm256_aesenclast_epi128(rcs_shuffle256(blk3, SHFMSK0, SHFMSK1), rk));
+}
+
+#endif
+
+#if defined(RCS_AESNI128_ENABLED)
+
+RCS_TARGET_AESNI
+static void rcs_ctr_transform_aesni(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
+{
+	assert(ctx != NULL);
+	assert(input != NULL);
+	assert(output != NULL);
+
+	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
+	size_t i;
+	size_t oft;
+
+	oft = 0;
+
+	/* process 8 blocks in parallel */
+	while (length >= RCS_PARALLEL8_BLOCK)
+	{
+		__m128i tmpn[16];
+		__m128i tmpo[16];
+
+		rcs_ctr_generate(counter, tmpn, 8);
+		rcs_transform_256x8(ctx, tmpo, tmpn);
+		rcs_ctr_xorn(output + oft, input + oft, tmpo, 16);
+
+		length -= RCS_PARALLEL8_BLOCK;
+		oft += RCS_PARALLEL8_BLOCK;
+	}
+
+	/* process 4 blocks in parallel */
+	if (length >= RCS_PARALLEL4_BLOCK)
+	{
+		__m128i tmpn[8];
+		__m128i tmpo[8];
+
+		rcs_ctr_generate(counter, tmpn, 4);
+		rcs_transform_256x4(ctx, tmpo, tmpn);
+		rcs_ctr_xorn(output + oft, input + oft, tmpo, 8);
+
+		length -= RCS_PARALLEL4_BLOCK;
+		oft += RCS_PARALLEL4_BLOCK;
+	}
+
+	while (length >= QSC_RCS_BLOCK_SIZE)
+	{
+		__m128i tmpn[2] = { _mm_loadu_si128((const __m128i*)counter), _mm_loadu_si128((const __m128i*)(counter + HLFBLK)) };
+		__m128i tmpo[2] = { 0 };
+
+		rcs_transform_256(ctx, tmpo, tmpn);
+
+		__m128i tmpi[2] = { _mm_loadu_si128((const __m128i*)((uint8_t*)input + oft)) , _mm_loadu_si128((const __m128i*)((uint8_t*)input + HLFBLK + oft)) };
+
+		tmpo[0] = _mm_xor_si128(tmpo[0], tmpi[0]);
+		tmpo[1] = _mm_xor_si128(tmpo[1], tmpi[1]);
+
+		qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+
+		/* store in output */
+		_mm_storeu_si128((__m128i*)((uint8_t*)output + oft), tmpo[0]);
+		_mm_storeu_si128((__m128i*)((uint8_t*)output + HLFBLK + oft), tmpo[1]);
+
+		length -= QSC_RCS_BLOCK_SIZE;
+		oft += QSC_RCS_BLOCK_SIZE;
+	}
+
+	if (length != 0)
+	{
+		__m128i tmpn[2] = { _mm_loadu_si128((const __m128i*)counter), _mm_loadu_si128((const __m128i*)(counter + HLFBLK)) };
+		__m128i tmpo[2] = { 0 };
+		uint8_t tmpb[QSC_RCS_BLOCK_SIZE] = { 0 };
+
+		rcs_transform_256(ctx, tmpo, tmpn);
+
+		/* store in tmp */
+		_mm_storeu_si128((__m128i*)tmpb, tmpo[0]);
+		_mm_storeu_si128((__m128i*)((uint8_t*)tmpb + HLFBLK), tmpo[1]);
+
+		for (i = 0; i < length; ++i)
+		{
+			output[oft + i] = tmpb[i] ^ input[oft + i];
+		}
+
+		qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+	}
+}
+
+#endif
+
+#if defined(QSC_RCS_VAES256_ENABLED)
+
+RCS_TARGET_VAES256
+static void rcs_ctr_transform_vaes256(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
+{
+	assert(ctx != NULL);
+	assert(input != NULL);
+	assert(output != NULL);
+
+	size_t i;
+	size_t oft;
+
+	oft = 0;
+
+	/* process 4 blocks in parallel, one block per 256-bit register */
+	while (length >= RCS_AVX2X4_BLOCK)
+	{
+		__m256i ctry[4];
+		__m256i otpy[4];
+
+		for (i = 0; i < 4; ++i)
+		{
+			ctry[i] = _mm256_loadu_si256((const __m256i*)counter);
+			qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+		}
+
+		rcs_transform_256yx4(ctx, otpy, ctry);
+
+		for (i = 0; i < 4; ++i)
+		{
+			otpy[i] = _mm256_xor_si256(otpy[i], _mm256_loadu_si256((const __m256i*)(input + oft + (i * QSC_RCS_BLOCK_SIZE))));
+			_mm256_storeu_si256((__m256i*)(output + oft + (i * QSC_RCS_BLOCK_SIZE)), otpy[i]);
+		}
+
+		length -= RCS_AVX2X4_BLOCK;
+		oft += RCS_AVX2X4_BLOCK;
+	}
+
+	while (length >= QSC_RCS_BLOCK_SIZE)
+	{
+		__m256i ctry = _mm256_loadu_si256((const __m256i*)counter);
+		__m256i otpy;
+
+		rcs_transform_256y(ctx, &otpy, &ctry);
+		otpy = _mm256_xor_si256(otpy, _mm256_loadu_si256((const __m256i*)(input + oft)));
+		_mm256_storeu_si256((__m256i*)(output + oft), otpy);
+		qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+
+		length -= QSC_RCS_BLOCK_SIZE;
+		oft += QSC_RCS_BLOCK_SIZE;
+	}
+
+	/* the partial block is processed by the 128-bit path */
+	if (length != 0)
+	{
+		rcs_ctr_transform_aesni(ctx, counter, output + oft, input + oft, length);
+	}
+}
+
+#endif
+
+#if defined(QSC_RCS_VAES512_ENABLED)
+
+RCS_TARGET_VAES512
+static void rcs_ctr_transform_vaes512(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
+{
+	assert(ctx != NULL);
+	assert(input != NULL);
+	assert(output != NULL);
+
+	size_t i;
+	size_t oft;
+
+	oft = 0;
+
+	if (length != 0)
+	{
+		const __m512i CTRINC2 = _mm512_set_epi64(0, 0, 0, 2, 0, 0, 0, 2);
+		__m512i ctrw[4];
+		__m512i otpw[4];
+
+		/* initialize and pre-set the nonce, the upper block is one counter ahead */
+		ctrw[0] = _mm512_broadcast_i64x4(_mm256_loadu_si256((const __m256i*)counter));
+		ctrw[0] = rcs_ctr_add512(ctrw[0], _mm512_set_epi64(0, 0, 0, 1, 0, 0, 0, 0));
+
+		/* process 8 blocks in parallel */
+		while (length >= RCS_AVX512X4_BLOCK)
+		{
+			ctrw[1] = rcs_ctr_add512(ctrw[0], CTRINC2);
+			ctrw[2] = rcs_ctr_add512(ctrw[1], CTRINC2);
+			ctrw[3] = rcs_ctr_add512(ctrw[2], CTRINC2);
+
+			/* encrypt the nonces */
+			rcs_transform_512x4(ctx, otpw, ctrw);
+
+			for (i = 0; i < 4; ++i)
+			{
+				/* xor the encrypted nonce with the input and store in output */
+				otpw[i] = _mm512_xor_si512(otpw[i], _mm512_loadu_si512((const __m512i*)(input + oft + (i * RCS_AVX512_BLOCK))));
+				_mm512_storeu_si512((__m512i*)(output + oft + (i * RCS_AVX512_BLOCK)), otpw[i]);
+			}
+
+			ctrw[0] = rcs_ctr_add512(ctrw[3], CTRINC2);
+			oft += RCS_AVX512X4_BLOCK;
+			length -= RCS_AVX512X4_BLOCK;
+		}
+
+		/* process the remaining blocks 2 at a time, using masked loads and stores for a partial block */
+		while (length != 0)
+		{
+			const size_t BLKLEN = qsc_intutils_min(length, RCS_AVX512_BLOCK);
+			const __mmask64 LDMASK = (BLKLEN == RCS_AVX512_BLOCK) ? ~(__mmask64)0 : (((__mmask64)1 << BLKLEN) - 1);
+
+			rcs_transform_512(ctx, &otpw[0], &ctrw[0]);
+			otpw[0] = _mm512_xor_si512(otpw[0], _mm512_maskz_loadu_epi8(LDMASK, input + oft));
+			_mm512_mask_storeu_epi8(output + oft, LDMASK, otpw[0]);
+
+			/* a partial block consumes a counter, as in the sequential path */
+			ctrw[0] = rcs_ctr_add512(ctrw[0], (BLKLEN > QSC_RCS_BLOCK_SIZE) ? CTRINC2 : _mm512_set_epi64(0, 0, 0, 1, 0, 0, 0, 1));
+			oft += BLKLEN;
+			length -= BLKLEN;
+		}
+
+		/* store the last position of the nonce */
+		_mm256_storeu_si256((__m256i*)counter, _mm512_castsi512_si256(ctrw[0]));
+	}
+}
+
+#endif
+
+/* vector-permute functions */
+
+#if defined(QSC_RCS_VPERM_ENABLED)
+
+/*
+* The vector-permute kernels evaluate the s-box with pshufb nibble lookups, after Hamburg.
+* The input transform maps a byte into the tower field GF((2^4)^2), where it is inverted with lookups
+* of GF(2^4) inverses; the output tables map the inverse back and return S(x)^0x63 and 2(S(x)^0x63).
+* The affine constant passes through MixColumns unchanged, so it is added to the round-keys instead,
+* and the RCS permutation and the AES ShiftRows are folded into the MixColumns shuffle masks.
+* Every lookup is a register shuffle, so there are no secret-dependent memory accesses.
+*/
+
+static const uint8_t rcs_vperm_ipt_lo[16] =
+{
+	0x00, 0x01, 0x9F, 0x9E, 0x1B, 0x1A, 0x84, 0x85, 0x11, 0x10, 0x8E, 0x8F, 0x0A, 0x0B, 0x95, 0x94
+};
+
+static const uint8_t rcs_vperm_ipt_hi[16] =
+{
+	0x00, 0x4D, 0xEF, 0xA2, 0x45, 0x08, 0xAA, 0xE7, 0xAE, 0xE3, 0x41, 0x0C, 0xEB, 0xA6, 0x04, 0x49
+};
+
+/* the GF(2^4) inverse, and a constant over the inverse; 1/0 is 0x80, which a shuffle returns as zero */
+static const uint8_t rcs_vperm_inv[16] =
+{
+	0x80, 0x01, 0x09, 0x0E, 0x0D, 0x0B, 0x07, 0x06, 0x0F, 0x02, 0x0C, 0x05, 0x0A, 0x04, 0x03, 0x08
+};
+
+static const uint8_t rcs_vperm_inva[16] =
+{
+	0x80, 0x04, 0x02, 0x0D, 0x01, 0x0A, 0x0F, 0x0B, 0x09, 0x08, 0x05, 0x07, 0x0E, 0x03, 0x0C, 0x06
+};
+
+static const uint8_t rcs_vperm_sbo_lo[16] =
+{
+	0x00, 0xB1, 0xC0, 0xC8, 0xF1, 0x48, 0x08, 0xB9, 0x79, 0x88, 0x40, 0x80, 0xF9, 0x31, 0x39, 0x71
+};
+
+static const uint8_t rcs_vperm_sbo_hi[16] =
+{
+	0x00, 0xD3, 0xDD, 0x47, 0xA0, 0xE9, 0x9A, 0x49, 0x94, 0x34, 0x73, 0xAE, 0x3A, 0x7D, 0xE7, 0x0E
+};
+
+static const uint8_t rcs_vperm_sb2_lo[16] =
+{
+	0x00, 0x79, 0x9B, 0x8B, 0xF9, 0x90, 0x10, 0x69, 0xF2, 0x0B, 0x80, 0x1B, 0xE9, 0x62, 0x72, 0xE2
+};
+
+static const uint8_t rcs_vperm_sb2_hi[16] =
+{
+	0x00, 0xBD, 0xA1, 0x8E, 0x5B, 0xC9, 0x2F, 0x92, 0x33, 0x68, 0xE6, 0x47, 0x74, 0xFA, 0xD5, 0x1C
+};
+
+/* the bytes of each half-block taken from the other half, as in the AES-NI blend mask */
+static const uint8_t rcs_vperm_blend[16] =
+{
+	0x00, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0xFF
+};
+
+/* the RCS shuffle and ShiftRows, followed by a rotation of each column by 0, 1, 2 and 3 rows */
+static const uint8_t rcs_vperm_mix[4][16] =
+{
+	{ 0x03, 0x0E, 0x05, 0x00, 0x0F, 0x0A, 0x01, 0x0C, 0x0B, 0x06, 0x0D, 0x08, 0x07, 0x02, 0x09, 0x04 },
+	{ 0x0E, 0x05, 0x00, 0x03, 0x0A, 0x01, 0x0C, 0x0F, 0x06, 0x0D, 0x08, 0x0B, 0x02, 0x09, 0x04, 0x07 },
+	{ 0x05, 0x00, 0x03, 0x0E, 0x01, 0x0C, 0x0F, 0x0A, 0x0D, 0x08, 0x0B, 0x06, 0x09, 0x04, 0x07, 0x02 },
+	{ 0x00, 0x03, 0x0E, 0x05, 0x0C, 0x0F, 0x0A, 0x01, 0x08, 0x0B, 0x06, 0x0D, 0x04, 0x07, 0x02, 0x09 }
+};
+
+static void rcs_load_roundkeys_vperm(qsc_rcs_state* ctx)
+{
+	/* the round-keys are stored as whole blocks; every key after the first absorbs the s-box constant */
+	const size_t KEYLEN = (ctx->rounds + 1) * QSC_RCS_BLOCK_SIZE;
+	uint8_t* pkey = (uint8_t*)ctx->roundkeysy;
+
+	qsc_memutils_clear((uint8_t*)ctx->roundkeysy, sizeof(ctx->roundkeysy));
+	qsc_memutils_copy(pkey, (const uint8_t*)ctx->roundkeys, KEYLEN);
+
+	for (size_t i = QSC_RCS_BLOCK_SIZE; i < KEYLEN; ++i)
+	{
+		pkey[i] ^= 0x63U;
+	}
+}
+
+RCS_TARGET_VPERM128
+static __m128i rcs_vperm_load128(const uint8_t* table)
+{
+	return _mm_loadu_si128((const __m128i*)table);
+}
+
+RCS_TARGET_VPERM128
+static __m128i rcs_vperm_sbox128(__m128i x, __m128i* x2)
+{
+	const __m128i NMASK = _mm_set1_epi8(0x0F);
+	const __m128i INV = rcs_vperm_load128(rcs_vperm_inv);
+	__m128i ak;
+	__m128i i;
+	__m128i iak;
+	__m128i io;
+	__m128i j;
+	__m128i jak;
+	__m128i jo;
+	__m128i k;
+
+	/* map to the tower field */
+	k = _mm_and_si128(x, NMASK);
+	i = _mm_and_si128(_mm_srli_epi16(x, 4), NMASK);
+	x = _mm_xor_si128(_mm_shuffle_epi8(rcs_vperm_load128(rcs_vperm_ipt_lo), k), _mm_shuffle_epi8(rcs_vperm_load128(rcs_vperm_ipt_hi), i));
+
+	/* invert */
+	k = _mm_and_si128(x, NMASK);
+	i = _mm_and_si128(_mm_srli_epi16(x, 4), NMASK);
+	j = _mm_xor_si128(i, k);
+	ak = _mm_shuffle_epi8(rcs_vperm_load128(rcs_vperm_inva), k);
+	iak = _mm_xor_si128(_mm_shuffle_epi8(INV, i), ak);
+	jak = _mm_xor_si128(_mm_shuffle_epi8(INV, j), ak);
+	io = _mm_xor_si128(_mm_shuffle_epi8(INV, iak), j);
+	jo = _mm_xor_si128(_mm_shuffle_epi8(INV, jak), i);
+
+	/* map back through the affine transform */
+	*x2 = _mm_xor_si128(_mm_shuffle_epi8(rcs_vperm_load128(rcs_vperm_sb2_lo), io), _mm_shuffle_epi8(rcs_vperm_load128(rcs_vperm_sb2_hi), jo));
+
+	return _mm_xor_si128(_mm_shuffle_epi8(rcs_vperm_load128(rcs_vperm_sbo_lo), io), _mm_shuffle_epi8(rcs_vperm_load128(rcs_vperm_sbo_hi), jo));
+}
+
+RCS_TARGET_VPERM128
+static __m128i rcs_vperm_mix128(__m128i x, __m128i x2, __m128i rkey)
+{
+	const __m128i X3 = _mm_xor_si128(x, x2);
+
+	x2 = _mm_xor_si128(_mm_shuffle_epi8(x2, rcs_vperm_load128(rcs_vperm_mix[0])), _mm_shuffle_epi8(X3, rcs_vperm_load128(rcs_vperm_mix[1])));
+	x = _mm_xor_si128(_mm_shuffle_epi8(x, rcs_vperm_load128(rcs_vperm_mix[2])), _mm_shuffle_epi8(x, rcs_vperm_load128(rcs_vperm_mix[3])));
+
+	return _mm_xor_si128(_mm_xor_si128(x, x2), rkey);
+}
+
+RCS_TARGET_VPERM128
+static void rcs_transform_256v(const qsc_rcs_state* ctx, __m128i output[4], const __m128i input[4])
+{
+	/* transforms two blocks, each held in two 128-bit registers */
+	const __m128i* pkey = (const __m128i*)ctx->roundkeysy;
+	const __m128i BMASK = rcs_vperm_load128(rcs_vperm_blend);
+	__m128i blk[4];
+	__m128i tmp[4];
+	size_t i;
+	size_t r;
+
+	for (i = 0; i < 4; ++i)
+	{
+		blk[i] = _mm_xor_si128(_mm_loadu_si128(&input[i]), _mm_loadu_si128(&pkey[i & 1]));
+	}
+
+	for (r = 1; r <= ctx->rounds; ++r)
+	{
+		const __m128i RK0 = _mm_loadu_si128(&pkey[r * 2]);
+		const __m128i RK1 = _mm_loadu_si128(&pkey[(r * 2) + 1]);
+
+		for (i = 0; i < 4; i += 2)
+		{
+			/* exchange the blended bytes between the block halves */
+			tmp[i] = _mm_or_si128(_mm_andnot_si128(BMASK, blk[i]), _mm_and_si128(BMASK, blk[i + 1]));
+			tmp[i + 1] = _mm_or_si128(_mm_andnot_si128(BMASK, blk[i + 1]), _mm_and_si128(BMASK, blk[i]));
+		}
+
+		if (r != ctx->rounds)
+		{
+			for (i = 0; i < 4; ++i)
+			{
+				__m128i x2;
+
+				blk[i] = rcs_vperm_sbox128(tmp[i], &x2);
+				blk[i] = rcs_vperm_mix128(blk[i], x2, (i & 1) == 0 ? RK0 : RK1);
+			}
+		}
+		else
+		{
+			for (i = 0; i < 4; ++i)
+			{
+				__m128i x2;
+
+				blk[i] = rcs_vperm_sbox128(tmp[i], &x2);
+				blk[i] = _mm_xor_si128(_mm_shuffle_epi8(blk[i], rcs_vperm_load128(rcs_vperm_mix[0])), (i & 1) == 0 ? RK0 : RK1);
+			}
+		}
+	}
+
+	for (i = 0; i < 4; ++i)
+	{
+		_mm_storeu_si128(&output[i], blk[i]);
+	}
+}
+
+RCS_TARGET_VPERM128
+static void rcs_ctr_transform_vperm128(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
+{
+	assert(ctx != NULL);
+	assert(input != NULL);
+	assert(output != NULL);
+
+	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
+	__m128i ctrx[4];
+	__m128i otpx[4];
+	size_t i;
+	size_t oft;
+
+	oft = 0;
+
+	while (length != 0)
+	{
+		const size_t BLKLEN = (length >= RCS_VPERM128_BLOCK) ? RCS_VPERM128_BLOCK : length;
+
+		/* only the counters of the blocks that are used are consumed */
+		for (i = 0; i < 4; i += 2)
+		{
+			ctrx[i] = _mm_loadu_si128((const __m128i*)counter);
+			ctrx[i + 1] = _mm_loadu_si128((const __m128i*)(counter + HLFBLK));
+
+			if ((i * HLFBLK) < BLKLEN)
+			{
+				qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+			}
+		}
+
+		rcs_transform_256v(ctx, otpx, ctrx);
+
+		if (BLKLEN == RCS_VPERM128_BLOCK)
+		{
+			for (i = 0; i < 4; ++i)
+			{
+				otpx[i] = _mm_xor_si128(otpx[i], _mm_loadu_si128((const __m128i*)(input + oft + (i * HLFBLK))));
+				_mm_storeu_si128((__m128i*)(output + oft + (i * HLFBLK)), otpx[i]);
+			}
+		}
+		else
+		{
+			uint8_t tmpb[RCS_VPERM128_BLOCK] = { 0 };
+
+			for (i = 0; i < 4; ++i)
+			{
+				_mm_storeu_si128((__m128i*)(tmpb + (i * HLFBLK)), otpx[i]);
+			}
+
+			for (i = 0; i < BLKLEN; ++i)
+			{
+				output[oft + i] = tmpb[i] ^ input[oft + i];
+			}
+
+			qsc_memutils_clear(tmpb, sizeof(tmpb));
+		}
+
+		length -= BLKLEN;
+		oft += BLKLEN;
+	}
+}
+
+RCS_TARGET_VPERM256
+static __m256i rcs_vperm_load256(const uint8_t* table)
+{
+	return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)table));
+}
+
+RCS_TARGET_VPERM256
+static __m256i rcs_vperm_sbox256(__m256i x, __m256i* x2)
+{
+	const __m256i NMASK = _mm256_set1_epi8(0x0F);
+	const __m256i INV = rcs_vperm_load256(rcs_vperm_inv);
+	__m256i ak;
+	__m256i i;
+	__m256i iak;
+	__m256i io;
+	__m256i j;
+	__m256i jak;
+	__m256i jo;
+	__m256i k;
+
+	/* map to the tower field */
+	k = _mm256_and_si256(x, NMASK);
+	i = _mm256_and_si256(_mm256_srli_epi16(x, 4), NMASK);
+	x = _mm256_xor_si256(_mm256_shuffle_epi8(rcs_vperm_load256(rcs_vperm_ipt_lo), k), _mm256_shuffle_epi8(rcs_vperm_load256(rcs_vperm_ipt_hi), i));
+
+	/* invert */
+	k = _mm256_and_si256(x, NMASK);
+	i = _mm256_and_si256(_mm256_srli_epi16(x, 4), NMASK);
+	j = _mm256_xor_si256(i, k);
+	ak = _mm256_shuffle_epi8(rcs_vperm_load256(rcs_vperm_inva), k);
+	iak = _mm256_xor_si256(_mm256_shuffle_epi8(INV, i), ak);
+	jak = _mm256_xor_si256(_mm256_shuffle_epi8(INV, j), ak);
+	io = _mm256_xor_si256(_mm256_shuffle_epi8(INV, iak), j);
+	jo = _mm256_xor_si256(_mm256_shuffle_epi8(INV, jak), i);
+
+	/* map back through the affine transform */
+	*x2 = _mm256_xor_si256(_mm256_shuffle_epi8(rcs_vperm_load256(rcs_vperm_sb2_lo), io), _mm256_shuffle_epi8(rcs_vperm_load256(rcs_vperm_sb2_hi), jo));
+
+	return _mm256_xor_si256(_mm256_shuffle_epi8(rcs_vperm_load256(rcs_vperm_sbo_lo), io), _mm256_shuffle_epi8(rcs_vperm_load256(rcs_vperm_sbo_hi), jo));
+}
+
+RCS_TARGET_VPERM256
+static __m256i rcs_vperm_mix256(__m256i x, __m256i x2, __m256i rkey)
+{
+	const __m256i X3 = _mm256_xor_si256(x, x2);
+
+	x2 = _mm256_xor_si256(_mm256_shuffle_epi8(x2, rcs_vperm_load256(rcs_vperm_mix[0])), _mm256_shuffle_epi8(X3, rcs_vperm_load256(rcs_vperm_mix[1])));
+	x = _mm256_xor_si256(_mm256_shuffle_epi8(x, rcs_vperm_load256(rcs_vperm_mix[2])), _mm256_shuffle_epi8(x, rcs_vperm_load256(rcs_vperm_mix[3])));
+
+	return _mm256_xor_si256(_mm256_xor_si256(x, x2), rkey);
+}
+
+RCS_TARGET_VPERM256
+static void rcs_transform_256vy(const qsc_rcs_state* ctx, __m256i output[4], const __m256i input[4])
+{
+	/* transforms four blocks, one block per 256-bit register */
+	const __m256i BMASK = rcs_vperm_load256(rcs_vperm_blend);
+	__m256i blk[4];
+	size_t i;
+	size_t r;
+
+	for (i = 0; i < 4; ++i)
+	{
+		blk[i] = _mm256_xor_si256(_mm256_loadu_si256(&input[i]), _mm256_loadu_si256(&ctx->roundkeysy[0]));
+	}
+
+	for (r = 1; r <= ctx->rounds; ++r)
+	{
+		const __m256i RKEY = _mm256_loadu_si256(&ctx->roundkeysy[r]);
+
+		for (i = 0; i < 4; ++i)
+		{
+			__m256i x2;
+
+			/* exchange the blended bytes between the block halves */
+			blk[i] = _mm256_blendv_epi8(blk[i], _mm256_permute4x64_epi64(blk[i], 0x4E), BMASK);
+			blk[i] = rcs_vperm_sbox256(blk[i], &x2);
+			blk[i] = (r != ctx->rounds) ? rcs_vperm_mix256(blk[i], x2, RKEY) :
+				_mm256_xor_si256(_mm256_shuffle_epi8(blk[i], rcs_vperm_load256(rcs_vperm_mix[0])), RKEY);
+		}
+	}
+
+	for (i = 0; i < 4; ++i)
+	{
+		_mm256_storeu_si256(&output[i], blk[i]);
+	}
+}
+
+RCS_TARGET_VPERM256
+static void rcs_ctr_transform_vperm256(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
+{
+	assert(ctx != NULL);
+	assert(input != NULL);
+	assert(output != NULL);
+
+	__m256i ctry[4];
+	__m256i otpy[4];
+	size_t i;
+	size_t oft;
+
+	oft = 0;
+
+	while (length != 0)
+	{
+		const size_t BLKLEN = (length >= RCS_AVX2X4_BLOCK) ? RCS_AVX2X4_BLOCK : length;
+
+		/* only the counters of the blocks that are used are consumed */
+		for (i = 0; i < 4; ++i)
+		{
+			ctry[i] = _mm256_loadu_si256((const __m256i*)counter);
+
+			if ((i * QSC_RCS_BLOCK_SIZE) < BLKLEN)
+			{
+				qsc_intutils_le8increment(counter, QSC_RCS_BLOCK_SIZE);
+			}
+		}
+
+		rcs_transform_256vy(ctx, otpy, ctry);
+
+		if (BLKLEN == RCS_AVX2X4_BLOCK)
+		{
+			for (i = 0; i < 4; ++i)
+			{
+				otpy[i] = _mm256_xor_si256(otpy[i], _mm256_loadu_si256((const __m256i*)(input + oft + (i * QSC_RCS_BLOCK_SIZE))));
+				_mm256_storeu_si256((__m256i*)(output + oft + (i * QSC_RCS_BLOCK_SIZE)), otpy[i]);
+			}
+		}
+		else
+		{
+			uint8_t tmpb[RCS_AVX2X4_BLOCK] = { 0 };
+
+			for (i = 0; i < 4; ++i)
+			{
+				_mm256_storeu_si256((__m256i*)(tmpb + (i * QSC_RCS_BLOCK_SIZE)), otpy[i]);
+			}
+
+			for (i = 0; i < BLKLEN; ++i)
+			{
+				output[oft + i] = tmpb[i] ^ input[oft + i];
+			}
+
+			qsc_memutils_clear(tmpb, sizeof(tmpb));
+		}
+
+		length -= BLKLEN;
+		oft += BLKLEN;
+	}
+}
+
+#endif
+
+/* the kernel dispatch table, bound once to the widest kernel supported by the cpu */
+typedef struct
+{
+	void (*ctrtransform)(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length);	/* advances the counter past the blocks it uses */
+	void (*loadkeys)(qsc_rcs_state* ctx);
+	bool interleave;	/* the batch transform interleaves the blocks of short messages, the vaes kernels are faster on their own */
+	void (*ecbtransform)(const qsc_rcs_sector_key* key, uint8_t* blocks, size_t nblocks, bool encrypt);	/* the block transform of the sector mode */
+	void (*loadinverse)(qsc_rcs_sector_key* key);	/* stores the round-keys the sector mode decrypts with, NULL if they are already loaded */
+	const rcs_mac_kernel* mackernel;	/* the permutation of the batch mac, NULL if the codes are computed one message at a time */
+} rcs_kernel_table;
+
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH) || (!defined(QSC_RCS_VAES256_ENABLED) && !defined(QSC_RCS_VAES512_ENABLED))
+static const rcs_kernel_table rcs_kernel_aesni = { rcs_ctr_transform_aesni, NULL, true, rcs_ecb_transform_aesni, rcs_load_inverse_keys, RCS_MAC_KERNEL_NATIVE };
+#endif
+
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH) && defined(RCS_MAC_LANES_ENABLED)
+static const rcs_kernel_table rcs_kernel_aesni256 = { rcs_ctr_transform_aesni, NULL, true, rcs_ecb_transform_aesni, rcs_load_inverse_keys, RCS_MAC_KERNEL_X4 };
+static const rcs_kernel_table rcs_kernel_aesni512 = { rcs_ctr_transform_aesni, NULL, true, rcs_ecb_transform_aesni, rcs_load_inverse_keys, RCS_MAC_KERNEL_X8 };
+#endif
+
+#if defined(QSC_RCS_VAES256_ENABLED)
+static const rcs_kernel_table rcs_kernel_vaes256 = { rcs_ctr_transform_vaes256, rcs_load_roundkeys256, false, rcs_ecb_transform_aesni, rcs_load_inverse_keys, RCS_MAC_KERNEL_X4 };
+#endif
+
+#if defined(QSC_RCS_VAES512_ENABLED)
+static const rcs_kernel_table rcs_kernel_vaes512 = { rcs_ctr_transform_vaes512, rcs_load_roundkeys512, false, rcs_ecb_transform_vaes512, rcs_load_inverse_keys512, RCS_MAC_KERNEL_X8 };
+#endif
+
+#if defined(QSC_RCS_VPERM_ENABLED)
+static const rcs_kernel_table rcs_kernel_vperm128 = { rcs_ctr_transform_vperm128, rcs_load_roundkeys_vperm, false, rcs_ecb_transform_bitsliced, rcs_load_inverse_bitsliced, NULL };
+static const rcs_kernel_table rcs_kernel_vperm256 = { rcs_ctr_transform_vperm256, rcs_load_roundkeys_vperm, false, rcs_ecb_transform_bitsliced, rcs_load_inverse_bitsliced, RCS_MAC_KERNEL_X4 };
+#endif
+
+#if defined(QSC_RCS_BITSLICED_ENABLED)
+static const rcs_kernel_table rcs_kernel_bitsliced = { rcs_ctr_transform_bitsliced, rcs_load_roundkeys_bitsliced, false, rcs_ecb_transform_bitsliced, NULL, NULL };
+#endif
+
+static const rcs_kernel_table* rcs_kernel_select()
+{
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+	static const rcs_kernel_table* table = NULL;
+	const rcs_kernel_table* ptbl;
+
+	ptbl = QSC_ASYNC_POINTER_LOAD(&table);
+
+	if (ptbl == NULL)
+	{
+		const qsc_cpuidex_cpu_features* pfeat;
+
+		/* racing initializers select the same table, the pointer is published with release ordering */
+		pfeat = qsc_cpuidex_dispatch_features();
+
+		if (pfeat->aesni == false)
+		{
+			/* aes-ni is missing or masked, use the constant-time vector-permute or bitsliced kernels */
+			if (pfeat->avx2 == true)
+			{
+				ptbl = &rcs_kernel_vperm256;
+			}
+			else if (pfeat->ssse3 == true)
+			{
+				ptbl = &rcs_kernel_vperm128;
+			}
+			else
+			{
+				ptbl = &rcs_kernel_bitsliced;
+			}
+		}
+		else if (pfeat->avx512f == true && pfeat->avx512bw == true && pfeat->vaes == true)
+		{
+			ptbl = &rcs_kernel_vaes512;
+		}
+		else if (pfeat->avx2 == true && pfeat->vaes == true)
+		{
+			ptbl = &rcs_kernel_vaes256;
+		}
+#if defined(RCS_MAC_LANES_ENABLED)
+		else if (pfeat->avx512f == true)
+		{
+			ptbl = &rcs_kernel_aesni512;
+		}
+		else if (pfeat->avx2 == true)
+		{
+			ptbl = &rcs_kernel_aesni256;
+		}
+#endif
+		else
+		{
+			ptbl = &rcs_kernel_aesni;
+		}
+
+		QSC_ASYNC_POINTER_STORE(&table, ptbl);
+	}
+
+	return ptbl;
+#elif defined(QSC_RCS_VAES512_ENABLED)
+	return &rcs_kernel_vaes512;
+#elif defined(QSC_RCS_VAES256_ENABLED)
+	return &rcs_kernel_vaes256;
+#else
+	return &rcs_kernel_aesni;
+#endif
+}
+
+static void rcs_ctr_transform_counter(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
+{
+	rcs_kernel_select()->ctrtransform(ctx, counter, output, input, length);
+}
+
+static void rcs_ecb_transform(const qsc_rcs_sector_key* key, uint8_t* blocks, size_t nblocks, bool encrypt)
+{
+	rcs_kernel_select()->ecbtransform(key, blocks, nblocks, encrypt);
+}
+
+#else
+
+static void rcs_ctr_transform_counter(const qsc_rcs_state* ctx, uint8_t* counter, uint8_t* output, const uint8_t* input, size_t length)
+{
+	rcs_ctr_transform_bitsliced(ctx, counter, output, input, length);
+}
+
+static void rcs_ecb_transform(const qsc_rcs_sector_key* key, uint8_t* blocks, size_t nblocks, bool encrypt)
+{
+	rcs_ecb_transform_bitsliced(key, blocks, nblocks, encrypt);
+}
+
+#endif
+
+static void rcs_ctr_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	rcs_ctr_transform_counter(ctx, ctx->nonce, output, input, length);
+}
+
+#if defined(QSC_RCS_AESNI_ENABLED)
+
+/* a single counter block queued for the multi-stream transform */
+typedef struct
+{
+	const __m128i* rkeys;
+	uint8_t counter[QSC_RCS_BLOCK_SIZE];
+	uint8_t* output;
+	const uint8_t* input;
+	size_t length;
+} rcs_batch_block;
+
+RCS_TARGET_AESNI
+static void rcs_batch_flush(rcs_batch_block* queue, size_t count, size_t roundkeylen)
+{
+	const size_t HLFBLK = QSC_RCS_BLOCK_SIZE / 2;
+	const __m128i* rkeys[4];
+	__m128i tmpn[8];
+	__m128i tmpo[8];
+	uint8_t otp[QSC_RCS_BLOCK_SIZE];
+	size_t i;
+	size_t j;
+
+	for (i = 0; i < 4; ++i)
+	{
+		/* unused lanes repeat the first block, and their output is discarded */
+		const rcs_batch_block* pblk = (i < count) ? &queue[i] : &queue[0];
+
+		rkeys[i] = pblk->rkeys;
+		tmpn[i * 2] = _mm_loadu_si128((const __m128i*)pblk->counter);
+		tmpn[(i * 2) + 1] = _mm_loadu_si128((const __m128i*)(pblk->counter + HLFBLK));
+	}
+
+	rcs_transform_256x4m(rkeys, roundkeylen, tmpo, tmpn);
+
+	for (i = 0; i < count; ++i)
+	{
+		if (queue[i].length == QSC_RCS_BLOCK_SIZE)
+		{
+			rcs_ctr_xorn(queue[i].output, queue[i].input, &tmpo[i * 2], 2);
+		}
+		else
+		{
+			_mm_storeu_si128((__m128i*)otp, tmpo[i * 2]);
+			_mm_storeu_si128((__m128i*)(otp + HLFBLK), tmpo[(i * 2) + 1]);
+
+			for (j = 0; j < queue[i].length; ++j)
+			{
+				queue[i].output[j] = otp[j] ^ queue[i].input[j];
+			}
+		}
+	}
+
+	qsc_memutils_clear(otp, sizeof(otp));
+}
+
+#endif
+
+static void rcs_ctr_transform_batch(qsc_rcs_state* ctxs[], uint8_t* outputs[], const uint8_t* inputs[], const size_t lengths[], const bool selected[], size_t count)
+{
+	size_t i;
+	bool interleaved;
+
+	interleaved = false;
+
+#if defined(QSC_RCS_AESNI_ENABLED)
+	if (rcs_kernel_select()->interleave == true)
+	{
+		/* the blocks of short messages are interleaved across the lanes of the multi-key x4 kernel */
+		rcs_batch_block queue[4];
+		size_t qlen;
+		size_t rklen;
+
+		qlen = 0;
+		rklen = 0;
+
+		for (i = 0; i < count; ++i)
+		{
+			if (selected[i] == true)
+			{
+				qsc_rcs_state* ctx = ctxs[i];
+
+				if (lengths[i] >= RCS_BATCH_STREAM_MINIMUM)
+				{
+					rcs_ctr_transform(ctx, outputs[i], inputs[i], lengths[i]);
+				}
+				else
+				{
+					size_t oft;
+
+					oft = 0;
+
+					while (oft < lengths[i])
+					{
+						const size_t BLEN = (lengths[i] - oft > QSC_RCS_BLOCK_SIZE) ? QSC_RCS_BLOCK_SIZE : lengths[i] - oft;
+
+						/* the lanes share a round count, so a change of cipher type flushes the queue */
+						if (qlen != 0 && rklen != ctx->roundkeylen)
+						{
+							rcs_batch_flush(queue, qlen, rklen);
+							qlen = 0;
+						}
+
+						queue[qlen].rkeys = ctx->roundkeys;
+						qsc_memutils_copy(queue[qlen].counter, ctx->nonce, QSC_RCS_BLOCK_SIZE);
+						queue[qlen].output = outputs[i] + oft;
+						queue[qlen].input = inputs[i] + oft;
+						queue[qlen].length = BLEN;
+						rklen = ctx->roundkeylen;
+						++qlen;
+
+						/* every block, including a partial final block, consumes one counter */
+						qsc_intutils_le8increment(ctx->nonce, QSC_RCS_BLOCK_SIZE);
+
+						if (qlen == 4)
+						{
+							rcs_batch_flush(queue, qlen, rklen);
+							qlen = 0;
+						}
+
+						oft += BLEN;
+					}
+				}
+			}
+		}
+
+		if (qlen != 0)
+		{
+			rcs_batch_flush(queue, qlen, rklen);
+		}
+
+		qsc_memutils_clear(queue, sizeof(queue));
+		interleaved = true;
+	}
+#endif
+
+	if (interleaved == false)
+	{
+		/* the wide and constant-time kernels transform each message on their own */
+		for (i = 0; i < count; ++i)
+		{
+			if (selected[i] == true)
+			{
+				rcs_ctr_transform(ctxs[i], outputs[i], inputs[i], lengths[i]);
+			}
+		}
+	}
+}
+
+static void rcs_nonce_add(uint8_t* nonce, const uint8_t* origin, uint64_t block)
+{
+	/* 256-bit little-endian addition of a block index to the initial nonce */
+	uint64_t carry;
+
+	carry = block;
+
+	for (size_t i = 0; i < QSC_RCS_NONCE_SIZE; i += sizeof(uint64_t))
+	{
+		const uint64_t X = qsc_intutils_le8to64(origin + i);
+		const uint64_t S = X + carry;
+
+		qsc_intutils_le64to8(nonce + i, S);
+		carry = (S < X) ? 1 : 0;
+	}
+}
+
+static void rcs_range_transform(const qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, uint64_t offset, size_t length)
+{
+	const size_t SKIP = (size_t)(offset % QSC_RCS_BLOCK_SIZE);
+	uint8_t ctr[QSC_RCS_NONCE_SIZE];
+
+	/* the counter of the first block of the range is derived into a local block, the state is only read */
+	rcs_nonce_add(ctr, ctx->origin, offset / QSC_RCS_BLOCK_SIZE);
+
+	if (SKIP != 0 && length != 0)
+	{
+		uint8_t otp[QSC_RCS_BLOCK_SIZE] = { 0 };
+		const size_t BLEN = qsc_intutils_min(length, QSC_RCS_BLOCK_SIZE - SKIP);
+
+		/* the range starts inside a block; encrypt the counter and use the tail of the key-stream block */
+		rcs_ctr_transform_counter(ctx, ctr, otp, otp, QSC_RCS_BLOCK_SIZE);
+
+		for (size_t i = 0; i < BLEN; ++i)
+		{
+			output[i] = input[i] ^ otp[SKIP + i];
+		}
+
+		qsc_memutils_clear(otp, sizeof(otp));
+		output += BLEN;
+		input += BLEN;
+		length -= BLEN;
+	}
+
+	if (length != 0)
+	{
+		rcs_ctr_transform_counter(ctx, ctr, output, input, length);
+	}
+
+	qsc_memutils_clear(ctr, sizeof(ctr));
+}
+
+typedef struct
+{
+	qsc_rcs_state state;
+	uint8_t* output;
+	const uint8_t* input;
+	size_t length;
+} rcs_parallel_segment;
+
+static void rcs_parallel_worker(void* arg)
+{
+	rcs_parallel_segment* pseg = (rcs_parallel_segment*)arg;
+
+	rcs_ctr_transform(&pseg->state, pseg->output, pseg->input, pseg->length);
+}
+
+static void rcs_ctr_transform_parallel(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	rcs_parallel_segment* psegs;
+	size_t seglen;
+	size_t tcnt;
+
+	psegs = NULL;
+	tcnt = qsc_intutils_min(qsc_async_processor_count(), QSC_ASYNC_THREADS_MAX);
+
+	if (length >= RCS_PARALLEL_MINIMUM && tcnt > 1)
+	{
+		/* each worker owns a copy of the state, the round-keys are 64 byte vectors */
+		psegs = (rcs_parallel_segment*)qsc_memutils_aligned_alloc(64, tcnt * sizeof(rcs_parallel_segment));
+	}
+
+	if (psegs != NULL)
+	{
+		qsc_thread threads[QSC_ASYNC_THREADS_MAX];
+		bool tstat[QSC_ASYNC_THREADS_MAX];
+		size_t oft;
+
+		/* split the input into counter-aligned segments, the last segment takes the remainder */
+		seglen = (length / tcnt) - ((length / tcnt) % RCS_PARALLEL_ALIGNMENT);
+		oft = 0;
+
+		for (size_t i = 0; i < tcnt; ++i)
+		{
+			qsc_memutils_copy(&psegs[i].state, ctx, sizeof(qsc_rcs_state));
+			rcs_nonce_add(psegs[i].state.nonce, ctx->nonce, (uint64_t)(oft / QSC_RCS_BLOCK_SIZE));
+			psegs[i].output = output + oft;
+			psegs[i].input = input + oft;
+			psegs[i].length = (i == tcnt - 1) ? length - oft : seglen;
+			oft += seglen;
+		}
+
+		/* the calling thread transforms the first segment */
+		for (size_t i = 1; i < tcnt; ++i)
+		{
+			tstat[i] = qsc_async_thread_create(&threads[i], rcs_parallel_worker, &psegs[i]);
+		}
+
+		rcs_parallel_worker(&psegs[0]);
+
+		for (size_t i = 1; i < tcnt; ++i)
+		{
+			if (tstat[i] == true)
+			{
+				qsc_async_thread_wait(threads[i]);
+			}
+			else
+			{
+				/* a thread could not be created, transform its segment here */
+				rcs_parallel_worker(&psegs[i]);
+			}
+		}
+
+		/* the stream position is the nonce after the last segment */
+		qsc_memutils_copy(ctx->nonce, psegs[tcnt - 1].state.nonce, QSC_RCS_NONCE_SIZE);
+
+		qsc_memutils_clear((uint8_t*)psegs, tcnt * sizeof(rcs_parallel_segment));
+		qsc_memutils_aligned_free(psegs);
+	}
+	else
+	{
+		rcs_ctr_transform(ctx, output, input, length);
+	}
+}
+
+static void rcs_mac_finalize(qsc_rcs_state* ctx, uint8_t* output)
+{
+	uint8_t ctr[sizeof(uint64_t)] = { 0 };
+	uint64_t mctr = QSC_RCS_BLOCK_SIZE + ctx->counter + sizeof(uint64_t);
+
+	qsc_intutils_le64to8(ctr, mctr);
+
+#if defined(QSC_RCS_KPA_AUTHENTICATION)
+	/* update the counter, then finalize the mac and append code to output */
+	qsc_kpa_update(&ctx->kstate, ctr, sizeof(ctr));
+	qsc_kpa_finalize(&ctx->kstate, output, (ctx->ctype == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE);
+#else
+	if (ctx->ctype == RCS256)
+	{
+#	if defined(QSC_RCS_AUTH_KMACR12)
+		/* update the counter */
+		qsc_keccak_update(&ctx->kstate, qsc_keccak_rate_256, ctr, sizeof(ctr), QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+		/* finalize the mac and append code to output */
+		qsc_keccak_finalize(&ctx->kstate, qsc_keccak_rate_256, output, QSC_RCS256_MAC_SIZE, QSC_KECCAK_KMAC_DOMAIN_ID, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+#	else
+		/* update the counter */
+		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_256, ctr, sizeof(ctr));
+		/* finalize the mac and append code to output */
+		qsc_kmac_finalize(&ctx->kstate, qsc_keccak_rate_256, output, QSC_RCS256_MAC_SIZE);
+#	endif
+	}
+	else
+	{
+#	if defined(QSC_RCS_AUTH_KMACR12)
 		qsc_keccak_update(&ctx->kstate, qsc_keccak_rate_512, ctr, sizeof(ctr), QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
 		qsc_keccak_finalize(&ctx->kstate, qsc_keccak_rate_512, output, QSC_RCS512_MAC_SIZE, QSC_KECCAK_KMAC_DOMAIN_ID, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+#	else
+		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_512, ctr, sizeof(ctr));
+		qsc_kmac_finalize(&ctx->kstate, qsc_keccak_rate_512, output, QSC_RCS512_MAC_SIZE);
+#	endif
+	}
+#endif
+}
+
+static void rcs_mac_update(qsc_rcs_state* ctx, const uint8_t* input, size_t length)
+{
+#if defined(QSC_RCS_KPA_AUTHENTICATION)
+	/* the kpa rate is set by the mac key length */
+	qsc_kpa_update(&ctx->kstate, input, length);
+#else
+	if (ctx->ctype == RCS256)
+	{
+#	if defined(QSC_RCS_AUTH_KMACR12)
+		qsc_keccak_update(&ctx->kstate, qsc_keccak_rate_256, input, length, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+#	else
+		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_256, input, length);
+#	endif
+	}
+	else
+	{
+#	if defined(QSC_RCS_AUTH_KMACR12)
+		qsc_keccak_update(&ctx->kstate, qsc_keccak_rate_512, input, length, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
+#	else
+		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_512, input, length);
+#	endif
+	}
+#endif
+}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+
+/* a message queued for the multi-stream mac */
+typedef struct
+{
+	qsc_rcs_state* ctx;
+	const uint8_t* nonce;
+	const uint8_t* data;
+	size_t length;
+	uint8_t* code;
+} rcs_mac_job;
+
+#	if defined(RCS_MAC_LANES_ENABLED)
+
+/* a message in a lane of the interleaved keccak state; the absorbed stream is
+   the buffered bytes of the mac state, the nonce, the data, and the encoded byte counter */
+typedef struct
+{
+	const rcs_mac_job* job;
+	const uint8_t* segments[4];
+	size_t seglens[4];
+	uint8_t ctr[sizeof(uint64_t)];
+	uint8_t encode[sizeof(size_t) + 1];
+	size_t enclen;
+	size_t maclen;
+	size_t total;
+	size_t blocks;
+	size_t position;
+} rcs_mac_lane;
+
+static size_t rcs_mac_right_encode(uint8_t* buffer, size_t value)
+{
+	size_t i;
+	size_t n;
+	size_t v;
+
+	for (v = value, n = 0; v != 0 && (n < sizeof(size_t)); ++n, v >>= 8) { /* increments n */ }
+
+	if (n == 0)
+	{
+		n = 1;
+	}
+
+	for (i = 1; i <= n; ++i)
+	{
+		buffer[i - 1] = (uint8_t)(value >> (8 * (n - i)));
+	}
+
+	buffer[n] = (uint8_t)n;
+
+	return n + 1;
+}
+
+static void rcs_mac_lane_read(const rcs_mac_lane* lane, uint8_t* output, size_t offset, size_t length)
+{
+	size_t i;
+	size_t rlen;
+
+	for (i = 0; i < 4 && length != 0; ++i)
+	{
+		if (offset >= lane->seglens[i])
+		{
+			offset -= lane->seglens[i];
+		}
+		else
+		{
+			rlen = lane->seglens[i] - offset;
+			rlen = (rlen > length) ? length : rlen;
+			qsc_memutils_copy(output, lane->segments[i] + offset, rlen);
+			output += rlen;
+			length -= rlen;
+			offset = 0;
+		}
+	}
+}
+
+static void rcs_mac_lane_load(rcs_mac_lane* lane, const rcs_mac_job* job, size_t rate, uint64_t* lanes, size_t nlanes, size_t index)
+{
+	qsc_rcs_state* ctx = job->ctx;
+	size_t i;
+
+	lane->job = job;
+	lane->segments[0] = ctx->kstate.buffer;
+	lane->seglens[0] = ctx->kstate.position;
+	lane->segments[1] = job->nonce;
+	lane->seglens[1] = QSC_RCS_BLOCK_SIZE;
+	lane->segments[2] = job->data;
+	lane->seglens[2] = job->length;
+	qsc_intutils_le64to8(lane->ctr, QSC_RCS_BLOCK_SIZE + ctx->counter + sizeof(uint64_t));
+	lane->segments[3] = lane->ctr;
+	lane->seglens[3] = sizeof(lane->ctr);
+	lane->maclen = (ctx->ctype == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+	lane->enclen = rcs_mac_right_encode(lane->encode, lane->maclen * 8);
+	lane->total = lane->seglens[0] + lane->seglens[1] + lane->seglens[2] + lane->seglens[3];
+	/* the finalizer absorbs the remainder on its own if the length encoding does not fit behind it */
+	lane->blocks = (lane->total / rate) + (((lane->total % rate) + lane->enclen >= rate) ? 2 : 1);
+	lane->position = 0;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		lanes[(i * nlanes) + index] = ctx->kstate.state[i];
+	}
+}
+
+static void rcs_mac_lane_block(const rcs_mac_lane* lane, uint8_t* block, size_t rate)
+{
+	/* reproduces the block sequence of the keccak update and finalize functions */
+	const size_t NFULL = lane->total / rate;
+	size_t oft;
+
+	qsc_memutils_clear(block, QSC_KECCAK_STATE_BYTE_SIZE);
+
+	if (lane->position < NFULL)
+	{
+		rcs_mac_lane_read(lane, block, lane->position * rate, rate);
+	}
+	else
+	{
+		const size_t RMDLEN = lane->total - (NFULL * rate);
+
+		rcs_mac_lane_read(lane, block, NFULL * rate, RMDLEN);
+
+		/* if the length encoding does not fit behind the remainder, the remainder is absorbed first without padding,
+		   and the padding is then written over the start of the same buffer, as the keccak finalize function does */
+		if (lane->blocks - NFULL == 1 || lane->position != NFULL)
+		{
+			oft = (lane->blocks - NFULL == 1) ? RMDLEN : 0;
+			qsc_memutils_copy(block + oft, lane->encode, lane->enclen);
+			block[oft + lane->enclen] = QSC_KECCAK_KMAC_DOMAIN_ID;
+			block[rate - 1] |= 128U;
+		}
+	}
+}
+
+static void rcs_mac_lane_store(rcs_mac_lane* lane, const uint64_t* lanes, size_t nlanes, size_t index)
+{
+	qsc_rcs_state* ctx = lane->job->ctx;
+	size_t i;
+
+	for (i = 0; i < QSC_KECCAK_STATE_SIZE; ++i)
+	{
+		ctx->kstate.state[i] = lanes[(i * nlanes) + index];
+	}
+
+	for (i = 0; i < lane->maclen / sizeof(uint64_t); ++i)
+	{
+		qsc_intutils_le64to8(lane->job->code + (i * sizeof(uint64_t)), ctx->kstate.state[i]);
+	}
+
+	qsc_memutils_clear(ctx->kstate.buffer, sizeof(ctx->kstate.buffer));
+	ctx->kstate.position = 0;
+	lane->job = NULL;
+}
+
+static void rcs_mac_batch_lanes(const rcs_mac_kernel* kernel, const rcs_mac_job* jobs, size_t count, rcs_cipher_type ctype)
+{
+	/* the sponges of independent messages advance together, one per lane of the keccak permutation;
+	   a lane is refilled with the next message as soon as its tag has been squeezed */
+	const size_t RATE = (ctype == RCS256) ? (size_t)qsc_keccak_rate_256 : (size_t)qsc_keccak_rate_512;
+	const size_t NLANES = kernel->lanes;
+	rcs_mac_lane lanes[RCS_MAC_LANES_MAX] = { 0 };
+	uint64_t state[QSC_KECCAK_STATE_SIZE * RCS_MAC_LANES_MAX] = { 0 };
+	uint8_t block[QSC_KECCAK_STATE_BYTE_SIZE] = { 0 };
+	size_t actv;
+	size_t next;
+	size_t i;
+	size_t j;
+
+	next = 0;
+
+	while (true)
+	{
+		actv = 0;
+
+		for (i = 0; i < NLANES; ++i)
+		{
+			while (lanes[i].job == NULL && next < count)
+			{
+				if (jobs[next].ctx->ctype == ctype)
+				{
+					rcs_mac_lane_load(&lanes[i], &jobs[next], RATE, state, NLANES, i);
+				}
+
+				++next;
+			}
+
+			if (lanes[i].job != NULL)
+			{
+				rcs_mac_lane_block(&lanes[i], block, RATE);
+
+				for (j = 0; j < RATE / sizeof(uint64_t); ++j)
+				{
+					state[(j * NLANES) + i] ^= qsc_intutils_le8to64(block + (j * sizeof(uint64_t)));
+				}
+
+				++actv;
+			}
+		}
+
+		if (actv == 0)
+		{
+			break;
+		}
+
+		kernel->permute(state);
+
+		for (i = 0; i < NLANES; ++i)
+		{
+			if (lanes[i].job != NULL)
+			{
+				++lanes[i].position;
+
+				if (lanes[i].position == lanes[i].blocks)
+				{
+					rcs_mac_lane_store(&lanes[i], state, NLANES, i);
+				}
+			}
+		}
+	}
+
+	qsc_memutils_clear(block, sizeof(block));
+	qsc_memutils_clear(state, sizeof(state));
+	qsc_memutils_clear(lanes, sizeof(lanes));
+}
+
+#	endif
+
+static void rcs_mac_batch(const rcs_mac_job* jobs, size_t count)
+{
+	const rcs_mac_kernel* kernel;
+	size_t i;
+
+#	if !defined(RCS_MAC_LANES_ENABLED)
+	/* the kpa is already parallel internally, and without avx2 there are no lanes to fill */
+	kernel = NULL;
+#	elif defined(QSC_RCS_AESNI_ENABLED)
+	kernel = rcs_kernel_select()->mackernel;
+#	else
+	kernel = RCS_MAC_KERNEL_NATIVE;
+#	endif
+
+	if (kernel != NULL)
+	{
+#	if defined(RCS_MAC_LANES_ENABLED)
+		/* the rates differ, so each cipher type fills the lanes in its own pass */
+		rcs_mac_batch_lanes(kernel, jobs, count, RCS256);
+		rcs_mac_batch_lanes(kernel, jobs, count, RCS512);
+#	endif
+	}
+	else
+	{
+		for (i = 0; i < count; ++i)
+		{
+			rcs_mac_update(jobs[i].ctx, jobs[i].nonce, QSC_RCS_BLOCK_SIZE);
+			rcs_mac_update(jobs[i].ctx, jobs[i].data, jobs[i].length);
+			rcs_mac_finalize(jobs[i].ctx, jobs[i].code);
+		}
+	}
+}
+
+#endif
+
+static bool rcs_transform_batch(qsc_rcs_state* ctxs[], uint8_t* outputs[], const uint8_t* inputs[], const size_t lengths[], uint8_t* tags[], bool results[], size_t count)
+{
+#if defined(QSC_RCS_AUTHENTICATED)
+	uint8_t codes[RCS_BATCH_MAXIMUM][QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t nonces[RCS_BATCH_MAXIMUM][QSC_RCS_NONCE_SIZE] = { 0 };
+	rcs_mac_job jobs[RCS_BATCH_MAXIMUM] = { 0 };
+#endif
+	bool selected[RCS_BATCH_MAXIMUM] = { 0 };
+	size_t i;
+	bool res;
+
+	res = true;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+
+	for (i = 0; i < count; ++i)
+	{
+		/* update the processed bytes counter, and store the nonce position the mac is keyed with */
+		ctxs[i]->counter += lengths[i];
+		qsc_memutils_copy(nonces[i], ctxs[i]->nonce, QSC_RCS_NONCE_SIZE);
+		selected[i] = ctxs[i]->encrypt;
+	}
+
+	/* encrypt the plain-text of every encrypting stream */
+	rcs_ctr_transform_batch(ctxs, outputs, inputs, lengths, selected, count);
+
+	for (i = 0; i < count; ++i)
+	{
+		jobs[i].ctx = ctxs[i];
+		jobs[i].nonce = nonces[i];
+		jobs[i].length = lengths[i];
+
+		if (ctxs[i]->encrypt == true)
+		{
+			/* mac the cipher-text appending the code to the end of the array, or writing it to the tag array */
+			jobs[i].data = outputs[i];
+			jobs[i].code = (tags != NULL) ? tags[i] : outputs[i] + lengths[i];
+		}
+		else
+		{
+			/* mac the cipher-text to a temp array for comparison */
+			jobs[i].data = inputs[i];
+			jobs[i].code = codes[i];
+		}
+	}
+
+	rcs_mac_batch(jobs, count);
+
+	for (i = 0; i < count; ++i)
+	{
+		if (ctxs[i]->encrypt == true)
+		{
+			results[i] = true;
+			selected[i] = false;
+		}
+		else
+		{
+			const size_t MACLEN = (ctxs[i]->ctype == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+
+			/* test the mac for equality, bypassing the transform if the mac check fails */
+			results[i] = (qsc_intutils_verify(codes[i], (tags != NULL) ? tags[i] : inputs[i] + lengths[i], MACLEN) == 0);
+			selected[i] = results[i];
+			res = res && results[i];
+		}
+	}
+
+	/* decrypt the cipher-text of every authenticated stream */
+	rcs_ctr_transform_batch(ctxs, outputs, inputs, lengths, selected, count);
+
+	qsc_memutils_clear(codes, sizeof(codes));
+	qsc_memutils_clear(nonces, sizeof(nonces));
+
 #else
-		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_512, ctr, sizeof(ctr));
-		qsc_kmac_finalize(&ctx->kstate, qsc_keccak_rate_512, output, QSC_RCS512_MAC_SIZE);
+
+	(void)tags;
+
+	for (i = 0; i < count; ++i)
+	{
+		selected[i] = true;
+		results[i] = true;
+	}
+
+	rcs_ctr_transform_batch(ctxs, outputs, inputs, lengths, selected, count);
+
+#endif
+
+	return res;
+}
+
+static bool rcs_transform_batches(qsc_rcs_state* ctxs[], uint8_t* outputs[], const uint8_t* inputs[], const size_t lengths[], uint8_t* tags[], bool results[], size_t count)
+{
+	bool status[RCS_BATCH_MAXIMUM] = { 0 };
+	size_t bcnt;
+	size_t oft;
+	bool res;
+
+	res = true;
+	oft = 0;
+
+	while (oft < count)
+	{
+		bcnt = (count - oft > RCS_BATCH_MAXIMUM) ? RCS_BATCH_MAXIMUM : count - oft;
+
+		if (rcs_transform_batch(ctxs + oft, outputs + oft, inputs + oft, lengths + oft, (tags != NULL) ? tags + oft : NULL, status, bcnt) == false)
+		{
+			res = false;
+		}
+
+		if (results != NULL)
+		{
+			qsc_memutils_copy(results + oft, status, bcnt * sizeof(bool));
+		}
+
+		oft += bcnt;
+	}
+
+	return res;
+}
+
+static void rcs_ctr_mac_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	/* encrypt in cache-sized tiles, and absorb each tile of cipher-text while it is still in the L1 cache */
+	size_t oft;
+
+	oft = 0;
+
+	while (length != 0)
+	{
+		const size_t TLEN = (length > RCS_MAC_TILE_SIZE) ? RCS_MAC_TILE_SIZE : length;
+
+		rcs_ctr_transform(ctx, output + oft, input + oft, TLEN);
+		rcs_mac_update(ctx, output + oft, TLEN);
+
+		length -= TLEN;
+		oft += TLEN;
+	}
+}
+
+static void rcs_mac_ctr_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	/* absorb each tile of cipher-text, then decrypt it while it is still in the L1 cache;
+	   the mac reads the tile first, so the input and output arrays can overlap */
+	size_t oft;
+
+	oft = 0;
+
+	while (length != 0)
+	{
+		const size_t TLEN = (length > RCS_MAC_TILE_SIZE) ? RCS_MAC_TILE_SIZE : length;
+
+		rcs_mac_update(ctx, input + oft, TLEN);
+		rcs_ctr_transform(ctx, output + oft, input + oft, TLEN);
+
+		length -= TLEN;
+		oft += TLEN;
+	}
+}
+
+static bool rcs_authenticated_decrypt(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	uint8_t code[QSC_RCS512_MAC_SIZE] = { 0 };
+	const size_t MACLEN = (ctx->ctype == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+	bool res;
+
+	res = false;
+
+#if defined(QSC_RCS_FUSED_DECRYPTION)
+
+	/* authenticate and decrypt the cipher-text in a single pass */
+	rcs_mac_ctr_transform(ctx, output, input, length);
+
+	/* mac the cipher-text to a temp array for comparison */
+	rcs_mac_finalize(ctx, code);
+
+	/* test the mac for equality, erasing the plain-text if the mac check fails */
+	if (qsc_intutils_verify(code, input + length, MACLEN) == 0)
+	{
+		res = true;
+	}
+	else
+	{
+		qsc_memutils_clear(output, length);
+	}
+
+#else
+
+	/* update the mac with the cipher-text */
+	rcs_mac_update(ctx, input, length);
+
+	/* mac the cipher-text to a temp array for comparison */
+	rcs_mac_finalize(ctx, code);
+
+	/* test the mac for equality, bypassing the transform if the mac check fails */
+	if (qsc_intutils_verify(code, input + length, MACLEN) == 0)
+	{
+		/* transform the plain-text with the counter-mode cipher */
+		rcs_ctr_transform(ctx, output, input, length);
+		res = true;
+	}
+
+#endif
+
+	qsc_memutils_clear(code, sizeof(code));
+
+	return res;
+}
+
+static size_t rcs_vector_length(const qsc_rcs_iovec* vector, size_t count)
+{
+	size_t i;
+	size_t len;
+
+	len = 0;
+
+	for (i = 0; i < count; ++i)
+	{
+		len += vector[i].length;
+	}
+
+	return len;
+}
+
+static void rcs_vector_transform(qsc_rcs_state* ctx, const qsc_rcs_iovec* output, size_t outcount, const qsc_rcs_iovec* input, size_t incount, bool macin, bool macout)
+{
+	/* walk the input and output fragments together, transforming the spans where both are contiguous;
+	   whole blocks are transformed in place, and a block split by a fragment boundary
+	   is generated once and its key-stream carried into the next span */
+	uint8_t kstm[QSC_RCS_BLOCK_SIZE] = { 0 };
+	size_t kpos;
+	size_t iidx;
+	size_t ioft;
+	size_t oidx;
+	size_t ooft;
+	size_t i;
+
+	kpos = QSC_RCS_BLOCK_SIZE;
+	iidx = 0;
+	ioft = 0;
+	oidx = 0;
+	ooft = 0;
+
+	while (iidx < incount && oidx < outcount)
+	{
+		if (ioft == input[iidx].length)
+		{
+			++iidx;
+			ioft = 0;
+		}
+		else if (ooft == output[oidx].length)
+		{
+			++oidx;
+			ooft = 0;
+		}
+		else
+		{
+			const uint8_t* pin = input[iidx].buffer + ioft;
+			uint8_t* pout = output[oidx].buffer + ooft;
+			size_t slen;
+
+			slen = qsc_intutils_min(input[iidx].length - ioft, output[oidx].length - ooft);
+
+			if (kpos == QSC_RCS_BLOCK_SIZE && slen < QSC_RCS_BLOCK_SIZE)
+			{
+				/* the block is split by a fragment boundary; it consumes one counter, as it would in a contiguous array */
+				qsc_memutils_clear(kstm, sizeof(kstm));
+				rcs_ctr_transform(ctx, kstm, kstm, sizeof(kstm));
+				kpos = 0;
+			}
+			else
+			{
+				if (kpos != QSC_RCS_BLOCK_SIZE)
+				{
+					/* use the remainder of the carried key-stream block */
+					slen = qsc_intutils_min(slen, QSC_RCS_BLOCK_SIZE - kpos);
+				}
+				else
+				{
+					slen -= slen % QSC_RCS_BLOCK_SIZE;
+				}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+				/* the mac absorbs the cipher-text before decryption, so the fragments can be transformed in place */
+				if (macin == true)
+				{
+					rcs_mac_update(ctx, pin, slen);
+				}
+#endif
+
+				if (kpos != QSC_RCS_BLOCK_SIZE)
+				{
+					for (i = 0; i < slen; ++i)
+					{
+						pout[i] = pin[i] ^ kstm[kpos + i];
+					}
+
+					kpos += slen;
+				}
+				else
+				{
+					rcs_ctr_transform(ctx, pout, pin, slen);
+				}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+				if (macout == true)
+				{
+					rcs_mac_update(ctx, pout, slen);
+				}
 #endif
+
+				ioft += slen;
+				ooft += slen;
+			}
+		}
+	}
+
+	qsc_memutils_clear(kstm, sizeof(kstm));
+}
+
+static void rcs_stream_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	size_t i;
+	size_t klen;
+	size_t oft;
+
+	oft = 0;
+
+	/* use the key-stream left over from the previous update */
+	klen = qsc_intutils_min(length, QSC_RCS_BLOCK_SIZE - ctx->kspos);
+
+	for (i = 0; i < klen; ++i)
+	{
+		output[i] = input[i] ^ ctx->kstream[ctx->kspos + i];
+	}
+
+	ctx->kspos += klen;
+	oft += klen;
+	length -= klen;
+
+	/* the stream is now block-aligned; whole blocks go to the kernel */
+	if (length >= QSC_RCS_BLOCK_SIZE)
+	{
+		klen = length - (length % QSC_RCS_BLOCK_SIZE);
+		rcs_ctr_transform(ctx, output + oft, input + oft, klen);
+		oft += klen;
+		length -= klen;
+	}
+
+	/* generate the next block, and keep what this update does not use */
+	if (length != 0)
+	{
+		qsc_memutils_clear(ctx->kstream, sizeof(ctx->kstream));
+		rcs_ctr_transform(ctx, ctx->kstream, ctx->kstream, sizeof(ctx->kstream));
+
+		for (i = 0; i < length; ++i)
+		{
+			output[oft + i] = input[oft + i] ^ ctx->kstream[i];
+		}
+
+		ctx->kspos = length;
 	}
 }
 
-static void rcs_mac_update(qsc_rcs_state* ctx, const uint8_t* input, size_t length)
+static void rcs_stream_reset(qsc_rcs_state* ctx)
+{
+	qsc_memutils_clear(ctx->kstream, sizeof(ctx->kstream));
+	ctx->kspos = QSC_RCS_BLOCK_SIZE;
+	ctx->pending = false;
+}
+
+static void rcs_sector_double(uint64_t tweak[4])
 {
-	if (ctx->ctype == RCS256)
-	{
-#if defined(QSC_RCS_AUTH_KMACR12)
-		qsc_keccak_update(&ctx->kstate, qsc_keccak_rate_256, input, length, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
-#else
-		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_256, input, length);
-#endif
-	}
-	else
+	/* multiply the tweak by x in GF(2^256), modulo x^256 + x^10 + x^5 + x^2 + 1; the block is a little-endian integer */
+	const uint64_t CARRY = (uint64_t)0 - (tweak[3] >> 63);
+
+	tweak[3] = (tweak[3] << 1) | (tweak[2] >> 63);
+	tweak[2] = (tweak[2] << 1) | (tweak[1] >> 63);
+	tweak[1] = (tweak[1] << 1) | (tweak[0] >> 63);
+	tweak[0] = (tweak[0] << 1) ^ (CARRY & 0x0000000000000425ULL);
+}
+
+static void rcs_sector_transform(const qsc_rcs_sector_key* key, uint8_t* output, const uint8_t* input, uint64_t sector, size_t sectorlen, size_t count, bool encrypt)
+{
+	/* the XEX mode; block j of a sector is masked before and after the block cipher with E(sector) times x^(j+1),
+	   the exponent starts at one, so no mask is equal to an encrypted tweak */
+	const size_t SBLKS = sectorlen / QSC_RCS_BLOCK_SIZE;
+	QSC_ALIGN(64) uint8_t blks[RCS_SECTOR_BATCH * QSC_RCS_BLOCK_SIZE] = { 0 };
+	QSC_ALIGN(64) uint8_t msks[RCS_SECTOR_BATCH * QSC_RCS_BLOCK_SIZE] = { 0 };
+	QSC_ALIGN(64) uint8_t twks[RCS_SECTOR_BATCH * QSC_RCS_BLOCK_SIZE] = { 0 };
+	uint64_t tweak[4] = { 0 };
+	size_t bcnt;
+	size_t bpos;
+	size_t gcnt;
+	size_t nblk;
+	size_t oft;
+	size_t scur;
+	size_t i;
+	size_t j;
+
+	oft = 0;
+
+	while (count != 0)
 	{
-#if defined(QSC_RCS_AUTH_KMACR12)
-		qsc_keccak_update(&ctx->kstate, qsc_keccak_rate_512, input, length, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
-#else
-		qsc_kmac_update(&ctx->kstate, qsc_keccak_rate_512, input, length);
-#endif
+		gcnt = qsc_intutils_min(count, RCS_SECTOR_BATCH);
+
+		/* the tweaks of a group of sectors are encrypted in one call */
+		qsc_memutils_clear(twks, sizeof(twks));
+
+		for (i = 0; i < gcnt; ++i)
+		{
+			qsc_intutils_le64to8(twks + (i * QSC_RCS_BLOCK_SIZE), sector + i);
+		}
+
+		rcs_ecb_transform(key, twks, gcnt, true);
+
+		/* the blocks of the group are batched across the sector boundaries, so short sectors still fill the kernel */
+		bcnt = gcnt * SBLKS;
+		bpos = SBLKS;
+		scur = 0;
+
+		while (bcnt != 0)
+		{
+			nblk = qsc_intutils_min(bcnt, RCS_SECTOR_BATCH);
+
+			for (j = 0; j < nblk; ++j)
+			{
+				uint8_t* pmsk = msks + (j * QSC_RCS_BLOCK_SIZE);
+
+				if (bpos == SBLKS)
+				{
+					for (i = 0; i < 4; ++i)
+					{
+						tweak[i] = qsc_intutils_le8to64(twks + (scur * QSC_RCS_BLOCK_SIZE) + (i * sizeof(uint64_t)));
+					}
+
+					++scur;
+					bpos = 0;
+				}
+
+				rcs_sector_double(tweak);
+
+				for (i = 0; i < 4; ++i)
+				{
+					qsc_intutils_le64to8(pmsk + (i * sizeof(uint64_t)), tweak[i]);
+				}
+
+				for (i = 0; i < QSC_RCS_BLOCK_SIZE; ++i)
+				{
+					blks[(j * QSC_RCS_BLOCK_SIZE) + i] = input[oft + (j * QSC_RCS_BLOCK_SIZE) + i] ^ pmsk[i];
+				}
+
+				++bpos;
+			}
+
+			rcs_ecb_transform(key, blks, nblk, encrypt);
+
+			for (i = 0; i < nblk * QSC_RCS_BLOCK_SIZE; ++i)
+			{
+				output[oft + i] = blks[i] ^ msks[i];
+			}
+
+			oft += nblk * QSC_RCS_BLOCK_SIZE;
+			bcnt -= nblk;
+		}
+
+		sector += gcnt;
+		count -= gcnt;
 	}
+
+	qsc_memutils_clear(blks, sizeof(blks));
+	qsc_memutils_clear(msks, sizeof(msks));
+	qsc_memutils_clear(twks, sizeof(twks));
+	qsc_memutils_clear((uint8_t*)tweak, sizeof(tweak));
 }
 
-static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keyparams)
+static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keyparams, bool sector)
 {
 	uint8_t sbuf[QSC_KECCAK_STATE_SIZE * sizeof(uint64_t)] = { 0 };
 	qsc_keccak_state kstate;
-	size_t i;
+	const uint8_t* name;
+	size_t namelen;
 	size_t oft;
 	size_t rlen;
 
+	if (sector == true)
+	{
+		name = (ctx->ctype == RCS256) ? rcs256_sector_name : rcs512_sector_name;
+		namelen = RCS_SECTOR_NAME_LENGTH;
+	}
+	else
+	{
+		name = (ctx->ctype == RCS256) ? rcs256_name : rcs512_name;
+		namelen = RCS_NAME_LENGTH;
+	}
+
 	if (ctx->ctype == RCS256)
 	{
 		uint8_t tmpr[RCS256_ROUNDKEY_SIZE * RCS_ROUNDKEY_ELEMENT_SIZE] = { 0 };
 
 		/* initialize an instance of cSHAKE */
-		qsc_cshake_initialize(&kstate, qsc_keccak_rate_256, keyparams->key, keyparams->keylen, rcs256_name, RCS_NAME_LENGTH, keyparams->info, keyparams->infolen);
+		qsc_cshake_initialize(&kstate, qsc_keccak_rate_256, keyparams->key, keyparams->keylen, name, namelen, keyparams->info, keyparams->infolen);
 
 		oft = 0;
 		rlen = RCS256_ROUNDKEY_SIZE * RCS_ROUNDKEY_ELEMENT_SIZE;
@@ -605,17 +3903,14 @@ static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keypa
 		const size_t RNKLEN = (QSC_RCS_BLOCK_SIZE / sizeof(__m128i)) * (ctx->rounds + 1);
 
 		/* copy p-rand bytes to round keys */
-		for (i = 0; i < RNKLEN; ++i)
+		for (size_t i = 0; i < RNKLEN; ++i)
 		{
 			ctx->roundkeys[i] = _mm_loadu_si128((const __m128i*)(tmpr + (i * sizeof(__m128i))));
 		}
 
 #else
-		/* realign in big endian format for ACS test vectors; RCS is the fallback to the AES-NI implementation */
-		for (i = 0; i < RCS256_ROUNDKEY_SIZE; ++i)
-		{
-			ctx->roundkeys[i] = qsc_intutils_be8to32(tmpr + (i * sizeof(uint32_t)));
-		}
+		/* store the round keys as bit-planes */
+		rcs_bitslice_roundkeys(ctx->roundkeys, tmpr, ctx->rounds);
 #endif
 
 #if defined(QSC_RCS_AUTHENTICATED)
@@ -624,7 +3919,9 @@ static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keypa
 		uint8_t mkey[RCS256_MKEY_LENGTH];
 		qsc_memutils_copy(mkey, sbuf, RCS256_MKEY_LENGTH);
 
-#	if defined(QSC_RCS_AUTH_KMACR12)
+#	if defined(QSC_RCS_KPA_AUTHENTICATION)
+		qsc_kpa_initialize(&ctx->kstate, mkey, sizeof(mkey), rcs_kpa_name, RCS_KPA_NAME_LENGTH);
+#	elif defined(QSC_RCS_AUTH_KMACR12)
 		qsc_keccak_initialize_state(&ctx->kstate);
 		qsc_keccak_absorb_key_custom(&ctx->kstate, qsc_keccak_rate_256, mkey, sizeof(mkey), NULL, 0, rcs_kmacr24_name, RCS_KMACR12_NAME_LENGTH, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
 #	else
@@ -639,7 +3936,7 @@ static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keypa
 		uint8_t tmpr[RCS512_ROUNDKEY_SIZE * RCS_ROUNDKEY_ELEMENT_SIZE] = { 0 };
 
 		/* initialize an instance of cSHAKE */
-		qsc_cshake_initialize(&kstate, qsc_keccak_rate_512, keyparams->key, keyparams->keylen, rcs512_name, RCS_NAME_LENGTH, keyparams->info, keyparams->infolen);
+		qsc_cshake_initialize(&kstate, qsc_keccak_rate_512, keyparams->key, keyparams->keylen, name, namelen, keyparams->info, keyparams->infolen);
 
 		oft = 0;
 		rlen = RCS512_ROUNDKEY_SIZE * RCS_ROUNDKEY_ELEMENT_SIZE;
@@ -657,16 +3954,13 @@ static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keypa
 		const size_t RNKLEN = (QSC_RCS_BLOCK_SIZE / sizeof(__m128i)) * (ctx->rounds + 1);
 
 		/* copy p-rand bytes to round keys */
-		for (i = 0; i < RNKLEN; ++i)
+		for (size_t i = 0; i < RNKLEN; ++i)
 		{
 			ctx->roundkeys[i] = _mm_loadu_si128((const __m128i*)(tmpr + (i * sizeof(__m128i))));
 		}
 #else
-		/* realign in big endian format for ACS test vectors; RCS is the fallback to the AES-NI implementation */
-		for (i = 0; i < RCS512_ROUNDKEY_SIZE; ++i)
-		{
-			ctx->roundkeys[i] = qsc_intutils_be8to32(tmpr + (i * sizeof(uint32_t)));
-		}
+		/* store the round keys as bit-planes */
+		rcs_bitslice_roundkeys(ctx->roundkeys, tmpr, ctx->rounds);
 #endif
 
 #if defined(QSC_RCS_AUTHENTICATED)
@@ -675,7 +3969,9 @@ static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keypa
 		qsc_cshake_squeezeblocks(&kstate, qsc_keccak_rate_512, sbuf, 1);
 		qsc_memutils_copy(mkey, sbuf, RCS512_MKEY_LENGTH);
 
-#	if defined(QSC_RCS_AUTH_KMACR12)
+#	if defined(QSC_RCS_KPA_AUTHENTICATION)
+		qsc_kpa_initialize(&ctx->kstate, mkey, sizeof(mkey), rcs_kpa_name, RCS_KPA_NAME_LENGTH);
+#	elif defined(QSC_RCS_AUTH_KMACR12)
 		qsc_keccak_initialize_state(&ctx->kstate);
 		qsc_keccak_absorb_key_custom(&ctx->kstate, qsc_keccak_rate_512, mkey, sizeof(mkey), NULL, 0, rcs_kmacr24_name, RCS_KMACR12_NAME_LENGTH, QSC_KECCAK_PERMUTATION_MIN_ROUNDS);
 #	else
@@ -687,93 +3983,302 @@ static void rcs_secure_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keypa
 	}
 
 #if defined(QSC_RCS_AESNI_ENABLED)
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-	/* store the avx-512 round keys */
-	qsc_memutils_clear((uint8_t*)ctx->roundkeysw, sizeof(ctx->roundkeysw));
-
-	for (i = 0; i < ctx->roundkeylen; i += 2)
+	/* store the round keys in the layout used by the selected kernel */
+	if (rcs_kernel_select()->loadkeys != NULL)
 	{
-		rcs_load2x128to512(&ctx->roundkeys[i], &ctx->roundkeys[i + 1], &ctx->roundkeysw[i / 2]);
+		rcs_kernel_select()->loadkeys(ctx);
 	}
+#endif
+}
+
+/* rcs common */
+
+void qsc_rcs_dispose(qsc_rcs_state* ctx)
+{
+	if (ctx != NULL)
+	{
+#if defined(QSC_RCS_KPA_AUTHENTICATION)
+		qsc_kpa_dispose(&ctx->kstate);
+#elif defined(QSC_RCS_AUTHENTICATED)
+		qsc_keccak_dispose(&ctx->kstate);
+#endif
+
+#if defined(QSC_RCS_AESNI_ENABLED)
+#	if defined(QSC_RCS_VAES512_ENABLED)
+		qsc_memutils_clear((uint8_t*)ctx->roundkeysw, sizeof(ctx->roundkeysw));
+#	endif
+#	if defined(QSC_RCS_VAES256_ENABLED) || defined(QSC_RCS_VPERM_ENABLED)
+		qsc_memutils_clear((uint8_t*)ctx->roundkeysy, sizeof(ctx->roundkeysy));
 #	endif
+#	if defined(QSC_RCS_BITSLICED_ENABLED)
+		qsc_memutils_clear((uint8_t*)ctx->roundkeysb, sizeof(ctx->roundkeysb));
+#	endif
+#endif
+
+		qsc_memutils_clear((uint8_t*)ctx->roundkeys, sizeof(ctx->roundkeys));
+		qsc_memutils_clear(ctx->nonce, sizeof(ctx->nonce));
+		qsc_memutils_clear(ctx->origin, sizeof(ctx->origin));
+		qsc_memutils_clear(ctx->kstream, sizeof(ctx->kstream));
+		ctx->kspos = 0;
+		ctx->pending = false;
+		ctx->counter = 0;
+		ctx->ctype = RCS256;
+		ctx->roundkeylen = 0;
+		ctx->rounds = 0;
+		ctx->encrypt = false;
+	}
+}
+
+static void rcs_state_expand(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keyparams, bool sector)
+{
+	ctx->ctype = keyparams->keylen == QSC_RCS512_KEY_SIZE ? RCS512 : RCS256;
+	qsc_memutils_clear((uint8_t*)ctx->roundkeys, sizeof(ctx->roundkeys));
+
+	if (ctx->ctype == RCS256)
+	{
+		/* initialize rcs state */
+		ctx->roundkeylen = RCS256_ROUNDKEY_SIZE;
+		ctx->rounds = 22;
+	}
+	else
+	{
+		/* initialize rcs state */
+		ctx->roundkeylen = RCS512_ROUNDKEY_SIZE;
+		ctx->rounds = 30;
+	}
+
+	/* generate the cipher and mac keys */
+	rcs_secure_expand(ctx, keyparams, sector);
+
+	/* no streamed message is pending */
+	rcs_stream_reset(ctx);
+}
+
+void qsc_rcs_initialize(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keyparams, bool encryption)
+{
+	assert(ctx != NULL);
+	assert(keyparams->nonce != NULL);
+	assert(keyparams->key != NULL);
+	assert(keyparams->keylen == QSC_RCS256_KEY_SIZE || keyparams->keylen == QSC_RCS512_KEY_SIZE);
+
+	rcs_state_expand(ctx, keyparams, false);
+	qsc_memutils_copy(ctx->nonce, keyparams->nonce, QSC_RCS_NONCE_SIZE);
+	qsc_memutils_copy(ctx->origin, keyparams->nonce, QSC_RCS_NONCE_SIZE);
+	ctx->counter = 1;
+	ctx->encrypt = encryption;
+}
+
+void qsc_rcs_key_dispose(qsc_rcs_key* key)
+{
+	if (key != NULL)
+	{
+		qsc_rcs_dispose(&key->state);
+	}
+}
+
+void qsc_rcs_key_expand(qsc_rcs_key* key, const qsc_rcs_keyparams* keyparams)
+{
+	assert(key != NULL);
+	assert(keyparams->key != NULL);
+	assert(keyparams->keylen == QSC_RCS256_KEY_SIZE || keyparams->keylen == QSC_RCS512_KEY_SIZE);
+
+	rcs_state_expand(&key->state, keyparams, false);
+	qsc_memutils_clear(key->state.nonce, QSC_RCS_NONCE_SIZE);
+	qsc_memutils_clear(key->state.origin, QSC_RCS_NONCE_SIZE);
+	key->state.counter = 0;
+	key->state.encrypt = false;
+}
+
+void qsc_rcs_stream_initialize(qsc_rcs_state* ctx, const qsc_rcs_key* key, const uint8_t* nonce, bool encryption)
+{
+	assert(ctx != NULL);
+	assert(key != NULL);
+	assert(nonce != NULL);
+
+	/* clone the round-keys and the keyed mac state */
+	qsc_memutils_copy(ctx, &key->state, sizeof(qsc_rcs_state));
+	qsc_memutils_copy(ctx->nonce, nonce, QSC_RCS_NONCE_SIZE);
+	qsc_memutils_copy(ctx->origin, nonce, QSC_RCS_NONCE_SIZE);
+	ctx->counter = 1;
+	ctx->encrypt = encryption;
+}
+
+void qsc_rcs_nonce_derive(uint8_t* nonce, const uint8_t* base, uint64_t index, size_t offset)
+{
+	assert(nonce != NULL);
+	assert(base != NULL);
+	assert(offset >= sizeof(uint64_t) && offset + sizeof(uint64_t) <= QSC_RCS_NONCE_SIZE);
+
+	size_t i;
+
+	if (nonce != base)
+	{
+		qsc_memutils_copy(nonce, base, QSC_RCS_NONCE_SIZE);
+	}
+
+	/* the low 64 bits are the block counter of the derived stream, and start at zero */
+	qsc_memutils_clear(nonce, sizeof(uint64_t));
+
+	for (i = 0; i < sizeof(uint64_t); ++i)
+	{
+		nonce[offset + i] ^= (uint8_t)(index >> (i * 8));
+	}
+}
+
+void qsc_rcs_set_associated(qsc_rcs_state* ctx, const uint8_t* data, size_t length)
+{
+	assert(ctx != NULL);
+	assert(data != NULL);
+	assert(length != 0);
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	if (length != 0)
+	{
+		uint8_t code[sizeof(uint32_t)] = { 0 };
+
+		/* add the ad data to the hash */
+		rcs_mac_update(ctx, data, length);
+		/* add the length of the ad */
+		qsc_intutils_le32to8(code, (uint32_t)length);
+		rcs_mac_update(ctx, code, sizeof(code));
+	}
+#else
+	/* the mac is not keyed without authentication, the ad is not used */
+	(void)ctx;
+	(void)data;
+	(void)length;
+#endif
+}
+
+bool qsc_rcs_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+	assert(input != NULL);
+
+	bool res;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+
+	res = false;
+
+	/* update the processed bytes counter */
+	ctx->counter += length;
+
+	/* update the mac with the current nonce position */
+	rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
+
+	if (ctx->encrypt)
+	{
+		/* transform the plain-text with the counter-mode cipher, and update the mac with the cipher-text */
+		rcs_ctr_mac_transform(ctx, output, input, length);
+
+		/* mac the cipher-text appending the code to the end of the array */
+		rcs_mac_finalize(ctx, output + length);
+		res = true;
+	}
+	else
+	{
+		/* authenticate the cipher-text, and decrypt it if the mac check succeeds */
+		res = rcs_authenticated_decrypt(ctx, output, input, length);
+	}
+
+#else
+
+	rcs_ctr_transform(ctx, output, input, length);
+	res = true;
+
 #endif
+
+	return res;
 }
 
-/* rcs common */
+bool qsc_rcs_extended_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length, bool finalize)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+	assert(input != NULL);
+
+	bool res;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+
+	res = false;
+
+	/* update the processed bytes counter */
+	ctx->counter += length;
+
+	/* update the mac with the current nonce position */
+	rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
+
+	if (ctx->encrypt == true)
+	{
+		/* transform the plain-text with the counter-mode cipher, and update the mac with the cipher-text */
+		rcs_ctr_mac_transform(ctx, output, input, length);
+
+		if (finalize == true)
+		{
+			/* mac the cipher-text appending the code to the end of the array */
+			rcs_mac_finalize(ctx, output + length);
+		}
+
+		res = true;
+	}
+	else
+	{
+		if (finalize == true)
+		{
+			/* authenticate the cipher-text, and decrypt it if the mac check succeeds */
+			res = rcs_authenticated_decrypt(ctx, output, input, length);
+		}
+		else
+		{
+			/* update the mac with the cipher-text, and transform it with the counter-mode cipher */
+			rcs_mac_ctr_transform(ctx, output, input, length);
+			res = true;
+		}
+	}
+
+#else
 
-void qsc_rcs_dispose(qsc_rcs_state* ctx)
-{
-	if (ctx != NULL)
-	{
-#if defined(QSC_RCS_AUTHENTICATED)
-		qsc_keccak_dispose(&ctx->kstate);
-#endif
+	rcs_ctr_transform(ctx, output, input, length);
+	res = true;
 
-#if defined(QSC_RCS_AESNI_ENABLED)
-#	if defined(QSC_SYSTEM_HAS_AVX512)
-		qsc_memutils_clear((uint8_t*)ctx->roundkeysw, sizeof(ctx->roundkeysw));
-#	endif
 #endif
 
-		qsc_memutils_clear((uint8_t*)ctx->roundkeys, sizeof(ctx->roundkeys));
-		qsc_memutils_clear(ctx->nonce, sizeof(ctx->nonce));
-		ctx->counter = 0;
-		ctx->ctype = RCS256;
-		ctx->roundkeylen = 0;
-		ctx->rounds = 0;
-		ctx->encrypt = false;
-	}
+	return res;
 }
 
-void qsc_rcs_initialize(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keyparams, bool encryption)
+void qsc_rcs_seek(qsc_rcs_state* ctx, uint64_t block)
 {
 	assert(ctx != NULL);
-	assert(keyparams->nonce != NULL);
-	assert(keyparams->key != NULL);
-	assert(keyparams->keylen == QSC_RCS256_KEY_SIZE || keyparams->keylen == QSC_RCS512_KEY_SIZE);
 
-	ctx->ctype = keyparams->keylen == QSC_RCS512_KEY_SIZE ? RCS512 : RCS256;
-	qsc_memutils_clear((uint8_t*)ctx->roundkeys, sizeof(ctx->roundkeys));
-	qsc_memutils_copy(ctx->nonce, keyparams->nonce, QSC_RCS_NONCE_SIZE);
-	ctx->counter = 1;
-	ctx->encrypt = encryption;
+	rcs_nonce_add(ctx->nonce, ctx->origin, block);
+	/* the key-stream left over from the previous position is discarded, the next update starts on the block boundary */
+	qsc_memutils_clear(ctx->kstream, sizeof(ctx->kstream));
+	ctx->kspos = QSC_RCS_BLOCK_SIZE;
+}
 
-	if (ctx->ctype == RCS256)
-	{
-		/* initialize rcs state */
-		ctx->roundkeylen = RCS256_ROUNDKEY_SIZE;
-		ctx->rounds = 22;
-	}
-	else
-	{
-		/* initialize rcs state */
-		ctx->roundkeylen = RCS512_ROUNDKEY_SIZE;
-		ctx->rounds = 30;
-	}
+void qsc_rcs_keystream_range(const qsc_rcs_state* ctx, uint8_t* output, uint64_t offset, size_t length)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
 
-	/* generate the cipher and mac keys */
-	rcs_secure_expand(ctx, keyparams);
+	/* the key-stream is the transform of a zeroed array */
+	qsc_memutils_clear(output, length);
+	rcs_range_transform(ctx, output, output, offset, length);
 }
 
-void qsc_rcs_set_associated(qsc_rcs_state* ctx, const uint8_t* data, size_t length)
+void qsc_rcs_range_transform(const qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, uint64_t offset, size_t length)
 {
 	assert(ctx != NULL);
-	assert(data != NULL);
-	assert(length != 0);
-
-	if (length != 0)
-	{
-		uint8_t code[sizeof(uint32_t)] = { 0 };
+	assert(output != NULL);
+	assert(input != NULL);
 
-		/* add the ad data to the hash */
-		rcs_mac_update(ctx, data, length);
-		/* add the length of the ad */
-		qsc_intutils_le32to8(code, (uint32_t)length);
-		rcs_mac_update(ctx, code, sizeof(code));
-	}
+	rcs_range_transform(ctx, output, input, offset, length);
 }
 
-bool qsc_rcs_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+bool qsc_rcs_parallel_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
 {
 	assert(ctx != NULL);
 	assert(output != NULL);
@@ -793,10 +4298,8 @@ bool qsc_rcs_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input
 
 	if (ctx->encrypt)
 	{
-		/* transform the plain-text with the counter-mode cipher */
-		rcs_ctr_transform(ctx, output, input, length);
-
-		/* update the mac with the cipher-text */
+		/* generate the key-stream on all cores, then update the mac with the cipher-text */
+		rcs_ctr_transform_parallel(ctx, output, input, length);
 		rcs_mac_update(ctx, output, length);
 
 		/* mac the cipher-text appending the code to the end of the array */
@@ -805,41 +4308,24 @@ bool qsc_rcs_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input
 	}
 	else
 	{
-		/* update the mac with the cipher-text */
-		rcs_mac_update(ctx, input, length);
-
-		if (ctx->ctype == RCS256)
-		{
-			uint8_t code[QSC_RCS256_MAC_SIZE] = { 0 };
+		uint8_t code[QSC_RCS512_MAC_SIZE] = { 0 };
+		const size_t MACLEN = (ctx->ctype == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
 
-			/* mac the cipher-text to a temp array for comparison */
-			rcs_mac_finalize(ctx, code);
+		/* mac the cipher-text to a temp array for comparison */
+		rcs_mac_update(ctx, input, length);
+		rcs_mac_finalize(ctx, code);
 
-			/* test the mac for equality, bypassing the transform if the mac check fails */
-			if (qsc_intutils_verify(code, input + length, QSC_RCS256_MAC_SIZE) == 0)
-			{
-				/* transform the plain-text with the counter-mode cipher */
-				rcs_ctr_transform(ctx, output, input, length);
-				res = true;
-			}
-		}
-		else
+		/* test the mac for equality, bypassing the transform if the mac check fails */
+		if (qsc_intutils_verify(code, input + length, MACLEN) == 0)
 		{
-			uint8_t code[QSC_RCS512_MAC_SIZE] = { 0 };
-
-			rcs_mac_finalize(ctx, code);
-
-			if (qsc_intutils_verify(code, input + length, QSC_RCS512_MAC_SIZE) == 0)
-			{
-				rcs_ctr_transform(ctx, output, input, length);
-				res = true;
-			}
+			rcs_ctr_transform_parallel(ctx, output, input, length);
+			res = true;
 		}
 	}
 
 #else
 
-	rcs_ctr_transform(ctx, output, input, length);
+	rcs_ctr_transform_parallel(ctx, output, input, length);
 	res = true;
 
 #endif
@@ -847,89 +4333,294 @@ bool qsc_rcs_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input
 	return res;
 }
 
-bool qsc_rcs_extended_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length, bool finalize)
+bool qsc_rcs_transform_batch(qsc_rcs_state* ctxs[], uint8_t* outputs[], const uint8_t* inputs[], const size_t lengths[], bool results[], size_t count)
+{
+	assert(ctxs != NULL);
+	assert(outputs != NULL);
+	assert(inputs != NULL);
+	assert(lengths != NULL);
+
+	return rcs_transform_batches(ctxs, outputs, inputs, lengths, NULL, results, count);
+}
+
+bool qsc_rcs_transform_batch_detached(qsc_rcs_state* ctxs[], uint8_t* outputs[], const uint8_t* inputs[], const size_t lengths[], uint8_t* tags[], bool results[], size_t count)
+{
+	assert(ctxs != NULL);
+	assert(outputs != NULL);
+	assert(inputs != NULL);
+	assert(lengths != NULL);
+	assert(tags != NULL);
+
+	return rcs_transform_batches(ctxs, outputs, inputs, lengths, tags, results, count);
+}
+
+bool qsc_rcs_encrypt_vector(qsc_rcs_state* ctx, const qsc_rcs_iovec* output, size_t outcount, const qsc_rcs_iovec* input, size_t incount, uint8_t* tag)
 {
 	assert(ctx != NULL);
-	assert(output != NULL);
-	assert(input != NULL);
+	assert(output != NULL || outcount == 0);
+	assert(input != NULL || incount == 0);
 
+	const size_t MLEN = rcs_vector_length(input, incount);
 	bool res;
 
+	res = false;
+
+	if (MLEN == rcs_vector_length(output, outcount))
+	{
 #if defined(QSC_RCS_AUTHENTICATED)
+		assert(tag != NULL);
 
-	res = false;
+		/* update the processed bytes counter */
+		ctx->counter += MLEN;
 
-	/* update the processed bytes counter */
-	ctx->counter += length;
+		/* update the mac with the current nonce position */
+		rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
 
-	/* update the mac with the current nonce position */
-	rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
+		/* encrypt the fragments, and update the mac with each cipher-text fragment */
+		rcs_vector_transform(ctx, output, outcount, input, incount, false, true);
 
-	if (ctx->encrypt == true)
+		/* mac the cipher-text, writing the code to the tag array */
+		rcs_mac_finalize(ctx, tag);
+#else
+		(void)tag;
+		rcs_vector_transform(ctx, output, outcount, input, incount, false, false);
+#endif
+		res = true;
+	}
+
+	return res;
+}
+
+bool qsc_rcs_decrypt_vector(qsc_rcs_state* ctx, const qsc_rcs_iovec* output, size_t outcount, const qsc_rcs_iovec* input, size_t incount, const uint8_t* tag)
+{
+	assert(ctx != NULL);
+	assert(output != NULL || outcount == 0);
+	assert(input != NULL || incount == 0);
+
+	const size_t MLEN = rcs_vector_length(input, incount);
+	bool res;
+
+	res = false;
+
+	if (MLEN == rcs_vector_length(output, outcount))
 	{
-		/* transform the plain-text with the counter-mode cipher */
-		rcs_ctr_transform(ctx, output, input, length);
+#if defined(QSC_RCS_AUTHENTICATED)
+		uint8_t code[QSC_RCS512_MAC_SIZE] = { 0 };
+		const size_t MACLEN = (ctx->ctype == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+		size_t i;
 
-		/* update the mac with the cipher-text */
-		rcs_mac_update(ctx, output, length);
+		assert(tag != NULL);
 
-		if (finalize == true)
+		/* update the processed bytes counter */
+		ctx->counter += MLEN;
+
+		/* update the mac with the current nonce position */
+		rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
+
+#	if defined(QSC_RCS_FUSED_DECRYPTION)
+		/* authenticate and decrypt the fragments in a single pass */
+		rcs_vector_transform(ctx, output, outcount, input, incount, true, false);
+		rcs_mac_finalize(ctx, code);
+
+		/* test the mac for equality, erasing the plain-text if the mac check fails */
+		if (qsc_intutils_verify(code, tag, MACLEN) == 0)
 		{
-			/* mac the cipher-text appending the code to the end of the array */
-			rcs_mac_finalize(ctx, output + length);
+			res = true;
+		}
+		else
+		{
+			for (i = 0; i < outcount; ++i)
+			{
+				qsc_memutils_clear(output[i].buffer, output[i].length);
+			}
+		}
+#	else
+		/* update the mac with each cipher-text fragment */
+		for (i = 0; i < incount; ++i)
+		{
+			rcs_mac_update(ctx, input[i].buffer, input[i].length);
+		}
+
+		rcs_mac_finalize(ctx, code);
+
+		/* test the mac for equality, bypassing the transform if the mac check fails */
+		if (qsc_intutils_verify(code, tag, MACLEN) == 0)
+		{
+			rcs_vector_transform(ctx, output, outcount, input, incount, false, false);
+			res = true;
 		}
+#	endif
 
+		qsc_memutils_clear(code, sizeof(code));
+#else
+		(void)tag;
+		rcs_vector_transform(ctx, output, outcount, input, incount, false, false);
 		res = true;
+#endif
+	}
+
+	return res;
+}
+
+void qsc_rcs_update(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length)
+{
+	assert(ctx != NULL);
+	assert(output != NULL || length == 0);
+	assert(input != NULL || length == 0);
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	if (ctx->pending == false)
+	{
+		/* update the mac with the nonce position of the message */
+		rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
+		ctx->pending = true;
+	}
+
+	/* update the processed bytes counter */
+	ctx->counter += length;
+
+	if (ctx->encrypt == true)
+	{
+		rcs_stream_transform(ctx, output, input, length);
+		rcs_mac_update(ctx, output, length);
 	}
 	else
 	{
-		/* update the mac with the cipher-text */
+		/* the mac absorbs the cipher-text first, so the arrays can overlap */
 		rcs_mac_update(ctx, input, length);
+		rcs_stream_transform(ctx, output, input, length);
+	}
+#else
+	rcs_stream_transform(ctx, output, input, length);
+#endif
+}
 
-		if (finalize == true)
-		{
-			if (ctx->ctype == RCS256)
-			{
-				uint8_t code[QSC_RCS256_MAC_SIZE] = { 0 };
+void qsc_rcs_encrypt_final(qsc_rcs_state* ctx, uint8_t* tag)
+{
+	assert(ctx != NULL);
 
-				/* mac the cipher-text to a temp array for comparison */
-				rcs_mac_finalize(ctx, code);
+#if defined(QSC_RCS_AUTHENTICATED)
+	assert(tag != NULL);
 
-				/* test the mac for equality, bypassing the transform if the mac check fails */
-				if (qsc_intutils_verify(code, input + length, QSC_RCS256_MAC_SIZE) == 0)
-				{
-					/* transform the plain-text with the counter-mode cipher */
-					rcs_ctr_transform(ctx, output, input, length);
-					res = true;
-				}
-			}
-			else
-			{
-				uint8_t code[QSC_RCS512_MAC_SIZE] = { 0 };
+	if (ctx->pending == false)
+	{
+		/* an empty message */
+		rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
+	}
 
-				rcs_mac_finalize(ctx, code);
+	/* mac the cipher-text, writing the code to the tag array */
+	rcs_mac_finalize(ctx, tag);
+#else
+	(void)tag;
+#endif
 
-				if (qsc_intutils_verify(code, input + length, QSC_RCS512_MAC_SIZE) == 0)
-				{
-					rcs_ctr_transform(ctx, output, input, length);
-					res = true;
-				}
-			}
-		}
-		else
-		{
-			/* transform the plain-text with the counter-mode cipher */
-			rcs_ctr_transform(ctx, output, input, length);
-			res = true;
-		}
+	rcs_stream_reset(ctx);
+}
+
+bool qsc_rcs_decrypt_final(qsc_rcs_state* ctx, const uint8_t* tag)
+{
+	assert(ctx != NULL);
+
+	bool res;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	uint8_t code[QSC_RCS512_MAC_SIZE] = { 0 };
+	const size_t MACLEN = (ctx->ctype == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+
+	assert(tag != NULL);
+
+	if (ctx->pending == false)
+	{
+		/* an empty message */
+		rcs_mac_update(ctx, ctx->nonce, QSC_RCS_BLOCK_SIZE);
 	}
 
+	/* mac the cipher-text to a temp array, and test it for equality with the expected code */
+	rcs_mac_finalize(ctx, code);
+	res = (qsc_intutils_verify(code, tag, MACLEN) == 0);
+	qsc_memutils_clear(code, sizeof(code));
 #else
-
-	rcs_ctr_transform(ctx, output, input, length);
+	(void)tag;
 	res = true;
+#endif
+
+	rcs_stream_reset(ctx);
+
+	return res;
+}
+
+void qsc_rcs_sector_key_dispose(qsc_rcs_sector_key* key)
+{
+	if (key != NULL)
+	{
+		qsc_rcs_dispose(&key->state);
+
+#if defined(QSC_RCS_AESNI_ENABLED)
+		qsc_memutils_clear((uint8_t*)key->invkeys, sizeof(key->invkeys));
+#	if defined(QSC_RCS_VAES512_ENABLED)
+		qsc_memutils_clear((uint8_t*)key->invkeysw, sizeof(key->invkeysw));
+#	endif
+#endif
+	}
+}
+
+void qsc_rcs_sector_key_expand(qsc_rcs_sector_key* key, const qsc_rcs_keyparams* keyparams)
+{
+	assert(key != NULL);
+	assert(keyparams->key != NULL);
+	assert(keyparams->keylen == QSC_RCS256_KEY_SIZE || keyparams->keylen == QSC_RCS512_KEY_SIZE);
+
+	rcs_state_expand(&key->state, keyparams, true);
+	qsc_memutils_clear(key->state.nonce, QSC_RCS_NONCE_SIZE);
+	qsc_memutils_clear(key->state.origin, QSC_RCS_NONCE_SIZE);
+	key->state.counter = 0;
+	key->state.encrypt = false;
 
+#if defined(QSC_RCS_AESNI_ENABLED)
+	qsc_memutils_clear((uint8_t*)key->invkeys, sizeof(key->invkeys));
+
+	/* store the decryption round-keys in the layout used by the selected kernel */
+	if (rcs_kernel_select()->loadinverse != NULL)
+	{
+		rcs_kernel_select()->loadinverse(key);
+	}
 #endif
+}
+
+bool qsc_rcs_sector_encrypt(const qsc_rcs_sector_key* key, uint8_t* output, const uint8_t* input, uint64_t sector, size_t sectorlen, size_t count)
+{
+	assert(key != NULL);
+	assert(output != NULL);
+	assert(input != NULL);
+
+	bool res;
+
+	res = false;
+
+	if (sectorlen != 0 && sectorlen % QSC_RCS_BLOCK_SIZE == 0)
+	{
+		rcs_sector_transform(key, output, input, sector, sectorlen, count, true);
+		res = true;
+	}
+
+	return res;
+}
+
+bool qsc_rcs_sector_decrypt(const qsc_rcs_sector_key* key, uint8_t* output, const uint8_t* input, uint64_t sector, size_t sectorlen, size_t count)
+{
+	assert(key != NULL);
+	assert(output != NULL);
+	assert(input != NULL);
+
+	bool res;
+
+	res = false;
+
+	if (sectorlen != 0 && sectorlen % QSC_RCS_BLOCK_SIZE == 0)
+	{
+		rcs_sector_transform(key, output, input, sector, sectorlen, count, false);
+		res = true;
+	}
 
 	return res;
 }
@@ -110,6 +110,10 @@
 * The qsc_rcs_set_associated(state,in,inlen) function can be used to add additional data to the MAC generators input, like packet-header data, or a custom code or counter.
 *
 * \par
+* For disk-style encryption, where the cipher-text must fit in the space of the plain-text, the qsc_rcs_sector_encrypt and qsc_rcs_sector_decrypt functions
+* provide a length-preserving, tweakable, unauthenticated mode on the same Rijndael-256 rounds, using inverse-cipher kernels for decryption.
+*
+* \par
 * This implementation has both a C reference code, and an implementation that uses the AES-NI instructions that are used in the AES and RCS cipher variants. \n
 * The AES-NI implementation can be enabled by adding the QSC_RCS_AESNI_ENABLED constant to your preprocessor definitions. \n
 * The RCS-256, RCS-512, known answer vectors are taken from the CEX++ cryptographic library <a href="https://github.com/Steppenwolfe65/CEX">The CEX++ Cryptographic Library</a>. \n
@@ -117,8 +121,6 @@
 * To enable the AES-NI implementation, uncomment the definition in this file or add QSC_RCS_AESNI_ENABLED or add it to the compiler preprocessor definitions. \n
 */
 
-/* TODO: Test KPA on small block AVX2 */
-
 #include "common.h"
 #include "sha3.h"
 
@@ -144,6 +146,23 @@
 #	define QSC_RCS_AUTH_KMACR12
 #endif
 
+/*!
+\def QSC_RCS_KPA_AUTHENTICATION
+* \brief Enables the Keccak-based Parallel Authentication (KPA) MAC.
+* Unrem this flag to authenticate with KPA-R12 instead of KMAC; KPA absorbs eight rate blocks in parallel,
+* using the AVX2 or AVX-512 Keccak permutations if they are enabled. This setting takes precedence over QSC_RCS_AUTH_KMACR12.
+*/
+//#define QSC_RCS_KPA_AUTHENTICATION
+
+/*!
+\def QSC_RCS_FUSED_DECRYPTION
+* \brief Enables the single-pass authenticated decryption mode.
+* Unrem this flag to authenticate and decrypt the cipher-text in one pass of cache-sized tiles.
+* The plain-text is written to the output array before the MAC code is checked;
+* if authentication fails, the output array is erased, and the transform returns false.
+*/
+//#define QSC_RCS_FUSED_DECRYPTION
+
 /*!
 * \def QSC_RCS_AESNI_ENABLED
 * \brief Enable the use of intrinsics and the AES-NI implementation.
@@ -162,6 +181,38 @@
 #	include <immintrin.h>
 #endif
 
+/*!
+* \def QSC_RCS_VAES512_ENABLED
+* \brief The AVX-512 VAES kernel is compiled; it is selected at runtime, or by the compiler flags if runtime dispatch is disabled.
+*/
+#if defined(QSC_RCS_AESNI_ENABLED) && (defined(QSC_SYSTEM_RUNTIME_DISPATCH) || defined(QSC_SYSTEM_HAS_AVX512))
+#	define QSC_RCS_VAES512_ENABLED
+#endif
+
+/*!
+* \def QSC_RCS_VAES256_ENABLED
+* \brief The AVX2 VAES kernel is compiled; it is selected at runtime, or by the compiler flags if runtime dispatch is disabled.
+*/
+#if defined(QSC_RCS_AESNI_ENABLED) && (defined(QSC_SYSTEM_RUNTIME_DISPATCH) || (defined(QSC_SYSTEM_HAS_AVX2) && defined(QSC_SYSTEM_HAS_VAES) && !defined(QSC_SYSTEM_HAS_AVX512)))
+#	define QSC_RCS_VAES256_ENABLED
+#endif
+
+/*!
+* \def QSC_RCS_VPERM_ENABLED
+* \brief The SSSE3 and AVX2 vector-permute kernels are compiled; they are selected at runtime on processors without AES-NI.
+*/
+#if defined(QSC_RCS_AESNI_ENABLED) && defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+#	define QSC_RCS_VPERM_ENABLED
+#endif
+
+/*!
+* \def QSC_RCS_BITSLICED_ENABLED
+* \brief The constant-time bitsliced kernel is compiled; it is the only kernel when AES-NI is disabled, and the runtime fallback on processors without AES-NI.
+*/
+#if !defined(QSC_RCS_AESNI_ENABLED) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+#	define QSC_RCS_BITSLICED_ENABLED
+#endif
+
 /*!
 * \def QSC_RCS_BLOCK_SIZE
 * \brief The internal block size in bytes, required by the encryption and decryption functions.
@@ -233,11 +284,17 @@ QSC_EXPORT_API typedef struct
 	rcs_cipher_type ctype;				/*!< The cipher type; RCS-256 or RCS-512 */
 #if defined(QSC_RCS_AESNI_ENABLED)
 	__m128i roundkeys[62];				/*!< The 128-bit integer round-key array */
-#	if defined(QSC_SYSTEM_HAS_AVX512)
+#	if defined(QSC_RCS_VAES512_ENABLED)
 		__m512i roundkeysw[31];			/*!< The 512-bit integer round-key array */
 #	endif
+#	if defined(QSC_RCS_VAES256_ENABLED) || defined(QSC_RCS_VPERM_ENABLED)
+		__m256i roundkeysy[31];			/*!< The 256-bit integer round-key array, shared by the AVX2 and vector-permute kernels */
+#	endif
+#	if defined(QSC_RCS_BITSLICED_ENABLED)
+		uint64_t roundkeysb[248];		/*!< The bitsliced round-key array */
+#	endif
 #else
-	uint32_t roundkeys[248];			/*!< The round-keys 32-bit subkey array */
+	uint64_t roundkeys[248];			/*!< The bitsliced round-key array */
 #endif
 	size_t roundkeylen;					/*!< The round-key array length */
 	size_t rounds;						/*!< The number of transformation rounds */
@@ -247,10 +304,51 @@ QSC_EXPORT_API typedef struct
 	qsc_keccak_state kstate;			/*!< The keccak state structure */
 #endif
 	uint8_t nonce[QSC_RCS_NONCE_SIZE];	/*!< The nonce or initialization vector */
+	uint8_t origin[QSC_RCS_NONCE_SIZE];	/*!< The initial nonce, block zero of the key-stream */
+	uint8_t kstream[QSC_RCS_BLOCK_SIZE];	/*!< The unused key-stream of a partial block, carried between streaming updates */
+	size_t kspos;						/*!< The position of the next unused byte in the key-stream buffer */
+	bool pending;						/*!< A streamed message has been started, and not yet finalized */
 	uint64_t counter;					/*!< the processed bytes counter */
 	bool encrypt;						/*!< the transformation mode; true for encryption */
 } qsc_rcs_state;
 
+/*!
+* \struct qsc_rcs_key
+* \brief An expanded cipher key; the round-key arrays and the keyed MAC state.
+* The key is expanded once, and is then used to initialize any number of streams with different nonces.
+* Stream initialization only reads the key, so one key can be shared by several threads.
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_state state;				/*!< The expanded state template; the nonce and counters are unset */
+} qsc_rcs_key;
+
+/*!
+* \struct qsc_rcs_sector_key
+* \brief An expanded key for the length-preserving sector mode; the cipher round-keys, and the inverse round-keys used by the decryption kernels.
+* The sector functions only read the key, so one key can be shared by several threads.
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_state state;				/*!< The expanded cipher state; only the round-keys are used */
+#if defined(QSC_RCS_AESNI_ENABLED)
+	__m128i invkeys[62];				/*!< The 128-bit inverse round-key array, in decryption order */
+#	if defined(QSC_RCS_VAES512_ENABLED)
+		__m512i invkeysw[31];			/*!< The 512-bit inverse round-key array, in decryption order */
+#	endif
+#endif
+} qsc_rcs_sector_key;
+
+/*!
+* \struct qsc_rcs_iovec
+* \brief A fragment of a scattered message, used by the vectored transform functions.
+*/
+QSC_EXPORT_API typedef struct
+{
+	uint8_t* buffer;					/*!< A pointer to the fragment */
+	size_t length;						/*!< The length of the fragment in bytes */
+} qsc_rcs_iovec;
+
 /* public functions */
 
 /**
@@ -272,6 +370,48 @@ QSC_EXPORT_API void qsc_rcs_dispose(qsc_rcs_state* ctx);
 */
 QSC_EXPORT_API void qsc_rcs_initialize(qsc_rcs_state* ctx, const qsc_rcs_keyparams* keyparams, bool encryption);
 
+/**
+* \brief Dispose of an expanded cipher key.
+*
+* \param key: [struct] The expanded key structure
+*/
+QSC_EXPORT_API void qsc_rcs_key_dispose(qsc_rcs_key* key);
+
+/**
+* \brief Expand the input cipher-key and optional info tweak into a reusable key structure.
+* This runs the cSHAKE key schedule and keys the MAC; the nonce member of the key parameters is not used.
+*
+* \param key: [struct] The expanded key structure
+* \param keyparams: [const][struct] The secret input cipher-key and info structure
+*/
+QSC_EXPORT_API void qsc_rcs_key_expand(qsc_rcs_key* key, const qsc_rcs_keyparams* keyparams);
+
+/**
+* \brief Initialize a stream from an expanded key and a nonce.
+* The state is a copy of the expanded key, so no key schedule is run;
+* the output is identical to that of a state initialized with qsc_rcs_initialize using the same key, info and nonce.
+*
+* \param ctx: [struct] The cipher state structure
+* \param key: [const][struct] The expanded key structure
+* \param nonce: [const] The nonce, an array of QSC_RCS_NONCE_SIZE bytes
+* \param encryption: Initialize the cipher for encryption, or false for decryption mode
+*/
+QSC_EXPORT_API void qsc_rcs_stream_initialize(qsc_rcs_state* ctx, const qsc_rcs_key* key, const uint8_t* nonce, bool encryption);
+
+/**
+* \brief Derive the nonce of one stream from a base nonce and a 64-bit index.
+* The low 64 bits of the derived nonce are the block counter of the stream, and start at zero;
+* the index is added, little-endian, to the upper bits of the base nonce at a byte offset.
+* Streams with distinct indices at the same offset never share a counter block.
+* A second index can be added by passing the derived nonce as the base, with another offset.
+*
+* \param nonce: The derived nonce, an array of QSC_RCS_NONCE_SIZE bytes
+* \param base: [const] The base nonce, an array of QSC_RCS_NONCE_SIZE bytes; can be the nonce array
+* \param index: The stream index, such as a segment, record, or sector number
+* \param offset: The byte offset of the index; at least 8, and at most QSC_RCS_NONCE_SIZE - 8
+*/
+QSC_EXPORT_API void qsc_rcs_nonce_derive(uint8_t* nonce, const uint8_t* base, uint64_t index, size_t offset);
+
 /**
 * \brief Set the associated data string used in authenticating the message.
 * The associated data may be packet header information, domain specific data, or a secret shared by a group.
@@ -291,6 +431,8 @@ QSC_EXPORT_API void qsc_rcs_set_associated(qsc_rcs_state* ctx, const uint8_t* da
 * In encryption mode, the input plain-text is encrypted and then an authentication MAC code is appended to the ciphertext.
 * In decryption mode, the input cipher-text is authenticated internally and compared to the mac code appended to the cipher-text,
 * if the codes to not match, the cipher-text is not decrypted and the call fails.
+* If QSC_RCS_FUSED_DECRYPTION is defined, authentication and decryption run in a single pass,
+* and on failure the output array is erased.
 *
 * \warning The cipher must be initialized before this function can be called
 *
@@ -312,6 +454,9 @@ QSC_EXPORT_API bool qsc_rcs_transform(qsc_rcs_state* ctx, uint8_t* output, const
 * In encryption mode, the input plain-text is encrypted, then authenticated, and the MAC code is appended to the cipher-text.
 * In decryption mode, the input cipher-text is authenticated internally and compared to the MAC code appended to the cipher-text,
 * if the codes to not match, the cipher-text is not decrypted and the call fails.
+* If QSC_RCS_FUSED_DECRYPTION is defined, the final call erases its output array on authentication failure.
+* Each call binds the nonce to the MAC and starts a new key-stream block, so the output depends on how the input is split;
+* use qsc_rcs_update when the pieces have arbitrary sizes.
 *
 * \warning The cipher must be initialized before this function can be called
 *
@@ -325,4 +470,234 @@ QSC_EXPORT_API bool qsc_rcs_transform(qsc_rcs_state* ctx, uint8_t* output, const
 */
 QSC_EXPORT_API bool qsc_rcs_extended_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length, bool finalize);
 
+/**
+* \brief Set the counter position of the key-stream to a block index.
+* The nonce is set to the initial nonce plus the block index, using 256-bit little-endian arithmetic,
+* the next transform starts at byte offset (block * QSC_RCS_BLOCK_SIZE) of the stream.
+* The unused key-stream of a streamed partial block is discarded, so a following qsc_rcs_update starts on the block boundary.
+* Seeking does not change the MAC state; a code generated after a seek does not authenticate the whole stream.
+*
+* \warning The cipher must be initialized before this function can be called
+*
+* \param ctx: [struct] The cipher state structure
+* \param block: The block index, relative to the initial nonce
+*/
+QSC_EXPORT_API void qsc_rcs_seek(qsc_rcs_state* ctx, uint64_t block);
+
+/**
+* \brief Generate the key-stream for a byte range of the stream.
+* The range starts at any byte offset; the state is only read, so one initialized state can be shared by threads generating different ranges.
+*
+* \warning The cipher must be initialized before this function can be called
+*
+* \param ctx: [struct] The cipher state structure
+* \param output: A pointer to the key-stream output array
+* \param offset: The byte offset of the range, relative to the initial nonce
+* \param length: The number of key-stream bytes to generate
+*/
+QSC_EXPORT_API void qsc_rcs_keystream_range(const qsc_rcs_state* ctx, uint8_t* output, uint64_t offset, size_t length);
+
+/**
+* \brief Transform a byte range of the stream without authentication.
+* Used to decrypt an arbitrary range of a large cipher-text; the input is the cipher-text of the range only,
+* without the MAC code. The state is only read, so one initialized state can be shared by threads transforming different ranges.
+*
+* \warning The cipher must be initialized before this function can be called,
+* the cipher-text must be authenticated separately if required.
+*
+* \param ctx: [struct] The cipher state structure
+* \param output: A pointer to the output array
+* \param input: [const] A pointer to the input array
+* \param offset: The byte offset of the range, relative to the initial nonce
+* \param length: The number of bytes to transform
+*/
+QSC_EXPORT_API void qsc_rcs_range_transform(const qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, uint64_t offset, size_t length);
+
+/**
+* \brief Transform a large array of bytes, splitting the counter-mode key-stream between threads.
+* The input is divided into counter-aligned segments, one for each processor core,
+* and each worker thread transforms its segment with a copy of the round-keys and its own starting nonce.
+* The cipher-text and MAC code are identical to those of qsc_rcs_transform, which is used for inputs smaller than 1MB.
+* In authenticated mode the MAC is computed on the calling thread, after the key-stream stage on encryption,
+* and before it on decryption.
+*
+* \warning The cipher must be initialized before this function can be called
+*
+* \param ctx: [struct] The cipher state structure
+* \param output: A pointer to the output array
+* \param input: [const] A pointer to the input array
+* \param length: The number of bytes to transform
+*
+* \return: Returns true if the cipher has been transformed the data successfully, false on failure
+*/
+QSC_EXPORT_API bool qsc_rcs_parallel_transform(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length);
+
+/**
+* \brief Transform a batch of short messages, each with its own independent cipher state.
+* On CPUs with AES-NI but without VAES, the counter blocks of short messages are interleaved across the lanes of a multi-key AES-NI kernel;
+* the VAES kernels already fill their vectors from a single message. In authenticated mode the MAC sponges of the messages advance together in the lanes of the AVX2 or AVX-512 Keccak permutation.
+* Each message is processed with the mode of its own state, so encryption and decryption can be mixed in one batch.
+* The cipher-text, MAC code, and resulting state of each message are identical to those of qsc_rcs_transform;
+* on decryption the MAC is always verified before the cipher-text is decrypted, and a message that fails is not decrypted.
+*
+* \warning Every state must be initialized, and a state can appear only once in a batch.
+* Each encryption output array must be long enough to hold the message and the appended MAC code.
+*
+* \param ctxs: [struct] The array of cipher state structures
+* \param outputs: The array of output array pointers
+* \param inputs: [const] The array of input array pointers
+* \param lengths: [const] The array of message lengths, not including the MAC code
+* \param results: An optional array that receives the authentication result of each message; can be NULL
+* \param count: The number of messages in the batch
+*
+* \return: Returns true if every message was transformed successfully, false if any MAC check failed
+*/
+QSC_EXPORT_API bool qsc_rcs_transform_batch(qsc_rcs_state* ctxs[], uint8_t* outputs[], const uint8_t* inputs[], const size_t lengths[], bool results[], size_t count);
+
+/**
+* \brief Transform a batch of messages with detached MAC codes, each with its own independent cipher state.
+* Identical to qsc_rcs_transform_batch, except that the MAC code of each message is written to, or read from, its own tag array,
+* so the output holds only the cipher-text; used where the codes are stored apart from the data, such as sector metadata.
+*
+* \warning Every state must be initialized, and a state can appear only once in a batch.
+*
+* \param ctxs: [struct] The array of cipher state structures
+* \param outputs: The array of output array pointers
+* \param inputs: [const] The array of input array pointers
+* \param lengths: [const] The array of message lengths
+* \param tags: The array of MAC code array pointers; written on encryption, and compared on decryption
+* \param results: An optional array that receives the authentication result of each message; can be NULL
+* \param count: The number of messages in the batch
+*
+* \return: Returns true if every message was transformed successfully, false if any MAC check failed
+*/
+QSC_EXPORT_API bool qsc_rcs_transform_batch_detached(qsc_rcs_state* ctxs[], uint8_t* outputs[], const uint8_t* inputs[], const size_t lengths[], uint8_t* tags[], bool results[], size_t count);
+
+/**
+* \brief Encrypt a message held in fragmented buffers, without copying it to a contiguous array.
+* The input and output fragments can be split at different positions, but their total lengths must be equal.
+* The key-stream carries across fragment boundaries, and the MAC absorbs each cipher-text fragment in place,
+* so the cipher-text and MAC code are identical to those of qsc_rcs_transform on the joined message.
+*
+* \warning The cipher must be initialized for encryption before this function can be called
+*
+* \param ctx: [struct] The cipher state structure
+* \param output: [const] The array of output fragments
+* \param outcount: The number of output fragments
+* \param input: [const] The array of input fragments
+* \param incount: The number of input fragments
+* \param tag: The array receiving the MAC code; the MAC size of the cipher type. Unused, and can be NULL, if authentication is disabled
+*
+* \return: Returns false if the input and output lengths differ
+*/
+QSC_EXPORT_API bool qsc_rcs_encrypt_vector(qsc_rcs_state* ctx, const qsc_rcs_iovec* output, size_t outcount, const qsc_rcs_iovec* input, size_t incount, uint8_t* tag);
+
+/**
+* \brief Authenticate and decrypt a message held in fragmented buffers, without copying it to a contiguous array.
+* The MAC absorbs each cipher-text fragment in place, and the message is compared with the separate MAC code.
+* The fragments are decrypted only if the MAC check succeeds; with QSC_RCS_FUSED_DECRYPTION enabled
+* they are decrypted in the same pass, and the output fragments are erased if the check fails.
+*
+* \warning The cipher must be initialized for decryption before this function can be called
+*
+* \param ctx: [struct] The cipher state structure
+* \param output: [const] The array of output fragments
+* \param outcount: The number of output fragments
+* \param input: [const] The array of input fragments
+* \param incount: The number of input fragments
+* \param tag: [const] The expected MAC code. Unused, and can be NULL, if authentication is disabled
+*
+* \return: Returns false if the MAC check fails or the input and output lengths differ
+*/
+QSC_EXPORT_API bool qsc_rcs_decrypt_vector(qsc_rcs_state* ctx, const qsc_rcs_iovec* output, size_t outcount, const qsc_rcs_iovec* input, size_t incount, const uint8_t* tag);
+
+/**
+* \brief Transform the next piece of a streamed message.
+* The message can be split into pieces of any size; the unused key-stream of a partial block is kept
+* for the next piece, and the MAC absorbs the pieces as one message. The cipher-text and MAC code are
+* identical to those of qsc_rcs_transform on the whole message, however it was split.
+* Block-aligned runs within a piece are transformed by the widest kernel.
+* The first update of a message binds the current nonce to the MAC.
+*
+* \warning The cipher must be initialized before this function can be called.
+* The message is completed by qsc_rcs_encrypt_final or qsc_rcs_decrypt_final, and the other transform
+* functions must not be called on the state while a streamed message is pending.
+* Decrypted pieces are released before the MAC is checked, and must not be trusted until the final call succeeds.
+*
+* \param ctx: [struct] The cipher state structure
+* \param output: A pointer to the output array
+* \param input: [const] A pointer to the input array
+* \param length: The number of bytes to transform
+*/
+QSC_EXPORT_API void qsc_rcs_update(qsc_rcs_state* ctx, uint8_t* output, const uint8_t* input, size_t length);
+
+/**
+* \brief Complete a streamed encryption, and write the MAC code.
+* The unused key-stream is erased; the next update starts a new message at the following nonce position.
+*
+* \param ctx: [struct] The cipher state structure
+* \param tag: The array receiving the MAC code; the MAC size of the cipher type. Unused, and can be NULL, if authentication is disabled
+*/
+QSC_EXPORT_API void qsc_rcs_encrypt_final(qsc_rcs_state* ctx, uint8_t* tag);
+
+/**
+* \brief Complete a streamed decryption, and compare the MAC code of the message with the expected code.
+* The unused key-stream is erased; the next update starts a new message at the following nonce position.
+*
+* \param ctx: [struct] The cipher state structure
+* \param tag: [const] The expected MAC code. Unused, and can be NULL, if authentication is disabled
+*
+* \return: Returns true if the message is authentic
+*/
+QSC_EXPORT_API bool qsc_rcs_decrypt_final(qsc_rcs_state* ctx, const uint8_t* tag);
+
+/**
+* \brief Dispose of an expanded sector key.
+*
+* \param key: [struct] The expanded sector key structure
+*/
+QSC_EXPORT_API void qsc_rcs_sector_key_dispose(qsc_rcs_sector_key* key);
+
+/**
+* \brief Expand the input cipher-key and optional info tweak into a key for the sector mode.
+* The round-keys are generated by the cSHAKE key schedule with a name distinct from the stream cipher,
+* so the same input key can be used for both without sharing a round-key array; the nonce member of the key parameters is not used.
+*
+* \param key: [struct] The expanded sector key structure
+* \param keyparams: [const][struct] The secret input cipher-key and info structure
+*/
+QSC_EXPORT_API void qsc_rcs_sector_key_expand(qsc_rcs_sector_key* key, const qsc_rcs_keyparams* keyparams);
+
+/**
+* \brief Encrypt a run of consecutive sectors with the length-preserving sector mode.
+* The mode is the XEX tweakable block cipher on the Rijndael-256 rounds; each sector is encrypted in place of its plain-text,
+* with no nonce or MAC code, and the cipher-text of a block depends on the key, the sector number, and the position of the block in the sector.
+* The mode is not authenticated; a modified sector decrypts to unpredictable plain-text, and a sector can be rolled back to an earlier version.
+* The blocks of several sectors are transformed together, so short sectors still fill the widest kernel.
+*
+* \param key: [const][struct] The expanded sector key structure
+* \param output: The output array, count * sectorlen bytes; can be the input array
+* \param input: [const] The input array, count * sectorlen bytes
+* \param sector: The sector number of the first sector
+* \param sectorlen: The sector size in bytes; a non-zero multiple of QSC_RCS_BLOCK_SIZE
+* \param count: The number of sectors
+*
+* \return: Returns false if the sector size is not a multiple of the block size
+*/
+QSC_EXPORT_API bool qsc_rcs_sector_encrypt(const qsc_rcs_sector_key* key, uint8_t* output, const uint8_t* input, uint64_t sector, size_t sectorlen, size_t count);
+
+/**
+* \brief Decrypt a run of consecutive sectors with the length-preserving sector mode.
+*
+* \param key: [const][struct] The expanded sector key structure
+* \param output: The output array, count * sectorlen bytes; can be the input array
+* \param input: [const] The input array, count * sectorlen bytes
+* \param sector: The sector number of the first sector
+* \param sectorlen: The sector size in bytes; a non-zero multiple of QSC_RCS_BLOCK_SIZE
+* \param count: The number of sectors
+*
+* \return: Returns false if the sector size is not a multiple of the block size
+*/
+QSC_EXPORT_API bool qsc_rcs_sector_decrypt(const qsc_rcs_sector_key* key, uint8_t* output, const uint8_t* input, uint64_t sector, size_t sectorlen, size_t count);
+
 #endif
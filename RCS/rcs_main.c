@@ -22,6 +22,13 @@
 #include "cpuidex.h"
 #include "rcs.h"
 #include "rcs_test.h"
+#include "rcsdgram_test.h"
+#include "rcsfile_test.h"
+#include "rcsipc_test.h"
+#include "rcslog_test.h"
+#include "rcsrec_test.h"
+#include "rcsseg_test.h"
+#include "rcsvol_test.h"
 #include "sha3_test.h"
 #include "testutils.h"
 #include <stdio.h>
@@ -111,6 +118,34 @@ int main()
 		qsctest_rcs_run();
 		qsctest_print_line("");
 
+		qsctest_print_line("*** Test the segmented container format using round trip, random access, and tamper tests. ***");
+		qsctest_rcsseg_run();
+		qsctest_print_line("");
+
+		qsctest_print_line("*** Test the memory-mapped file functions using encryption, verification, and decryption of temporary files. ***");
+		qsctest_rcsfile_run();
+		qsctest_print_line("");
+
+		qsctest_print_line("*** Test the record layer using round trip and tamper tests over loopback TCP connections. ***");
+		qsctest_rcsrec_run();
+		qsctest_print_line("");
+
+		qsctest_print_line("*** Test the datagram functions using out-of-order, replay window, tamper, and loopback UDP tests. ***");
+		qsctest_rcsdgram_run();
+		qsctest_print_line("");
+
+		qsctest_print_line("*** Test the shared memory ring using round trip tests between processes, and tamper tests. ***");
+		qsctest_rcsipc_run();
+		qsctest_print_line("");
+
+		qsctest_print_line("*** Test the sector volume using random-access round trip and tamper tests on a temporary file. ***");
+		qsctest_rcsvol_run();
+		qsctest_print_line("");
+
+		qsctest_print_line("*** Test the encrypted log using append, seek, read, and recovery tests on a temporary file. ***");
+		qsctest_rcslog_run();
+		qsctest_print_line("");
+
 		qsctest_print_line("*** Test SHAKE, cSHAKE, KMAC, and SHA3 implementations using the official KAT vetors. ***");
 		qsctest_sha3_run();
 		qsctest_print_line("");
@@ -1,5 +1,6 @@
 #include "rcs_test.h"
 #include "intutils.h"
+#include "memutils.h"
 #include "csp.h"
 #include "testutils.h"
 #include <stdio.h>
@@ -35,7 +36,13 @@ bool qsctest_rcs256_kat()
 	qsctest_hex_to_bin("FFFEFDFCFBFAF9F8F7F6F5F4F3F2F1F0DFDEDDDCDBDAD9D8D7D6D5D4D3D2D1D0", nce, sizeof(nce));
 
 #if defined(QSC_RCS_AUTHENTICATED)
-#	if defined(QSC_RCS_AUTH_KMACR12)
+#	if defined(QSC_RCS_KPA_AUTHENTICATION)
+	/* rcsc256kpa256 */
+	qsctest_hex_to_bin("D4E387B91DC17672FBF74AF42F28D16576DAE20AA03CA3D3D6711D3ED3821BF8"
+		"8495C2D24CCA451BF059318BD776F87040834C86111084E2C184CC8171012500", exp1, sizeof(exp1));
+	qsctest_hex_to_bin("7921324560D43CE63751293E280D638E50D60C6171BF6E78C3BC7B160E3E9BE5"
+		"3DAD3477C203E34A3DBEB450352A4A37C97099190F0458C29A9ED335ABA65E1C", exp2, sizeof(exp2));
+#	elif defined(QSC_RCS_AUTH_KMACR12)
 	/* rcsc256p256 */
 	qsctest_hex_to_bin("D4E387B91DC17672FBF74AF42F28D16576DAE20AA03CA3D3D6711D3ED3821BF8"
 		"A282FF629207678A430AA676CFA1C21C763FA0C950136FA7338E55B5CFDEA89F", exp1, sizeof(exp1));
@@ -147,7 +154,17 @@ bool qsctest_rcs512_kat()
 	qsctest_hex_to_bin("FFFEFDFCFBFAF9F8F7F6F5F4F3F2F1F0DFDEDDDCDBDAD9D8D7D6D5D4D3D2D1D0", nce, sizeof(nce));
 
 #if defined(QSC_RCS_AUTHENTICATED)
-#	if defined(QSC_RCS_AUTH_KMACR12)
+#	if defined(QSC_RCS_KPA_AUTHENTICATION)
+	/* rcsc512kpa512 */
+	qsctest_hex_to_bin("B83B8234D260FBBBA5CB52BD1B37B30EDC2705FC53A7B846EFE04CDA430F0405"
+		"CB779CEA01B82D0407D9FA19AAB9D5969A93F35E245DD28A107A7A851EAF0DCE"
+		"5F71FD8AB69F5924BA837CC43B6AFD9EF1A79856BB395C9F6F09FFBBCE96B61C"
+		"5343FD951826B7841E156717F9AD0C26BFF604AFBB95AC5E09F2F7935C3122D6", exp1, sizeof(exp1));
+	qsctest_hex_to_bin("720F4AFC15C716643AEA680AF059FFA560E8CFA0BD70AF3C7C05552D5768D122"
+		"3D19623EA202BC2136500BE6B9BFAFC8C840AB2E30E90FF343623AEBDE9BC00F"
+		"450BCFF862CEE5C86963C442CF9470B7095112B1AB546637544EB15C4E86A6E8"
+		"5F33710C805D5B5572F40821340C5D8BDF1B92DF6FADAD0BB364E3500FC0A2E2", exp2, sizeof(exp2));
+#	elif defined(QSC_RCS_AUTH_KMACR12)
 	/* rcsc512p512 */
 	/* rcsc512p512 */
 	qsctest_hex_to_bin("B83B8234D260FBBBA5CB52BD1B37B30EDC2705FC53A7B846EFE04CDA430F0405"
@@ -456,12 +473,12 @@ bool qsctest_rcs512_stress_test()
 bool qsctest_rcs_wide_equality()
 {
 	const size_t SMPMIN = 16 * 128;
-	uint8_t* dec;
 	uint8_t* enc;
 	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
 	uint8_t* msg;
 	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
 	uint8_t ncopy[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t* seq;
 	qsc_rcs_state ctx1;
 	qsc_rcs_state ctx2;
 	size_t mctr;
@@ -485,28 +502,28 @@ bool qsctest_rcs_wide_equality()
 		} 
 		while (mlen < SMPMIN);
 
-		dec = (uint8_t*)malloc(mlen);
 #if defined(QSC_RCS_AUTHENTICATED)
 		enc = (uint8_t*)malloc(mlen + QSC_RCS256_MAC_SIZE);
 #else
 		enc = (uint8_t*)malloc(mlen);
 #endif
 		msg = (uint8_t*)malloc(mlen);
+		seq = (uint8_t*)malloc(mlen);
 
-		if (dec != NULL && enc != NULL && msg != NULL)
+		if (enc != NULL && msg != NULL && seq != NULL)
 		{
-			qsc_intutils_clear8(dec, mlen);
 #if defined(QSC_RCS_AUTHENTICATED)
 			qsc_intutils_clear8(enc, mlen + QSC_RCS256_MAC_SIZE);
 #else
 			qsc_intutils_clear8(enc, mlen);
 #endif
 			qsc_intutils_clear8(msg, mlen);
+			qsc_intutils_clear8(seq, mlen);
 
 			/* generate the key and nonce */
 			qsc_csp_generate(key, sizeof(key));
 			qsc_csp_generate(ncopy, sizeof(ncopy));
-			/* use a random sized message 1-65535 */
+			/* use a random sized message 2048-65535 */
 			qsc_csp_generate(msg, mlen);
 
 			/* initialize the key parameters struct */
@@ -516,7 +533,7 @@ bool qsctest_rcs_wide_equality()
 			/* initialize the state */
 			qsc_rcs_initialize(&ctx1, &kp1, true);
 
-			/* encrypt the array */
+			/* encrypt the array in one call, using the parallel block paths */
 			qsc_rcs_transform(&ctx1, enc, msg, mlen);
 
 			/* erase the internal state */
@@ -527,9 +544,9 @@ bool qsctest_rcs_wide_equality()
 			qsc_rcs_keyparams kp2 = { key, sizeof(key), nonce };
 
 			/* initialize the state */
-			qsc_rcs_initialize(&ctx2, &kp2, false);
+			qsc_rcs_initialize(&ctx2, &kp2, true);
 
-			/* encrypt using 16-byte blocks, bypassing AVX512 */
+			/* encrypt using 32-byte blocks, bypassing the parallel paths */
 
 			mctr = mlen;
 			moft = 0;
@@ -537,7 +554,7 @@ bool qsctest_rcs_wide_equality()
 			while (mctr != 0)
 			{
 				const size_t BLKRMD = qsc_intutils_min(QSC_RCS_BLOCK_SIZE, mctr);
-				qsc_rcs_transform(&ctx2, (uint8_t*)(dec + moft), (uint8_t*)(enc + moft), BLKRMD);
+				qsc_rcs_extended_transform(&ctx2, (uint8_t*)(seq + moft), (uint8_t*)(msg + moft), BLKRMD, false);
 				mctr -= BLKRMD;
 				moft += BLKRMD;
 			}
@@ -545,20 +562,41 @@ bool qsctest_rcs_wide_equality()
 			/* erase the internal state */
 			qsc_rcs_dispose(&ctx2);
 
-			if (qsc_intutils_are_equal8(dec, msg, mlen) == false)
+			/* compare the cipher-text, the mac code is not generated by the sequential calls */
+			if (qsc_intutils_are_equal8(enc, seq, mlen) == false)
 			{
 				status = false;
-				break;
 			}
 
 			/* reset the state */
-			free(dec);
 			free(enc);
 			free(msg);
+			free(seq);
+
+			if (status == false)
+			{
+				break;
+			}
+
 			++tctr;
 		}
 		else
 		{
+			if (enc != NULL)
+			{
+				free(enc);
+			}
+
+			if (msg != NULL)
+			{
+				free(msg);
+			}
+
+			if (seq != NULL)
+			{
+				free(seq);
+			}
+
 			status = false;
 			break;
 		}
@@ -568,52 +606,1150 @@ bool qsctest_rcs_wide_equality()
 }
 #endif
 
-void qsctest_rcs_run()
+#if defined(QSC_RCS_AUTHENTICATED)
+static bool rcs_is_zeroed(const uint8_t* a, size_t length)
 {
-	if (qsctest_rcs256_kat() == true)
+	uint8_t r;
+
+	r = 0;
+
+	for (size_t i = 0; i < length; ++i)
 	{
-		qsctest_print_safe("Success! Passed the RCS-256 known answer tests. \n");
+		r |= a[i];
+	}
+
+	return (r == 0);
+}
+
+static bool rcs_authentication_failure(uint8_t* key, size_t keylen, size_t maclen)
+{
+	/* three full mac tiles and a partial tile */
+	const size_t MLEN = (3 * 8192) + 77;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* msg;
+	uint8_t ncopy[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcs_state state;
+	bool status;
+
+	status = true;
+	dec = (uint8_t*)malloc(MLEN);
+	enc = (uint8_t*)malloc(MLEN + maclen);
+	msg = (uint8_t*)malloc(MLEN);
+
+	if (dec != NULL && enc != NULL && msg != NULL)
+	{
+		qsc_rcs_keyparams kp = { key, keylen, nonce, NULL, 0 };
+
+		qsc_csp_generate(msg, MLEN);
+		qsc_csp_generate(ncopy, sizeof(ncopy));
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+
+		/* encrypt the message */
+		qsc_rcs_initialize(&state, &kp, true);
+		qsc_rcs_transform(&state, enc, msg, MLEN);
+
+		/* flip a bit in the second tile of the cipher-text */
+		enc[8192 + 11] ^= 0x01U;
+
+		/* the tampered cipher-text must be rejected, and no plain-text released */
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&state, &kp, false);
+		qsc_intutils_clear8(dec, MLEN);
+
+		if (qsc_rcs_transform(&state, dec, enc, MLEN) == true)
+		{
+			qsctest_print_safe("Failure! rcs_authentication_failure: tampered cipher-text accepted -RA1 \n");
+			status = false;
+		}
+
+		if (rcs_is_zeroed(dec, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcs_authentication_failure: plain-text released -RA2 \n");
+			status = false;
+		}
+
+		/* the restored cipher-text must decrypt in the same buffer */
+		enc[8192 + 11] ^= 0x01U;
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&state, &kp, false);
+
+		if (qsc_rcs_transform(&state, dec, enc, MLEN) == false || qsc_intutils_are_equal8(dec, msg, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcs_authentication_failure: decryption failure -RA3 \n");
+			status = false;
+		}
+
+		/* tamper with the code and decrypt in two calls; the final segment must be withheld */
+		enc[MLEN] ^= 0x01U;
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&state, &kp, false);
+		qsc_intutils_clear8(dec, MLEN);
+		qsc_rcs_extended_transform(&state, dec, enc, 8192, false);
+
+		if (qsc_rcs_extended_transform(&state, dec + 8192, enc + 8192, MLEN - 8192, true) == true ||
+			rcs_is_zeroed(dec + 8192, MLEN - 8192) == false)
+		{
+			qsctest_print_safe("Failure! rcs_authentication_failure: tampered code accepted -RA4 \n");
+			status = false;
+		}
+
+		qsc_rcs_dispose(&state);
 	}
 	else
 	{
-		qsctest_print_safe("Failure! Failed the RCS-256 known answer tests. \n");
+		status = false;
 	}
 
-	if (qsctest_rcs512_kat() == true)
+	if (dec != NULL)
 	{
-		qsctest_print_safe("Success! Passed the RCS-512 known answer tests. \n");
+		free(dec);
 	}
-	else
+
+	if (enc != NULL)
 	{
-		qsctest_print_safe("Failure! Failed the RCS-512 known answer tests. \n");
+		free(enc);
 	}
 
-	if (qsctest_rcs256_stress_test() == true)
+	if (msg != NULL)
 	{
-		qsctest_print_safe("Success! Passed the RCS-256 stress test. \n");
+		free(msg);
+	}
+
+	return status;
+}
+
+bool qsctest_rcs_authentication_failure()
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	bool status;
+
+	qsc_csp_generate(key, sizeof(key));
+	status = rcs_authentication_failure(key, QSC_RCS256_KEY_SIZE, QSC_RCS256_MAC_SIZE);
+
+	if (rcs_authentication_failure(key, QSC_RCS512_KEY_SIZE, QSC_RCS512_MAC_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+#endif
+
+bool qsctest_rcs_seek_range()
+{
+	const size_t MLEN = 4096 + 93;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* msg;
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	uint8_t ncopy[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t pmcnt[sizeof(uint16_t)] = { 0 };
+	qsc_rcs_state state;
+	size_t rlen;
+	size_t roft;
+	size_t tctr;
+	bool status;
+
+	status = true;
+	dec = (uint8_t*)malloc(MLEN);
+	enc = (uint8_t*)malloc(MLEN + QSC_RCS256_MAC_SIZE);
+	msg = (uint8_t*)malloc(MLEN);
+
+	if (dec != NULL && enc != NULL && msg != NULL)
+	{
+		qsc_rcs_keyparams kp = { key, sizeof(key), nonce, NULL, 0 };
+
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(msg, MLEN);
+		/* start close to a carry over the low 64 bits of the counter */
+		qsc_csp_generate(ncopy, sizeof(ncopy));
+		qsc_intutils_le64to8(ncopy, 0xFFFFFFFFFFFFFFF0ULL);
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+
+		/* encrypt the whole stream */
+		qsc_rcs_initialize(&state, &kp, true);
+		qsc_rcs_transform(&state, enc, msg, MLEN);
+
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&state, &kp, false);
+
+		for (tctr = 0; tctr < QSCTEST_RCS_TEST_CYCLES; ++tctr)
+		{
+			/* decrypt a random byte range of the cipher-text */
+			qsc_csp_generate(pmcnt, sizeof(pmcnt));
+			roft = (size_t)qsc_intutils_le8to16(pmcnt) % MLEN;
+			qsc_csp_generate(pmcnt, sizeof(pmcnt));
+			rlen = ((size_t)qsc_intutils_le8to16(pmcnt) % (MLEN - roft)) + 1;
+
+			qsc_rcs_range_transform(&state, dec, enc + roft, roft, rlen);
+
+			if (qsc_intutils_are_equal8(dec, msg + roft, rlen) == false)
+			{
+				qsctest_print_safe("Failure! rcs_seek_range: range decryption failure -RR1 \n");
+				status = false;
+				break;
+			}
+
+			/* the key-stream of the range is the xor of the message and the cipher-text */
+			qsc_rcs_keystream_range(&state, dec, roft, rlen);
+
+			for (size_t i = 0; i < rlen; ++i)
+			{
+				dec[i] ^= msg[roft + i];
+			}
+
+			if (qsc_intutils_are_equal8(dec, enc + roft, rlen) == false)
+			{
+				qsctest_print_safe("Failure! rcs_seek_range: key-stream failure -RR2 \n");
+				status = false;
+				break;
+			}
+		}
+
+		/* seek to a block and continue the stream from there */
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&state, &kp, true);
+		qsc_rcs_seek(&state, 37);
+		qsc_rcs_transform(&state, dec, msg + (37 * QSC_RCS_BLOCK_SIZE), MLEN - (37 * QSC_RCS_BLOCK_SIZE));
+
+		if (qsc_intutils_are_equal8(dec, enc + (37 * QSC_RCS_BLOCK_SIZE), MLEN - (37 * QSC_RCS_BLOCK_SIZE)) == false)
+		{
+			qsctest_print_safe("Failure! rcs_seek_range: seek failure -RR3 \n");
+			status = false;
+		}
+
+		/* seek in the middle of a streamed block; the leftover key-stream must not be used after the seek */
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&state, &kp, true);
+		qsc_rcs_update(&state, dec, msg, 5);
+		qsc_rcs_seek(&state, 37);
+		qsc_rcs_update(&state, dec, msg + (37 * QSC_RCS_BLOCK_SIZE), MLEN - (37 * QSC_RCS_BLOCK_SIZE));
+
+		if (qsc_intutils_are_equal8(dec, enc + (37 * QSC_RCS_BLOCK_SIZE), MLEN - (37 * QSC_RCS_BLOCK_SIZE)) == false)
+		{
+			qsctest_print_safe("Failure! rcs_seek_range: seek after update failure -RR4 \n");
+			status = false;
+		}
+
+		qsc_rcs_dispose(&state);
 	}
 	else
 	{
-		qsctest_print_safe("Failure! Failed the RCS-256 stress test. \n");
+		status = false;
 	}
 
-	if (qsctest_rcs512_stress_test() == true)
+	if (dec != NULL)
 	{
-		qsctest_print_safe("Success! Passed the RCS-512 stress test. \n");
+		free(dec);
+	}
+
+	if (enc != NULL)
+	{
+		free(enc);
+	}
+
+	if (msg != NULL)
+	{
+		free(msg);
+	}
+
+	return status;
+}
+
+bool qsctest_rcs_parallel_equality()
+{
+	/* large enough to be split between threads, with a partial final block */
+	const size_t MLEN = (4 * 1024 * 1024) + 45;
+	uint8_t* dec;
+	uint8_t* enc1;
+	uint8_t* enc2;
+	uint8_t* msg;
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t ncopy[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcs_state ctx1;
+	qsc_rcs_state ctx2;
+	qsc_rcs_state ctx3;
+	bool status;
+
+	status = true;
+	dec = (uint8_t*)malloc(MLEN);
+	enc1 = (uint8_t*)malloc(MLEN + QSC_RCS512_MAC_SIZE);
+	enc2 = (uint8_t*)malloc(MLEN + QSC_RCS512_MAC_SIZE);
+	msg = (uint8_t*)malloc(MLEN);
+
+	if (dec != NULL && enc1 != NULL && enc2 != NULL && msg != NULL)
+	{
+		qsc_rcs_keyparams kp = { key, sizeof(key), nonce, NULL, 0 };
+#if defined(QSC_RCS_AUTHENTICATED)
+		const size_t CLEN = MLEN + QSC_RCS512_MAC_SIZE;
+#else
+		const size_t CLEN = MLEN;
+#endif
+
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(ncopy, sizeof(ncopy));
+		for (size_t i = 0; i < MLEN; i += QSC_CSP_SEED_MAX)
+		{
+			qsc_csp_generate(msg + i, qsc_intutils_min(QSC_CSP_SEED_MAX, MLEN - i));
+		}
+
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&ctx1, &kp, true);
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&ctx2, &kp, true);
+		memcpy(nonce, ncopy, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_initialize(&ctx3, &kp, false);
+
+		/* the parallel transform must match the sequential transform, and leave the stream at the same position */
+		for (size_t i = 0; i < 2; ++i)
+		{
+			qsc_rcs_transform(&ctx1, enc1, msg, MLEN);
+			qsc_rcs_parallel_transform(&ctx2, enc2, msg, MLEN);
+
+			if (qsc_intutils_are_equal8(enc1, enc2, CLEN) == false)
+			{
+				qsctest_print_safe("Failure! rcs_parallel_equality: output mismatch -RP1 \n");
+				status = false;
+			}
+
+			if (qsc_rcs_parallel_transform(&ctx3, dec, enc2, MLEN) == false || qsc_intutils_are_equal8(dec, msg, MLEN) == false)
+			{
+				qsctest_print_safe("Failure! rcs_parallel_equality: decryption failure -RP2 \n");
+				status = false;
+			}
+		}
+
+		qsc_rcs_dispose(&ctx1);
+		qsc_rcs_dispose(&ctx2);
+		qsc_rcs_dispose(&ctx3);
 	}
 	else
 	{
-		qsctest_print_safe("Failure! Failed the RCS-512 stress test. \n");
+		status = false;
+	}
+
+	if (dec != NULL)
+	{
+		free(dec);
+	}
+
+	if (enc1 != NULL)
+	{
+		free(enc1);
+	}
+
+	if (enc2 != NULL)
+	{
+		free(enc2);
+	}
+
+	if (msg != NULL)
+	{
+		free(msg);
+	}
+
+	return status;
+}
+
+static bool rcs_key_reuse(size_t keylen, size_t maclen)
+{
+	uint8_t aad[20] = { 0 };
+	uint8_t enc1[1024 + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t enc2[1024 + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t info[16] = { 0 };
+	uint8_t msg[1024] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcs_key rkey;
+	qsc_rcs_state ctx1;
+	qsc_rcs_state ctx2;
+	bool status;
+
+	status = true;
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(info, sizeof(info));
+	qsc_csp_generate(aad, sizeof(aad));
+
+	qsc_rcs_keyparams kp = { key, keylen, nonce, info, sizeof(info) };
+
+	/* expand the key once, and start several streams from it */
+	qsc_rcs_key_expand(&rkey, &kp);
+
+	for (size_t i = 0; i < 8; ++i)
+	{
+		const size_t MLEN = (i * 131) + 1;
+		size_t clen;
+
+		qsc_csp_generate(nonce, sizeof(nonce));
+		qsc_csp_generate(msg, MLEN);
+#if defined(QSC_RCS_AUTHENTICATED)
+		clen = MLEN + maclen;
+#else
+		clen = MLEN;
+		(void)maclen;
+#endif
+
+		qsc_rcs_initialize(&ctx1, &kp, true);
+		qsc_rcs_stream_initialize(&ctx2, &rkey, nonce, true);
+#if defined(QSC_RCS_AUTHENTICATED)
+		qsc_rcs_set_associated(&ctx1, aad, sizeof(aad));
+		qsc_rcs_set_associated(&ctx2, aad, sizeof(aad));
+#endif
+		qsc_rcs_transform(&ctx1, enc1, msg, MLEN);
+		qsc_rcs_transform(&ctx2, enc2, msg, MLEN);
+
+		if (qsc_intutils_are_equal8(enc1, enc2, clen) == false)
+		{
+			qsctest_print_safe("Failure! rcs_key_reuse: output mismatch -RU1 \n");
+			status = false;
+		}
+
+		/* decrypt with a stream from the same key */
+		qsc_rcs_stream_initialize(&ctx2, &rkey, nonce, false);
+#if defined(QSC_RCS_AUTHENTICATED)
+		qsc_rcs_set_associated(&ctx2, aad, sizeof(aad));
+#endif
+
+		if (qsc_rcs_transform(&ctx2, enc2, enc1, MLEN) == false || qsc_intutils_are_equal8(enc2, msg, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcs_key_reuse: decryption failure -RU2 \n");
+			status = false;
+		}
 	}
 
+	qsc_rcs_dispose(&ctx1);
+	qsc_rcs_dispose(&ctx2);
+	qsc_rcs_key_dispose(&rkey);
+
+	return status;
+}
+
+bool qsctest_rcs_key_reuse()
+{
+	bool status;
+
+	status = rcs_key_reuse(QSC_RCS256_KEY_SIZE, QSC_RCS256_MAC_SIZE);
+
+	if (rcs_key_reuse(QSC_RCS512_KEY_SIZE, QSC_RCS512_MAC_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_rcs_batch_equality()
+{
+	/* short packets of both cipher types, partial blocks, and lengths that take the single-stream path */
+	const size_t MLENS[] = { 1, 31, 32, 33, 64, 100, 127, 128, 257, 600, 1500 };
+	const size_t MCNT = sizeof(MLENS) / sizeof(MLENS[0]);
+	uint8_t dec[sizeof(MLENS) / sizeof(MLENS[0])][1500] = { 0 };
+	uint8_t enc1[sizeof(MLENS) / sizeof(MLENS[0])][1500 + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t enc2[sizeof(MLENS) / sizeof(MLENS[0])][1500 + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t msg[sizeof(MLENS) / sizeof(MLENS[0])][1500] = { 0 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcs_state ctx1[sizeof(MLENS) / sizeof(MLENS[0])];
+	qsc_rcs_state ctx2[sizeof(MLENS) / sizeof(MLENS[0])];
+	qsc_rcs_state ctx3[sizeof(MLENS) / sizeof(MLENS[0])];
+	qsc_rcs_state* pdec[sizeof(MLENS) / sizeof(MLENS[0])];
+	qsc_rcs_state* penc[sizeof(MLENS) / sizeof(MLENS[0])];
+	const uint8_t* pin[sizeof(MLENS) / sizeof(MLENS[0])];
+	uint8_t* pout[sizeof(MLENS) / sizeof(MLENS[0])];
+	bool results[sizeof(MLENS) / sizeof(MLENS[0])] = { 0 };
+	size_t clen;
+	size_t i;
+	bool status;
+
+	status = true;
+
+	for (i = 0; i < MCNT; ++i)
+	{
+		/* alternate the cipher types, so the batch must regroup the lanes */
+		const size_t KLEN = (i % 2 == 0) ? QSC_RCS256_KEY_SIZE : QSC_RCS512_KEY_SIZE;
+		qsc_rcs_keyparams kp = { key, KLEN, nonce, NULL, 0 };
+
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(nonce, sizeof(nonce));
+		qsc_rcs_initialize(&ctx1[i], &kp, true);
+		qsc_rcs_initialize(&ctx2[i], &kp, true);
+		qsc_rcs_initialize(&ctx3[i], &kp, false);
+		penc[i] = &ctx2[i];
+		pdec[i] = &ctx3[i];
+	}
+
+	/* the second round checks that the mac state and nonce of every stream were left at the same position */
+	for (size_t j = 0; j < 2; ++j)
+	{
+		for (i = 0; i < MCNT; ++i)
+		{
+			qsc_csp_generate(msg[i], MLENS[i]);
+			qsc_rcs_transform(&ctx1[i], enc1[i], msg[i], MLENS[i]);
+			pin[i] = msg[i];
+			pout[i] = enc2[i];
+		}
+
+		qsc_rcs_transform_batch(penc, pout, pin, MLENS, results, MCNT);
+
+		for (i = 0; i < MCNT; ++i)
+		{
+#if defined(QSC_RCS_AUTHENTICATED)
+			clen = MLENS[i] + ((i % 2 == 0) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE);
+#else
+			clen = MLENS[i];
+#endif
+
+			if (qsc_intutils_are_equal8(enc1[i], enc2[i], clen) == false)
+			{
+				qsctest_print_safe("Failure! rcs_batch_equality: output mismatch -RB1 \n");
+				status = false;
+			}
+
+			pin[i] = enc2[i];
+			pout[i] = dec[i];
+		}
+
+		if (qsc_rcs_transform_batch(pdec, pout, pin, MLENS, results, MCNT) == false)
+		{
+			qsctest_print_safe("Failure! rcs_batch_equality: authentication failure -RB2 \n");
+			status = false;
+		}
+
+		for (i = 0; i < MCNT; ++i)
+		{
+			if (results[i] == false || qsc_intutils_are_equal8(dec[i], msg[i], MLENS[i]) == false)
+			{
+				qsctest_print_safe("Failure! rcs_batch_equality: decryption failure -RB3 \n");
+				status = false;
+			}
+		}
+	}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	/* a tampered message must fail alone, without affecting the other streams in the batch */
+	for (i = 0; i < MCNT; ++i)
+	{
+		qsc_csp_generate(msg[i], MLENS[i]);
+		pin[i] = msg[i];
+		pout[i] = enc2[i];
+	}
+
+	qsc_rcs_transform_batch(penc, pout, pin, MLENS, results, MCNT);
+	enc2[4][0] ^= 1U;
+
+	for (i = 0; i < MCNT; ++i)
+	{
+		pin[i] = enc2[i];
+		pout[i] = dec[i];
+	}
+
+	if (qsc_rcs_transform_batch(pdec, pout, pin, MLENS, results, MCNT) == true)
+	{
+		qsctest_print_safe("Failure! rcs_batch_equality: authentication bypass -RB4 \n");
+		status = false;
+	}
+
+	for (i = 0; i < MCNT; ++i)
+	{
+		if (results[i] != (i != 4) || (i != 4 && qsc_intutils_are_equal8(dec[i], msg[i], MLENS[i]) == false))
+		{
+			qsctest_print_safe("Failure! rcs_batch_equality: independent stream failure -RB5 \n");
+			status = false;
+		}
+	}
+#endif
+
+	for (i = 0; i < MCNT; ++i)
+	{
+		qsc_rcs_dispose(&ctx1[i]);
+		qsc_rcs_dispose(&ctx2[i]);
+		qsc_rcs_dispose(&ctx3[i]);
+	}
+
+	return status;
+}
+
+static size_t rcs_fragment(qsc_rcs_iovec* vector, size_t maxcount, uint8_t* buffer, size_t length)
+{
+	/* split the buffer at random positions, including empty fragments and fragments smaller than a block */
+	uint8_t rnd[1] = { 0 };
+	size_t count;
+	size_t flen;
+
+	count = 0;
+
+	while (length != 0)
+	{
+		qsc_csp_generate(rnd, sizeof(rnd));
+		flen = (count == maxcount - 1) ? length : qsc_intutils_min(rnd[0] % 71, length);
+		vector[count].buffer = buffer;
+		vector[count].length = flen;
+		buffer += flen;
+		length -= flen;
+		++count;
+	}
+
+	return count;
+}
+
+static bool rcs_vector_equality(size_t keylen, size_t maclen)
+{
+	uint8_t dec[1500] = { 0 };
+	uint8_t enc1[1500 + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t enc2[1500] = { 0 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t msg[1500] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t tag[QSC_RCS512_MAC_SIZE] = { 0 };
+	qsc_rcs_iovec vdec[64];
+	qsc_rcs_iovec venc[64];
+	qsc_rcs_iovec vmsg[64];
+	qsc_rcs_state ctx1;
+	qsc_rcs_state ctx2;
+	qsc_rcs_state ctx3;
+	size_t cdec;
+	size_t cenc;
+	size_t cmsg;
+	bool status;
+
+	status = true;
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(nonce, sizeof(nonce));
+
+	qsc_rcs_keyparams kp = { key, keylen, nonce, NULL, 0 };
+
+	qsc_rcs_initialize(&ctx1, &kp, true);
+	qsc_rcs_initialize(&ctx2, &kp, true);
+	qsc_rcs_initialize(&ctx3, &kp, false);
+
+	/* successive messages check that the nonce and mac state carry between calls */
+	for (size_t i = 0; i < 16; ++i)
+	{
+		const size_t MLEN = (i * 97) + 1;
+
+		qsc_csp_generate(msg, MLEN);
+		qsc_rcs_transform(&ctx1, enc1, msg, MLEN);
+
+		/* the input and output are split at different positions */
+		cmsg = rcs_fragment(vmsg, 64, msg, MLEN);
+		cenc = rcs_fragment(venc, 64, enc2, MLEN);
+
+		if (qsc_rcs_encrypt_vector(&ctx2, venc, cenc, vmsg, cmsg, tag) == false ||
+			qsc_intutils_are_equal8(enc1, enc2, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcs_vector_equality: output mismatch -RV1 \n");
+			status = false;
+		}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+		if (qsc_intutils_are_equal8(enc1 + MLEN, tag, maclen) == false)
+		{
+			qsctest_print_safe("Failure! rcs_vector_equality: mac code mismatch -RV2 \n");
+			status = false;
+		}
+#else
+		(void)maclen;
+#endif
+
+		cenc = rcs_fragment(venc, 64, enc2, MLEN);
+		cdec = rcs_fragment(vdec, 64, dec, MLEN);
+
+		if (qsc_rcs_decrypt_vector(&ctx3, vdec, cdec, venc, cenc, tag) == false ||
+			qsc_intutils_are_equal8(dec, msg, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcs_vector_equality: decryption failure -RV3 \n");
+			status = false;
+		}
+	}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	/* a modified fragment must fail authentication */
+	qsc_rcs_encrypt_vector(&ctx2, venc, cenc, vdec, cdec, tag);
+	venc[cenc - 1].buffer[0] ^= 1U;
+
+	if (qsc_rcs_decrypt_vector(&ctx3, vdec, cdec, venc, cenc, tag) == true)
+	{
+		qsctest_print_safe("Failure! rcs_vector_equality: authentication bypass -RV4 \n");
+		status = false;
+	}
+#endif
+
+	/* mismatched lengths are rejected */
+	venc[0].buffer = enc2;
+	venc[0].length = 1;
+
+	if (qsc_rcs_encrypt_vector(&ctx2, venc, 1, vmsg, cmsg, tag) == true)
+	{
+		qsctest_print_safe("Failure! rcs_vector_equality: length check failure -RV5 \n");
+		status = false;
+	}
+
+	qsc_rcs_dispose(&ctx1);
+	qsc_rcs_dispose(&ctx2);
+	qsc_rcs_dispose(&ctx3);
+
+	return status;
+}
+
+bool qsctest_rcs_vector_equality()
+{
+	bool status;
+
+	status = rcs_vector_equality(QSC_RCS256_KEY_SIZE, QSC_RCS256_MAC_SIZE);
+
+	if (rcs_vector_equality(QSC_RCS512_KEY_SIZE, QSC_RCS512_MAC_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+static bool rcs_stream_equality(size_t keylen, size_t maclen)
+{
+	uint8_t dec[8192] = { 0 };
+	uint8_t enc1[8192 + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t enc2[8192] = { 0 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t msg[8192] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t tag[QSC_RCS512_MAC_SIZE] = { 0 };
+	qsc_rcs_iovec vpcs[64];
+	qsc_rcs_state ctx1;
+	qsc_rcs_state ctx2;
+	qsc_rcs_state ctx3;
+	size_t cpcs;
+	size_t oft;
+	bool status;
+
+	status = true;
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(nonce, sizeof(nonce));
+
+	qsc_rcs_keyparams kp = { key, keylen, nonce, NULL, 0 };
+
+	qsc_rcs_initialize(&ctx1, &kp, true);
+	qsc_rcs_initialize(&ctx2, &kp, true);
+	qsc_rcs_initialize(&ctx3, &kp, false);
+
+	/* successive messages, including an empty message, and long pieces that reach the wide kernels */
+	for (size_t i = 0; i < 12; ++i)
+	{
+		const size_t MLEN = (i == 3) ? 0 : (i * 677) + 5;
+
+		qsc_csp_generate(msg, MLEN);
+		qsc_rcs_transform(&ctx1, enc1, msg, MLEN);
+
+		/* the message is written in random pieces */
+		cpcs = rcs_fragment(vpcs, 64, msg, MLEN);
+		oft = 0;
+
+		for (size_t j = 0; j < cpcs; ++j)
+		{
+			qsc_rcs_update(&ctx2, enc2 + oft, vpcs[j].buffer, vpcs[j].length);
+			oft += vpcs[j].length;
+		}
+
+		qsc_rcs_encrypt_final(&ctx2, tag);
+
+		if (qsc_intutils_are_equal8(enc1, enc2, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcs_stream_equality: output mismatch -RS1 \n");
+			status = false;
+		}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+		if (qsc_intutils_are_equal8(enc1 + MLEN, tag, maclen) == false)
+		{
+			qsctest_print_safe("Failure! rcs_stream_equality: mac code mismatch -RS2 \n");
+			status = false;
+		}
+#else
+		(void)maclen;
+#endif
+
+		/* decrypt in place, split at different positions */
+		cpcs = rcs_fragment(vpcs, 64, enc2, MLEN);
+
+		for (size_t j = 0; j < cpcs; ++j)
+		{
+			qsc_rcs_update(&ctx3, vpcs[j].buffer, vpcs[j].buffer, vpcs[j].length);
+		}
+
+		if (qsc_rcs_decrypt_final(&ctx3, tag) == false || qsc_intutils_are_equal8(enc2, msg, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcs_stream_equality: decryption failure -RS3 \n");
+			status = false;
+		}
+	}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	/* a modified message must fail authentication */
+	qsc_rcs_update(&ctx2, enc2, msg, 100);
+	qsc_rcs_encrypt_final(&ctx2, tag);
+	enc2[99] ^= 1U;
+	qsc_rcs_update(&ctx3, dec, enc2, 50);
+	qsc_rcs_update(&ctx3, dec + 50, enc2 + 50, 50);
+
+	if (qsc_rcs_decrypt_final(&ctx3, tag) == true)
+	{
+		qsctest_print_safe("Failure! rcs_stream_equality: authentication bypass -RS4 \n");
+		status = false;
+	}
+#endif
+
+	qsc_rcs_dispose(&ctx1);
+	qsc_rcs_dispose(&ctx2);
+	qsc_rcs_dispose(&ctx3);
+
+	return status;
+}
+
+bool qsctest_rcs_stream_equality()
+{
+	bool status;
+
+	status = rcs_stream_equality(QSC_RCS256_KEY_SIZE, QSC_RCS256_MAC_SIZE);
+
+	if (rcs_stream_equality(QSC_RCS512_KEY_SIZE, QSC_RCS512_MAC_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+static bool rcs_sector_kat()
+{
+	/* vectors generated by this implementation, and checked for equality across the aes-ni, vaes and bitsliced kernels */
+	uint8_t enc[64] = { 0 };
+	uint8_t exp256[64] = { 0 };
+	uint8_t exp512[64] = { 0 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t msg[64] = { 0 };
+	qsc_rcs_sector_key skey;
+	bool status;
+
+	status = true;
+
+	qsctest_hex_to_bin("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+		"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F", key, sizeof(key));
+	qsctest_hex_to_bin("0E703D719DBE61C8E7BBA52AE837FCC55956B211935E88DF9ACFBBD6935DA472"
+		"0F1262FD29901658FF36C213755BD6389261BEA00ABAAA1439833FF37249D5A6", exp256, sizeof(exp256));
+	qsctest_hex_to_bin("F92E77141AD3DD02DCF582CBBF470FF07D7CCA110EDD70621B48A827CA6CCBDC"
+		"5C2745B5744463D9574A7D27901C6175D605787C603F383CA2AA1F5283C8C688", exp512, sizeof(exp512));
+
+	for (size_t i = 0; i < sizeof(msg); ++i)
+	{
+		msg[i] = (uint8_t)((i * 7) + 3);
+	}
+
+	qsc_rcs_keyparams kp256 = { key, QSC_RCS256_KEY_SIZE, NULL, NULL, 0 };
+	qsc_rcs_sector_key_expand(&skey, &kp256);
+	qsc_rcs_sector_encrypt(&skey, enc, msg, 0x0102, sizeof(msg), 1);
+
+	if (qsc_intutils_are_equal8(enc, exp256, sizeof(exp256)) == false)
+	{
+		qsctest_print_safe("Failure! rcs_sector_kat: RCS-256 cipher-text does not match the known answer -RK1 \n");
+		status = false;
+	}
+
+	qsc_rcs_sector_key_dispose(&skey);
+
+	qsc_rcs_keyparams kp512 = { key, QSC_RCS512_KEY_SIZE, NULL, NULL, 0 };
+	qsc_rcs_sector_key_expand(&skey, &kp512);
+	qsc_rcs_sector_encrypt(&skey, enc, msg, 0x0102, sizeof(msg), 1);
+
+	if (qsc_intutils_are_equal8(enc, exp512, sizeof(exp512)) == false)
+	{
+		qsctest_print_safe("Failure! rcs_sector_kat: RCS-512 cipher-text does not match the known answer -RK2 \n");
+		status = false;
+	}
+
+	qsc_rcs_sector_key_dispose(&skey);
+
+	return status;
+}
+
+static bool rcs_sector_equality(size_t keylen)
+{
+	const size_t SLENS[4] = { 32, 96, 512, 4096 };
+	const size_t BUFLEN = 16 * 4096;
+	uint8_t blk[4096] = { 0 };
+	uint8_t info[16] = { 0 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	qsc_rcs_sector_key skey1;
+	qsc_rcs_sector_key skey2;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* msg;
+	bool status;
+
+	status = true;
+	dec = (uint8_t*)malloc(BUFLEN);
+	enc = (uint8_t*)malloc(BUFLEN);
+	msg = (uint8_t*)malloc(BUFLEN);
+
+	if (dec != NULL && enc != NULL && msg != NULL)
+	{
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(info, sizeof(info));
+
+		qsc_rcs_keyparams kp1 = { key, keylen, NULL, NULL, 0 };
+		qsc_rcs_keyparams kp2 = { key, keylen, NULL, info, sizeof(info) };
+		qsc_rcs_sector_key_expand(&skey1, &kp1);
+		qsc_rcs_sector_key_expand(&skey2, &kp2);
+
+		for (size_t i = 0; i < 4; ++i)
+		{
+			for (size_t j = 1; j <= 16; ++j)
+			{
+				const size_t MLEN = SLENS[i] * j;
+				const uint64_t SECTOR = 1000 + (j * 31);
+
+				qsc_csp_generate(msg, MLEN);
+				qsc_rcs_sector_encrypt(&skey1, enc, msg, SECTOR, SLENS[i], j);
+
+				if (qsc_intutils_are_equal8(enc, msg, QSC_RCS_BLOCK_SIZE) == true)
+				{
+					qsctest_print_safe("Failure! rcs_sector_equality: the cipher-text is the plain-text -RX1 \n");
+					status = false;
+				}
+
+				/* a run is the same as each of its sectors encrypted on its own */
+				for (size_t k = 0; k < j; ++k)
+				{
+					qsc_rcs_sector_encrypt(&skey1, blk, msg + (k * SLENS[i]), SECTOR + k, SLENS[i], 1);
+
+					if (qsc_intutils_are_equal8(blk, enc + (k * SLENS[i]), SLENS[i]) == false)
+					{
+						qsctest_print_safe("Failure! rcs_sector_equality: the run and single sector outputs differ -RX2 \n");
+						status = false;
+					}
+				}
+
+				/* decrypt in place */
+				qsc_memutils_copy(dec, enc, MLEN);
+				qsc_rcs_sector_decrypt(&skey1, dec, dec, SECTOR, SLENS[i], j);
+
+				if (qsc_intutils_are_equal8(dec, msg, MLEN) == false)
+				{
+					qsctest_print_safe("Failure! rcs_sector_equality: decryption failure -RX3 \n");
+					status = false;
+				}
+			}
+		}
+
+		/* equal plain-text in two sectors, and in two blocks of a sector, encrypts to different cipher-text */
+		qsc_memutils_clear(msg, 2 * 4096);
+		qsc_rcs_sector_encrypt(&skey1, enc, msg, 5, 4096, 2);
+
+		if (qsc_intutils_are_equal8(enc, enc + 4096, 4096) == true ||
+			qsc_intutils_are_equal8(enc, enc + QSC_RCS_BLOCK_SIZE, QSC_RCS_BLOCK_SIZE) == true)
+		{
+			qsctest_print_safe("Failure! rcs_sector_equality: the sector tweak was not applied -RX4 \n");
+			status = false;
+		}
+
+		/* the info string changes the key schedule */
+		qsc_rcs_sector_encrypt(&skey2, dec, msg, 5, 4096, 1);
+
+		if (qsc_intutils_are_equal8(enc, dec, 4096) == true)
+		{
+			qsctest_print_safe("Failure! rcs_sector_equality: the info string was not applied -RX5 \n");
+			status = false;
+		}
+
+		/* a modified bit garbles its own block, and leaves the other blocks of the sector intact */
+		enc[40] ^= 0x01U;
+		qsc_rcs_sector_decrypt(&skey1, dec, enc, 5, 4096, 1);
+
+		if (qsc_intutils_are_equal8(dec, msg, QSC_RCS_BLOCK_SIZE) == false ||
+			qsc_intutils_are_equal8(dec + QSC_RCS_BLOCK_SIZE, msg + QSC_RCS_BLOCK_SIZE, QSC_RCS_BLOCK_SIZE) == true ||
+			qsc_intutils_are_equal8(dec + (2 * QSC_RCS_BLOCK_SIZE), msg + (2 * QSC_RCS_BLOCK_SIZE), 4096 - (2 * QSC_RCS_BLOCK_SIZE)) == false)
+		{
+			qsctest_print_safe("Failure! rcs_sector_equality: a modified block was not contained -RX6 \n");
+			status = false;
+		}
+
+		/* the sector size must be a multiple of the block size */
+		if (qsc_rcs_sector_encrypt(&skey1, enc, msg, 0, 0, 1) == true ||
+			qsc_rcs_sector_encrypt(&skey1, enc, msg, 0, QSC_RCS_BLOCK_SIZE + 1, 1) == true ||
+			qsc_rcs_sector_decrypt(&skey1, enc, msg, 0, 100, 1) == true)
+		{
+			qsctest_print_safe("Failure! rcs_sector_equality: an invalid sector size was accepted -RX7 \n");
+			status = false;
+		}
+
+		qsc_rcs_sector_key_dispose(&skey1);
+		qsc_rcs_sector_key_dispose(&skey2);
+	}
+	else
+	{
+		status = false;
+	}
+
+	if (dec != NULL)
+	{
+		free(dec);
+	}
+
+	if (enc != NULL)
+	{
+		free(enc);
+	}
+
+	if (msg != NULL)
+	{
+		free(msg);
+	}
+
+	return status;
+}
+
+bool qsctest_rcs_sector_equality()
+{
+	bool status;
+
+	status = rcs_sector_kat();
+
+	if (rcs_sector_equality(QSC_RCS256_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	if (rcs_sector_equality(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+void qsctest_rcs_run()
+{
+	if (qsctest_rcs256_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS-256 known answer tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS-256 known answer tests. \n");
+	}
+
+	if (qsctest_rcs512_kat() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS-512 known answer tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS-512 known answer tests. \n");
+	}
+
+	if (qsctest_rcs256_stress_test() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS-256 stress test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS-256 stress test. \n");
+	}
+
+	if (qsctest_rcs512_stress_test() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS-512 stress test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS-512 stress test. \n");
+	}
+
+	if (qsctest_rcs_key_reuse() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS expanded key reuse test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS expanded key reuse test. \n");
+	}
+
+	if (qsctest_rcs_seek_range() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS seek and range transform test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS seek and range transform test. \n");
+	}
+
+	if (qsctest_rcs_parallel_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS parallel transform equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS parallel transform equality test. \n");
+	}
+
+	if (qsctest_rcs_batch_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS batch transform equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS batch transform equality test. \n");
+	}
+
+	if (qsctest_rcs_vector_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS vectored transform equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS vectored transform equality test. \n");
+	}
+
+	if (qsctest_rcs_stream_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS streaming transform equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS streaming transform equality test. \n");
+	}
+
+	if (qsctest_rcs_sector_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS sector mode known answer and equality tests. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS sector mode known answer and equality tests. \n");
+	}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	if (qsctest_rcs_authentication_failure() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS authentication failure test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS authentication failure test. \n");
+	}
+#endif
+
 #if defined(QSCTEST_RCS_WIDE_BLOCK_TESTS)
 	if (qsctest_rcs_wide_equality() == true)
 	{
-		qsctest_print_safe("Success! Passed the RCS AVX-512 equality test. \n");
+		qsctest_print_safe("Success! Passed the RCS wide-block equality test. \n");
 	}
 	else
 	{
-		qsctest_print_safe("Failure! Failed the RCS AVX-512 equality test. \n");
+		qsctest_print_safe("Failure! Failed the RCS wide-block equality test. \n");
 	}
 #endif
 }
\ No newline at end of file
@@ -13,12 +13,8 @@
 #include "common.h"
 #include "rcs.h"
 
-#if defined(QSC_SYSTEM_HAS_AVX512) 
-#	if defined(QSC_RCS_AESNI_ENABLED)
-#		if !defined(QSC_RCS_AUTHENTICATED)
-#			define QSCTEST_RCS_WIDE_BLOCK_TESTS
-#		endif
-#	endif
+#if defined(QSC_RCS_AESNI_ENABLED)
+#	define QSCTEST_RCS_WIDE_BLOCK_TESTS
 #endif
 
 #define QSCTEST_RCS_TEST_CYCLES 100
@@ -61,9 +57,68 @@ bool qsctest_rcs256_stress_test();
 */
 bool qsctest_rcs512_stress_test();
 
+/**
+* \brief Tests streams initialized from an expanded key for equal output to fully initialized streams.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_key_reuse();
+
+/**
+* \brief Tests the seek, key-stream range, and range transform functions against a sequential transform.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_seek_range();
+
+/**
+* \brief Tests the threaded parallel transform for equal output to the sequential transform.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_parallel_equality();
+
+/**
+* \brief Tests the batch transform of independent mixed RCS-256 and RCS-512 streams for equal output to the single-stream transform.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_batch_equality();
+
+/**
+* \brief Tests the vectored transform of fragmented messages for equal output to the contiguous transform.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_vector_equality();
+
+/**
+* \brief Tests the streaming update and final functions with random piece sizes for equal output to the single-call transform.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_stream_equality();
+
+/**
+* \brief Tests the length-preserving sector mode; a known answer, in-place round trips of sector runs,
+* runs against single sectors, and the sector and block tweaks.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_sector_equality();
+
+#if defined(QSC_RCS_AUTHENTICATED)
+/**
+* \brief Tests that tampered cipher-text is rejected, and that no plain-text is released.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcs_authentication_failure();
+#endif
+
 #if defined(QSCTEST_RCS_WIDE_BLOCK_TESTS)
 /**
-* \brief Tests the RCS AVX functions for equal output to sequential processing.
+* \brief Tests the RCS parallel and AVX functions for equal output to sequential processing.
 *
 * \return Returns true for success
 */
@@ -0,0 +1,426 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	/* sendmmsg and recvmmsg */
+#	define _GNU_SOURCE
+#endif
+
+#include "rcsdgram.h"
+#include "intutils.h"
+#include "memutils.h"
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <winsock2.h>
+#	pragma comment(lib, "ws2_32.lib")
+#else
+#	include <sys/socket.h>
+#	include <sys/uio.h>
+#endif
+
+#define RCSDGRAM_INDEX_OFFSET 8
+
+static const uint8_t rcsdgram_initiator_label[] = "RCS datagram initiator";
+static const uint8_t rcsdgram_responder_label[] = "RCS datagram responder";
+
+static void rcsdgram_packet_initialize(const qsc_rcsdgram_state* ctx, qsc_rcs_state* state, const qsc_rcs_key* key, uint64_t number, const uint8_t* header, bool encryption)
+{
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+
+	qsc_rcs_nonce_derive(nonce, ctx->nonce, number, RCSDGRAM_INDEX_OFFSET);
+	qsc_rcs_stream_initialize(state, key, nonce, encryption);
+	/* bind the packet number to the packet */
+	qsc_rcs_set_associated(state, header, QSC_RCSDGRAM_HEADER_SIZE);
+	qsc_memutils_clear(nonce, sizeof(nonce));
+}
+
+static bool rcsdgram_window_check(const qsc_rcsdgram_state* ctx, uint64_t number)
+{
+	const size_t BIT = (size_t)(number % QSC_RCSDGRAM_WINDOW_SIZE);
+	bool res;
+
+	if (number >= ctx->rxtop)
+	{
+		/* ahead of every accepted packet */
+		res = true;
+	}
+	else if (ctx->rxtop - number > QSC_RCSDGRAM_WINDOW_SIZE)
+	{
+		/* behind the window */
+		res = false;
+	}
+	else
+	{
+		res = ((ctx->rxwindow[BIT / 64] >> (BIT % 64)) & 1U) == 0;
+	}
+
+	return res;
+}
+
+static void rcsdgram_window_update(qsc_rcsdgram_state* ctx, uint64_t number)
+{
+	const size_t BIT = (size_t)(number % QSC_RCSDGRAM_WINDOW_SIZE);
+	uint64_t pos;
+	size_t pbit;
+
+	if (number >= ctx->rxtop)
+	{
+		/* slide the window forward, clearing the positions it moves over */
+		if (number - ctx->rxtop >= QSC_RCSDGRAM_WINDOW_SIZE)
+		{
+			qsc_memutils_clear((uint8_t*)ctx->rxwindow, sizeof(ctx->rxwindow));
+		}
+		else
+		{
+			for (pos = ctx->rxtop; pos < number; ++pos)
+			{
+				pbit = (size_t)(pos % QSC_RCSDGRAM_WINDOW_SIZE);
+				ctx->rxwindow[pbit / 64] &= ~((uint64_t)1U << (pbit % 64));
+			}
+		}
+
+		ctx->rxtop = number + 1;
+	}
+
+	ctx->rxwindow[BIT / 64] |= ((uint64_t)1U << (BIT % 64));
+}
+
+bool qsc_rcsdgram_initialize(qsc_rcsdgram_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* nonce, bool initiator)
+{
+	assert(ctx != NULL);
+	assert(key != NULL);
+	assert(nonce != NULL);
+
+	bool res;
+
+	res = false;
+	qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsdgram_state));
+
+	if (keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE)
+	{
+		ctx->states = (qsc_rcs_state*)qsc_memutils_aligned_alloc(64, QSC_RCSDGRAM_BATCH_MAX * sizeof(qsc_rcs_state));
+
+		if (ctx->states != NULL)
+		{
+			/* each direction has its own key, so the two directions can share the session nonce and packet numbers */
+			qsc_rcs_keyparams kpi = { key, keylen, ctx->nonce, rcsdgram_initiator_label, sizeof(rcsdgram_initiator_label) - 1 };
+			qsc_rcs_keyparams kpr = { key, keylen, ctx->nonce, rcsdgram_responder_label, sizeof(rcsdgram_responder_label) - 1 };
+
+			qsc_memutils_copy(ctx->nonce, nonce, QSC_RCS_NONCE_SIZE);
+			qsc_rcs_key_expand(&ctx->txkey, (initiator == true) ? &kpi : &kpr);
+			qsc_rcs_key_expand(&ctx->rxkey, (initiator == true) ? &kpr : &kpi);
+#if defined(QSC_RCS_AUTHENTICATED)
+			ctx->maclen = (keylen == QSC_RCS256_KEY_SIZE) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+#else
+			ctx->maclen = 0;
+#endif
+			res = true;
+		}
+	}
+
+	return res;
+}
+
+void qsc_rcsdgram_dispose(qsc_rcsdgram_state* ctx)
+{
+	if (ctx != NULL)
+	{
+		if (ctx->states != NULL)
+		{
+			qsc_memutils_clear((uint8_t*)ctx->states, QSC_RCSDGRAM_BATCH_MAX * sizeof(qsc_rcs_state));
+			qsc_memutils_aligned_free(ctx->states);
+		}
+
+		qsc_rcs_key_dispose(&ctx->txkey);
+		qsc_rcs_key_dispose(&ctx->rxkey);
+		qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsdgram_state));
+	}
+}
+
+size_t qsc_rcsdgram_overhead(const qsc_rcsdgram_state* ctx)
+{
+	assert(ctx != NULL);
+
+	return QSC_RCSDGRAM_HEADER_SIZE + ctx->maclen;
+}
+
+size_t qsc_rcsdgram_seal(qsc_rcsdgram_state* ctx, qsc_rcsdgram_packet* packets, size_t count)
+{
+	assert(ctx != NULL);
+	assert(packets != NULL || count == 0);
+
+	const size_t OVERHEAD = QSC_RCSDGRAM_HEADER_SIZE + ctx->maclen;
+	qsc_rcs_state* pstates[QSC_RCSDGRAM_BATCH_MAX];
+	const uint8_t* inputs[QSC_RCSDGRAM_BATCH_MAX];
+	uint8_t* outputs[QSC_RCSDGRAM_BATCH_MAX];
+	size_t lengths[QSC_RCSDGRAM_BATCH_MAX];
+	qsc_rcsdgram_packet* ppkt;
+	size_t bcnt;
+	size_t oft;
+	size_t scnt;
+	size_t vcnt;
+	size_t i;
+
+	vcnt = 0;
+
+	for (oft = 0; oft < count; oft += bcnt)
+	{
+		bcnt = qsc_intutils_min(count - oft, QSC_RCSDGRAM_BATCH_MAX);
+		scnt = 0;
+
+		/* a packet whose buffer can not hold the datagram is skipped, and is not assigned a packet number */
+		for (i = 0; i < bcnt; ++i)
+		{
+			ppkt = &packets[oft + i];
+			ppkt->valid = false;
+
+			if (ppkt->capacity >= OVERHEAD && ppkt->length <= ppkt->capacity - OVERHEAD)
+			{
+				ppkt->number = ctx->txnumber;
+				++ctx->txnumber;
+				qsc_intutils_le64to8(ppkt->buffer, ppkt->number);
+				rcsdgram_packet_initialize(ctx, &ctx->states[scnt], &ctx->txkey, ppkt->number, ppkt->buffer, true);
+
+				pstates[scnt] = &ctx->states[scnt];
+				inputs[scnt] = ppkt->buffer + QSC_RCSDGRAM_HEADER_SIZE;
+				outputs[scnt] = ppkt->buffer + QSC_RCSDGRAM_HEADER_SIZE;
+				lengths[scnt] = ppkt->length;
+				ppkt->valid = true;
+				++scnt;
+			}
+		}
+
+		/* the packets are encrypted in place, interleaved in one batch */
+		qsc_rcs_transform_batch(pstates, outputs, inputs, lengths, NULL, scnt);
+
+		for (i = 0; i < scnt; ++i)
+		{
+			qsc_rcs_dispose(&ctx->states[i]);
+		}
+
+		vcnt += scnt;
+	}
+
+	return vcnt;
+}
+
+size_t qsc_rcsdgram_open(qsc_rcsdgram_state* ctx, qsc_rcsdgram_packet* packets, size_t count)
+{
+	assert(ctx != NULL);
+	assert(packets != NULL || count == 0);
+
+	const size_t OVERHEAD = QSC_RCSDGRAM_HEADER_SIZE + ctx->maclen;
+	qsc_rcs_state* pstates[QSC_RCSDGRAM_BATCH_MAX];
+	const uint8_t* inputs[QSC_RCSDGRAM_BATCH_MAX];
+	uint8_t* outputs[QSC_RCSDGRAM_BATCH_MAX];
+	size_t lengths[QSC_RCSDGRAM_BATCH_MAX];
+	size_t index[QSC_RCSDGRAM_BATCH_MAX];
+	bool results[QSC_RCSDGRAM_BATCH_MAX] = { 0 };
+	qsc_rcsdgram_packet* ppkt;
+	size_t bcnt;
+	size_t oft;
+	size_t scnt;
+	size_t vcnt;
+	size_t i;
+
+	vcnt = 0;
+
+	for (oft = 0; oft < count; oft += bcnt)
+	{
+		bcnt = qsc_intutils_min(count - oft, QSC_RCSDGRAM_BATCH_MAX);
+		scnt = 0;
+
+		/* a short datagram, or a packet number the window has already seen, is dropped before the cipher runs */
+		for (i = 0; i < bcnt; ++i)
+		{
+			ppkt = &packets[oft + i];
+			ppkt->valid = false;
+
+			if (ppkt->length >= OVERHEAD)
+			{
+				ppkt->number = qsc_intutils_le8to64(ppkt->buffer);
+
+				if (rcsdgram_window_check(ctx, ppkt->number) == true)
+				{
+					rcsdgram_packet_initialize(ctx, &ctx->states[scnt], &ctx->rxkey, ppkt->number, ppkt->buffer, false);
+					pstates[scnt] = &ctx->states[scnt];
+					inputs[scnt] = ppkt->buffer + QSC_RCSDGRAM_HEADER_SIZE;
+					outputs[scnt] = ppkt->buffer + QSC_RCSDGRAM_HEADER_SIZE;
+					lengths[scnt] = ppkt->length - OVERHEAD;
+					index[scnt] = oft + i;
+					++scnt;
+				}
+			}
+		}
+
+		qsc_rcs_transform_batch(pstates, outputs, inputs, lengths, results, scnt);
+
+		/* the window is checked again as it is updated, so a packet repeated within the batch is accepted once */
+		for (i = 0; i < scnt; ++i)
+		{
+			ppkt = &packets[index[i]];
+
+			if (results[i] == true && rcsdgram_window_check(ctx, ppkt->number) == true)
+			{
+				rcsdgram_window_update(ctx, ppkt->number);
+				ppkt->length = lengths[i];
+				ppkt->valid = true;
+				++vcnt;
+			}
+
+			qsc_rcs_dispose(&ctx->states[i]);
+		}
+
+		for (i = 0; i < bcnt; ++i)
+		{
+			if (packets[oft + i].valid == false)
+			{
+				packets[oft + i].length = 0;
+			}
+		}
+	}
+
+	return vcnt;
+}
+
+size_t qsc_rcsdgram_send(qsc_rcsdgram_state* ctx, qsc_rcsrec_socket socket, qsc_rcsdgram_packet* packets, size_t count)
+{
+	assert(ctx != NULL);
+	assert(packets != NULL || count == 0);
+
+	const size_t OVERHEAD = QSC_RCSDGRAM_HEADER_SIZE + ctx->maclen;
+#if defined(QSC_SYSTEM_OS_LINUX)
+	struct mmsghdr msgs[QSC_RCSDGRAM_BATCH_MAX] = { 0 };
+	struct iovec vecs[QSC_RCSDGRAM_BATCH_MAX];
+	size_t index[QSC_RCSDGRAM_BATCH_MAX];
+	size_t bcnt;
+#endif
+	size_t pos;
+	size_t scnt;
+	int slen;
+
+	qsc_rcsdgram_seal(ctx, packets, count);
+	pos = 0;
+	scnt = 0;
+
+#if defined(QSC_SYSTEM_OS_LINUX)
+	/* one system call sends the sealed packets of a batch; a partial send resumes at the first packet not sent */
+	while (pos < count)
+	{
+		bcnt = 0;
+
+		for (; pos < count && bcnt < QSC_RCSDGRAM_BATCH_MAX; ++pos)
+		{
+			if (packets[pos].valid == true)
+			{
+				vecs[bcnt].iov_base = packets[pos].buffer;
+				vecs[bcnt].iov_len = packets[pos].length + OVERHEAD;
+				msgs[bcnt].msg_hdr.msg_iov = &vecs[bcnt];
+				msgs[bcnt].msg_hdr.msg_iovlen = 1;
+				index[bcnt] = pos;
+				++bcnt;
+			}
+		}
+
+		if (bcnt == 0)
+		{
+			break;
+		}
+
+		slen = sendmmsg(socket, msgs, (unsigned int)bcnt, 0);
+
+		if (slen > 0)
+		{
+			scnt += (size_t)slen;
+
+			if ((size_t)slen < bcnt)
+			{
+				pos = index[slen];
+			}
+		}
+		else if (slen == 0 || errno != EINTR)
+		{
+			break;
+		}
+		else
+		{
+			pos = index[0];
+		}
+	}
+#else
+	for (; pos < count; ++pos)
+	{
+		if (packets[pos].valid == true)
+		{
+			slen = (int)send(socket, (const char*)packets[pos].buffer, (int)(packets[pos].length + OVERHEAD), 0);
+
+			if (slen < 0)
+			{
+				break;
+			}
+
+			++scnt;
+		}
+	}
+#endif
+
+	return scnt;
+}
+
+size_t qsc_rcsdgram_receive(qsc_rcsdgram_state* ctx, qsc_rcsrec_socket socket, qsc_rcsdgram_packet* packets, size_t count)
+{
+	assert(ctx != NULL);
+	assert(packets != NULL || count == 0);
+
+#if defined(QSC_SYSTEM_OS_LINUX)
+	struct mmsghdr msgs[QSC_RCSDGRAM_BATCH_MAX] = { 0 };
+	struct iovec vecs[QSC_RCSDGRAM_BATCH_MAX];
+	size_t i;
+#endif
+	size_t rcnt;
+	int rlen;
+
+	rcnt = 0;
+
+#if defined(QSC_SYSTEM_OS_LINUX)
+	count = qsc_intutils_min(count, QSC_RCSDGRAM_BATCH_MAX);
+
+	for (i = 0; i < count; ++i)
+	{
+		vecs[i].iov_base = packets[i].buffer;
+		vecs[i].iov_len = packets[i].capacity;
+		msgs[i].msg_hdr.msg_iov = &vecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/* wait for the first datagram, then take the others that are already queued */
+	do
+	{
+		rlen = recvmmsg(socket, msgs, (unsigned int)count, MSG_WAITFORONE, NULL);
+	}
+	while (rlen < 0 && errno == EINTR);
+
+	if (rlen > 0)
+	{
+		rcnt = (size_t)rlen;
+
+		for (i = 0; i < rcnt; ++i)
+		{
+			/* a datagram larger than its buffer was truncated, and is dropped */
+			packets[i].length = ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) == 0) ? (size_t)msgs[i].msg_len : 0;
+		}
+	}
+#else
+	if (count != 0)
+	{
+		rlen = (int)recv(socket, (char*)packets[0].buffer, (int)packets[0].capacity, 0);
+
+		if (rlen >= 0)
+		{
+			packets[0].length = (size_t)rlen;
+			rcnt = 1;
+		}
+	}
+#endif
+
+	qsc_rcsdgram_open(ctx, packets, rcnt);
+
+	return rcnt;
+}
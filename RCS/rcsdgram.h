@@ -0,0 +1,199 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSDGRAM_H
+#define QSC_RCSDGRAM_H
+
+/**
+* \file rcsdgram.h
+* \brief RCS datagram protection with batched socket I/O \n
+* Encrypts and authenticates independent datagrams, for tunnels and other protocols carried over UDP.
+*
+* Datagram layout: \n
+* packet number (8, little-endian) | cipher-text | MAC code (32 or 64) \n
+*
+* Each direction has its own expanded key, derived from the shared key with a direction label as the cSHAKE customization.
+* A packet is encrypted with a nonce made by adding its packet number to the upper bits of the session nonce,
+* and the packet number is bound to the packet as associated data; a packet is opened with nothing but its own number,
+* so packets can be decrypted in any order, and by any thread. \n
+* A sliding replay window rejects a packet number that has already been accepted, or that is older than the window.
+* The window is updated only after a packet is authenticated, so a forged packet can not advance it.
+*
+* The batch functions seal or open a vector of packets with one call to qsc_rcs_transform_batch, which interleaves the
+* cipher and MAC work of the packets across the vector lanes. On Linux, the socket functions move a whole batch
+* with a single sendmmsg or recvmmsg call; elsewhere packets are sent with a call for each packet, and a receive call returns one datagram.
+* The socket must be a connected datagram socket.
+*
+* Datagram example \n
+* \code
+* qsc_rcsdgram_state dgm;
+* qsc_rcsdgram_packet pkts[32];
+*
+* // both peers use the same key and session nonce, and opposite initiator flags
+* qsc_rcsdgram_initialize(&dgm, key, QSC_RCS256_KEY_SIZE, nonce, true);
+*
+* // the payload of each packet is written at pkts[i].buffer + QSC_RCSDGRAM_HEADER_SIZE
+* qsc_rcsdgram_send(&dgm, sock, pkts, 32);
+* count = qsc_rcsdgram_receive(&dgm, sock, pkts, 32);
+* qsc_rcsdgram_dispose(&dgm);
+* \endcode
+*/
+
+#include "common.h"
+#include "rcs.h"
+#include "rcsrec.h"
+
+/*!
+* \def QSC_RCSDGRAM_HEADER_SIZE
+* \brief The size of the packet number header in bytes
+*/
+#define QSC_RCSDGRAM_HEADER_SIZE 8
+
+/*!
+* \def QSC_RCSDGRAM_OVERHEAD_MAX
+* \brief The largest number of bytes a datagram adds to its payload; the header and an RCS-512 MAC code
+*/
+#define QSC_RCSDGRAM_OVERHEAD_MAX (QSC_RCSDGRAM_HEADER_SIZE + QSC_RCS512_MAC_SIZE)
+
+/*!
+* \def QSC_RCSDGRAM_BATCH_MAX
+* \brief The maximum number of packets in a batch
+*/
+#define QSC_RCSDGRAM_BATCH_MAX 64
+
+/*!
+* \def QSC_RCSDGRAM_WINDOW_SIZE
+* \brief The number of packet numbers tracked by the replay window; a multiple of 64
+*/
+#define QSC_RCSDGRAM_WINDOW_SIZE 1024
+
+/*!
+* \struct qsc_rcsdgram_packet
+* \brief A datagram buffer and its state
+*/
+QSC_EXPORT_API typedef struct
+{
+	uint8_t* buffer;			/*!< The datagram; the header, the payload at QSC_RCSDGRAM_HEADER_SIZE, and room for the MAC code */
+	size_t capacity;			/*!< The size of the datagram buffer */
+	size_t length;				/*!< The payload length; set to the datagram length before a packet is opened */
+	uint64_t number;			/*!< The packet number */
+	bool valid;					/*!< The packet was authenticated and was not a replay */
+} qsc_rcsdgram_packet;
+
+/*!
+* \struct qsc_rcsdgram_state
+* \brief The datagram state of one association
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_key txkey;									/*!< The expanded key of the send direction */
+	qsc_rcs_key rxkey;									/*!< The expanded key of the receive direction */
+	uint8_t nonce[QSC_RCS_NONCE_SIZE];					/*!< The session nonce */
+	uint64_t rxwindow[QSC_RCSDGRAM_WINDOW_SIZE / 64];	/*!< The replay window bitmap, indexed by packet number */
+	qsc_rcs_state* states;								/*!< The cipher states of a batch */
+	uint64_t txnumber;									/*!< The number of the next sent packet */
+	uint64_t rxtop;										/*!< One more than the highest accepted packet number; zero before the first packet */
+	size_t maclen;										/*!< The size of the packet MAC code */
+} qsc_rcsdgram_state;
+
+/**
+* \brief Initialize the datagram state.
+* The key and session nonce must be shared by both peers, and the session nonce must be unique for every association using a key.
+*
+* \param ctx: [struct] The datagram state
+* \param key: [const] The association key
+* \param keylen: The key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param nonce: [const] The session nonce, QSC_RCS_NONCE_SIZE bytes
+* \param initiator: True on one peer, false on the other
+*
+* \return Returns false if the key length is invalid or the batch states could not be allocated
+*/
+QSC_EXPORT_API bool qsc_rcsdgram_initialize(qsc_rcsdgram_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* nonce, bool initiator);
+
+/**
+* \brief Dispose of the datagram state.
+*
+* \param ctx: [struct] The datagram state
+*/
+QSC_EXPORT_API void qsc_rcsdgram_dispose(qsc_rcsdgram_state* ctx);
+
+/**
+* \brief Get the number of bytes a datagram adds to its payload.
+*
+* \param ctx: [const][struct] The datagram state
+*
+* \return Returns the size of the header and MAC code
+*/
+QSC_EXPORT_API size_t qsc_rcsdgram_overhead(const qsc_rcsdgram_state* ctx);
+
+/**
+* \brief Seal a batch of packets in place.
+* Each packet is assigned the next packet number, and its payload is encrypted and followed by the MAC code;
+* the datagram is the payload length plus qsc_rcsdgram_overhead bytes.
+* A packet whose capacity can not hold the datagram is skipped; its valid flag is cleared and its payload is unchanged.
+*
+* \param ctx: [struct] The datagram state
+* \param packets: [struct] The packets; the payload and its length are set, and the capacity holds the datagram
+* \param count: The number of packets
+*
+* \return Returns the number of packets sealed; the valid flag is set on each sealed packet
+*/
+QSC_EXPORT_API size_t qsc_rcsdgram_seal(qsc_rcsdgram_state* ctx, qsc_rcsdgram_packet* packets, size_t count);
+
+/**
+* \brief Open a batch of received packets in place.
+* Every packet is checked against the replay window, authenticated, and decrypted; the valid flag of a packet is set
+* only if it passed, and its length is then the payload length; the length of a packet that is not valid is set to zero.
+* Packets can arrive in any order.
+*
+* \param ctx: [struct] The datagram state
+* \param packets: [struct] The packets; the length is the received datagram length
+* \param count: The number of packets
+*
+* \return Returns the number of valid packets
+*/
+QSC_EXPORT_API size_t qsc_rcsdgram_open(qsc_rcsdgram_state* ctx, qsc_rcsdgram_packet* packets, size_t count);
+
+/**
+* \brief Seal a batch of packets and send them on a connected datagram socket.
+* A packet whose capacity can not hold the datagram is not sent.
+*
+* \param ctx: [struct] The datagram state
+* \param socket: The connected datagram socket
+* \param packets: [struct] The packets; the payload and its length are set, and the capacity holds the datagram
+* \param count: The number of packets
+*
+* \return Returns the number of packets sent; fewer than the number sealed if the socket returned an error
+*/
+QSC_EXPORT_API size_t qsc_rcsdgram_send(qsc_rcsdgram_state* ctx, qsc_rcsrec_socket socket, qsc_rcsdgram_packet* packets, size_t count);
+
+/**
+* \brief Receive a batch of packets from a connected datagram socket, and open them.
+* Blocks until at least one datagram arrives, then takes the datagrams that are already queued, up to count.
+*
+* \param ctx: [struct] The datagram state
+* \param socket: The connected datagram socket
+* \param packets: [struct] The packet buffers; the buffer and capacity are set
+* \param count: The number of packet buffers
+*
+* \return Returns the number of datagrams received, including the packets that are not valid; zero if the socket returned an error
+*/
+QSC_EXPORT_API size_t qsc_rcsdgram_receive(qsc_rcsdgram_state* ctx, qsc_rcsrec_socket socket, qsc_rcsdgram_packet* packets, size_t count);
+
+#endif
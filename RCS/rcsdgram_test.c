@@ -0,0 +1,459 @@
+#include "rcsdgram_test.h"
+#include "rcsrec_test.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "csp.h"
+#include "testutils.h"
+#include <stdlib.h>
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <winsock2.h>
+#	pragma comment(lib, "ws2_32.lib")
+#else
+#	include <arpa/inet.h>
+#	include <netinet/in.h>
+#	include <sys/socket.h>
+#endif
+
+#define RCSDGRAM_TEST_COUNT 150
+#define RCSDGRAM_TEST_PAYLOAD 1400
+#define RCSDGRAM_TEST_CAPACITY (RCSDGRAM_TEST_PAYLOAD + QSC_RCSDGRAM_OVERHEAD_MAX)
+
+bool qsctest_rcsdgram_loopback(qsc_rcsrec_socket sockets[2])
+{
+	struct sockaddr_in addr[2] = { 0 };
+	size_t i;
+	bool res;
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	WSADATA wsd;
+	int alen;
+
+	WSAStartup(MAKEWORD(2, 2), &wsd);
+#else
+	socklen_t alen;
+#endif
+
+	res = true;
+
+	/* bind both sockets to ephemeral ports, then connect each to the other */
+	for (i = 0; i < 2; ++i)
+	{
+		alen = (int)sizeof(addr[i]);
+		addr[i].sin_family = AF_INET;
+		addr[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr[i].sin_port = 0;
+		sockets[i] = (qsc_rcsrec_socket)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+		res = res && (bind(sockets[i], (struct sockaddr*)&addr[i], sizeof(addr[i])) == 0 &&
+			getsockname(sockets[i], (struct sockaddr*)&addr[i], &alen) == 0);
+	}
+
+	res = res && (connect(sockets[0], (struct sockaddr*)&addr[1], sizeof(addr[1])) == 0 &&
+		connect(sockets[1], (struct sockaddr*)&addr[0], sizeof(addr[0])) == 0);
+
+	if (res == false)
+	{
+		qsctest_rcsrec_close(sockets[0]);
+		qsctest_rcsrec_close(sockets[1]);
+	}
+
+	return res;
+}
+
+static void rcsdgram_packets_initialize(qsc_rcsdgram_packet* packets, uint8_t* buffers, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		packets[i].buffer = buffers + (i * RCSDGRAM_TEST_CAPACITY);
+		packets[i].capacity = RCSDGRAM_TEST_CAPACITY;
+		packets[i].length = (i * 53) % (RCSDGRAM_TEST_PAYLOAD + 1);
+		packets[i].number = 0;
+		packets[i].valid = false;
+		qsc_csp_generate(packets[i].buffer + QSC_RCSDGRAM_HEADER_SIZE, packets[i].length);
+	}
+}
+
+static bool rcsdgram_states_initialize(qsc_rcsdgram_state* sender, qsc_rcsdgram_state* receiver, size_t keylen)
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	bool res;
+
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(nonce, sizeof(nonce));
+	res = qsc_rcsdgram_initialize(sender, key, keylen, nonce, true);
+
+	if (qsc_rcsdgram_initialize(receiver, key, keylen, nonce, false) == false)
+	{
+		res = false;
+	}
+
+	return res;
+}
+
+static bool rcsdgram_equality(size_t keylen)
+{
+	qsc_rcsdgram_packet pkts[RCSDGRAM_TEST_COUNT];
+	qsc_rcsdgram_packet rpkt[RCSDGRAM_TEST_COUNT];
+	qsc_rcsdgram_state sender;
+	qsc_rcsdgram_state receiver;
+	uint8_t* bufs;
+	uint8_t* msgs;
+	size_t bcnt;
+	size_t j;
+	bool status;
+
+	status = rcsdgram_states_initialize(&sender, &receiver, keylen);
+	bufs = (uint8_t*)malloc(RCSDGRAM_TEST_COUNT * RCSDGRAM_TEST_CAPACITY);
+	msgs = (uint8_t*)malloc(RCSDGRAM_TEST_COUNT * RCSDGRAM_TEST_CAPACITY);
+
+	if (status == true && bufs != NULL && msgs != NULL)
+	{
+		rcsdgram_packets_initialize(pkts, bufs, RCSDGRAM_TEST_COUNT);
+		qsc_memutils_copy(msgs, bufs, RCSDGRAM_TEST_COUNT * RCSDGRAM_TEST_CAPACITY);
+		qsc_rcsdgram_seal(&sender, pkts, RCSDGRAM_TEST_COUNT);
+
+		/* the packets are opened in reverse order, in batches of seven */
+		for (size_t i = 0; i < RCSDGRAM_TEST_COUNT; ++i)
+		{
+			rpkt[i] = pkts[RCSDGRAM_TEST_COUNT - 1 - i];
+			rpkt[i].length += qsc_rcsdgram_overhead(&sender);
+		}
+
+		for (size_t i = 0; i < RCSDGRAM_TEST_COUNT; i += bcnt)
+		{
+			bcnt = qsc_intutils_min(7, RCSDGRAM_TEST_COUNT - i);
+
+			if (qsc_rcsdgram_open(&receiver, rpkt + i, bcnt) != bcnt)
+			{
+				qsctest_print_safe("Failure! rcsdgram_equality: authentication failure -DE1 \n");
+				status = false;
+			}
+		}
+
+		for (size_t i = 0; i < RCSDGRAM_TEST_COUNT; ++i)
+		{
+			j = RCSDGRAM_TEST_COUNT - 1 - i;
+
+			if (rpkt[i].valid == false || rpkt[i].number != (uint64_t)j || rpkt[i].length != pkts[j].length ||
+				qsc_intutils_are_equal8(rpkt[i].buffer + QSC_RCSDGRAM_HEADER_SIZE, msgs + (j * RCSDGRAM_TEST_CAPACITY) + QSC_RCSDGRAM_HEADER_SIZE, pkts[j].length) == false)
+			{
+				qsctest_print_safe("Failure! rcsdgram_equality: decryption mismatch -DE2 \n");
+				status = false;
+				break;
+			}
+		}
+	}
+	else
+	{
+		status = false;
+	}
+
+	qsc_rcsdgram_dispose(&sender);
+	qsc_rcsdgram_dispose(&receiver);
+
+	if (bufs != NULL)
+	{
+		free(bufs);
+	}
+
+	if (msgs != NULL)
+	{
+		free(msgs);
+	}
+
+	return status;
+}
+
+bool qsctest_rcsdgram_equality()
+{
+	bool status;
+
+	status = rcsdgram_equality(QSC_RCS256_KEY_SIZE);
+
+	if (rcsdgram_equality(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+static bool rcsdgram_open_copy(qsc_rcsdgram_state* ctx, const qsc_rcsdgram_packet* packet, uint8_t* buffer, size_t flip)
+{
+	qsc_rcsdgram_packet pcpy;
+
+	/* open a copy of a sealed packet, optionally with one bit changed */
+	pcpy = *packet;
+	pcpy.buffer = buffer;
+	pcpy.length = packet->length + qsc_rcsdgram_overhead(ctx);
+	qsc_memutils_copy(buffer, packet->buffer, pcpy.length);
+
+	if (flip < pcpy.length)
+	{
+		buffer[flip] ^= 0x01U;
+	}
+
+	return (qsc_rcsdgram_open(ctx, &pcpy, 1) == 1);
+}
+
+static bool rcsdgram_replay(size_t keylen)
+{
+	const size_t COUNT = QSC_RCSDGRAM_WINDOW_SIZE + 20;
+	uint8_t tmp[RCSDGRAM_TEST_CAPACITY] = { 0 };
+	qsc_rcsdgram_packet dups[2];
+	qsc_rcsdgram_packet* pkts;
+	qsc_rcsdgram_state sender;
+	qsc_rcsdgram_state receiver;
+	uint8_t* bufs;
+	uint8_t* dbuf;
+	bool status;
+
+	status = rcsdgram_states_initialize(&sender, &receiver, keylen);
+	pkts = (qsc_rcsdgram_packet*)malloc(COUNT * sizeof(qsc_rcsdgram_packet));
+	bufs = (uint8_t*)malloc(COUNT * RCSDGRAM_TEST_CAPACITY);
+	dbuf = (uint8_t*)malloc(2 * RCSDGRAM_TEST_CAPACITY);
+
+	if (status == true && pkts != NULL && bufs != NULL && dbuf != NULL)
+	{
+		rcsdgram_packets_initialize(pkts, bufs, COUNT);
+		qsc_rcsdgram_seal(&sender, pkts, COUNT);
+
+		/* a modified packet is rejected, and does not mark its number as seen */
+		if (rcsdgram_open_copy(&receiver, &pkts[1], tmp, QSC_RCSDGRAM_HEADER_SIZE + 3) == true ||
+			rcsdgram_open_copy(&receiver, &pkts[1], tmp, 0) == true ||
+			rcsdgram_open_copy(&receiver, &pkts[1], tmp, RCSDGRAM_TEST_CAPACITY) == false)
+		{
+			qsctest_print_safe("Failure! rcsdgram_replay: a modified packet was accepted -DA1 \n");
+			status = false;
+		}
+
+		/* an accepted packet is rejected when it is replayed */
+		if (rcsdgram_open_copy(&receiver, &pkts[1], tmp, RCSDGRAM_TEST_CAPACITY) == true)
+		{
+			qsctest_print_safe("Failure! rcsdgram_replay: a replayed packet was accepted -DA2 \n");
+			status = false;
+		}
+
+		/* a packet repeated within one batch is accepted once */
+		for (size_t i = 0; i < 2; ++i)
+		{
+			dups[i] = pkts[2];
+			dups[i].buffer = dbuf + (i * RCSDGRAM_TEST_CAPACITY);
+			dups[i].length = pkts[2].length + qsc_rcsdgram_overhead(&sender);
+			qsc_memutils_copy(dups[i].buffer, pkts[2].buffer, dups[i].length);
+		}
+
+		if (qsc_rcsdgram_open(&receiver, dups, 2) != 1 || dups[0].valid == false || dups[1].valid == true || dups[1].length != 0)
+		{
+			qsctest_print_safe("Failure! rcsdgram_replay: a duplicated packet was accepted twice -DA3 \n");
+			status = false;
+		}
+
+		/* a packet sent in the other direction is rejected */
+		if (rcsdgram_open_copy(&sender, &pkts[3], tmp, RCSDGRAM_TEST_CAPACITY) == true)
+		{
+			qsctest_print_safe("Failure! rcsdgram_replay: a reflected packet was accepted -DA4 \n");
+			status = false;
+		}
+
+		/* a datagram shorter than the header and MAC code is rejected */
+		dups[0].buffer = dbuf;
+		dups[0].length = qsc_rcsdgram_overhead(&sender) - 1;
+
+		if (qsc_rcsdgram_open(&receiver, dups, 1) != 0)
+		{
+			qsctest_print_safe("Failure! rcsdgram_replay: a short datagram was accepted -DA5 \n");
+			status = false;
+		}
+
+		/* after the last packet, the window reaches back QSC_RCSDGRAM_WINDOW_SIZE packet numbers */
+		if (rcsdgram_open_copy(&receiver, &pkts[COUNT - 1], tmp, RCSDGRAM_TEST_CAPACITY) == false ||
+			rcsdgram_open_copy(&receiver, &pkts[COUNT - 1 - QSC_RCSDGRAM_WINDOW_SIZE], tmp, RCSDGRAM_TEST_CAPACITY) == true ||
+			rcsdgram_open_copy(&receiver, &pkts[COUNT - QSC_RCSDGRAM_WINDOW_SIZE], tmp, RCSDGRAM_TEST_CAPACITY) == false ||
+			rcsdgram_open_copy(&receiver, &pkts[COUNT - 2], tmp, RCSDGRAM_TEST_CAPACITY) == false)
+		{
+			qsctest_print_safe("Failure! rcsdgram_replay: the replay window is not enforced -DA6 \n");
+			status = false;
+		}
+
+		/* a packet that does not fit its buffer is skipped, and does not consume a packet number */
+		for (size_t i = 0; i < 2; ++i)
+		{
+			dups[i].buffer = dbuf + (i * RCSDGRAM_TEST_CAPACITY);
+			dups[i].capacity = RCSDGRAM_TEST_CAPACITY;
+			dups[i].length = RCSDGRAM_TEST_PAYLOAD;
+			qsc_memutils_setvalue(dups[i].buffer + QSC_RCSDGRAM_HEADER_SIZE, 0xA5U, RCSDGRAM_TEST_PAYLOAD);
+		}
+
+		dups[0].capacity = RCSDGRAM_TEST_PAYLOAD + qsc_rcsdgram_overhead(&sender) - 1;
+		qsc_memutils_setvalue(tmp, 0xA5U, RCSDGRAM_TEST_PAYLOAD);
+
+		if (qsc_rcsdgram_seal(&sender, dups, 2) != 1 || dups[0].valid == true || dups[1].valid == false || dups[1].number != COUNT ||
+			qsc_intutils_are_equal8(dups[0].buffer + QSC_RCSDGRAM_HEADER_SIZE, tmp, RCSDGRAM_TEST_PAYLOAD) == false ||
+			rcsdgram_open_copy(&receiver, &dups[1], tmp, RCSDGRAM_TEST_CAPACITY) == false)
+		{
+			qsctest_print_safe("Failure! rcsdgram_replay: a packet larger than its buffer was sealed -DA7 \n");
+			status = false;
+		}
+	}
+	else
+	{
+		status = false;
+	}
+
+	qsc_rcsdgram_dispose(&sender);
+	qsc_rcsdgram_dispose(&receiver);
+
+	if (pkts != NULL)
+	{
+		free(pkts);
+	}
+
+	if (bufs != NULL)
+	{
+		free(bufs);
+	}
+
+	if (dbuf != NULL)
+	{
+		free(dbuf);
+	}
+
+	return status;
+}
+
+bool qsctest_rcsdgram_replay()
+{
+	bool status;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	status = rcsdgram_replay(QSC_RCS256_KEY_SIZE);
+
+	if (rcsdgram_replay(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+bool qsctest_rcsdgram_socket()
+{
+	const size_t BATCHES[] = { 1, 32, QSC_RCSDGRAM_BATCH_MAX };
+	qsc_rcsdgram_packet pkts[QSC_RCSDGRAM_BATCH_MAX];
+	qsc_rcsdgram_packet rpkt[QSC_RCSDGRAM_BATCH_MAX];
+	qsc_rcsrec_socket socks[2];
+	qsc_rcsdgram_state sender;
+	qsc_rcsdgram_state receiver;
+	uint8_t* msgs;
+	uint8_t* rbufs;
+	uint8_t* sbufs;
+	size_t rcnt;
+	size_t rtot;
+	bool status;
+
+	status = rcsdgram_states_initialize(&sender, &receiver, QSC_RCS256_KEY_SIZE);
+	msgs = (uint8_t*)malloc(QSC_RCSDGRAM_BATCH_MAX * RCSDGRAM_TEST_CAPACITY);
+	rbufs = (uint8_t*)malloc(QSC_RCSDGRAM_BATCH_MAX * RCSDGRAM_TEST_CAPACITY);
+	sbufs = (uint8_t*)malloc(QSC_RCSDGRAM_BATCH_MAX * RCSDGRAM_TEST_CAPACITY);
+
+	if (status == true && msgs != NULL && rbufs != NULL && sbufs != NULL && qsctest_rcsdgram_loopback(socks) == true)
+	{
+		for (size_t i = 0; i < sizeof(BATCHES) / sizeof(BATCHES[0]) && status == true; ++i)
+		{
+			const size_t BCNT = BATCHES[i];
+
+			rcsdgram_packets_initialize(pkts, sbufs, BCNT);
+			rcsdgram_packets_initialize(rpkt, rbufs, BCNT);
+			qsc_memutils_copy(msgs, sbufs, BCNT * RCSDGRAM_TEST_CAPACITY);
+
+			if (qsc_rcsdgram_send(&sender, socks[0], pkts, BCNT) != BCNT)
+			{
+				qsctest_print_safe("Failure! rcsdgram_socket: the packets were not sent -DS1 \n");
+				status = false;
+			}
+
+			/* loopback datagrams are queued when the send returns, so a batch usually arrives in one call */
+			rtot = 0;
+
+			while (rtot < BCNT && status == true)
+			{
+				rcnt = qsc_rcsdgram_receive(&receiver, socks[1], rpkt + rtot, BCNT - rtot);
+				status = (rcnt != 0);
+				rtot += rcnt;
+			}
+
+			for (size_t j = 0; j < rtot; ++j)
+			{
+				if (rpkt[j].valid == false || rpkt[j].length != pkts[j].length ||
+					qsc_intutils_are_equal8(rpkt[j].buffer + QSC_RCSDGRAM_HEADER_SIZE, msgs + (j * RCSDGRAM_TEST_CAPACITY) + QSC_RCSDGRAM_HEADER_SIZE, pkts[j].length) == false)
+				{
+					qsctest_print_safe("Failure! rcsdgram_socket: decryption mismatch -DS2 \n");
+					status = false;
+					break;
+				}
+			}
+		}
+
+		qsctest_rcsrec_close(socks[0]);
+		qsctest_rcsrec_close(socks[1]);
+	}
+	else
+	{
+		status = false;
+	}
+
+	qsc_rcsdgram_dispose(&sender);
+	qsc_rcsdgram_dispose(&receiver);
+
+	if (msgs != NULL)
+	{
+		free(msgs);
+	}
+
+	if (rbufs != NULL)
+	{
+		free(rbufs);
+	}
+
+	if (sbufs != NULL)
+	{
+		free(sbufs);
+	}
+
+	return status;
+}
+
+void qsctest_rcsdgram_run()
+{
+	if (qsctest_rcsdgram_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS datagram equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS datagram equality test. \n");
+	}
+
+	if (qsctest_rcsdgram_replay() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS datagram replay window test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS datagram replay window test. \n");
+	}
+
+	if (qsctest_rcsdgram_socket() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS datagram socket test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS datagram socket test. \n");
+	}
+}
@@ -0,0 +1,51 @@
+/**
+* \file rcsdgram_test.h
+* \brief <b>RCS Datagram Tests</b> \n
+* Out-of-order, replay window, tamper, and loopback socket tests for the datagram functions.
+* \author John Underhill
+* \date October 02, 2020
+*/
+
+#ifndef QSCTEST_RCSDGRAM_TEST_H
+#define QSCTEST_RCSDGRAM_TEST_H
+
+#include "common.h"
+#include "rcsdgram.h"
+
+/**
+* \brief Create a pair of UDP sockets on the loopback interface, each connected to the other.
+*
+* \param sockets: The connected sockets
+*
+* \return Returns true if the sockets are connected
+*/
+bool qsctest_rcsdgram_loopback(qsc_rcsrec_socket sockets[2]);
+
+/**
+* \brief Tests sealing a batch of packets, and opening them in reverse order in smaller batches.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsdgram_equality();
+
+/**
+* \brief Tests that modified, replayed, duplicated, reflected, short, and out-of-window packets are rejected,
+* that a rejected packet does not move the replay window, and that a packet larger than its buffer is not sealed.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsdgram_replay();
+
+/**
+* \brief Tests batched sending and receiving of packets over a loopback UDP connection.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsdgram_socket();
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_rcsdgram_run();
+
+#endif
@@ -0,0 +1,422 @@
+#include "rcsfile.h"
+#include "csp.h"
+#include "memutils.h"
+#include "timerex.h"
+#include <stdio.h>
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+static void rcsfile_map_clear(qsc_rcsfile_map* map)
+{
+	map->data = NULL;
+	map->length = 0;
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	map->file = INVALID_HANDLE_VALUE;
+	map->mapping = NULL;
+#else
+	map->handle = -1;
+#endif
+}
+
+#if !defined(QSC_SYSTEM_OS_WINDOWS)
+static void rcsfile_map_advise(qsc_rcsfile_map* map)
+{
+	/* the segments are walked front to back by every worker, so read ahead aggressively
+	   and drop pages behind the workers; huge pages cut the page-table walk on anonymous and tmpfs backed mappings */
+#if defined(MADV_SEQUENTIAL)
+	madvise(map->data, (size_t)map->length, MADV_SEQUENTIAL);
+#endif
+#if defined(MADV_HUGEPAGE)
+	madvise(map->data, (size_t)map->length, MADV_HUGEPAGE);
+#endif
+}
+
+static bool rcsfile_same_file(const qsc_rcsfile_map* map, const char* path)
+{
+	struct stat sin;
+	struct stat sout;
+	bool res;
+
+	res = false;
+
+	if (fstat(map->handle, &sin) == 0 && stat(path, &sout) == 0)
+	{
+		res = (sin.st_dev == sout.st_dev && sin.st_ino == sout.st_ino);
+	}
+
+	return res;
+}
+#endif
+
+static bool rcsfile_key_valid(size_t keylen)
+{
+	return (keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE);
+}
+
+static void rcsfile_statistics_set(qsc_rcsfile_statistics* stats, uint64_t length, uint64_t start)
+{
+	if (stats != NULL)
+	{
+		stats->length = length;
+		stats->nanoseconds = qsc_timerex_monotonic_nanoseconds() - start;
+	}
+}
+
+static qsc_rcsfile_status rcsfile_container_load(qsc_rcsseg_state* ctx, const qsc_rcsfile_map* map, const uint8_t* key, size_t keylen, uint64_t* plainlen)
+{
+	qsc_rcsfile_status res;
+
+	res = qsc_rcsfile_status_invalid_format;
+	*plainlen = 0;
+
+	if (map->length >= QSC_RCSSEG_HEADER_SIZE && qsc_rcsseg_initialize(ctx, key, keylen, map->data) == true)
+	{
+		*plainlen = qsc_rcsseg_decrypted_size(ctx, map->length);
+
+		/* a container that does not end on a segment and MAC code boundary was truncated or extended */
+		if (qsc_rcsseg_encrypted_size(ctx, *plainlen) == map->length)
+		{
+			res = qsc_rcsfile_status_success;
+		}
+		else
+		{
+			res = qsc_rcsfile_status_authentication_failure;
+			qsc_rcsseg_dispose(ctx);
+		}
+	}
+
+	return res;
+}
+
+bool qsc_rcsfile_map_input(qsc_rcsfile_map* map, const char* path)
+{
+	assert(map != NULL);
+	assert(path != NULL);
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	LARGE_INTEGER flen;
+#else
+	struct stat fst;
+	void* pmap;
+#endif
+	bool res;
+
+	res = false;
+	rcsfile_map_clear(map);
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (map->file != INVALID_HANDLE_VALUE && GetFileSizeEx(map->file, &flen) == TRUE && (uint64_t)flen.QuadPart <= (uint64_t)SIZE_MAX)
+	{
+		map->length = (uint64_t)flen.QuadPart;
+		res = true;
+
+		if (map->length != 0)
+		{
+			map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+			if (map->mapping != NULL)
+			{
+				map->data = (uint8_t*)MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+			}
+
+			res = (map->data != NULL);
+		}
+	}
+#else
+	map->handle = open(path, O_RDONLY);
+
+	if (map->handle >= 0 && fstat(map->handle, &fst) == 0 && S_ISREG(fst.st_mode) && (uint64_t)fst.st_size <= (uint64_t)SIZE_MAX)
+	{
+		map->length = (uint64_t)fst.st_size;
+		res = true;
+
+		if (map->length != 0)
+		{
+			pmap = mmap(NULL, (size_t)map->length, PROT_READ, MAP_SHARED, map->handle, 0);
+			res = (pmap != MAP_FAILED);
+
+			if (res == true)
+			{
+				map->data = (uint8_t*)pmap;
+				rcsfile_map_advise(map);
+			}
+		}
+	}
+#endif
+
+	if (res == false)
+	{
+		qsc_rcsfile_unmap(map);
+	}
+
+	return res;
+}
+
+bool qsc_rcsfile_map_output(qsc_rcsfile_map* map, const char* path, uint64_t length)
+{
+	assert(map != NULL);
+	assert(path != NULL);
+
+#if !defined(QSC_SYSTEM_OS_WINDOWS)
+	void* pmap;
+#endif
+	bool res;
+
+	res = false;
+	rcsfile_map_clear(map);
+
+	if (length <= (uint64_t)SIZE_MAX)
+	{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		map->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+		if (map->file != INVALID_HANDLE_VALUE)
+		{
+			map->length = length;
+			res = true;
+
+			if (length != 0)
+			{
+				/* creating the mapping extends the file to the mapping size */
+				map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READWRITE, (DWORD)(length >> 32), (DWORD)length, NULL);
+
+				if (map->mapping != NULL)
+				{
+					map->data = (uint8_t*)MapViewOfFile(map->mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)length);
+				}
+
+				res = (map->data != NULL);
+			}
+		}
+#else
+		map->handle = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+		if (map->handle >= 0 && ftruncate(map->handle, (off_t)length) == 0)
+		{
+			map->length = length;
+			res = true;
+
+			if (length != 0)
+			{
+#	if defined(QSC_SYSTEM_OS_LINUX)
+				/* allocate the blocks up front, so the page faults of the workers do not allocate on the file system;
+				   a file system without fallocate support is not an error, running out of space is */
+				res = (posix_fallocate(map->handle, 0, (off_t)length) != ENOSPC);
+#	endif
+
+				if (res == true)
+				{
+					pmap = mmap(NULL, (size_t)length, PROT_READ | PROT_WRITE, MAP_SHARED, map->handle, 0);
+					res = (pmap != MAP_FAILED);
+
+					if (res == true)
+					{
+						map->data = (uint8_t*)pmap;
+						rcsfile_map_advise(map);
+					}
+				}
+			}
+		}
+#endif
+	}
+
+	if (res == false)
+	{
+		qsc_rcsfile_unmap(map);
+	}
+
+	return res;
+}
+
+void qsc_rcsfile_unmap(qsc_rcsfile_map* map)
+{
+	if (map != NULL)
+	{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		if (map->data != NULL)
+		{
+			UnmapViewOfFile(map->data);
+		}
+
+		if (map->mapping != NULL)
+		{
+			CloseHandle(map->mapping);
+		}
+
+		if (map->file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(map->file);
+		}
+#else
+		if (map->data != NULL)
+		{
+			munmap(map->data, (size_t)map->length);
+		}
+
+		if (map->handle >= 0)
+		{
+			close(map->handle);
+		}
+#endif
+
+		rcsfile_map_clear(map);
+	}
+}
+
+qsc_rcsfile_status qsc_rcsfile_encrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, size_t segsize, qsc_rcsfile_statistics* stats)
+{
+	assert(inpath != NULL);
+	assert(outpath != NULL);
+	assert(key != NULL);
+
+	uint8_t header[QSC_RCSSEG_HEADER_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcsseg_state ctx;
+	qsc_rcsfile_map fin;
+	qsc_rcsfile_map fout;
+	qsc_rcsfile_status res;
+	uint64_t start;
+
+	start = qsc_timerex_monotonic_nanoseconds();
+
+	if (rcsfile_key_valid(keylen) == false || segsize < QSC_RCSSEG_SEGMENT_MIN || segsize > QSC_RCSSEG_SEGMENT_MAX ||
+		qsc_csp_generate(nonce, sizeof(nonce)) == false)
+	{
+		res = qsc_rcsfile_status_invalid_parameter;
+	}
+	else if (qsc_rcsfile_map_input(&fin, inpath) == false)
+	{
+		res = qsc_rcsfile_status_read_failure;
+	}
+	else
+	{
+		qsc_rcsseg_header_encode(header, keylen, segsize, nonce);
+		qsc_rcsseg_initialize(&ctx, key, keylen, header);
+		res = qsc_rcsfile_status_write_failure;
+
+#if !defined(QSC_SYSTEM_OS_WINDOWS)
+		if (rcsfile_same_file(&fin, outpath) == false)
+#endif
+		{
+			if (qsc_rcsfile_map_output(&fout, outpath, qsc_rcsseg_encrypted_size(&ctx, fin.length)) == true)
+			{
+				qsc_rcsseg_encrypt(&ctx, fout.data, fin.data, fin.length);
+				qsc_rcsfile_unmap(&fout);
+				res = qsc_rcsfile_status_success;
+			}
+		}
+
+		rcsfile_statistics_set(stats, fin.length, start);
+		qsc_rcsseg_dispose(&ctx);
+		qsc_rcsfile_unmap(&fin);
+	}
+
+	return res;
+}
+
+qsc_rcsfile_status qsc_rcsfile_decrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, qsc_rcsfile_statistics* stats)
+{
+	assert(inpath != NULL);
+	assert(outpath != NULL);
+	assert(key != NULL);
+
+	qsc_rcsseg_state ctx;
+	qsc_rcsfile_map fin;
+	qsc_rcsfile_map fout;
+	qsc_rcsfile_status res;
+	uint64_t plen;
+	uint64_t start;
+
+	start = qsc_timerex_monotonic_nanoseconds();
+
+	if (rcsfile_key_valid(keylen) == false)
+	{
+		res = qsc_rcsfile_status_invalid_parameter;
+	}
+	else if (qsc_rcsfile_map_input(&fin, inpath) == false)
+	{
+		res = qsc_rcsfile_status_read_failure;
+	}
+	else
+	{
+		res = rcsfile_container_load(&ctx, &fin, key, keylen, &plen);
+
+		if (res == qsc_rcsfile_status_success)
+		{
+			res = qsc_rcsfile_status_write_failure;
+
+#if !defined(QSC_SYSTEM_OS_WINDOWS)
+			if (rcsfile_same_file(&fin, outpath) == false)
+#endif
+			{
+				if (qsc_rcsfile_map_output(&fout, outpath, plen) == true)
+				{
+					res = (qsc_rcsseg_decrypt(&ctx, fout.data, fin.data, fin.length) == true) ?
+						qsc_rcsfile_status_success : qsc_rcsfile_status_authentication_failure;
+					qsc_rcsfile_unmap(&fout);
+
+					if (res != qsc_rcsfile_status_success)
+					{
+						/* the output was erased, do not leave an empty file in its place */
+						remove(outpath);
+					}
+				}
+			}
+
+			rcsfile_statistics_set(stats, plen, start);
+			qsc_rcsseg_dispose(&ctx);
+		}
+
+		qsc_rcsfile_unmap(&fin);
+	}
+
+	return res;
+}
+
+qsc_rcsfile_status qsc_rcsfile_verify(const char* inpath, const uint8_t* key, size_t keylen, qsc_rcsfile_statistics* stats)
+{
+	assert(inpath != NULL);
+	assert(key != NULL);
+
+	qsc_rcsseg_state ctx;
+	qsc_rcsfile_map fin;
+	qsc_rcsfile_status res;
+	uint64_t plen;
+	uint64_t start;
+
+	start = qsc_timerex_monotonic_nanoseconds();
+
+	if (rcsfile_key_valid(keylen) == false)
+	{
+		res = qsc_rcsfile_status_invalid_parameter;
+	}
+	else if (qsc_rcsfile_map_input(&fin, inpath) == false)
+	{
+		res = qsc_rcsfile_status_read_failure;
+	}
+	else
+	{
+		res = rcsfile_container_load(&ctx, &fin, key, keylen, &plen);
+
+		if (res == qsc_rcsfile_status_success)
+		{
+			res = (qsc_rcsseg_verify(&ctx, fin.data, fin.length) == true) ?
+				qsc_rcsfile_status_success : qsc_rcsfile_status_authentication_failure;
+			rcsfile_statistics_set(stats, plen, start);
+			qsc_rcsseg_dispose(&ctx);
+		}
+
+		qsc_rcsfile_unmap(&fin);
+	}
+
+	return res;
+}
@@ -0,0 +1,155 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSFILE_H
+#define QSC_RCSFILE_H
+
+/**
+* \file rcsfile.h
+* \brief RCS memory-mapped file encryption functions \n
+* Encrypts, decrypts, and verifies files in the segmented container format (rcsseg.h).
+*
+* The input and output files are memory-mapped, and the segments are transformed by a pool of worker threads
+* directly between the mapped pages, so no file data is copied through read or write buffers.
+* On posix systems the mappings are advised for sequential access (and transparent huge pages where supported),
+* and the output file is pre-allocated before it is written. \n
+* A decrypted file is written only if every segment is authentic; if authentication fails the output file is removed.
+*
+* File encryption example \n
+* \code
+* qsc_rcsfile_statistics stats;
+*
+* if (qsc_rcsfile_encrypt("plain.bin", "cipher.rcs", key, QSC_RCS256_KEY_SIZE, QSC_RCSSEG_SEGMENT_DEFAULT, &stats) == qsc_rcsfile_status_success)
+* {
+*     // throughput in GB/s: stats.length / stats.nanoseconds
+* }
+* \endcode
+*/
+
+#include "common.h"
+#include "rcsseg.h"
+
+/*! \enum qsc_rcsfile_status
+* The file operation result
+*/
+typedef enum
+{
+	qsc_rcsfile_status_success = 0,					/*!< The operation completed */
+	qsc_rcsfile_status_invalid_parameter = 1,		/*!< The key length or segment size is not valid */
+	qsc_rcsfile_status_read_failure = 2,			/*!< The input file could not be opened or mapped */
+	qsc_rcsfile_status_write_failure = 3,			/*!< The output file could not be created or mapped */
+	qsc_rcsfile_status_invalid_format = 4,			/*!< The input is not a container, or was not written with this key length */
+	qsc_rcsfile_status_authentication_failure = 5,	/*!< A segment failed authentication, or the container was truncated */
+} qsc_rcsfile_status;
+
+/*!
+* \struct qsc_rcsfile_map
+* \brief A memory-mapped file
+*/
+QSC_EXPORT_API typedef struct
+{
+	uint8_t* data;			/*!< The mapped file; NULL for an empty file */
+	uint64_t length;		/*!< The file length in bytes */
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	void* file;				/*!< The file handle */
+	void* mapping;			/*!< The file-mapping handle */
+#else
+	int handle;				/*!< The file descriptor */
+#endif
+} qsc_rcsfile_map;
+
+/*!
+* \struct qsc_rcsfile_statistics
+* \brief The statistics of a file operation
+*/
+QSC_EXPORT_API typedef struct
+{
+	uint64_t length;		/*!< The number of plain-text bytes processed */
+	uint64_t nanoseconds;	/*!< The elapsed wall-clock time of the operation, including the mapping of the files */
+} qsc_rcsfile_statistics;
+
+/**
+* \brief Map a file for reading.
+*
+* \param map: [struct] The file map
+* \param path: [const] The file path
+*
+* \return Returns true if the file was opened and mapped
+*/
+QSC_EXPORT_API bool qsc_rcsfile_map_input(qsc_rcsfile_map* map, const char* path);
+
+/**
+* \brief Create or truncate a file, set its length, and map it for writing.
+*
+* \param map: [struct] The file map
+* \param path: [const] The file path
+* \param length: The length of the file in bytes
+*
+* \return Returns true if the file was created and mapped
+*/
+QSC_EXPORT_API bool qsc_rcsfile_map_output(qsc_rcsfile_map* map, const char* path, uint64_t length);
+
+/**
+* \brief Unmap and close a mapped file.
+*
+* \param map: [struct] The file map
+*/
+QSC_EXPORT_API void qsc_rcsfile_unmap(qsc_rcsfile_map* map);
+
+/**
+* \brief Encrypt a file into a segmented container, written with a random file nonce.
+*
+* \param inpath: [const] The plain-text file path
+* \param outpath: [const] The container file path; must not be the input file
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param segsize: The number of plain-text bytes in a segment, between QSC_RCSSEG_SEGMENT_MIN and QSC_RCSSEG_SEGMENT_MAX
+* \param stats: [struct] The operation statistics; can be NULL
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsfile_status qsc_rcsfile_encrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, size_t segsize, qsc_rcsfile_statistics* stats);
+
+/**
+* \brief Authenticate and decrypt a segmented container file.
+* If any segment fails authentication, the output file is removed.
+*
+* \param inpath: [const] The container file path
+* \param outpath: [const] The plain-text file path; must not be the input file
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param stats: [struct] The operation statistics; can be NULL
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsfile_status qsc_rcsfile_decrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, qsc_rcsfile_statistics* stats);
+
+/**
+* \brief Authenticate every segment of a container file, without writing the plain-text.
+*
+* \param inpath: [const] The container file path
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param stats: [struct] The operation statistics; can be NULL
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsfile_status qsc_rcsfile_verify(const char* inpath, const uint8_t* key, size_t keylen, qsc_rcsfile_statistics* stats);
+
+#endif
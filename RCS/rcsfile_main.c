@@ -0,0 +1,177 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* rcs-file: encrypt, decrypt, and verify files in the segmented container format.
+*
+* rcs-file enc <key-file> <input> <output> [segment-size]
+* rcs-file dec <key-file> <input> <output>
+* rcs-file verify <key-file> <input>
+*
+* The key file holds the raw cipher key; 32 bytes for RCS-256, or 64 bytes for RCS-512.
+*/
+
+#include "common.h"
+#include "memutils.h"
+#include "rcsfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void rcsfile_print_usage(void)
+{
+	fprintf(stderr, "usage: rcs-file enc <key-file> <input> <output> [segment-size]\n");
+	fprintf(stderr, "       rcs-file dec <key-file> <input> <output>\n");
+	fprintf(stderr, "       rcs-file verify <key-file> <input>\n");
+	fprintf(stderr, "The key file holds a %d byte RCS-256 or a %d byte RCS-512 key.\n", QSC_RCS256_KEY_SIZE, QSC_RCS512_KEY_SIZE);
+	fprintf(stderr, "The segment size is between %d and %d bytes, the default is %d.\n", QSC_RCSSEG_SEGMENT_MIN, QSC_RCSSEG_SEGMENT_MAX, QSC_RCSSEG_SEGMENT_DEFAULT);
+}
+
+static const char* rcsfile_status_to_string(qsc_rcsfile_status status)
+{
+	const char* msg;
+
+	switch (status)
+	{
+		case qsc_rcsfile_status_success:
+			msg = "success";
+			break;
+		case qsc_rcsfile_status_invalid_parameter:
+			msg = "the key or segment size is invalid";
+			break;
+		case qsc_rcsfile_status_read_failure:
+			msg = "the input file could not be read";
+			break;
+		case qsc_rcsfile_status_write_failure:
+			msg = "the output file could not be written";
+			break;
+		case qsc_rcsfile_status_invalid_format:
+			msg = "the input is not a container for this key";
+			break;
+		case qsc_rcsfile_status_authentication_failure:
+			msg = "authentication failed";
+			break;
+		default:
+			msg = "unknown error";
+	}
+
+	return msg;
+}
+
+static bool rcsfile_key_load(uint8_t* key, size_t* keylen, const char* path)
+{
+	qsc_rcsfile_map fkey;
+	bool res;
+
+	res = false;
+	*keylen = 0;
+
+	if (qsc_rcsfile_map_input(&fkey, path) == true)
+	{
+		if (fkey.length == QSC_RCS256_KEY_SIZE || fkey.length == QSC_RCS512_KEY_SIZE)
+		{
+			*keylen = (size_t)fkey.length;
+			qsc_memutils_copy(key, fkey.data, *keylen);
+			res = true;
+		}
+
+		qsc_rcsfile_unmap(&fkey);
+	}
+
+	return res;
+}
+
+static void rcsfile_print_statistics(const char* operation, const qsc_rcsfile_statistics* stats)
+{
+	double gbps;
+	double secs;
+
+	secs = (double)stats->nanoseconds / 1000000000.0;
+	gbps = (stats->nanoseconds != 0) ? (double)stats->length / (double)stats->nanoseconds : 0.0;
+	printf("%s: %llu bytes in %.3f seconds, %.2f GB/s\n", operation, (unsigned long long)stats->length, secs, gbps);
+}
+
+int main(int argc, char* argv[])
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	qsc_rcsfile_statistics stats = { 0 };
+	qsc_rcsfile_status res;
+	const char* mode;
+	char* pend;
+	size_t keylen;
+	size_t segsize;
+	int ret;
+
+	ret = EXIT_FAILURE;
+	res = qsc_rcsfile_status_invalid_parameter;
+	mode = (argc > 1) ? argv[1] : "";
+	segsize = QSC_RCSSEG_SEGMENT_DEFAULT;
+
+	if ((strcmp(mode, "enc") == 0 && (argc == 5 || argc == 6)) ||
+		(strcmp(mode, "dec") == 0 && argc == 5) ||
+		(strcmp(mode, "verify") == 0 && argc == 4))
+	{
+		if (argc == 6)
+		{
+			segsize = (size_t)strtoull(argv[5], &pend, 10);
+
+			if (*pend != '\0')
+			{
+				segsize = 0;
+			}
+		}
+
+		if (rcsfile_key_load(key, &keylen, argv[2]) == false)
+		{
+			fprintf(stderr, "rcs-file: the key file %s could not be read, or is not %d or %d bytes\n", argv[2], QSC_RCS256_KEY_SIZE, QSC_RCS512_KEY_SIZE);
+		}
+		else
+		{
+			if (strcmp(mode, "enc") == 0)
+			{
+				res = qsc_rcsfile_encrypt(argv[3], argv[4], key, keylen, segsize, &stats);
+			}
+			else if (strcmp(mode, "dec") == 0)
+			{
+				res = qsc_rcsfile_decrypt(argv[3], argv[4], key, keylen, &stats);
+			}
+			else
+			{
+				res = qsc_rcsfile_verify(argv[3], key, keylen, &stats);
+			}
+
+			if (res == qsc_rcsfile_status_success)
+			{
+				rcsfile_print_statistics(mode, &stats);
+				ret = EXIT_SUCCESS;
+			}
+			else
+			{
+				fprintf(stderr, "rcs-file: %s: %s\n", argv[3], rcsfile_status_to_string(res));
+			}
+		}
+
+		qsc_memutils_clear(key, sizeof(key));
+	}
+	else
+	{
+		rcsfile_print_usage();
+	}
+
+	return ret;
+}
@@ -0,0 +1,248 @@
+#include "rcsfile_test.h"
+#include "rcsfile.h"
+#include "rcsuring.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "csp.h"
+#include "testutils.h"
+#include <stdio.h>
+
+#define RCSFILE_TEST_PLAIN "rcsfile_test.pln"
+#define RCSFILE_TEST_CIPHER "rcsfile_test.rcs"
+#define RCSFILE_TEST_DECRYPTED "rcsfile_test.dec"
+
+static bool rcsfile_write(const char* path, const uint8_t* input, size_t length)
+{
+	qsc_rcsfile_map fout;
+	bool res;
+
+	res = qsc_rcsfile_map_output(&fout, path, length);
+
+	if (res == true)
+	{
+		if (length != 0)
+		{
+			qsc_memutils_copy(fout.data, input, length);
+		}
+
+		qsc_rcsfile_unmap(&fout);
+	}
+
+	return res;
+}
+
+static bool rcsfile_compare(const char* path, const uint8_t* expected, size_t length)
+{
+	qsc_rcsfile_map fin;
+	bool res;
+
+	res = qsc_rcsfile_map_input(&fin, path);
+
+	if (res == true)
+	{
+		res = (fin.length == length && (length == 0 || qsc_intutils_are_equal8(fin.data, expected, length) == true));
+		qsc_rcsfile_unmap(&fin);
+	}
+
+	return res;
+}
+
+static bool rcsfile_equality(size_t keylen, size_t length)
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t* msg;
+	qsc_rcsfile_statistics stats;
+	bool status;
+
+	status = false;
+	msg = (uint8_t*)qsc_memutils_malloc((length != 0) ? length : 1);
+
+	if (msg != NULL)
+	{
+		status = true;
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(msg, length);
+
+		if (rcsfile_write(RCSFILE_TEST_PLAIN, msg, length) == false ||
+			qsc_rcsfile_encrypt(RCSFILE_TEST_PLAIN, RCSFILE_TEST_CIPHER, key, keylen, 4096, &stats) != qsc_rcsfile_status_success ||
+			stats.length != length)
+		{
+			qsctest_print_safe("Failure! rcsfile_equality: encryption failure -FE1 \n");
+			status = false;
+		}
+
+		if (qsc_rcsfile_verify(RCSFILE_TEST_CIPHER, key, keylen, &stats) != qsc_rcsfile_status_success)
+		{
+			qsctest_print_safe("Failure! rcsfile_equality: verification failure -FE2 \n");
+			status = false;
+		}
+
+		if (qsc_rcsfile_decrypt(RCSFILE_TEST_CIPHER, RCSFILE_TEST_DECRYPTED, key, keylen, &stats) != qsc_rcsfile_status_success ||
+			rcsfile_compare(RCSFILE_TEST_DECRYPTED, msg, length) == false)
+		{
+			qsctest_print_safe("Failure! rcsfile_equality: decryption mismatch -FE3 \n");
+			status = false;
+		}
+
+		/* the output file can not replace the input file */
+		if (qsc_rcsfile_encrypt(RCSFILE_TEST_PLAIN, RCSFILE_TEST_PLAIN, key, keylen, 4096, &stats) == qsc_rcsfile_status_success ||
+			rcsfile_compare(RCSFILE_TEST_PLAIN, msg, length) == false)
+		{
+			qsctest_print_safe("Failure! rcsfile_equality: input overwritten -FE4 \n");
+			status = false;
+		}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+		/* a modified container fails, and no plain-text file is left behind */
+		remove(RCSFILE_TEST_DECRYPTED);
+
+		if (qsctest_file_flip(RCSFILE_TEST_CIPHER, QSC_RCSSEG_HEADER_SIZE + (length / 2)) == false ||
+			qsc_rcsfile_verify(RCSFILE_TEST_CIPHER, key, keylen, &stats) != qsc_rcsfile_status_authentication_failure ||
+			qsc_rcsfile_decrypt(RCSFILE_TEST_CIPHER, RCSFILE_TEST_DECRYPTED, key, keylen, &stats) != qsc_rcsfile_status_authentication_failure ||
+			rcsfile_compare(RCSFILE_TEST_DECRYPTED, msg, 0) == true)
+		{
+			qsctest_print_safe("Failure! rcsfile_equality: authentication bypass -FE5 \n");
+			status = false;
+		}
+#endif
+
+		remove(RCSFILE_TEST_PLAIN);
+		remove(RCSFILE_TEST_CIPHER);
+		remove(RCSFILE_TEST_DECRYPTED);
+		qsc_memutils_alloc_free(msg);
+	}
+
+	return status;
+}
+
+bool qsctest_rcsfile_equality()
+{
+	const size_t LENGTHS[] = { 0, 1, 4096, 1000003 };
+	bool status;
+
+	status = true;
+
+	for (size_t i = 0; i < sizeof(LENGTHS) / sizeof(LENGTHS[0]); ++i)
+	{
+		if (rcsfile_equality(QSC_RCS256_KEY_SIZE, LENGTHS[i]) == false ||
+			rcsfile_equality(QSC_RCS512_KEY_SIZE, LENGTHS[i]) == false)
+		{
+			status = false;
+		}
+	}
+
+	return status;
+}
+
+#if defined(QSC_RCSURING_ENABLED)
+static bool rcsuring_equality(size_t keylen, size_t length, const qsc_rcsuring_params* params)
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t* msg;
+	qsc_rcsfile_statistics stats;
+	bool status;
+
+	status = false;
+	msg = (uint8_t*)qsc_memutils_malloc((length != 0) ? length : 1);
+
+	if (msg != NULL)
+	{
+		status = true;
+		qsc_csp_generate(key, sizeof(key));
+		qsc_csp_generate(msg, length);
+
+		/* the pipeline encrypts, the memory-mapped functions decrypt */
+		if (rcsfile_write(RCSFILE_TEST_PLAIN, msg, length) == false ||
+			qsc_rcsuring_encrypt(RCSFILE_TEST_PLAIN, RCSFILE_TEST_CIPHER, key, keylen, 4096, params, &stats) != qsc_rcsfile_status_success ||
+			qsc_rcsfile_decrypt(RCSFILE_TEST_CIPHER, RCSFILE_TEST_DECRYPTED, key, keylen, &stats) != qsc_rcsfile_status_success ||
+			rcsfile_compare(RCSFILE_TEST_DECRYPTED, msg, length) == false)
+		{
+			qsctest_print_safe("Failure! rcsuring_equality: encryption failure -UE1 \n");
+			status = false;
+		}
+
+		/* the memory-mapped functions encrypt, the pipeline decrypts */
+		remove(RCSFILE_TEST_DECRYPTED);
+
+		if (qsc_rcsfile_encrypt(RCSFILE_TEST_PLAIN, RCSFILE_TEST_CIPHER, key, keylen, 4096, &stats) != qsc_rcsfile_status_success ||
+			qsc_rcsuring_decrypt(RCSFILE_TEST_CIPHER, RCSFILE_TEST_DECRYPTED, key, keylen, params, &stats) != qsc_rcsfile_status_success ||
+			rcsfile_compare(RCSFILE_TEST_DECRYPTED, msg, length) == false)
+		{
+			qsctest_print_safe("Failure! rcsuring_equality: decryption failure -UE2 \n");
+			status = false;
+		}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+		/* a modified container fails, and no plain-text file is left behind */
+		remove(RCSFILE_TEST_DECRYPTED);
+
+		if (qsctest_file_flip(RCSFILE_TEST_CIPHER, QSC_RCSSEG_HEADER_SIZE + (length / 2)) == false ||
+			qsc_rcsuring_decrypt(RCSFILE_TEST_CIPHER, RCSFILE_TEST_DECRYPTED, key, keylen, params, &stats) != qsc_rcsfile_status_authentication_failure ||
+			rcsfile_compare(RCSFILE_TEST_DECRYPTED, msg, 0) == true)
+		{
+			qsctest_print_safe("Failure! rcsuring_equality: authentication bypass -UE3 \n");
+			status = false;
+		}
+#endif
+
+		remove(RCSFILE_TEST_PLAIN);
+		remove(RCSFILE_TEST_CIPHER);
+		remove(RCSFILE_TEST_DECRYPTED);
+		qsc_memutils_alloc_free(msg);
+	}
+
+	return status;
+}
+
+bool qsctest_rcsuring_equality()
+{
+	const size_t LENGTHS[] = { 0, 1, 4096 * 3, 1000003 };
+	const qsc_rcsuring_params PARAMS[] =
+	{
+		{ 1, 1, false, true },
+		{ 1, 1, false, false },
+		{ 4, 3, false, false },
+		{ QSC_RCSURING_DEPTH_DEFAULT, 0, true, false },
+		{ QSC_RCSURING_DEPTH_DEFAULT, 2, true, true },
+	};
+	bool status;
+
+	status = true;
+
+	for (size_t i = 0; i < sizeof(PARAMS) / sizeof(PARAMS[0]); ++i)
+	{
+		for (size_t j = 0; j < sizeof(LENGTHS) / sizeof(LENGTHS[0]); ++j)
+		{
+			if (rcsuring_equality((j % 2 == 0) ? QSC_RCS256_KEY_SIZE : QSC_RCS512_KEY_SIZE, LENGTHS[j], &PARAMS[i]) == false)
+			{
+				status = false;
+			}
+		}
+	}
+
+	return status;
+}
+#endif
+
+void qsctest_rcsfile_run()
+{
+	if (qsctest_rcsfile_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS memory-mapped file equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS memory-mapped file equality test. \n");
+	}
+
+#if defined(QSC_RCSURING_ENABLED)
+	if (qsctest_rcsuring_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS io_uring pipeline equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS io_uring pipeline equality test. \n");
+	}
+#endif
+}
@@ -0,0 +1,38 @@
+/**
+* \file rcsfile_test.h
+* \brief <b>RCS Memory-Mapped File Tests</b> \n
+* Encrypts, verifies, and decrypts temporary files with the memory-mapped file functions.
+* \author John Underhill
+* \date October 02, 2020
+*/
+
+#ifndef QSCTEST_RCSFILE_TEST_H
+#define QSCTEST_RCSFILE_TEST_H
+
+#include "common.h"
+#include "rcsuring.h"
+
+/**
+* \brief Tests the file encryption, verification, and decryption round trip,
+* and the rejection of a modified container.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsfile_equality();
+
+#if defined(QSC_RCSURING_ENABLED)
+/**
+* \brief Tests the io_uring and synchronous pipelines against the memory-mapped file functions,
+* with several queue depths, thread counts, and direct I/O, and the rejection of a modified container.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsuring_equality();
+#endif
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_rcsfile_run();
+
+#endif
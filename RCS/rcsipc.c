@@ -0,0 +1,474 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	/* memfd_create and file seals */
+#	define _GNU_SOURCE
+#endif
+
+#include "rcsipc.h"
+
+#if defined(QSC_RCSIPC_ENABLED)
+#include "csp.h"
+#include "intutils.h"
+#include "memutils.h"
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define RCSIPC_CONTROL_SIZE 4096
+#define RCSIPC_CACHE_LINE 64
+#define RCSIPC_VERSION 1
+#define RCSIPC_INDEX_OFFSET 8
+#define RCSIPC_SPIN_COUNT 64
+#define RCSIPC_SEALS (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)
+
+/* the control page; the geometry is written once by the producer, and each index word is on its own cache line */
+#define RCSIPC_MAGIC_OFFSET 0
+#define RCSIPC_VERSION_OFFSET 4
+#define RCSIPC_KEYSIZE_OFFSET 5
+#define RCSIPC_SLOTCOUNT_OFFSET 8
+#define RCSIPC_SLOTSIZE_OFFSET 12
+#define RCSIPC_NONCE_OFFSET 16
+#define RCSIPC_HEAD_OFFSET (1 * RCSIPC_CACHE_LINE)
+#define RCSIPC_TAIL_OFFSET (2 * RCSIPC_CACHE_LINE)
+#define RCSIPC_RELEASED_OFFSET (RCSIPC_TAIL_OFFSET + sizeof(uint64_t))
+#define RCSIPC_CLOSED_OFFSET (3 * RCSIPC_CACHE_LINE)
+#define RCSIPC_CWAIT_OFFSET (4 * RCSIPC_CACHE_LINE)
+#define RCSIPC_PWAIT_OFFSET (5 * RCSIPC_CACHE_LINE)
+
+static const uint8_t rcsipc_magic[4] = { 0x52U, 0x43U, 0x53U, 0x49U };
+static const uint8_t rcsipc_label[] = "RCS shared memory ring";
+
+static uint32_t* rcsipc_word(const qsc_rcsipc_state* ctx, size_t offset)
+{
+	return (uint32_t*)(ctx->region + offset);
+}
+
+static uint64_t* rcsipc_count(const qsc_rcsipc_state* ctx, size_t offset)
+{
+	return (uint64_t*)(ctx->region + offset);
+}
+
+static void rcsipc_futex_wait(uint32_t* word, uint32_t value)
+{
+	/* the mapping is shared between processes, so the futex is not private;
+	   the call returns at once if the word no longer holds the value */
+	syscall(SYS_futex, word, FUTEX_WAIT, value, NULL, NULL, 0);
+}
+
+static void rcsipc_futex_wake(uint32_t* word)
+{
+	syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static void rcsipc_publish(qsc_rcsipc_state* ctx, size_t index, size_t waiter)
+{
+	uint32_t* pidx;
+	uint32_t* pwait;
+
+	pidx = rcsipc_word(ctx, index);
+	pwait = rcsipc_word(ctx, waiter);
+
+	/* the index store and the waiter load are sequentially consistent, and pair with the
+	   waiter flag store and index load of the other side, so a sleeping peer is always seen */
+	__atomic_store_n(pidx, (uint32_t)ctx->sequence, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(pwait, __ATOMIC_SEQ_CST) != 0)
+	{
+		__atomic_store_n(pwait, 0, __ATOMIC_SEQ_CST);
+		rcsipc_futex_wake(pidx);
+	}
+}
+
+static void rcsipc_slot_initialize(const qsc_rcsipc_state* ctx, qsc_rcs_state* state, const uint8_t* header, bool encryption)
+{
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+
+	/* the message number is the 64-bit ring sequence, so the nonces of one ring do not repeat */
+	qsc_rcs_nonce_derive(nonce, ctx->nonce, ctx->sequence, RCSIPC_INDEX_OFFSET);
+	qsc_rcs_stream_initialize(state, &ctx->key, nonce, encryption);
+	/* bind the message length to the message */
+	qsc_rcs_set_associated(state, header, QSC_RCSIPC_SLOT_HEADER_SIZE);
+	qsc_memutils_clear(nonce, sizeof(nonce));
+}
+
+static bool rcsipc_geometry(qsc_rcsipc_state* ctx, size_t keylen, size_t slotcount, size_t slotsize)
+{
+	bool res;
+
+	res = false;
+
+	if ((keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE) &&
+		slotcount >= QSC_RCSIPC_SLOTS_MIN && slotcount <= QSC_RCSIPC_SLOTS_MAX && (slotcount & (slotcount - 1)) == 0 &&
+		slotsize >= QSC_RCSIPC_SLOT_MIN && slotsize <= QSC_RCSIPC_SLOT_MAX)
+	{
+#if defined(QSC_RCS_AUTHENTICATED)
+		ctx->maclen = (keylen == QSC_RCS256_KEY_SIZE) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+#else
+		ctx->maclen = 0;
+#endif
+		ctx->slotcount = slotcount;
+		ctx->slotsize = slotsize;
+		/* slots start on a cache line, so the two sides never share a line of neighbouring slots */
+		ctx->stride = QSC_RCSIPC_SLOT_HEADER_SIZE + slotsize + ctx->maclen;
+		ctx->stride = (ctx->stride + RCSIPC_CACHE_LINE - 1) & ~((size_t)RCSIPC_CACHE_LINE - 1);
+		ctx->regionlen = RCSIPC_CONTROL_SIZE + (slotcount * ctx->stride);
+		res = true;
+	}
+
+	return res;
+}
+
+static bool rcsipc_map(qsc_rcsipc_state* ctx, const uint8_t* key, size_t keylen)
+{
+	void* pmap;
+	bool res;
+
+	res = false;
+	pmap = mmap(NULL, ctx->regionlen, PROT_READ | PROT_WRITE, MAP_SHARED, ctx->handle, 0);
+
+	if (pmap != MAP_FAILED)
+	{
+		qsc_rcs_keyparams kp = { key, keylen, ctx->nonce, rcsipc_label, sizeof(rcsipc_label) - 1 };
+
+		ctx->region = (uint8_t*)pmap;
+		ctx->slots = ctx->region + RCSIPC_CONTROL_SIZE;
+
+		/* the consumer authenticates and decrypts a private copy of each message, which the producer can not reach */
+		if (ctx->producer == false)
+		{
+			ctx->buffer = (uint8_t*)qsc_memutils_malloc(ctx->slotsize + ctx->maclen);
+		}
+
+		if (ctx->producer == true || ctx->buffer != NULL)
+		{
+			qsc_rcs_key_expand(&ctx->key, &kp);
+			res = true;
+		}
+	}
+
+	return res;
+}
+
+qsc_rcsipc_status qsc_rcsipc_create(qsc_rcsipc_state* ctx, const uint8_t* key, size_t keylen, size_t slotcount, size_t slotsize)
+{
+	assert(ctx != NULL);
+	assert(key != NULL);
+
+	qsc_rcsipc_status res;
+
+	res = qsc_rcsipc_status_invalid_parameter;
+	qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsipc_state));
+	ctx->handle = -1;
+	ctx->producer = true;
+
+	if (rcsipc_geometry(ctx, keylen, slotcount, slotsize) == true)
+	{
+		res = qsc_rcsipc_status_system_failure;
+		ctx->handle = memfd_create("rcsipc", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+
+		/* the size is sealed, so the consumer can not be faulted by a truncated mapping */
+		if (ctx->handle >= 0 && ftruncate(ctx->handle, (off_t)ctx->regionlen) == 0 &&
+			fcntl(ctx->handle, F_ADD_SEALS, RCSIPC_SEALS) == 0 &&
+			qsc_csp_generate(ctx->nonce, QSC_RCS_NONCE_SIZE) == true &&
+			rcsipc_map(ctx, key, keylen) == true)
+		{
+			qsc_memutils_copy(ctx->region + RCSIPC_MAGIC_OFFSET, rcsipc_magic, sizeof(rcsipc_magic));
+			ctx->region[RCSIPC_VERSION_OFFSET] = RCSIPC_VERSION;
+			ctx->region[RCSIPC_KEYSIZE_OFFSET] = (uint8_t)keylen;
+			qsc_intutils_le32to8(ctx->region + RCSIPC_SLOTCOUNT_OFFSET, (uint32_t)slotcount);
+			qsc_intutils_le32to8(ctx->region + RCSIPC_SLOTSIZE_OFFSET, (uint32_t)slotsize);
+			qsc_memutils_copy(ctx->region + RCSIPC_NONCE_OFFSET, ctx->nonce, QSC_RCS_NONCE_SIZE);
+			res = qsc_rcsipc_status_success;
+		}
+		else
+		{
+			qsc_rcsipc_dispose(ctx);
+		}
+	}
+
+	return res;
+}
+
+qsc_rcsipc_status qsc_rcsipc_attach(qsc_rcsipc_state* ctx, int handle, const uint8_t* key, size_t keylen)
+{
+	assert(ctx != NULL);
+	assert(key != NULL);
+
+	uint8_t ctl[RCSIPC_NONCE_OFFSET + QSC_RCS_NONCE_SIZE];
+	struct stat fst;
+	qsc_rcsipc_status res;
+	int seals;
+
+	res = qsc_rcsipc_status_system_failure;
+	qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsipc_state));
+	ctx->handle = handle;
+	ctx->producer = false;
+	seals = fcntl(handle, F_GET_SEALS);
+
+	if (seals >= 0 && (seals & RCSIPC_SEALS) == RCSIPC_SEALS && fstat(handle, &fst) == 0 &&
+		(size_t)fst.st_size >= RCSIPC_CONTROL_SIZE && pread(handle, ctl, sizeof(ctl), 0) == (ssize_t)sizeof(ctl))
+	{
+		res = qsc_rcsipc_status_invalid_parameter;
+
+		if (qsc_intutils_are_equal8(ctl + RCSIPC_MAGIC_OFFSET, rcsipc_magic, sizeof(rcsipc_magic)) == true &&
+			ctl[RCSIPC_VERSION_OFFSET] == RCSIPC_VERSION && ctl[RCSIPC_KEYSIZE_OFFSET] == keylen &&
+			rcsipc_geometry(ctx, keylen, qsc_intutils_le8to32(ctl + RCSIPC_SLOTCOUNT_OFFSET), qsc_intutils_le8to32(ctl + RCSIPC_SLOTSIZE_OFFSET)) == true &&
+			(size_t)fst.st_size == ctx->regionlen)
+		{
+			res = qsc_rcsipc_status_system_failure;
+			qsc_memutils_copy(ctx->nonce, ctl + RCSIPC_NONCE_OFFSET, QSC_RCS_NONCE_SIZE);
+
+			if (rcsipc_map(ctx, key, keylen) == true)
+			{
+				/* start at the oldest message that has not been released; the 32-bit tail index wraps,
+				   so the full message number is read from the released count */
+				ctx->sequence = __atomic_load_n(rcsipc_count(ctx, RCSIPC_RELEASED_OFFSET), __ATOMIC_ACQUIRE);
+				res = qsc_rcsipc_status_success;
+			}
+		}
+	}
+
+	if (res != qsc_rcsipc_status_success)
+	{
+		qsc_rcsipc_dispose(ctx);
+	}
+
+	return res;
+}
+
+int qsc_rcsipc_handle(const qsc_rcsipc_state* ctx)
+{
+	assert(ctx != NULL);
+
+	return ctx->handle;
+}
+
+void qsc_rcsipc_dispose(qsc_rcsipc_state* ctx)
+{
+	if (ctx != NULL)
+	{
+		if (ctx->region != NULL)
+		{
+			munmap(ctx->region, ctx->regionlen);
+			qsc_rcs_key_dispose(&ctx->key);
+		}
+
+		if (ctx->buffer != NULL)
+		{
+			qsc_memutils_clear(ctx->buffer, ctx->slotsize + ctx->maclen);
+			qsc_memutils_alloc_free(ctx->buffer);
+		}
+
+		if (ctx->handle >= 0)
+		{
+			close(ctx->handle);
+		}
+
+		qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsipc_state));
+		ctx->handle = -1;
+	}
+}
+
+qsc_rcsipc_status qsc_rcsipc_send(qsc_rcsipc_state* ctx, const uint8_t* message, size_t length)
+{
+	assert(ctx != NULL);
+	assert(message != NULL || length == 0);
+
+	qsc_rcs_state state;
+	uint8_t* pslot;
+	uint32_t* ptail;
+	uint32_t* pwait;
+	qsc_rcsipc_status res;
+	uint32_t tail;
+	size_t spin;
+
+	res = qsc_rcsipc_status_invalid_parameter;
+
+	if (ctx->producer == true && ctx->region != NULL && length <= ctx->slotsize)
+	{
+		ptail = rcsipc_word(ctx, RCSIPC_TAIL_OFFSET);
+		pwait = rcsipc_word(ctx, RCSIPC_PWAIT_OFFSET);
+		spin = 0;
+
+		/* wait for a free slot; the indices are 32-bit counters that wrap, and the slot count divides 2^32 */
+		for (;;)
+		{
+			tail = __atomic_load_n(ptail, __ATOMIC_ACQUIRE);
+
+			if ((uint32_t)ctx->sequence - tail < (uint32_t)ctx->slotcount)
+			{
+				break;
+			}
+
+			if (spin < RCSIPC_SPIN_COUNT)
+			{
+				++spin;
+				sched_yield();
+			}
+			else
+			{
+				__atomic_store_n(pwait, 1, __ATOMIC_SEQ_CST);
+				tail = __atomic_load_n(ptail, __ATOMIC_SEQ_CST);
+
+				if ((uint32_t)ctx->sequence - tail >= (uint32_t)ctx->slotcount)
+				{
+					rcsipc_futex_wait(ptail, tail);
+				}
+			}
+		}
+
+		pslot = ctx->slots + ((size_t)(ctx->sequence & (ctx->slotcount - 1)) * ctx->stride);
+		qsc_intutils_le32to8(pslot, (uint32_t)length);
+		qsc_memutils_clear(pslot + sizeof(uint32_t), QSC_RCSIPC_SLOT_HEADER_SIZE - sizeof(uint32_t));
+
+		/* the message is encrypted from the caller's buffer straight into the slot, followed by its MAC code */
+		rcsipc_slot_initialize(ctx, &state, pslot, true);
+		qsc_rcs_transform(&state, pslot + QSC_RCSIPC_SLOT_HEADER_SIZE, message, length);
+		qsc_rcs_dispose(&state);
+
+		++ctx->sequence;
+		rcsipc_publish(ctx, RCSIPC_HEAD_OFFSET, RCSIPC_CWAIT_OFFSET);
+		res = qsc_rcsipc_status_success;
+	}
+
+	return res;
+}
+
+void qsc_rcsipc_close(qsc_rcsipc_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx->producer == true && ctx->region != NULL)
+	{
+		__atomic_store_n(rcsipc_word(ctx, RCSIPC_CLOSED_OFFSET), 1, __ATOMIC_SEQ_CST);
+		/* the consumer may be asleep on the head word */
+		__atomic_store_n(rcsipc_word(ctx, RCSIPC_CWAIT_OFFSET), 0, __ATOMIC_SEQ_CST);
+		rcsipc_futex_wake(rcsipc_word(ctx, RCSIPC_HEAD_OFFSET));
+	}
+}
+
+qsc_rcsipc_status qsc_rcsipc_receive(qsc_rcsipc_state* ctx, uint8_t** message, size_t* length)
+{
+	assert(ctx != NULL);
+	assert(message != NULL);
+	assert(length != NULL);
+
+	uint8_t hdr[QSC_RCSIPC_SLOT_HEADER_SIZE];
+	qsc_rcs_state state;
+	uint8_t* pslot;
+	uint32_t* phead;
+	uint32_t* pwait;
+	uint32_t* pclosed;
+	qsc_rcsipc_status res;
+	uint32_t head;
+	size_t mlen;
+	size_t spin;
+
+	res = qsc_rcsipc_status_invalid_parameter;
+	*message = NULL;
+	*length = 0;
+
+	if (ctx->producer == false && ctx->region != NULL)
+	{
+		pslot = ctx->slots + ((size_t)(ctx->sequence & (ctx->slotcount - 1)) * ctx->stride);
+
+		if (ctx->pending == true)
+		{
+			*message = ctx->buffer;
+			*length = ctx->pendlen;
+			res = qsc_rcsipc_status_success;
+		}
+		else
+		{
+			phead = rcsipc_word(ctx, RCSIPC_HEAD_OFFSET);
+			pwait = rcsipc_word(ctx, RCSIPC_CWAIT_OFFSET);
+			pclosed = rcsipc_word(ctx, RCSIPC_CLOSED_OFFSET);
+			spin = 0;
+
+			for (;;)
+			{
+				head = __atomic_load_n(phead, __ATOMIC_ACQUIRE);
+
+				if (head != (uint32_t)ctx->sequence)
+				{
+					res = qsc_rcsipc_status_success;
+					break;
+				}
+
+				/* the closed flag is set after the last head store, so the head is read again once it is seen */
+				if (__atomic_load_n(pclosed, __ATOMIC_ACQUIRE) != 0)
+				{
+					head = __atomic_load_n(phead, __ATOMIC_ACQUIRE);
+					res = (head != (uint32_t)ctx->sequence) ? qsc_rcsipc_status_success : qsc_rcsipc_status_closed;
+					break;
+				}
+
+				if (spin < RCSIPC_SPIN_COUNT)
+				{
+					++spin;
+					sched_yield();
+				}
+				else
+				{
+					__atomic_store_n(pwait, 1, __ATOMIC_SEQ_CST);
+					head = __atomic_load_n(phead, __ATOMIC_SEQ_CST);
+
+					if (head == (uint32_t)ctx->sequence && __atomic_load_n(pclosed, __ATOMIC_SEQ_CST) == 0)
+					{
+						rcsipc_futex_wait(phead, head);
+					}
+				}
+			}
+
+			if (res == qsc_rcsipc_status_success)
+			{
+				/* the header and the message are copied out of the shared memory before they are checked and authenticated,
+				   so the peer can not change the cipher-text after the MAC check, or the plain-text after it is returned */
+				qsc_memutils_copy(hdr, pslot, sizeof(hdr));
+				mlen = qsc_intutils_le8to32(hdr);
+				res = qsc_rcsipc_status_authentication_failure;
+
+				if (mlen <= ctx->slotsize && qsc_intutils_le8to32(hdr + sizeof(uint32_t)) == 0)
+				{
+					qsc_memutils_copy(ctx->buffer, pslot + QSC_RCSIPC_SLOT_HEADER_SIZE, mlen + ctx->maclen);
+					rcsipc_slot_initialize(ctx, &state, hdr, false);
+
+					if (qsc_rcs_transform(&state, ctx->buffer, ctx->buffer, mlen) == true)
+					{
+						ctx->pending = true;
+						ctx->pendlen = mlen;
+						*message = ctx->buffer;
+						*length = mlen;
+						res = qsc_rcsipc_status_success;
+					}
+
+					qsc_rcs_dispose(&state);
+				}
+			}
+		}
+	}
+
+	return res;
+}
+
+void qsc_rcsipc_release(qsc_rcsipc_state* ctx)
+{
+	assert(ctx != NULL);
+
+	if (ctx->producer == false && ctx->pending == true)
+	{
+		/* the plain-text is erased from the private buffer, and the slot is returned to the producer */
+		qsc_memutils_clear(ctx->buffer, ctx->pendlen);
+		ctx->pending = false;
+		ctx->pendlen = 0;
+		++ctx->sequence;
+		/* the released count is stored before the tail index that publishes it */
+		__atomic_store_n(rcsipc_count(ctx, RCSIPC_RELEASED_OFFSET), ctx->sequence, __ATOMIC_RELEASE);
+		rcsipc_publish(ctx, RCSIPC_TAIL_OFFSET, RCSIPC_PWAIT_OFFSET);
+	}
+}
+
+#endif
@@ -0,0 +1,254 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSIPC_H
+#define QSC_RCSIPC_H
+
+/**
+* \file rcsipc.h
+* \brief RCS encrypted shared-memory ring (Linux) \n
+* A single-producer, single-consumer message ring between processes, held in an anonymous shared memory file.
+*
+* The ring is created by the producer with memfd_create, and the file descriptor is passed to the consumer process,
+* either by inheritance across fork, or over a unix domain socket (SCM_RIGHTS); the consumer attaches to it with the same key.
+* The key is never written to the shared memory. \n
+* The producer encrypts each message from its own buffer directly into a ring slot with qsc_rcs_transform; the consumer
+* copies the slot into a private buffer, authenticates and decrypts it there, and then releases the slot.
+* The plain-text is never written to the shared memory, and a peer that changes a slot after it is copied can not change
+* the message that was authenticated. Each slot holds its own MAC code.
+*
+* Shared memory layout: \n
+* control page (4096) | slot 0 | slot 1 | ... \n
+* slot: message length (4, little-endian) | reserved (4) | cipher-text | MAC code (32 or 64) \n
+*
+* The head and tail indices live on separate cache lines of the control page, and the full 64-bit count of released messages
+* is stored beside the tail, so a consumer that attaches later derives the right nonce after the 32-bit indices wrap;
+* the producer is the only writer of the head,
+* and the consumer the only writer of the tail, so no locks are taken. A side that finds the ring empty or full spins briefly,
+* then sleeps on the index word with a shared futex, and the other side issues a wake only when a waiter has registered,
+* so a steady stream of messages makes no system calls. \n
+* Message n is encrypted with a nonce made by adding n to the upper bits of the ring nonce, and the slot header is bound
+* as associated data. The consumer derives the nonce from its own message count, so a message that is replayed, reordered,
+* or written by a process that can map the memory but does not hold the key, fails authentication.
+* The peer process holds the key, and is trusted.
+*
+* The ring is only available on Linux (QSC_RCSIPC_ENABLED).
+*
+* Ring example \n
+* \code
+* // producer
+* qsc_rcsipc_state prod;
+* qsc_rcsipc_create(&prod, key, QSC_RCS256_KEY_SIZE, 64, 65536);
+* // fork, or send qsc_rcsipc_handle(&prod) to the consumer
+* qsc_rcsipc_send(&prod, message, msglen);
+* qsc_rcsipc_close(&prod);
+* qsc_rcsipc_dispose(&prod);
+*
+* // consumer
+* qsc_rcsipc_state cons;
+* uint8_t* msg;
+* size_t mlen;
+* qsc_rcsipc_attach(&cons, fd, key, QSC_RCS256_KEY_SIZE);
+*
+* while (qsc_rcsipc_receive(&cons, &msg, &mlen) == qsc_rcsipc_status_success)
+* {
+*	// use msg, then return the slot to the producer
+*	qsc_rcsipc_release(&cons);
+* }
+*
+* qsc_rcsipc_dispose(&cons);
+* \endcode
+*/
+
+#include "common.h"
+#include "rcs.h"
+
+#if defined(QSC_SYSTEM_OS_LINUX)
+/*!
+* \def QSC_RCSIPC_ENABLED
+* \brief The shared-memory ring is available
+*/
+#	define QSC_RCSIPC_ENABLED
+#endif
+
+#if defined(QSC_RCSIPC_ENABLED)
+
+/*!
+* \def QSC_RCSIPC_SLOT_HEADER_SIZE
+* \brief The size of the slot header in bytes
+*/
+#define QSC_RCSIPC_SLOT_HEADER_SIZE 8
+
+/*!
+* \def QSC_RCSIPC_SLOT_MIN
+* \brief The smallest message capacity of a slot in bytes
+*/
+#define QSC_RCSIPC_SLOT_MIN 64
+
+/*!
+* \def QSC_RCSIPC_SLOT_MAX
+* \brief The largest message capacity of a slot in bytes
+*/
+#define QSC_RCSIPC_SLOT_MAX (16 * 1024 * 1024)
+
+/*!
+* \def QSC_RCSIPC_SLOT_DEFAULT
+* \brief The default message capacity of a slot in bytes
+*/
+#define QSC_RCSIPC_SLOT_DEFAULT (64 * 1024)
+
+/*!
+* \def QSC_RCSIPC_SLOTS_MIN
+* \brief The smallest number of slots in a ring
+*/
+#define QSC_RCSIPC_SLOTS_MIN 2
+
+/*!
+* \def QSC_RCSIPC_SLOTS_MAX
+* \brief The largest number of slots in a ring
+*/
+#define QSC_RCSIPC_SLOTS_MAX 65536
+
+/*!
+* \def QSC_RCSIPC_SLOTS_DEFAULT
+* \brief The default number of slots in a ring
+*/
+#define QSC_RCSIPC_SLOTS_DEFAULT 64
+
+/*!
+* \enum qsc_rcsipc_status
+* \brief The ring operation status
+*/
+typedef enum
+{
+	qsc_rcsipc_status_success = 0,					/*!< The operation succeeded */
+	qsc_rcsipc_status_invalid_parameter = 1,		/*!< The message is larger than a slot, or the call does not match the ring side */
+	qsc_rcsipc_status_authentication_failure = 2,	/*!< The message failed authentication, or its header is invalid; the ring can not be read further */
+	qsc_rcsipc_status_closed = 3,					/*!< The producer closed the ring, and every message was read */
+	qsc_rcsipc_status_system_failure = 4,			/*!< The shared memory could not be created or mapped */
+} qsc_rcsipc_status;
+
+/*!
+* \struct qsc_rcsipc_state
+* \brief The state of one side of a ring
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_key key;						/*!< The expanded ring key */
+	uint8_t nonce[QSC_RCS_NONCE_SIZE];		/*!< The ring nonce */
+	uint8_t* region;						/*!< The shared memory mapping */
+	uint8_t* slots;							/*!< The first slot */
+	uint8_t* buffer;						/*!< The consumer's private copy of the received message */
+	size_t regionlen;						/*!< The size of the mapping */
+	size_t slotcount;						/*!< The number of slots; a power of two */
+	size_t slotsize;						/*!< The message capacity of a slot */
+	size_t stride;							/*!< The distance between slots */
+	size_t maclen;							/*!< The size of the slot MAC code */
+	size_t pendlen;							/*!< The length of the received message that has not been released */
+	uint64_t sequence;						/*!< The number of messages sent, or received */
+	int handle;								/*!< The shared memory file descriptor */
+	bool producer;							/*!< This is the producer side */
+	bool pending;							/*!< The consumer holds a received slot that has not been released */
+} qsc_rcsipc_state;
+
+/**
+* \brief Create a ring in a new shared memory file, as the producer.
+* A random ring nonce is generated, so a key can be used for more than one ring.
+*
+* \param ctx: [struct] The producer state
+* \param key: [const] The ring key, shared with the consumer
+* \param keylen: The key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param slotcount: The number of slots; a power of two, between QSC_RCSIPC_SLOTS_MIN and QSC_RCSIPC_SLOTS_MAX
+* \param slotsize: The largest message, between QSC_RCSIPC_SLOT_MIN and QSC_RCSIPC_SLOT_MAX
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsipc_status qsc_rcsipc_create(qsc_rcsipc_state* ctx, const uint8_t* key, size_t keylen, size_t slotcount, size_t slotsize);
+
+/**
+* \brief Attach to a ring created by another process, as the consumer.
+* The ring geometry and nonce are read from the control page, and checked against the size of the file.
+*
+* \param ctx: [struct] The consumer state
+* \param handle: The shared memory file descriptor; the state takes ownership, and closes it on dispose
+* \param key: [const] The ring key
+* \param keylen: The key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsipc_status qsc_rcsipc_attach(qsc_rcsipc_state* ctx, int handle, const uint8_t* key, size_t keylen);
+
+/**
+* \brief Get the shared memory file descriptor of a ring, to pass to the consumer.
+*
+* \param ctx: [const][struct] The ring state
+*
+* \return Returns the file descriptor
+*/
+QSC_EXPORT_API int qsc_rcsipc_handle(const qsc_rcsipc_state* ctx);
+
+/**
+* \brief Unmap the ring, close the file descriptor, and clear the state.
+*
+* \param ctx: [struct] The ring state
+*/
+QSC_EXPORT_API void qsc_rcsipc_dispose(qsc_rcsipc_state* ctx);
+
+/**
+* \brief Encrypt a message into the next ring slot.
+* Waits while the ring is full.
+*
+* \param ctx: [struct] The producer state
+* \param message: [const] The message
+* \param length: The message length; no larger than the slot size
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsipc_status qsc_rcsipc_send(qsc_rcsipc_state* ctx, const uint8_t* message, size_t length);
+
+/**
+* \brief Close the ring; the consumer reads the remaining messages, and then receives the closed status.
+*
+* \param ctx: [struct] The producer state
+*/
+QSC_EXPORT_API void qsc_rcsipc_close(qsc_rcsipc_state* ctx);
+
+/**
+* \brief Copy the next message out of its slot, and authenticate and decrypt it in the private buffer of the state.
+* Waits while the ring is empty. The message stays in the buffer until it is released with qsc_rcsipc_release;
+* a received message that has not been released is returned again.
+*
+* \param ctx: [struct] The consumer state
+* \param message: Receives a pointer to the message in the private buffer
+* \param length: Receives the message length
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsipc_status qsc_rcsipc_receive(qsc_rcsipc_state* ctx, uint8_t** message, size_t* length);
+
+/**
+* \brief Erase the received message, and return its slot to the producer.
+*
+* \param ctx: [struct] The consumer state
+*/
+QSC_EXPORT_API void qsc_rcsipc_release(qsc_rcsipc_state* ctx);
+
+#endif
+
+#endif
@@ -0,0 +1,500 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	/* memfd_create */
+#	define _GNU_SOURCE
+#endif
+
+#include "rcsipc_test.h"
+#include "csp.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "testutils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(QSC_RCSIPC_ENABLED)
+#	include <sys/mman.h>
+#	include <sys/wait.h>
+#	include <unistd.h>
+#endif
+
+#define RCSIPC_TEST_COUNT 1000
+#define RCSIPC_TEST_SLOTS 4
+#define RCSIPC_TEST_SLOTSIZE 4096
+
+#if defined(QSC_RCSIPC_ENABLED)
+
+static size_t rcsipc_message(uint8_t* message, size_t index)
+{
+	size_t mlen;
+
+	/* the consumer process rebuilds the same messages to compare */
+	mlen = (index * 997) % (RCSIPC_TEST_SLOTSIZE + 1);
+
+	for (size_t i = 0; i < mlen; ++i)
+	{
+		message[i] = (uint8_t)((index * 31) + (i * 7));
+	}
+
+	return mlen;
+}
+
+static int rcsipc_consumer(int handle, const uint8_t* key, size_t keylen)
+{
+	uint8_t exp[RCSIPC_TEST_SLOTSIZE];
+	qsc_rcsipc_state cons;
+	uint8_t* msg;
+	size_t elen;
+	size_t mlen;
+	size_t i;
+	int res;
+
+	res = 1;
+
+	if (qsc_rcsipc_attach(&cons, handle, key, keylen) == qsc_rcsipc_status_success)
+	{
+		res = 0;
+
+		for (i = 0; i < RCSIPC_TEST_COUNT && res == 0; ++i)
+		{
+			elen = rcsipc_message(exp, i);
+
+			if (qsc_rcsipc_receive(&cons, &msg, &mlen) != qsc_rcsipc_status_success)
+			{
+				res = 2;
+			}
+			else if (mlen != elen || qsc_intutils_are_equal8(msg, exp, mlen) == false)
+			{
+				res = 3;
+			}
+			else
+			{
+				qsc_rcsipc_release(&cons);
+			}
+		}
+
+		if (res == 0 && qsc_rcsipc_receive(&cons, &msg, &mlen) != qsc_rcsipc_status_closed)
+		{
+			res = 4;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+	}
+
+	return res;
+}
+
+static bool rcsipc_equality(size_t keylen)
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t msg[RCSIPC_TEST_SLOTSIZE];
+	qsc_rcsipc_state prod;
+	size_t mlen;
+	pid_t pid;
+	int wst;
+	bool status;
+
+	status = false;
+	qsc_csp_generate(key, sizeof(key));
+
+	if (qsc_rcsipc_create(&prod, key, keylen, RCSIPC_TEST_SLOTS, RCSIPC_TEST_SLOTSIZE) == qsc_rcsipc_status_success)
+	{
+		/* the child maps the ring again from a copy of the descriptor, as an unrelated process would */
+		fflush(stdout);
+		pid = fork();
+
+		if (pid == 0)
+		{
+			_exit(rcsipc_consumer(dup(qsc_rcsipc_handle(&prod)), key, keylen));
+		}
+
+		if (pid > 0)
+		{
+			status = true;
+
+			for (size_t i = 0; i < RCSIPC_TEST_COUNT; ++i)
+			{
+				mlen = rcsipc_message(msg, i);
+
+				if (qsc_rcsipc_send(&prod, msg, mlen) != qsc_rcsipc_status_success)
+				{
+					qsctest_print_safe("Failure! rcsipc_equality: a message was not sent -IE1 \n");
+					status = false;
+					break;
+				}
+			}
+
+			/* the close also releases a consumer that is waiting after a failed send */
+			qsc_rcsipc_close(&prod);
+
+			if (waitpid(pid, &wst, 0) != pid || WIFEXITED(wst) == 0 || WEXITSTATUS(wst) != 0)
+			{
+				qsctest_print_safe("Failure! rcsipc_equality: the consumer process failed -IE2 \n");
+				status = false;
+			}
+		}
+		else
+		{
+			qsctest_print_safe("Failure! rcsipc_equality: the consumer process could not be started -IE3 \n");
+		}
+
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		qsctest_print_safe("Failure! rcsipc_equality: the ring could not be created -IE4 \n");
+	}
+
+	return status;
+}
+
+static bool rcsipc_pair(qsc_rcsipc_state* prod, qsc_rcsipc_state* cons, const uint8_t* key, const uint8_t* ckey, size_t keylen)
+{
+	bool res;
+
+	res = false;
+
+	/* both sides in one process, each with its own mapping */
+	if (qsc_rcsipc_create(prod, key, keylen, RCSIPC_TEST_SLOTS, RCSIPC_TEST_SLOTSIZE) == qsc_rcsipc_status_success)
+	{
+		res = (qsc_rcsipc_attach(cons, dup(qsc_rcsipc_handle(prod)), ckey, keylen) == qsc_rcsipc_status_success);
+
+		if (res == false)
+		{
+			qsc_rcsipc_dispose(prod);
+		}
+	}
+
+	return res;
+}
+
+static bool rcsipc_authentication(size_t keylen)
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t bkey[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t msg[RCSIPC_TEST_SLOTSIZE] = { 0 };
+	uint8_t copy[RCSIPC_TEST_SLOTSIZE + QSC_RCSIPC_SLOT_HEADER_SIZE + QSC_RCS512_MAC_SIZE];
+	qsc_rcsipc_state prod;
+	qsc_rcsipc_state cons;
+	uint8_t* pmsg;
+	size_t mlen;
+	bool status;
+
+	status = true;
+	qsc_csp_generate(key, sizeof(key));
+	qsc_memutils_copy(bkey, key, sizeof(bkey));
+	bkey[0] ^= 1U;
+	qsc_csp_generate(msg, sizeof(msg));
+
+	/* a modified cipher-text */
+	if (rcsipc_pair(&prod, &cons, key, key, keylen) == true)
+	{
+		qsc_rcsipc_send(&prod, msg, 1000);
+		prod.slots[QSC_RCSIPC_SLOT_HEADER_SIZE + 500] ^= 1U;
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_authentication_failure)
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: a modified slot was accepted -IA1 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		status = false;
+	}
+
+	/* a modified length, within and beyond the slot */
+	if (rcsipc_pair(&prod, &cons, key, key, keylen) == true)
+	{
+		qsc_rcsipc_send(&prod, msg, 1000);
+		qsc_rcsipc_send(&prod, msg, 1000);
+		qsc_intutils_le32to8(prod.slots, 999);
+		qsc_intutils_le32to8(prod.slots + prod.stride, RCSIPC_TEST_SLOTSIZE + 1);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_authentication_failure)
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: a modified length was accepted -IA2 \n");
+			status = false;
+		}
+
+		/* skip the first slot to reach the second */
+		cons.sequence = 1;
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_authentication_failure)
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: an oversized length was accepted -IA3 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		status = false;
+	}
+
+	/* a replayed slot: the first message is copied over the second */
+	if (rcsipc_pair(&prod, &cons, key, key, keylen) == true)
+	{
+		qsc_rcsipc_send(&prod, msg, 1000);
+		qsc_memutils_copy(copy, prod.slots, QSC_RCSIPC_SLOT_HEADER_SIZE + 1000 + prod.maclen);
+		qsc_rcsipc_send(&prod, msg, 1000);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_success || mlen != 1000 ||
+			qsc_intutils_are_equal8(pmsg, msg, mlen) == false)
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: a valid message was not received -IA4 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_release(&cons);
+		qsc_memutils_copy(prod.slots + prod.stride, copy, QSC_RCSIPC_SLOT_HEADER_SIZE + 1000 + prod.maclen);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_authentication_failure)
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: a replayed slot was accepted -IA5 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		status = false;
+	}
+
+	/* a slot changed by the peer after it was received does not change the message */
+	if (rcsipc_pair(&prod, &cons, key, key, keylen) == true)
+	{
+		qsc_rcsipc_send(&prod, msg, 1000);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_success)
+		{
+			status = false;
+		}
+
+		prod.slots[QSC_RCSIPC_SLOT_HEADER_SIZE + 500] ^= 1U;
+
+		if (mlen != 1000 || qsc_intutils_are_equal8(pmsg, msg, mlen) == false ||
+			(pmsg >= prod.slots && pmsg < prod.slots + (RCSIPC_TEST_SLOTS * prod.stride)) ||
+			(pmsg >= cons.slots && pmsg < cons.slots + (RCSIPC_TEST_SLOTS * cons.stride)))
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: a received message was reachable by the peer -IA7 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		status = false;
+	}
+
+	/* a consumer that attaches after the 32-bit ring indices wrap */
+	if (rcsipc_pair(&prod, &cons, key, key, keylen) == true)
+	{
+		/* release a placeholder message, as if 2^32 - 1 messages had passed through the ring */
+		prod.sequence = 0xFFFFFFFFULL;
+		cons.sequence = 0xFFFFFFFEULL;
+		cons.pending = true;
+		qsc_rcsipc_release(&cons);
+		qsc_rcsipc_send(&prod, msg, 100);
+		qsc_rcsipc_send(&prod, msg, 200);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_success || mlen != 100)
+		{
+			status = false;
+		}
+
+		qsc_rcsipc_release(&cons);
+		qsc_rcsipc_dispose(&cons);
+
+		if (qsc_rcsipc_attach(&cons, dup(qsc_rcsipc_handle(&prod)), key, keylen) != qsc_rcsipc_status_success ||
+			qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_success || mlen != 200 ||
+			qsc_intutils_are_equal8(pmsg, msg, mlen) == false)
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: a consumer attached after the indices wrapped was rejected -IA8 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		status = false;
+	}
+
+	/* a consumer with the wrong key */
+	if (rcsipc_pair(&prod, &cons, key, bkey, keylen) == true)
+	{
+		qsc_rcsipc_send(&prod, msg, 1000);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_authentication_failure)
+		{
+			qsctest_print_safe("Failure! rcsipc_authentication: the wrong key was accepted -IA6 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+static bool rcsipc_parameters()
+{
+	uint8_t key[QSC_RCS256_KEY_SIZE] = { 0 };
+	uint8_t msg[RCSIPC_TEST_SLOTSIZE + 1] = { 0 };
+	qsc_rcsipc_state prod;
+	qsc_rcsipc_state cons;
+	uint8_t* pmsg;
+	size_t mlen;
+	int fd;
+	bool status;
+
+	status = true;
+	qsc_csp_generate(key, sizeof(key));
+
+	if (qsc_rcsipc_create(&prod, key, sizeof(key), 6, RCSIPC_TEST_SLOTSIZE) != qsc_rcsipc_status_invalid_parameter ||
+		qsc_rcsipc_create(&prod, key, sizeof(key), RCSIPC_TEST_SLOTS, QSC_RCSIPC_SLOT_MIN - 1) != qsc_rcsipc_status_invalid_parameter ||
+		qsc_rcsipc_create(&prod, key, 16, RCSIPC_TEST_SLOTS, RCSIPC_TEST_SLOTSIZE) != qsc_rcsipc_status_invalid_parameter)
+	{
+		qsctest_print_safe("Failure! rcsipc_parameters: an invalid ring geometry was accepted -IP1 \n");
+		status = false;
+	}
+
+	if (rcsipc_pair(&prod, &cons, key, key, sizeof(key)) == true)
+	{
+		if (qsc_rcsipc_send(&prod, msg, sizeof(msg)) != qsc_rcsipc_status_invalid_parameter ||
+			qsc_rcsipc_send(&cons, msg, 1) != qsc_rcsipc_status_invalid_parameter ||
+			qsc_rcsipc_receive(&prod, &pmsg, &mlen) != qsc_rcsipc_status_invalid_parameter)
+		{
+			qsctest_print_safe("Failure! rcsipc_parameters: an invalid call was accepted -IP2 \n");
+			status = false;
+		}
+
+		/* a message that is received twice without a release is the same message */
+		qsc_rcsipc_send(&prod, msg, 100);
+		qsc_rcsipc_close(&prod);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_success ||
+			qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_success || mlen != 100)
+		{
+			qsctest_print_safe("Failure! rcsipc_parameters: a pending message was not returned -IP3 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_release(&cons);
+
+		if (qsc_rcsipc_receive(&cons, &pmsg, &mlen) != qsc_rcsipc_status_closed)
+		{
+			qsctest_print_safe("Failure! rcsipc_parameters: the closed ring was not reported -IP4 \n");
+			status = false;
+		}
+
+		qsc_rcsipc_dispose(&cons);
+		qsc_rcsipc_dispose(&prod);
+	}
+	else
+	{
+		status = false;
+	}
+
+	/* memory that can be resized by the peer is refused */
+	fd = memfd_create("rcsipc_test", MFD_CLOEXEC);
+
+	if (fd >= 0)
+	{
+		/* the state takes the descriptor, and closes it when the attach fails */
+		if (ftruncate(fd, 4096 + (RCSIPC_TEST_SLOTS * 8192)) != 0)
+		{
+			close(fd);
+		}
+		else if (qsc_rcsipc_attach(&cons, fd, key, sizeof(key)) != qsc_rcsipc_status_system_failure)
+		{
+			qsctest_print_safe("Failure! rcsipc_parameters: unsealed memory was accepted -IP5 \n");
+			status = false;
+		}
+	}
+
+	return status;
+}
+
+#endif
+
+bool qsctest_rcsipc_equality()
+{
+	bool status;
+
+#if defined(QSC_RCSIPC_ENABLED)
+	status = rcsipc_equality(QSC_RCS256_KEY_SIZE);
+
+	if (rcsipc_equality(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+bool qsctest_rcsipc_authentication_failure()
+{
+	bool status;
+
+#if defined(QSC_RCSIPC_ENABLED)
+	status = rcsipc_parameters();
+
+#	if defined(QSC_RCS_AUTHENTICATED)
+	if (rcsipc_authentication(QSC_RCS256_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	if (rcsipc_authentication(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#	endif
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+void qsctest_rcsipc_run()
+{
+#if defined(QSC_RCSIPC_ENABLED)
+	if (qsctest_rcsipc_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS shared memory ring equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS shared memory ring equality test. \n");
+	}
+
+	if (qsctest_rcsipc_authentication_failure() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS shared memory ring authentication test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS shared memory ring authentication test. \n");
+	}
+#endif
+}
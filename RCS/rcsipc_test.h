@@ -0,0 +1,37 @@
+/**
+* \file rcsipc_test.h
+* \brief <b>RCS Shared-Memory Ring Tests</b> \n
+* Round-trip tests between processes, and tamper tests, for the encrypted shared-memory ring.
+* \author John Underhill
+* \date October 02, 2020
+*/
+
+#ifndef QSCTEST_RCSIPC_TEST_H
+#define QSCTEST_RCSIPC_TEST_H
+
+#include "common.h"
+#include "rcsipc.h"
+
+/**
+* \brief Tests a stream of messages of varying length from a producer to a consumer process, through a small ring,
+* so the producer waits for free slots and the ring indices wrap.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsipc_equality();
+
+/**
+* \brief Tests that modified, replayed, and oversized slots, and a consumer with the wrong key, are rejected,
+* that a received message is not in the shared memory, that a consumer attached after the ring indices wrap reads on,
+* and that invalid parameters and unsealed memory are refused.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsipc_authentication_failure();
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_rcsipc_run();
+
+#endif
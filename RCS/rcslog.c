@@ -0,0 +1,714 @@
+#include "rcslog.h"
+#include "csp.h"
+#include "fileutils.h"
+#include "intutils.h"
+#include "memutils.h"
+
+#define RCSLOG_MAGIC_SIZE 4
+#define RCSLOG_VERSION_OFFSET 4
+#define RCSLOG_CIPHER_OFFSET 5
+#define RCSLOG_SEGMENT_OFFSET 8
+#define RCSLOG_NONCE_OFFSET 16
+#define RCSLOG_CHECK_OFFSET 48
+#define RCSLOG_CHECK_SIZE 16
+#define RCSLOG_COUNT_OFFSET 8
+#define RCSLOG_LENGTH_OFFSET 12
+#define RCSLOG_SESSION_OFFSET 16
+#define RCSLOG_SEQUENCE_OFFSET 8
+#define RCSLOG_NONCE_SESSION_OFFSET 16
+#define RCSLOG_ASSOCIATED_SIZE (QSC_RCSLOG_HEADER_SIZE + QSC_RCSLOG_SEGMENT_HEADER_SIZE + QSC_RCS512_MAC_SIZE)
+#define RCSLOG_SCAN_SIZE (4 * 1024 * 1024)
+
+static const uint8_t rcslog_magic[RCSLOG_MAGIC_SIZE] = { 0x52, 0x43, 0x53, 0x4C };
+
+static void rcslog_clear(qsc_rcslog_state* ctx)
+{
+	qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcslog_state));
+	ctx->handle = QSC_FILEUTILS_INVALID_HANDLE;
+}
+
+static bool rcslog_load(qsc_rcslog_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* header)
+{
+	const rcs_cipher_type CTYPE = (keylen == QSC_RCS512_KEY_SIZE) ? RCS512 : RCS256;
+	size_t segsize;
+	size_t i;
+	bool res;
+
+	res = false;
+	segsize = (size_t)qsc_intutils_le8to32(header + RCSLOG_SEGMENT_OFFSET);
+
+	if (qsc_intutils_are_equal8(header, rcslog_magic, RCSLOG_MAGIC_SIZE) == true &&
+		header[RCSLOG_VERSION_OFFSET] == QSC_RCSLOG_VERSION &&
+		header[RCSLOG_CIPHER_OFFSET] == (uint8_t)CTYPE &&
+		(keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE) &&
+		segsize >= QSC_RCSLOG_SEGMENT_MIN && segsize <= QSC_RCSLOG_SEGMENT_MAX)
+	{
+		/* the reserved bytes must be zero */
+		res = true;
+
+		for (i = RCSLOG_CIPHER_OFFSET + 1; i < RCSLOG_SEGMENT_OFFSET; ++i)
+		{
+			res = res && (header[i] == 0);
+		}
+
+		for (i = RCSLOG_SEGMENT_OFFSET + sizeof(uint32_t); i < RCSLOG_NONCE_OFFSET; ++i)
+		{
+			res = res && (header[i] == 0);
+		}
+	}
+
+	if (res == true)
+	{
+		qsc_rcs_keyparams kp = { key, keylen, ctx->nonce, NULL, 0 };
+
+		qsc_memutils_copy(ctx->header, header, QSC_RCSLOG_HEADER_SIZE);
+		qsc_memutils_copy(ctx->nonce, header + RCSLOG_NONCE_OFFSET, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_key_expand(&ctx->key, &kp);
+#if defined(QSC_RCS_AUTHENTICATED)
+		ctx->maclen = (CTYPE == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+#else
+		ctx->maclen = 0;
+#endif
+		ctx->segsize = segsize;
+		qsc_csp_generate(ctx->session, sizeof(ctx->session));
+		ctx->offset = QSC_RCSLOG_HEADER_SIZE;
+		ctx->roffset = QSC_RCSLOG_HEADER_SIZE;
+		ctx->payload = (uint8_t*)qsc_memutils_malloc(segsize);
+		ctx->wbuffer = (uint8_t*)qsc_memutils_malloc(QSC_RCSLOG_SEGMENT_HEADER_SIZE + segsize + ctx->maclen);
+		ctx->rbuffer = (uint8_t*)qsc_memutils_malloc(ctx->maclen + QSC_RCSLOG_SEGMENT_HEADER_SIZE + segsize + ctx->maclen);
+		res = (ctx->payload != NULL && ctx->wbuffer != NULL && ctx->rbuffer != NULL);
+	}
+
+	return res;
+}
+
+static void rcslog_header_check(qsc_rcslog_state* ctx, uint8_t* check)
+{
+	uint8_t code[QSC_RCS512_MAC_SIZE] = { 0 };
+
+	/* the MAC code of an empty message, with the header before the key check as associated data;
+	   no key-stream is generated, so the log nonce is not used by a segment */
+	qsc_rcs_stream_initialize(&ctx->state, &ctx->key, ctx->nonce, true);
+	qsc_rcs_set_associated(&ctx->state, ctx->header, RCSLOG_CHECK_OFFSET);
+	qsc_rcs_transform(&ctx->state, code, code, 0);
+	qsc_memutils_copy(check, code, RCSLOG_CHECK_SIZE);
+	qsc_memutils_clear(code, sizeof(code));
+}
+
+static void rcslog_segment_initialize(const qsc_rcslog_state* ctx, qsc_rcs_state* state, const uint8_t* seghdr, const uint8_t* chain, bool encryption)
+{
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t ad[RCSLOG_ASSOCIATED_SIZE] = { 0 };
+
+	/* a segment is keyed by its first sequence number and the session value of the writer that sealed it */
+	qsc_rcs_nonce_derive(nonce, ctx->nonce, qsc_intutils_le8to64(seghdr), RCSLOG_SEQUENCE_OFFSET);
+	qsc_rcs_nonce_derive(nonce, nonce, qsc_intutils_le8to64(seghdr + RCSLOG_SESSION_OFFSET), RCSLOG_NONCE_SESSION_OFFSET);
+
+	qsc_rcs_stream_initialize(state, &ctx->key, nonce, encryption);
+	/* bind the log header, the segment header, and the MAC code of the previous segment */
+	qsc_memutils_copy(ad, ctx->header, QSC_RCSLOG_HEADER_SIZE);
+	qsc_memutils_copy(ad + QSC_RCSLOG_HEADER_SIZE, seghdr, QSC_RCSLOG_SEGMENT_HEADER_SIZE);
+
+	if (ctx->maclen != 0)
+	{
+		qsc_memutils_copy(ad + QSC_RCSLOG_HEADER_SIZE + QSC_RCSLOG_SEGMENT_HEADER_SIZE, chain, ctx->maclen);
+	}
+
+	qsc_rcs_set_associated(state, ad, QSC_RCSLOG_HEADER_SIZE + QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->maclen);
+	qsc_memutils_clear(nonce, sizeof(nonce));
+}
+
+static bool rcslog_segment_valid(const qsc_rcslog_state* ctx, const uint8_t* seghdr, uint64_t sequence)
+{
+	uint64_t count;
+	uint64_t plen;
+
+	count = qsc_intutils_le8to32(seghdr + RCSLOG_COUNT_OFFSET);
+	plen = qsc_intutils_le8to32(seghdr + RCSLOG_LENGTH_OFFSET);
+
+	/* every record holds at least its length prefix */
+	return (qsc_intutils_le8to64(seghdr) == sequence && count != 0 &&
+		plen <= ctx->segsize && count * QSC_RCSLOG_RECORD_HEADER_SIZE <= plen);
+}
+
+static bool rcslog_segment_write(qsc_rcslog_state* ctx)
+{
+	uint8_t* pseg;
+	size_t slen;
+	bool res;
+
+	res = true;
+
+	if (ctx->seglen != 0)
+	{
+		pseg = ctx->wbuffer;
+		qsc_intutils_le64to8(pseg, ctx->first);
+		qsc_intutils_le32to8(pseg + RCSLOG_COUNT_OFFSET, (uint32_t)(ctx->sequence - ctx->first));
+		qsc_intutils_le32to8(pseg + RCSLOG_LENGTH_OFFSET, (uint32_t)ctx->seglen);
+		qsc_memutils_copy(pseg + RCSLOG_SESSION_OFFSET, ctx->session, sizeof(ctx->session));
+
+		/* the whole payload is encrypted in one call, and the MAC code is appended to the cipher-text */
+		rcslog_segment_initialize(ctx, &ctx->state, pseg, ctx->chain, true);
+		qsc_rcs_transform(&ctx->state, pseg + QSC_RCSLOG_SEGMENT_HEADER_SIZE, ctx->payload, ctx->seglen);
+		slen = QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->seglen + ctx->maclen;
+		res = qsc_fileutils_write_at(ctx->handle, pseg, slen, ctx->offset);
+
+		/* a failed write leaves the open segment in place, so it is written again with the same nonce and records */
+		if (res == true)
+		{
+			qsc_memutils_copy(ctx->chain, pseg + slen - ctx->maclen, ctx->maclen);
+			qsc_memutils_clear(ctx->payload, ctx->seglen);
+			ctx->offset += slen;
+			ctx->first = ctx->sequence;
+			ctx->seglen = 0;
+			ctx->unsynced = true;
+		}
+	}
+
+	return res;
+}
+
+static qsc_rcslog_status rcslog_recover(qsc_rcslog_state* ctx)
+{
+	qsc_rcs_state* pstates[QSC_RCSLOG_SCAN_BATCH];
+	const uint8_t* inputs[QSC_RCSLOG_SCAN_BATCH];
+	uint8_t* outputs[QSC_RCSLOG_SCAN_BATCH];
+	uint8_t* tags[QSC_RCSLOG_SCAN_BATCH];
+	size_t lengths[QSC_RCSLOG_SCAN_BATCH];
+	bool results[QSC_RCSLOG_SCAN_BATCH];
+	qsc_rcslog_status res;
+	qsc_rcs_state* states;
+	uint8_t* buf;
+	uint8_t* pseg;
+	uint64_t flen;
+	uint64_t sequence;
+	size_t blen;
+	size_t rlen;
+	size_t slen;
+	size_t pos;
+	size_t bcnt;
+	size_t i;
+	bool valid;
+	bool end;
+
+	res = qsc_rcslog_status_read_failure;
+	valid = true;
+	end = false;
+	flen = qsc_fileutils_size(ctx->handle);
+	/* a run holds at least one segment of the largest size, and the MAC code of the segment before the run */
+	blen = qsc_intutils_max(RCSLOG_SCAN_SIZE, QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->segsize + ctx->maclen);
+	buf = (uint8_t*)qsc_memutils_malloc(ctx->maclen + blen);
+	states = (qsc_rcs_state*)qsc_memutils_aligned_alloc(64, QSC_RCSLOG_SCAN_BATCH * sizeof(qsc_rcs_state));
+
+	if (buf != NULL && states != NULL)
+	{
+		res = qsc_rcslog_status_success;
+
+		while (end == false && ctx->offset < flen)
+		{
+			rlen = (flen - ctx->offset < (uint64_t)blen) ? (size_t)(flen - ctx->offset) : blen;
+			qsc_memutils_copy(buf, ctx->chain, ctx->maclen);
+
+			if (qsc_fileutils_read_at(ctx->handle, buf + ctx->maclen, rlen, ctx->offset) == false)
+			{
+				res = qsc_rcslog_status_read_failure;
+				break;
+			}
+
+			/* the segment headers are checked, and the segments of the run are collected into a batch */
+			sequence = ctx->sequence;
+			pos = 0;
+			bcnt = 0;
+
+			while (bcnt < QSC_RCSLOG_SCAN_BATCH && pos + QSC_RCSLOG_SEGMENT_HEADER_SIZE <= rlen)
+			{
+				pseg = buf + ctx->maclen + pos;
+
+				if (rcslog_segment_valid(ctx, pseg, sequence) == false)
+				{
+					end = true;
+					break;
+				}
+
+				slen = QSC_RCSLOG_SEGMENT_HEADER_SIZE + qsc_intutils_le8to32(pseg + RCSLOG_LENGTH_OFFSET) + ctx->maclen;
+
+				if (pos + slen > rlen)
+				{
+					/* a segment that runs past the end of the file was torn; otherwise it starts the next run */
+					end = (ctx->offset + pos + slen > flen);
+					break;
+				}
+
+				/* the previous MAC code is stored just before the segment, or copied from the chain for the first segment of the run */
+				rcslog_segment_initialize(ctx, &states[bcnt], pseg, pseg - ctx->maclen, false);
+				pstates[bcnt] = &states[bcnt];
+				inputs[bcnt] = pseg + QSC_RCSLOG_SEGMENT_HEADER_SIZE;
+				outputs[bcnt] = pseg + QSC_RCSLOG_SEGMENT_HEADER_SIZE;
+				tags[bcnt] = pseg + slen - ctx->maclen;
+				lengths[bcnt] = slen - QSC_RCSLOG_SEGMENT_HEADER_SIZE - ctx->maclen;
+				sequence += qsc_intutils_le8to32(pseg + RCSLOG_COUNT_OFFSET);
+				pos += slen;
+				++bcnt;
+			}
+
+			if (bcnt == 0)
+			{
+				/* a partial segment header at the end of the file */
+				end = true;
+			}
+			else
+			{
+				qsc_rcs_transform_batch_detached(pstates, outputs, inputs, lengths, tags, results, bcnt);
+
+				/* the log ends before the first segment that fails authentication */
+				for (i = 0; i < bcnt && valid == true; ++i)
+				{
+					valid = results[i];
+
+					if (valid == true)
+					{
+						pseg = (uint8_t*)inputs[i] - QSC_RCSLOG_SEGMENT_HEADER_SIZE;
+						qsc_memutils_copy(ctx->chain, tags[i], ctx->maclen);
+						ctx->sequence += qsc_intutils_le8to32(pseg + RCSLOG_COUNT_OFFSET);
+						ctx->offset += QSC_RCSLOG_SEGMENT_HEADER_SIZE + lengths[i] + ctx->maclen;
+					}
+				}
+
+				end = (end == true || valid == false);
+
+				for (i = 0; i < bcnt; ++i)
+				{
+					qsc_rcs_dispose(&states[i]);
+				}
+			}
+		}
+
+		ctx->first = ctx->sequence;
+		qsc_memutils_clear(buf, ctx->maclen + blen);
+	}
+
+	if (buf != NULL)
+	{
+		qsc_memutils_alloc_free(buf);
+	}
+
+	if (states != NULL)
+	{
+		qsc_memutils_aligned_free(states);
+	}
+
+	/* a torn or failed tail is removed, so new segments continue the chain from the last authentic segment */
+	if (res == qsc_rcslog_status_success && flen > ctx->offset)
+	{
+		if (qsc_fileutils_truncate(ctx->handle, ctx->offset) == false || qsc_fileutils_sync(ctx->handle) == false)
+		{
+			res = qsc_rcslog_status_write_failure;
+		}
+	}
+
+	return res;
+}
+
+static qsc_rcslog_status rcslog_read_load(qsc_rcslog_state* ctx)
+{
+	qsc_rcslog_status res;
+	uint8_t* pseg;
+	uint64_t first;
+	uint64_t count;
+	size_t plen;
+	size_t rlen;
+	size_t pos;
+	size_t i;
+
+	res = qsc_rcslog_status_read_failure;
+	pseg = ctx->rbuffer + ctx->maclen;
+	rlen = QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->segsize + ctx->maclen;
+
+	if (ctx->offset - ctx->roffset < (uint64_t)rlen)
+	{
+		rlen = (size_t)(ctx->offset - ctx->roffset);
+	}
+
+	/* the previous MAC code and the segment are read in one call; the first segment is chained to zeros */
+	if (ctx->roffset == QSC_RCSLOG_HEADER_SIZE)
+	{
+		qsc_memutils_clear(ctx->rbuffer, ctx->maclen);
+
+		if (qsc_fileutils_read_at(ctx->handle, pseg, rlen, ctx->roffset) == true)
+		{
+			res = qsc_rcslog_status_success;
+		}
+	}
+	else if (qsc_fileutils_read_at(ctx->handle, ctx->rbuffer, ctx->maclen + rlen, ctx->roffset - ctx->maclen) == true)
+	{
+		res = qsc_rcslog_status_success;
+	}
+
+	if (res == qsc_rcslog_status_success)
+	{
+		res = qsc_rcslog_status_invalid_format;
+		first = qsc_intutils_le8to64(pseg);
+		count = qsc_intutils_le8to32(pseg + RCSLOG_COUNT_OFFSET);
+		plen = qsc_intutils_le8to32(pseg + RCSLOG_LENGTH_OFFSET);
+
+		if (rlen >= QSC_RCSLOG_SEGMENT_HEADER_SIZE && rcslog_segment_valid(ctx, pseg, first) == true &&
+			QSC_RCSLOG_SEGMENT_HEADER_SIZE + plen + ctx->maclen <= rlen &&
+			ctx->rsequence >= first && ctx->rsequence - first < count)
+		{
+			res = qsc_rcslog_status_authentication_failure;
+			rcslog_segment_initialize(ctx, &ctx->state, pseg, ctx->rbuffer, false);
+
+			if (qsc_rcs_transform(&ctx->state, pseg + QSC_RCSLOG_SEGMENT_HEADER_SIZE, pseg + QSC_RCSLOG_SEGMENT_HEADER_SIZE, plen) == true)
+			{
+				/* the records must fill the payload exactly */
+				res = qsc_rcslog_status_success;
+				pos = 0;
+
+				for (i = 0; i < count && res == qsc_rcslog_status_success; ++i)
+				{
+					if (plen - pos < QSC_RCSLOG_RECORD_HEADER_SIZE ||
+						plen - pos - QSC_RCSLOG_RECORD_HEADER_SIZE < qsc_intutils_le8to32(pseg + QSC_RCSLOG_SEGMENT_HEADER_SIZE + pos))
+					{
+						res = qsc_rcslog_status_invalid_format;
+					}
+					else
+					{
+						/* skip to the record at the read position */
+						if (first + i == ctx->rsequence)
+						{
+							ctx->rposition = pos;
+						}
+
+						pos += QSC_RCSLOG_RECORD_HEADER_SIZE + qsc_intutils_le8to32(pseg + QSC_RCSLOG_SEGMENT_HEADER_SIZE + pos);
+					}
+				}
+
+				if (res == qsc_rcslog_status_success && pos == plen)
+				{
+					ctx->rlength = plen;
+					ctx->rloaded = true;
+				}
+				else
+				{
+					res = qsc_rcslog_status_invalid_format;
+					qsc_memutils_clear(pseg, QSC_RCSLOG_SEGMENT_HEADER_SIZE + plen);
+				}
+			}
+		}
+	}
+
+	return res;
+}
+
+qsc_rcslog_status qsc_rcslog_create(qsc_rcslog_state* ctx, const char* path, const uint8_t* key, size_t keylen, size_t segsize)
+{
+	assert(ctx != NULL);
+	assert(path != NULL);
+	assert(key != NULL);
+
+	uint8_t hdr[QSC_RCSLOG_HEADER_SIZE] = { 0 };
+	qsc_rcslog_status res;
+	bool fres;
+
+	res = qsc_rcslog_status_invalid_parameter;
+	rcslog_clear(ctx);
+
+	if ((keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE) &&
+		segsize >= QSC_RCSLOG_SEGMENT_MIN && segsize <= QSC_RCSLOG_SEGMENT_MAX)
+	{
+		res = qsc_rcslog_status_write_failure;
+		qsc_memutils_copy(hdr, rcslog_magic, RCSLOG_MAGIC_SIZE);
+		hdr[RCSLOG_VERSION_OFFSET] = QSC_RCSLOG_VERSION;
+		hdr[RCSLOG_CIPHER_OFFSET] = (uint8_t)((keylen == QSC_RCS512_KEY_SIZE) ? RCS512 : RCS256);
+		qsc_intutils_le32to8(hdr + RCSLOG_SEGMENT_OFFSET, (uint32_t)segsize);
+		qsc_csp_generate(hdr + RCSLOG_NONCE_OFFSET, QSC_RCS_NONCE_SIZE);
+
+		if (rcslog_load(ctx, key, keylen, hdr) == true)
+		{
+			rcslog_header_check(ctx, ctx->header + RCSLOG_CHECK_OFFSET);
+			qsc_memutils_copy(hdr, ctx->header, sizeof(hdr));
+			ctx->handle = qsc_fileutils_open(path, true);
+			fres = (ctx->handle != QSC_FILEUTILS_INVALID_HANDLE);
+
+			/* the header is made durable before the first segment can be committed */
+			if (fres == true && qsc_fileutils_write_at(ctx->handle, hdr, sizeof(hdr), 0) == true && qsc_fileutils_sync(ctx->handle) == true)
+			{
+				res = qsc_rcslog_status_success;
+			}
+		}
+	}
+
+	if (res != qsc_rcslog_status_success)
+	{
+		qsc_rcslog_dispose(ctx);
+	}
+
+	return res;
+}
+
+qsc_rcslog_status qsc_rcslog_open(qsc_rcslog_state* ctx, const char* path, const uint8_t* key, size_t keylen)
+{
+	assert(ctx != NULL);
+	assert(path != NULL);
+	assert(key != NULL);
+
+	uint8_t hdr[QSC_RCSLOG_HEADER_SIZE] = { 0 };
+	qsc_rcslog_status res;
+	bool fres;
+
+	res = qsc_rcslog_status_read_failure;
+	rcslog_clear(ctx);
+
+	ctx->handle = qsc_fileutils_open(path, false);
+	fres = (ctx->handle != QSC_FILEUTILS_INVALID_HANDLE);
+
+	if (fres == true && qsc_fileutils_read_at(ctx->handle, hdr, sizeof(hdr), 0) == true)
+	{
+		res = qsc_rcslog_status_invalid_format;
+
+		if (rcslog_load(ctx, key, keylen, hdr) == true)
+		{
+			uint8_t check[RCSLOG_CHECK_SIZE] = { 0 };
+
+			res = qsc_rcslog_status_authentication_failure;
+			rcslog_header_check(ctx, check);
+
+			/* the wrong key is rejected before the recovery scan can truncate the file */
+			if (qsc_intutils_verify(check, ctx->header + RCSLOG_CHECK_OFFSET, RCSLOG_CHECK_SIZE) == 0)
+			{
+				res = rcslog_recover(ctx);
+			}
+		}
+	}
+
+	if (res != qsc_rcslog_status_success)
+	{
+		qsc_rcslog_dispose(ctx);
+	}
+
+	return res;
+}
+
+void qsc_rcslog_dispose(qsc_rcslog_state* ctx)
+{
+	if (ctx != NULL)
+	{
+		if (ctx->payload != NULL)
+		{
+			qsc_memutils_clear(ctx->payload, ctx->segsize);
+			qsc_memutils_alloc_free(ctx->payload);
+		}
+
+		if (ctx->wbuffer != NULL)
+		{
+			qsc_memutils_alloc_free(ctx->wbuffer);
+		}
+
+		if (ctx->rbuffer != NULL)
+		{
+			qsc_memutils_clear(ctx->rbuffer, ctx->maclen + QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->segsize + ctx->maclen);
+			qsc_memutils_alloc_free(ctx->rbuffer);
+		}
+
+		qsc_fileutils_close(&ctx->handle);
+
+		qsc_rcs_dispose(&ctx->state);
+		qsc_rcs_key_dispose(&ctx->key);
+		rcslog_clear(ctx);
+	}
+}
+
+qsc_rcslog_status qsc_rcslog_append(qsc_rcslog_state* ctx, const uint8_t* record, size_t length, uint64_t* sequence)
+{
+	assert(ctx != NULL);
+	assert(record != NULL || length == 0);
+
+	qsc_rcslog_status res;
+
+	res = qsc_rcslog_status_invalid_parameter;
+
+	if (ctx->payload != NULL && length <= ctx->segsize - QSC_RCSLOG_RECORD_HEADER_SIZE)
+	{
+		res = qsc_rcslog_status_success;
+
+		/* a full segment is written, and is synchronized with the next commit */
+		if (ctx->seglen + QSC_RCSLOG_RECORD_HEADER_SIZE + length > ctx->segsize && rcslog_segment_write(ctx) == false)
+		{
+			res = qsc_rcslog_status_write_failure;
+		}
+
+		if (res == qsc_rcslog_status_success)
+		{
+			qsc_intutils_le32to8(ctx->payload + ctx->seglen, (uint32_t)length);
+
+			if (length != 0)
+			{
+				qsc_memutils_copy(ctx->payload + ctx->seglen + QSC_RCSLOG_RECORD_HEADER_SIZE, record, length);
+			}
+
+			ctx->seglen += QSC_RCSLOG_RECORD_HEADER_SIZE + length;
+
+			if (sequence != NULL)
+			{
+				*sequence = ctx->sequence;
+			}
+
+			++ctx->sequence;
+		}
+	}
+
+	return res;
+}
+
+qsc_rcslog_status qsc_rcslog_commit(qsc_rcslog_state* ctx)
+{
+	assert(ctx != NULL);
+
+	qsc_rcslog_status res;
+
+	res = qsc_rcslog_status_invalid_parameter;
+
+	if (ctx->payload != NULL)
+	{
+		res = qsc_rcslog_status_write_failure;
+
+		/* one synchronization makes every segment written since the last commit durable */
+		if (rcslog_segment_write(ctx) == true && (ctx->unsynced == false || qsc_fileutils_sync(ctx->handle) == true))
+		{
+			ctx->unsynced = false;
+			res = qsc_rcslog_status_success;
+		}
+	}
+
+	return res;
+}
+
+uint64_t qsc_rcslog_sequence(const qsc_rcslog_state* ctx)
+{
+	assert(ctx != NULL);
+
+	return ctx->sequence;
+}
+
+qsc_rcslog_status qsc_rcslog_seek(qsc_rcslog_state* ctx, uint64_t sequence)
+{
+	assert(ctx != NULL);
+
+	uint8_t seghdr[QSC_RCSLOG_SEGMENT_HEADER_SIZE] = { 0 };
+	qsc_rcslog_status res;
+	uint64_t offset;
+	uint64_t first;
+
+	res = qsc_rcslog_status_invalid_parameter;
+
+	if (ctx->payload != NULL)
+	{
+		res = qsc_rcslog_status_end_of_log;
+
+		/* the records of the open segment have not been written */
+		if (sequence <= ctx->first)
+		{
+			res = qsc_rcslog_status_success;
+			offset = QSC_RCSLOG_HEADER_SIZE;
+			first = 0;
+
+			/* only the segment headers are read, to step over the segments before the record */
+			while (offset < ctx->offset && res == qsc_rcslog_status_success)
+			{
+				if (qsc_fileutils_read_at(ctx->handle, seghdr, sizeof(seghdr), offset) == false)
+				{
+					res = qsc_rcslog_status_read_failure;
+				}
+				else if (rcslog_segment_valid(ctx, seghdr, first) == false)
+				{
+					res = qsc_rcslog_status_invalid_format;
+				}
+				else if (sequence - first < qsc_intutils_le8to32(seghdr + RCSLOG_COUNT_OFFSET))
+				{
+					break;
+				}
+				else
+				{
+					first += qsc_intutils_le8to32(seghdr + RCSLOG_COUNT_OFFSET);
+					offset += QSC_RCSLOG_SEGMENT_HEADER_SIZE + qsc_intutils_le8to32(seghdr + RCSLOG_LENGTH_OFFSET) + ctx->maclen;
+				}
+			}
+
+			if (res == qsc_rcslog_status_success)
+			{
+				qsc_memutils_clear(ctx->rbuffer, ctx->maclen + QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->rlength);
+				ctx->roffset = offset;
+				ctx->rsequence = sequence;
+				ctx->rlength = 0;
+				ctx->rposition = 0;
+				ctx->rloaded = false;
+			}
+		}
+	}
+
+	return res;
+}
+
+qsc_rcslog_status qsc_rcslog_read(qsc_rcslog_state* ctx, uint8_t* output, size_t outlen, size_t* reclen, uint64_t* sequence)
+{
+	assert(ctx != NULL);
+	assert(output != NULL || outlen == 0);
+	assert(reclen != NULL);
+
+	qsc_rcslog_status res;
+	const uint8_t* prec;
+	size_t rlen;
+
+	res = qsc_rcslog_status_invalid_parameter;
+	*reclen = 0;
+
+	if (ctx->payload != NULL)
+	{
+		res = qsc_rcslog_status_success;
+
+		/* the segment is authenticated and decrypted when its first record is read */
+		if (ctx->rloaded == false)
+		{
+			res = (ctx->roffset < ctx->offset) ? rcslog_read_load(ctx) : qsc_rcslog_status_end_of_log;
+		}
+
+		if (res == qsc_rcslog_status_success)
+		{
+			prec = ctx->rbuffer + ctx->maclen + QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->rposition;
+			rlen = qsc_intutils_le8to32(prec);
+			*reclen = rlen;
+
+			if (rlen > outlen)
+			{
+				res = qsc_rcslog_status_invalid_parameter;
+			}
+			else
+			{
+				if (rlen != 0)
+				{
+					qsc_memutils_copy(output, prec + QSC_RCSLOG_RECORD_HEADER_SIZE, rlen);
+				}
+
+				if (sequence != NULL)
+				{
+					*sequence = ctx->rsequence;
+				}
+
+				++ctx->rsequence;
+				ctx->rposition += QSC_RCSLOG_RECORD_HEADER_SIZE + rlen;
+
+				/* the read position moves to the next segment after the last record */
+				if (ctx->rposition == ctx->rlength)
+				{
+					qsc_memutils_clear(ctx->rbuffer, ctx->maclen + QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->rlength);
+					ctx->roffset += QSC_RCSLOG_SEGMENT_HEADER_SIZE + ctx->rlength + ctx->maclen;
+					ctx->rlength = 0;
+					ctx->rposition = 0;
+					ctx->rloaded = false;
+				}
+			}
+		}
+	}
+
+	return res;
+}
@@ -0,0 +1,268 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSLOG_H
+#define QSC_RCSLOG_H
+
+/**
+* \file rcslog.h
+* \brief RCS append-only encrypted log \n
+* An encrypted log of variable-length records, written in segments and committed in groups; for audit trails and journals.
+*
+* Log layout: \n
+* header (64) | segment | segment | ... \n
+* Header layout (64 bytes): \n
+* magic (4) | version (1) | cipher type (1) | reserved (2) | segment size (4, little-endian) | reserved (4) | log nonce (32) | key check (16) \n
+* Segment layout: \n
+* first sequence (8, little-endian) | record count (4, little-endian) | payload length (4, little-endian) | session (8) | cipher-text |
+* MAC code (32 or 64) \n
+* Record layout, within the payload: \n
+* record length (4, little-endian) | record \n
+*
+* Every record has a sequence number, starting at zero, and the records of a segment are numbered consecutively
+* from the first sequence in the segment header. Appended records are collected into a segment buffer,
+* and the whole payload of a segment is encrypted by a single transform call, which runs on the widest cipher kernel.
+* The log keeps one expanded key and one cipher state for its lifetime; each segment is transformed with a nonce derived
+* from the log nonce and its first sequence number, so the nonces follow the sequence numbers and are never repeated.
+* Every create or open of the log also draws a random session value, which is stored in the segment header and added to the nonce,
+* so a segment that reuses the sequence numbers of a torn segment removed by recovery does not repeat its key-stream. \n
+* The log header, the segment header, and the MAC code of the previous segment are bound to every segment as associated data,
+* so the segments form a chain; a segment can not be modified, removed, reordered, or moved to another log
+* without failing authentication. A log truncated at a segment boundary is still a valid log, and ends at the last segment. \n
+* A segment is written to the file when it is full, or when the log is committed; a commit writes the open segment,
+* and makes every segment written since the previous commit durable with a single file synchronization.
+* Records appended after the last commit are lost if the process stops before the next commit. \n
+* When a log is opened, the key check in the header, the leading bytes of a MAC code of the header, is verified first,
+* so a log opened with the wrong key is rejected before it can be changed. A recovery scan then reads the segments in large runs,
+* checks the segment headers, and authenticates the segments in batches across the vector lanes, using the chained MAC codes stored in the file.
+* The log ends at the last authentic segment; a segment torn by a crash, and anything after it, is truncated from the file.
+* A damaged segment in the middle of the log is treated in the same way, and the log is recovered to the point before it.
+* The state holds the segment buffers, so a log is used by one thread at a time.
+*
+* Log example \n
+* \code
+* qsc_rcslog_state log;
+*
+* qsc_rcslog_create(&log, "audit.log", key, QSC_RCS256_KEY_SIZE, QSC_RCSLOG_SEGMENT_DEFAULT);
+* qsc_rcslog_append(&log, record1, rec1len, NULL);
+* qsc_rcslog_append(&log, record2, rec2len, NULL);
+* // one write and one file synchronization for both records
+* qsc_rcslog_commit(&log);
+*
+* // read the log from the first record
+* qsc_rcslog_seek(&log, 0);
+*
+* while (qsc_rcslog_read(&log, output, sizeof(output), &reclen, &sequence) == qsc_rcslog_status_success)
+* {
+*	...
+* }
+*
+* qsc_rcslog_dispose(&log);
+* \endcode
+*/
+
+#include "common.h"
+#include "fileutils.h"
+#include "rcs.h"
+
+/*!
+* \def QSC_RCSLOG_HEADER_SIZE
+* \brief The size of the log header in bytes
+*/
+#define QSC_RCSLOG_HEADER_SIZE 64
+
+/*!
+* \def QSC_RCSLOG_SEGMENT_HEADER_SIZE
+* \brief The size of a segment header in bytes
+*/
+#define QSC_RCSLOG_SEGMENT_HEADER_SIZE 24
+
+/*!
+* \def QSC_RCSLOG_RECORD_HEADER_SIZE
+* \brief The size of the length prefix of a record in bytes
+*/
+#define QSC_RCSLOG_RECORD_HEADER_SIZE 4
+
+/*!
+* \def QSC_RCSLOG_VERSION
+* \brief The log format version
+*/
+#define QSC_RCSLOG_VERSION 0x01
+
+/*!
+* \def QSC_RCSLOG_SEGMENT_DEFAULT
+* \brief The default size of a segment payload in bytes
+*/
+#define QSC_RCSLOG_SEGMENT_DEFAULT (64 * 1024)
+
+/*!
+* \def QSC_RCSLOG_SEGMENT_MIN
+* \brief The minimum size of a segment payload in bytes
+*/
+#define QSC_RCSLOG_SEGMENT_MIN 256
+
+/*!
+* \def QSC_RCSLOG_SEGMENT_MAX
+* \brief The maximum size of a segment payload in bytes
+*/
+#define QSC_RCSLOG_SEGMENT_MAX (16 * 1024 * 1024)
+
+/*!
+* \def QSC_RCSLOG_SCAN_BATCH
+* \brief The number of segments authenticated in one batch by the recovery scan
+*/
+#define QSC_RCSLOG_SCAN_BATCH 16
+
+/*! \enum qsc_rcslog_status
+* The log operation result
+*/
+typedef enum
+{
+	qsc_rcslog_status_success = 0,					/*!< The operation completed */
+	qsc_rcslog_status_invalid_parameter = 1,		/*!< The key length or segment size is not valid, or a record does not fit in a segment or the output */
+	qsc_rcslog_status_read_failure = 2,				/*!< The log file could not be opened or read */
+	qsc_rcslog_status_write_failure = 3,			/*!< The log file could not be created, written, or synchronized */
+	qsc_rcslog_status_invalid_format = 4,			/*!< The file is not a log, or was not written with this key length */
+	qsc_rcslog_status_authentication_failure = 5,	/*!< The key check or a segment failed authentication; the read position is not advanced */
+	qsc_rcslog_status_end_of_log = 6,				/*!< There are no more records */
+} qsc_rcslog_status;
+
+/*!
+* \struct qsc_rcslog_state
+* \brief The log state; the expanded key, the long-lived cipher state, the chain, the segment buffers, and the read position
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_key key;								/*!< The expanded cipher key */
+	qsc_rcs_state state;							/*!< The cipher state, initialized for each segment */
+	uint8_t header[QSC_RCSLOG_HEADER_SIZE];			/*!< The log header */
+	uint8_t nonce[QSC_RCS_NONCE_SIZE];				/*!< The log nonce */
+	uint8_t chain[QSC_RCS512_MAC_SIZE];				/*!< The MAC code of the last written segment */
+	uint8_t session[sizeof(uint64_t)];				/*!< The random session value of the segments written by this state */
+	uint8_t* payload;								/*!< The plain-text records of the open segment */
+	uint8_t* wbuffer;								/*!< The encrypted segment being written; the segment header, the cipher-text, and the MAC code */
+	uint8_t* rbuffer;								/*!< The segment at the read position; the previous MAC code, and the segment */
+	uint64_t sequence;								/*!< The sequence number of the next appended record */
+	uint64_t first;									/*!< The sequence number of the first record in the open segment */
+	uint64_t offset;								/*!< The file offset of the end of the written segments */
+	uint64_t roffset;								/*!< The file offset of the segment at the read position */
+	uint64_t rsequence;								/*!< The sequence number of the next record to read */
+	size_t segsize;									/*!< The maximum payload size of a segment */
+	size_t seglen;									/*!< The payload length of the open segment */
+	size_t maclen;									/*!< The size of a segment MAC code */
+	size_t rlength;									/*!< The payload length of the loaded read segment */
+	size_t rposition;								/*!< The payload position of the next record in the loaded read segment */
+	bool rloaded;									/*!< The read segment is loaded and authenticated */
+	bool unsynced;									/*!< Segments were written since the last commit */
+	qsc_fileutils_handle handle;					/*!< The file handle */
+} qsc_rcslog_state;
+
+/**
+* \brief Create a log file, replacing an existing file, and open it for appending and reading.
+*
+* \param ctx: [struct] The log state
+* \param path: [const] The log file path
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param segsize: The maximum payload size of a segment, between QSC_RCSLOG_SEGMENT_MIN and QSC_RCSLOG_SEGMENT_MAX
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcslog_status qsc_rcslog_create(qsc_rcslog_state* ctx, const char* path, const uint8_t* key, size_t keylen, size_t segsize);
+
+/**
+* \brief Open an existing log file for appending and reading.
+* The recovery scan authenticates the segments, and truncates the file after the last authentic segment;
+* new records continue the sequence from the end of the log.
+*
+* \param ctx: [struct] The log state
+* \param path: [const] The log file path
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; must match the cipher type in the header
+*
+* \return Returns the operation status; qsc_rcslog_status_authentication_failure if the key does not match the key check
+*/
+QSC_EXPORT_API qsc_rcslog_status qsc_rcslog_open(qsc_rcslog_state* ctx, const char* path, const uint8_t* key, size_t keylen);
+
+/**
+* \brief Close the log file, and clear the state.
+* Records appended since the last commit that have not been written are discarded.
+*
+* \param ctx: [struct] The log state
+*/
+QSC_EXPORT_API void qsc_rcslog_dispose(qsc_rcslog_state* ctx);
+
+/**
+* \brief Append a record to the log.
+* The record is added to the open segment; a full segment is encrypted and written, but is durable only after the next commit.
+*
+* \param ctx: [struct] The log state
+* \param record: [const] The record
+* \param length: The record length; at most the segment size, less QSC_RCSLOG_RECORD_HEADER_SIZE
+* \param sequence: Receives the sequence number of the record; can be NULL
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcslog_status qsc_rcslog_append(qsc_rcslog_state* ctx, const uint8_t* record, size_t length, uint64_t* sequence);
+
+/**
+* \brief Commit the appended records.
+* The open segment is encrypted and written, and the file is synchronized once for every segment written since the last commit.
+*
+* \param ctx: [struct] The log state
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcslog_status qsc_rcslog_commit(qsc_rcslog_state* ctx);
+
+/**
+* \brief Get the sequence number of the next appended record; the number of records in the log, including the open segment.
+*
+* \param ctx: [const][struct] The log state
+*
+* \return Returns the next sequence number
+*/
+QSC_EXPORT_API uint64_t qsc_rcslog_sequence(const qsc_rcslog_state* ctx);
+
+/**
+* \brief Set the read position to a record.
+* The segment headers are read to find the segment holding the record, without decrypting the segments before it.
+*
+* \param ctx: [struct] The log state
+* \param sequence: The sequence number of the next record to read
+*
+* \return Returns the operation status; qsc_rcslog_status_end_of_log if the record has not been written
+*/
+QSC_EXPORT_API qsc_rcslog_status qsc_rcslog_seek(qsc_rcslog_state* ctx, uint64_t sequence);
+
+/**
+* \brief Read the record at the read position, and advance the position.
+* Each segment is authenticated and decrypted when its first record is read; records in the open segment can be read after a commit.
+*
+* \param ctx: [struct] The log state
+* \param output: The output array
+* \param outlen: The output array length
+* \param reclen: Receives the record length; set to the required length if the output is too small
+* \param sequence: Receives the sequence number of the record; can be NULL
+*
+* \return Returns the operation status; qsc_rcslog_status_end_of_log after the last written record
+*/
+QSC_EXPORT_API qsc_rcslog_status qsc_rcslog_read(qsc_rcslog_state* ctx, uint8_t* output, size_t outlen, size_t* reclen, uint64_t* sequence);
+
+#endif
@@ -0,0 +1,566 @@
+#include "rcslog_test.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "csp.h"
+#include "testutils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RCSLOG_TEST_PATH "rcslog_test.log"
+#define RCSLOG_TEST_SEGMENT 1024
+#define RCSLOG_TEST_RECORDS 500
+#define RCSLOG_TEST_GROUP 37
+#define RCSLOG_TEST_RECORD_MAX 300
+#define RCSLOG_TEST_SEGMENTS_MAX 256
+
+static size_t rcslog_record_fill(uint64_t sequence, uint8_t* record)
+{
+	/* the content of a record is a function of its sequence number; every 11th record is empty */
+	size_t rlen;
+	size_t i;
+
+	rlen = (size_t)((sequence * 37) % RCSLOG_TEST_RECORD_MAX);
+
+	if (sequence % 11 == 0)
+	{
+		rlen = 0;
+	}
+
+	for (i = 0; i < rlen; ++i)
+	{
+		record[i] = (uint8_t)(sequence + (i * 13));
+	}
+
+	return rlen;
+}
+
+static uint64_t rcslog_raw_size(const char* path)
+{
+	FILE* fp;
+	uint64_t flen;
+
+	flen = 0;
+	fp = fopen(path, "rb");
+
+	if (fp != NULL)
+	{
+		if (fseek(fp, 0, SEEK_END) == 0)
+		{
+			flen = (uint64_t)ftell(fp);
+		}
+
+		fclose(fp);
+	}
+
+	return flen;
+}
+
+static bool rcslog_raw_truncate(const char* path, uint64_t length)
+{
+	/* the file is rewritten with its leading bytes, as a crash would leave a torn tail */
+	uint8_t* buf;
+	FILE* fp;
+	bool res;
+
+	res = false;
+	buf = (uint8_t*)qsc_memutils_malloc((size_t)length);
+
+	if (buf != NULL)
+	{
+		if (qsctest_file_read(path, 0, buf, (size_t)length) == true)
+		{
+			fp = fopen(path, "wb");
+
+			if (fp != NULL)
+			{
+				res = (fwrite(buf, 1, (size_t)length, fp) == length);
+				fclose(fp);
+			}
+		}
+
+		qsc_memutils_alloc_free(buf);
+	}
+
+	return res;
+}
+
+static size_t rcslog_raw_segments(const char* path, size_t maclen, uint64_t* offsets, uint64_t* firsts)
+{
+	/* walk the segment headers, and list the file offset and first sequence of each segment */
+	uint8_t seghdr[QSC_RCSLOG_SEGMENT_HEADER_SIZE] = { 0 };
+	uint64_t flen;
+	uint64_t oft;
+	size_t scnt;
+
+	flen = rcslog_raw_size(path);
+	oft = QSC_RCSLOG_HEADER_SIZE;
+	scnt = 0;
+
+	while (oft < flen && scnt < RCSLOG_TEST_SEGMENTS_MAX && qsctest_file_read(path, oft, seghdr, sizeof(seghdr)) == true)
+	{
+		offsets[scnt] = oft;
+		firsts[scnt] = qsc_intutils_le8to64(seghdr);
+		oft += QSC_RCSLOG_SEGMENT_HEADER_SIZE + qsc_intutils_le8to32(seghdr + 12) + maclen;
+		++scnt;
+	}
+
+	return scnt;
+}
+
+static bool rcslog_append_range(qsc_rcslog_state* log, uint64_t start, uint64_t count, uint8_t* rec)
+{
+	uint64_t seq;
+	size_t rlen;
+	bool res;
+
+	res = true;
+
+	for (uint64_t i = start; i < start + count && res == true; ++i)
+	{
+		rlen = rcslog_record_fill(i, rec);
+		res = (qsc_rcslog_append(log, rec, rlen, &seq) == qsc_rcslog_status_success && seq == i);
+
+		/* commit a group of records at a time */
+		if (res == true && (i % RCSLOG_TEST_GROUP) == RCSLOG_TEST_GROUP - 1)
+		{
+			res = (qsc_rcslog_commit(log) == qsc_rcslog_status_success);
+		}
+	}
+
+	if (res == true)
+	{
+		res = (qsc_rcslog_commit(log) == qsc_rcslog_status_success);
+	}
+
+	return res;
+}
+
+static bool rcslog_read_range(qsc_rcslog_state* log, uint64_t start, uint64_t count, uint8_t* rec, uint8_t* exp)
+{
+	uint64_t seq;
+	size_t elen;
+	size_t rlen;
+	bool res;
+
+	res = (qsc_rcslog_seek(log, start) == qsc_rcslog_status_success);
+
+	for (uint64_t i = start; i < start + count && res == true; ++i)
+	{
+		elen = rcslog_record_fill(i, exp);
+		res = (qsc_rcslog_read(log, rec, RCSLOG_TEST_SEGMENT, &rlen, &seq) == qsc_rcslog_status_success &&
+			seq == i && rlen == elen && (rlen == 0 || qsc_intutils_are_equal8(rec, exp, rlen) == true));
+	}
+
+	return res;
+}
+
+static bool rcslog_segment_compare(const char* path, const uint8_t* key, size_t keylen, size_t maclen, uint8_t* rec)
+{
+	/* encrypt the records of the first segment with the single-stream transform, and compare it with the stored segment */
+	uint8_t hdr[QSC_RCSLOG_HEADER_SIZE] = { 0 };
+	uint8_t seghdr[QSC_RCSLOG_SEGMENT_HEADER_SIZE] = { 0 };
+	uint8_t ad[QSC_RCSLOG_HEADER_SIZE + QSC_RCSLOG_SEGMENT_HEADER_SIZE + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t* pln;
+	uint8_t* exp;
+	uint8_t* raw;
+	qsc_rcs_state state;
+	size_t count;
+	size_t plen;
+	size_t rlen;
+	size_t pos;
+	size_t i;
+	bool res;
+
+	res = false;
+	pln = (uint8_t*)qsc_memutils_malloc(RCSLOG_TEST_SEGMENT);
+	exp = (uint8_t*)qsc_memutils_malloc(RCSLOG_TEST_SEGMENT + QSC_RCS512_MAC_SIZE);
+	raw = (uint8_t*)qsc_memutils_malloc(RCSLOG_TEST_SEGMENT + QSC_RCS512_MAC_SIZE);
+
+	if (pln != NULL && exp != NULL && raw != NULL &&
+		qsctest_file_read(path, 0, hdr, sizeof(hdr)) == true &&
+		qsctest_file_read(path, QSC_RCSLOG_HEADER_SIZE, seghdr, sizeof(seghdr)) == true)
+	{
+		count = qsc_intutils_le8to32(seghdr + 8);
+		plen = qsc_intutils_le8to32(seghdr + 12);
+		pos = 0;
+
+		for (i = 0; i < count; ++i)
+		{
+			rlen = rcslog_record_fill(i, rec);
+
+			if (pos + QSC_RCSLOG_RECORD_HEADER_SIZE + rlen > RCSLOG_TEST_SEGMENT)
+			{
+				break;
+			}
+
+			qsc_intutils_le32to8(pln + pos, (uint32_t)rlen);
+			qsc_memutils_copy(pln + pos + QSC_RCSLOG_RECORD_HEADER_SIZE, rec, rlen);
+			pos += QSC_RCSLOG_RECORD_HEADER_SIZE + rlen;
+		}
+
+		if (i == count && pos == plen &&
+			qsctest_file_read(path, QSC_RCSLOG_HEADER_SIZE + QSC_RCSLOG_SEGMENT_HEADER_SIZE, raw, plen + maclen) == true)
+		{
+			qsc_rcs_keyparams kp = { key, keylen, nonce, NULL, 0 };
+
+			/* the nonce is the log nonce with a zero block counter, plus the first sequence and the session value */
+			qsc_memutils_copy(nonce, hdr + 16, QSC_RCS_NONCE_SIZE);
+			qsc_memutils_clear(nonce, sizeof(uint64_t));
+
+			for (i = 0; i < sizeof(uint64_t); ++i)
+			{
+				nonce[8 + i] ^= seghdr[i];
+				nonce[16 + i] ^= seghdr[16 + i];
+			}
+
+			/* the first segment is chained to a zero MAC code */
+			qsc_memutils_copy(ad, hdr, sizeof(hdr));
+			qsc_memutils_copy(ad + sizeof(hdr), seghdr, sizeof(seghdr));
+			qsc_rcs_initialize(&state, &kp, true);
+#if defined(QSC_RCS_AUTHENTICATED)
+			qsc_rcs_set_associated(&state, ad, sizeof(hdr) + sizeof(seghdr) + maclen);
+#endif
+			qsc_rcs_transform(&state, exp, pln, plen);
+			qsc_rcs_dispose(&state);
+			res = qsc_intutils_are_equal8(exp, raw, plen + maclen);
+		}
+	}
+
+	if (pln != NULL)
+	{
+		qsc_memutils_alloc_free(pln);
+	}
+
+	if (exp != NULL)
+	{
+		qsc_memutils_alloc_free(exp);
+	}
+
+	if (raw != NULL)
+	{
+		qsc_memutils_alloc_free(raw);
+	}
+
+	return res;
+}
+
+static bool rcslog_equality(size_t keylen)
+{
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	qsc_rcslog_state log;
+	uint8_t* rec;
+	uint8_t* exp;
+	uint64_t seq;
+	size_t rlen;
+	size_t maclen;
+	bool status;
+
+	status = false;
+	qsc_csp_generate(key, sizeof(key));
+	rec = (uint8_t*)qsc_memutils_malloc(RCSLOG_TEST_SEGMENT);
+	exp = (uint8_t*)qsc_memutils_malloc(RCSLOG_TEST_SEGMENT);
+
+	if (rec != NULL && exp != NULL && qsc_rcslog_create(&log, RCSLOG_TEST_PATH, key, keylen, RCSLOG_TEST_SEGMENT) == qsc_rcslog_status_success)
+	{
+		status = true;
+		maclen = log.maclen;
+
+		if (rcslog_append_range(&log, 0, RCSLOG_TEST_RECORDS, rec) == false || qsc_rcslog_sequence(&log) != RCSLOG_TEST_RECORDS)
+		{
+			qsctest_print_safe("Failure! rcslog_equality: the records could not be appended -LE1 \n");
+			status = false;
+		}
+
+		if (rcslog_read_range(&log, 0, RCSLOG_TEST_RECORDS, rec, exp) == false ||
+			qsc_rcslog_read(&log, rec, RCSLOG_TEST_SEGMENT, &rlen, &seq) != qsc_rcslog_status_end_of_log)
+		{
+			qsctest_print_safe("Failure! rcslog_equality: the records were not read back in order -LE2 \n");
+			status = false;
+		}
+
+		if (rcslog_read_range(&log, 250, 10, rec, exp) == false ||
+			qsc_rcslog_seek(&log, RCSLOG_TEST_RECORDS) != qsc_rcslog_status_success ||
+			qsc_rcslog_read(&log, rec, RCSLOG_TEST_SEGMENT, &rlen, &seq) != qsc_rcslog_status_end_of_log ||
+			qsc_rcslog_seek(&log, RCSLOG_TEST_RECORDS + 1) != qsc_rcslog_status_end_of_log)
+		{
+			qsctest_print_safe("Failure! rcslog_equality: a seek did not find the record -LE3 \n");
+			status = false;
+		}
+
+		/* a short output array reports the record length, and does not advance the read position */
+		if (qsc_rcslog_seek(&log, 1) != qsc_rcslog_status_success ||
+			qsc_rcslog_read(&log, rec, rcslog_record_fill(1, exp) - 1, &rlen, &seq) != qsc_rcslog_status_invalid_parameter ||
+			rlen != rcslog_record_fill(1, exp) ||
+			rcslog_read_range(&log, 1, 1, rec, exp) == false)
+		{
+			qsctest_print_safe("Failure! rcslog_equality: a short output array was not handled -LE4 \n");
+			status = false;
+		}
+
+		/* a record fills at most one segment */
+		qsc_memutils_clear(rec, RCSLOG_TEST_SEGMENT);
+
+		if (qsc_rcslog_append(&log, rec, RCSLOG_TEST_SEGMENT - QSC_RCSLOG_RECORD_HEADER_SIZE + 1, NULL) != qsc_rcslog_status_invalid_parameter ||
+			qsc_rcslog_append(&log, rec, RCSLOG_TEST_SEGMENT - QSC_RCSLOG_RECORD_HEADER_SIZE, &seq) != qsc_rcslog_status_success ||
+			seq != RCSLOG_TEST_RECORDS || qsc_rcslog_commit(&log) != qsc_rcslog_status_success)
+		{
+			qsctest_print_safe("Failure! rcslog_equality: the record size limit was not enforced -LE5 \n");
+			status = false;
+		}
+
+		qsc_rcslog_dispose(&log);
+
+		if (rcslog_segment_compare(RCSLOG_TEST_PATH, key, keylen, maclen, rec) == false)
+		{
+			qsctest_print_safe("Failure! rcslog_equality: the segment differs from the single-stream transform -LE6 \n");
+			status = false;
+		}
+
+		/* a reopened log continues the sequence */
+		if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, keylen) == qsc_rcslog_status_success)
+		{
+			if (qsc_rcslog_sequence(&log) != RCSLOG_TEST_RECORDS + 1 ||
+				rcslog_read_range(&log, 0, RCSLOG_TEST_RECORDS, rec, exp) == false ||
+				qsc_rcslog_read(&log, rec, RCSLOG_TEST_SEGMENT, &rlen, &seq) != qsc_rcslog_status_success ||
+				rlen != RCSLOG_TEST_SEGMENT - QSC_RCSLOG_RECORD_HEADER_SIZE || seq != RCSLOG_TEST_RECORDS)
+			{
+				qsctest_print_safe("Failure! rcslog_equality: the reopened log was not read back -LE7 \n");
+				status = false;
+			}
+
+			/* records appended after the reopen are numbered from the end of the log; the new records use the fill of their sequence */
+			if (rcslog_append_range(&log, RCSLOG_TEST_RECORDS + 1, 50, rec) == false)
+			{
+				qsctest_print_safe("Failure! rcslog_equality: the records could not be appended to the reopened log -LE8 \n");
+				status = false;
+			}
+
+			qsc_rcslog_dispose(&log);
+
+			if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, keylen) != qsc_rcslog_status_success ||
+				qsc_rcslog_sequence(&log) != RCSLOG_TEST_RECORDS + 51 ||
+				rcslog_read_range(&log, RCSLOG_TEST_RECORDS + 1, 50, rec, exp) == false ||
+				rcslog_read_range(&log, 0, 100, rec, exp) == false)
+			{
+				qsctest_print_safe("Failure! rcslog_equality: the extended log was not read back -LE9 \n");
+				status = false;
+			}
+
+			qsc_rcslog_dispose(&log);
+		}
+		else
+		{
+			qsctest_print_safe("Failure! rcslog_equality: the log could not be reopened -LE10 \n");
+			status = false;
+		}
+	}
+	else
+	{
+		qsctest_print_safe("Failure! rcslog_equality: the log could not be created -LE11 \n");
+	}
+
+	remove(RCSLOG_TEST_PATH);
+
+	if (rec != NULL)
+	{
+		qsc_memutils_alloc_free(rec);
+	}
+
+	if (exp != NULL)
+	{
+		qsc_memutils_alloc_free(exp);
+	}
+
+	return status;
+}
+
+static bool rcslog_recovery(size_t keylen)
+{
+	const uint64_t RCNT = 200;
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t bkey[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t tail[100] = { 0 };
+	uint64_t offsets[RCSLOG_TEST_SEGMENTS_MAX] = { 0 };
+	uint64_t firsts[RCSLOG_TEST_SEGMENTS_MAX] = { 0 };
+	qsc_rcslog_state log;
+	uint8_t* rec;
+	uint8_t* exp;
+	uint64_t flen;
+	uint64_t seq;
+	size_t maclen;
+	size_t scnt;
+	size_t last;
+	size_t rlen;
+	bool status;
+
+	status = false;
+	qsc_csp_generate(key, sizeof(key));
+	qsc_memutils_copy(bkey, key, sizeof(bkey));
+	bkey[0] ^= 0x01U;
+	rec = (uint8_t*)qsc_memutils_malloc(RCSLOG_TEST_SEGMENT);
+	exp = (uint8_t*)qsc_memutils_malloc(RCSLOG_TEST_SEGMENT);
+
+	if (rec != NULL && exp != NULL && qsc_rcslog_create(&log, RCSLOG_TEST_PATH, key, keylen, RCSLOG_TEST_SEGMENT) == qsc_rcslog_status_success)
+	{
+		status = true;
+		maclen = log.maclen;
+		rcslog_append_range(&log, 0, RCNT, rec);
+		qsc_rcslog_dispose(&log);
+		scnt = rcslog_raw_segments(RCSLOG_TEST_PATH, maclen, offsets, firsts);
+		last = scnt - 1;
+		flen = rcslog_raw_size(RCSLOG_TEST_PATH);
+
+		/* the wrong key and the wrong cipher type are rejected, and the file is not changed */
+		if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, bkey, keylen) != qsc_rcslog_status_authentication_failure ||
+			qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, (keylen == QSC_RCS256_KEY_SIZE) ? QSC_RCS512_KEY_SIZE : QSC_RCS256_KEY_SIZE) != qsc_rcslog_status_invalid_format ||
+			rcslog_raw_size(RCSLOG_TEST_PATH) != flen)
+		{
+			qsctest_print_safe("Failure! rcslog_recovery: the wrong key was accepted -LR1 \n");
+			status = false;
+		}
+
+		/* random bytes after the last segment are removed */
+		qsc_csp_generate(tail, sizeof(tail));
+		qsctest_file_write(RCSLOG_TEST_PATH, flen, tail, sizeof(tail));
+
+		if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, keylen) != qsc_rcslog_status_success ||
+			qsc_rcslog_sequence(&log) != RCNT || rcslog_raw_size(RCSLOG_TEST_PATH) != flen ||
+			rcslog_read_range(&log, 0, RCNT, rec, exp) == false)
+		{
+			qsctest_print_safe("Failure! rcslog_recovery: an extended tail was not removed -LR2 \n");
+			status = false;
+		}
+
+		qsc_rcslog_dispose(&log);
+
+		/* a torn last segment is truncated, and new records continue the sequence with a new session */
+		rcslog_raw_truncate(RCSLOG_TEST_PATH, offsets[last] + QSC_RCSLOG_SEGMENT_HEADER_SIZE + 30);
+
+		if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, keylen) != qsc_rcslog_status_success ||
+			qsc_rcslog_sequence(&log) != firsts[last] || rcslog_raw_size(RCSLOG_TEST_PATH) != offsets[last] ||
+			rcslog_read_range(&log, 0, firsts[last], rec, exp) == false ||
+			rcslog_append_range(&log, firsts[last], RCNT - firsts[last], rec) == false)
+		{
+			qsctest_print_safe("Failure! rcslog_recovery: a torn segment was not truncated -LR3 \n");
+			status = false;
+		}
+
+		qsc_rcslog_dispose(&log);
+
+		if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, keylen) != qsc_rcslog_status_success ||
+			qsc_rcslog_sequence(&log) != RCNT || rcslog_read_range(&log, 0, RCNT, rec, exp) == false)
+		{
+			qsctest_print_safe("Failure! rcslog_recovery: the recovered log was not extended -LR4 \n");
+			status = false;
+		}
+
+		qsc_rcslog_dispose(&log);
+
+		/* a modified last segment fails authentication, and is truncated */
+		scnt = rcslog_raw_segments(RCSLOG_TEST_PATH, maclen, offsets, firsts);
+		last = scnt - 1;
+		qsctest_file_flip(RCSLOG_TEST_PATH, offsets[last] + QSC_RCSLOG_SEGMENT_HEADER_SIZE + 10);
+
+		if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, keylen) != qsc_rcslog_status_success ||
+			qsc_rcslog_sequence(&log) != firsts[last] || rcslog_raw_size(RCSLOG_TEST_PATH) != offsets[last])
+		{
+			qsctest_print_safe("Failure! rcslog_recovery: a modified segment was not truncated -LR5 \n");
+			status = false;
+		}
+
+		/* a segment modified while the log is open is rejected by a read, and the records before it are intact */
+		qsctest_file_flip(RCSLOG_TEST_PATH, offsets[3] - 1);
+
+		if (qsc_rcslog_seek(&log, firsts[2]) != qsc_rcslog_status_success ||
+			qsc_rcslog_read(&log, rec, RCSLOG_TEST_SEGMENT, &rlen, &seq) != qsc_rcslog_status_authentication_failure ||
+			rcslog_read_range(&log, 0, firsts[2], rec, exp) == false)
+		{
+			qsctest_print_safe("Failure! rcslog_recovery: a modified segment was read -LR6 \n");
+			status = false;
+		}
+
+		qsc_rcslog_dispose(&log);
+
+		/* the log is recovered to the point before the modified segment */
+		if (qsc_rcslog_open(&log, RCSLOG_TEST_PATH, key, keylen) != qsc_rcslog_status_success ||
+			qsc_rcslog_sequence(&log) != firsts[2] || rcslog_raw_size(RCSLOG_TEST_PATH) != offsets[2])
+		{
+			qsctest_print_safe("Failure! rcslog_recovery: the log was not recovered before a modified segment -LR7 \n");
+			status = false;
+		}
+
+		qsc_rcslog_dispose(&log);
+	}
+	else
+	{
+		qsctest_print_safe("Failure! rcslog_recovery: the log could not be created -LR8 \n");
+	}
+
+	remove(RCSLOG_TEST_PATH);
+
+	if (rec != NULL)
+	{
+		qsc_memutils_alloc_free(rec);
+	}
+
+	if (exp != NULL)
+	{
+		qsc_memutils_alloc_free(exp);
+	}
+
+	return status;
+}
+
+bool qsctest_rcslog_equality()
+{
+	bool status;
+
+	status = rcslog_equality(QSC_RCS256_KEY_SIZE);
+
+	if (rcslog_equality(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_rcslog_recovery()
+{
+	bool status;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	status = rcslog_recovery(QSC_RCS256_KEY_SIZE);
+
+	if (rcslog_recovery(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+void qsctest_rcslog_run()
+{
+	if (qsctest_rcslog_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS encrypted log equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS encrypted log equality test. \n");
+	}
+
+	if (qsctest_rcslog_recovery() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS encrypted log recovery test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS encrypted log recovery test. \n");
+	}
+}
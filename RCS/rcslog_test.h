@@ -0,0 +1,36 @@
+/**
+* \file rcslog_test.h
+* \brief <b>RCS Encrypted Log Tests</b> \n
+* Append, read, seek, and recovery tests for the append-only encrypted log, on a temporary file.
+* \author John Underhill
+* \date October 02, 2020
+*/
+
+#ifndef QSCTEST_RCSLOG_TEST_H
+#define QSCTEST_RCSLOG_TEST_H
+
+#include "common.h"
+#include "rcslog.h"
+
+/**
+* \brief Tests that appended records are read back in order and after a seek, across commits, full segments, and a reopened log,
+* and compares a stored segment with the single-stream transform.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcslog_equality();
+
+/**
+* \brief Tests that the recovery scan truncates a torn, modified, or extended tail and continues the sequence,
+* that a modified segment is rejected by a read, and that the wrong key is rejected without changing the file.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcslog_recovery();
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_rcslog_run();
+
+#endif
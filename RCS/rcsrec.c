@@ -0,0 +1,490 @@
+#include "rcsrec.h"
+#include "intutils.h"
+#include "memutils.h"
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <winsock2.h>
+#	pragma comment(lib, "ws2_32.lib")
+typedef WSABUF rcsrec_iovec;
+#else
+#	include <sys/socket.h>
+#	include <sys/uio.h>
+typedef struct iovec rcsrec_iovec;
+#endif
+
+#define RCSREC_INDEX_OFFSET 8
+#define RCSREC_RECEIVE_VECTORS 3
+#define RCSREC_SEND_VECTORS (QSC_RCSREC_BATCH_MAX * 3)
+
+static const uint8_t rcsrec_initiator_label[] = "RCS record layer initiator";
+static const uint8_t rcsrec_responder_label[] = "RCS record layer responder";
+
+static void rcsrec_vector_set(rcsrec_iovec* vec, uint8_t* buffer, size_t length)
+{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	vec->buf = (char*)buffer;
+	vec->len = (ULONG)length;
+#else
+	vec->iov_base = buffer;
+	vec->iov_len = length;
+#endif
+}
+
+static void rcsrec_vector_advance(rcsrec_iovec** vec, size_t* count, size_t length)
+{
+	rcsrec_iovec* pvec;
+	size_t vlen;
+
+	pvec = *vec;
+
+	/* drop the vectors that were transferred completely, and move the start of a partial vector */
+	while (*count != 0)
+	{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		vlen = (size_t)pvec->len;
+#else
+		vlen = pvec->iov_len;
+#endif
+
+		if (length < vlen)
+		{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+			rcsrec_vector_set(pvec, (uint8_t*)pvec->buf + length, vlen - length);
+#else
+			rcsrec_vector_set(pvec, (uint8_t*)pvec->iov_base + length, vlen - length);
+#endif
+			break;
+		}
+
+		length -= vlen;
+		++pvec;
+		--*count;
+	}
+
+	*vec = pvec;
+}
+
+static qsc_rcsrec_status rcsrec_send_vector(qsc_rcsrec_socket socket, rcsrec_iovec* vec, size_t count)
+{
+	qsc_rcsrec_status res;
+
+	res = qsc_rcsrec_status_success;
+
+	/* a stream socket can accept part of a gather write; resume from the first unsent byte */
+	while (count != 0 && res == qsc_rcsrec_status_success)
+	{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		DWORD slen;
+
+		slen = 0;
+
+		if (WSASend((SOCKET)socket, vec, (DWORD)count, &slen, 0, NULL, NULL) != 0)
+		{
+			res = qsc_rcsrec_status_socket_failure;
+		}
+		else
+		{
+			rcsrec_vector_advance(&vec, &count, (size_t)slen);
+		}
+#else
+		struct msghdr msg = { 0 };
+		ssize_t slen;
+
+		msg.msg_iov = vec;
+		msg.msg_iovlen = count;
+#	if defined(MSG_NOSIGNAL)
+		slen = sendmsg(socket, &msg, MSG_NOSIGNAL);
+#	else
+		slen = sendmsg(socket, &msg, 0);
+#	endif
+
+		if (slen < 0)
+		{
+			if (errno != EINTR)
+			{
+				res = qsc_rcsrec_status_socket_failure;
+			}
+		}
+		else
+		{
+			rcsrec_vector_advance(&vec, &count, (size_t)slen);
+		}
+#endif
+	}
+
+	return res;
+}
+
+static qsc_rcsrec_status rcsrec_receive_vector(qsc_rcsrec_socket socket, rcsrec_iovec* vec, size_t count, size_t required, size_t* received)
+{
+	qsc_rcsrec_status res;
+
+	res = qsc_rcsrec_status_success;
+	*received = 0;
+
+	/* the vectors past the required length are filled only with the bytes that have already arrived */
+	while (*received < required && res == qsc_rcsrec_status_success)
+	{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+		DWORD flags;
+		DWORD rlen;
+
+		flags = 0;
+		rlen = 0;
+
+		if (WSARecv((SOCKET)socket, vec, (DWORD)count, &rlen, &flags, NULL, NULL) != 0)
+		{
+			res = qsc_rcsrec_status_socket_failure;
+		}
+		else if (rlen == 0)
+		{
+			res = qsc_rcsrec_status_connection_closed;
+		}
+		else
+		{
+			*received += (size_t)rlen;
+			rcsrec_vector_advance(&vec, &count, (size_t)rlen);
+		}
+#else
+		struct msghdr msg = { 0 };
+		ssize_t rlen;
+
+		msg.msg_iov = vec;
+		msg.msg_iovlen = count;
+		rlen = recvmsg(socket, &msg, 0);
+
+		if (rlen < 0)
+		{
+			if (errno != EINTR)
+			{
+				res = qsc_rcsrec_status_socket_failure;
+			}
+		}
+		else if (rlen == 0)
+		{
+			res = qsc_rcsrec_status_connection_closed;
+		}
+		else
+		{
+			*received += (size_t)rlen;
+			rcsrec_vector_advance(&vec, &count, (size_t)rlen);
+		}
+#endif
+	}
+
+	return res;
+}
+
+static void rcsrec_record_initialize(const qsc_rcsrec_state* ctx, qsc_rcs_state* state, const qsc_rcs_key* key, uint64_t sequence, const uint8_t* header, bool encryption)
+{
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+
+	/* each direction has its own key, so the sequence number alone makes the record nonce unique */
+	qsc_rcs_nonce_derive(nonce, ctx->nonce, sequence, RCSREC_INDEX_OFFSET);
+	qsc_rcs_stream_initialize(state, key, nonce, encryption);
+	/* bind the length header to the record */
+	qsc_rcs_set_associated(state, header, QSC_RCSREC_HEADER_SIZE);
+	qsc_memutils_clear(nonce, sizeof(nonce));
+}
+
+static void rcsrec_seal(qsc_rcsrec_state* ctx, const uint8_t* input, size_t length)
+{
+	const size_t SLOT = ctx->txcount;
+	qsc_rcs_state state;
+	qsc_rcs_iovec vin;
+	qsc_rcs_iovec vout;
+
+	/* encrypt into the slot buffer; the input is the slot buffer itself when the record was coalesced */
+	vin.buffer = (uint8_t*)input;
+	vin.length = length;
+	vout.buffer = ctx->txbuf + (SLOT * ctx->recsize);
+	vout.length = length;
+
+	qsc_intutils_le32to8(ctx->txhdr[SLOT], (uint32_t)length);
+	rcsrec_record_initialize(ctx, &state, &ctx->txkey, ctx->txseq, ctx->txhdr[SLOT], true);
+	qsc_rcs_encrypt_vector(&state, &vout, 1, &vin, 1, ctx->txtag[SLOT]);
+	qsc_rcs_dispose(&state);
+
+	ctx->txlen[SLOT] = length;
+	++ctx->txcount;
+	++ctx->txseq;
+	ctx->txfill = 0;
+}
+
+static qsc_rcsrec_status rcsrec_transmit(qsc_rcsrec_state* ctx)
+{
+	rcsrec_iovec vec[RCSREC_SEND_VECTORS];
+	qsc_rcsrec_status res;
+	size_t i;
+
+	/* header, cipher-text, and MAC code of every sealed record, in one gather write */
+	for (i = 0; i < ctx->txcount; ++i)
+	{
+		rcsrec_vector_set(&vec[i * 3], ctx->txhdr[i], QSC_RCSREC_HEADER_SIZE);
+		rcsrec_vector_set(&vec[(i * 3) + 1], ctx->txbuf + (i * ctx->recsize), ctx->txlen[i]);
+		rcsrec_vector_set(&vec[(i * 3) + 2], ctx->txtag[i], ctx->maclen);
+	}
+
+	res = rcsrec_send_vector(ctx->socket, vec, ctx->txcount * 3);
+	ctx->txcount = 0;
+
+	return res;
+}
+
+static qsc_rcsrec_status rcsrec_receive_record(qsc_rcsrec_state* ctx, uint8_t* output, size_t outlen, size_t* received)
+{
+	rcsrec_iovec vec[RCSREC_RECEIVE_VECTORS];
+	uint8_t hdr[QSC_RCSREC_HEADER_SIZE] = { 0 };
+	qsc_rcsrec_status res;
+	qsc_rcs_state state;
+	qsc_rcs_iovec vrec;
+	uint8_t* prec;
+	size_t rlen;
+	size_t rtot;
+
+	res = qsc_rcsrec_status_success;
+
+	/* complete the header, part of which may have arrived with the previous record */
+	if (ctx->rxhdrlen < QSC_RCSREC_HEADER_SIZE)
+	{
+		rcsrec_vector_set(&vec[0], ctx->rxhdr + ctx->rxhdrlen, QSC_RCSREC_HEADER_SIZE - ctx->rxhdrlen);
+		res = rcsrec_receive_vector(ctx->socket, vec, 1, QSC_RCSREC_HEADER_SIZE - ctx->rxhdrlen, &rtot);
+		ctx->rxhdrlen += rtot;
+	}
+
+	if (res == qsc_rcsrec_status_success)
+	{
+		qsc_memutils_copy(hdr, ctx->rxhdr, QSC_RCSREC_HEADER_SIZE);
+		ctx->rxhdrlen = 0;
+		rlen = (size_t)qsc_intutils_le8to32(hdr);
+
+		if (rlen <= ctx->recsize)
+		{
+			/* a record that fits is received and decrypted in the caller's array */
+			prec = (rlen <= outlen) ? output : ctx->rxbuf;
+
+			rcsrec_vector_set(&vec[0], prec, rlen);
+			rcsrec_vector_set(&vec[1], ctx->rxtag, ctx->maclen);
+			rcsrec_vector_set(&vec[2], ctx->rxhdr, QSC_RCSREC_HEADER_SIZE);
+			res = rcsrec_receive_vector(ctx->socket, vec, RCSREC_RECEIVE_VECTORS, rlen + ctx->maclen, &rtot);
+
+			if (res == qsc_rcsrec_status_success)
+			{
+				ctx->rxhdrlen = rtot - (rlen + ctx->maclen);
+				vrec.buffer = prec;
+				vrec.length = rlen;
+
+				rcsrec_record_initialize(ctx, &state, &ctx->rxkey, ctx->rxseq, hdr, false);
+
+				if (qsc_rcs_decrypt_vector(&state, &vrec, 1, &vrec, 1, ctx->rxtag) == true)
+				{
+					++ctx->rxseq;
+
+					if (prec == output)
+					{
+						*received = rlen;
+					}
+					else
+					{
+						qsc_memutils_copy(output, ctx->rxbuf, outlen);
+						*received = outlen;
+						ctx->rxpos = outlen;
+						ctx->rxpend = rlen - outlen;
+					}
+				}
+				else
+				{
+					res = qsc_rcsrec_status_authentication_failure;
+				}
+
+				qsc_rcs_dispose(&state);
+			}
+			else if (res == qsc_rcsrec_status_connection_closed)
+			{
+				/* the stream ended inside a record */
+				res = qsc_rcsrec_status_invalid_record;
+			}
+		}
+		else
+		{
+			res = qsc_rcsrec_status_invalid_record;
+		}
+	}
+	else if (res == qsc_rcsrec_status_connection_closed && ctx->rxhdrlen != 0)
+	{
+		/* the stream ended inside a header */
+		res = qsc_rcsrec_status_invalid_record;
+	}
+
+	return res;
+}
+
+bool qsc_rcsrec_initialize(qsc_rcsrec_state* ctx, qsc_rcsrec_socket socket, const uint8_t* key, size_t keylen, const uint8_t* nonce, bool initiator, size_t recsize)
+{
+	assert(ctx != NULL);
+	assert(key != NULL);
+	assert(nonce != NULL);
+
+	bool res;
+
+	res = false;
+	qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsrec_state));
+
+	if ((keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE) &&
+		recsize >= QSC_RCSREC_RECORD_MIN && recsize <= QSC_RCSREC_RECORD_MAX)
+	{
+		/* batch enough records to fill the send buffer, at least one */
+		ctx->txslots = qsc_intutils_min(qsc_intutils_max(QSC_RCSREC_BATCH_SIZE / recsize, 1), QSC_RCSREC_BATCH_MAX);
+		ctx->txbuf = (uint8_t*)qsc_memutils_malloc(ctx->txslots * recsize);
+		ctx->rxbuf = (uint8_t*)qsc_memutils_malloc(recsize);
+
+		if (ctx->txbuf != NULL && ctx->rxbuf != NULL)
+		{
+			/* each direction has its own key, so the two streams can share the session nonce */
+			qsc_rcs_keyparams kpi = { key, keylen, ctx->nonce, rcsrec_initiator_label, sizeof(rcsrec_initiator_label) - 1 };
+			qsc_rcs_keyparams kpr = { key, keylen, ctx->nonce, rcsrec_responder_label, sizeof(rcsrec_responder_label) - 1 };
+
+			qsc_memutils_copy(ctx->nonce, nonce, QSC_RCS_NONCE_SIZE);
+			qsc_rcs_key_expand(&ctx->txkey, (initiator == true) ? &kpi : &kpr);
+			qsc_rcs_key_expand(&ctx->rxkey, (initiator == true) ? &kpr : &kpi);
+#if defined(QSC_RCS_AUTHENTICATED)
+			ctx->maclen = (keylen == QSC_RCS256_KEY_SIZE) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+#else
+			ctx->maclen = 0;
+#endif
+			ctx->recsize = recsize;
+			ctx->socket = socket;
+			res = true;
+		}
+		else
+		{
+			qsc_rcsrec_dispose(ctx);
+		}
+	}
+
+	return res;
+}
+
+void qsc_rcsrec_dispose(qsc_rcsrec_state* ctx)
+{
+	if (ctx != NULL)
+	{
+		if (ctx->txbuf != NULL)
+		{
+			qsc_memutils_clear(ctx->txbuf, ctx->txslots * ctx->recsize);
+			qsc_memutils_alloc_free(ctx->txbuf);
+		}
+
+		if (ctx->rxbuf != NULL)
+		{
+			qsc_memutils_clear(ctx->rxbuf, ctx->recsize);
+			qsc_memutils_alloc_free(ctx->rxbuf);
+		}
+
+		qsc_rcs_key_dispose(&ctx->txkey);
+		qsc_rcs_key_dispose(&ctx->rxkey);
+		qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsrec_state));
+	}
+}
+
+qsc_rcsrec_status qsc_rcsrec_write(qsc_rcsrec_state* ctx, const uint8_t* data, size_t length)
+{
+	assert(ctx != NULL);
+	assert(data != NULL || length == 0);
+
+	qsc_rcsrec_status res;
+	uint8_t* pslot;
+	size_t plen;
+
+	res = qsc_rcsrec_status_success;
+
+	while (length != 0 && res == qsc_rcsrec_status_success)
+	{
+		pslot = ctx->txbuf + (ctx->txcount * ctx->recsize);
+
+		if (ctx->txfill == 0 && length >= ctx->recsize)
+		{
+			/* a full record is encrypted straight from the caller's data */
+			plen = ctx->recsize;
+			rcsrec_seal(ctx, data, plen);
+		}
+		else
+		{
+			/* small writes are coalesced in the open record */
+			plen = qsc_intutils_min(ctx->recsize - ctx->txfill, length);
+			qsc_memutils_copy(pslot + ctx->txfill, data, plen);
+			ctx->txfill += plen;
+
+			if (ctx->txfill == ctx->recsize)
+			{
+				rcsrec_seal(ctx, pslot, ctx->recsize);
+			}
+		}
+
+		data += plen;
+		length -= plen;
+
+		if (ctx->txcount == ctx->txslots)
+		{
+			res = rcsrec_transmit(ctx);
+		}
+	}
+
+	return res;
+}
+
+qsc_rcsrec_status qsc_rcsrec_flush(qsc_rcsrec_state* ctx)
+{
+	assert(ctx != NULL);
+
+	qsc_rcsrec_status res;
+	uint8_t* pslot;
+
+	res = qsc_rcsrec_status_success;
+
+	if (ctx->txfill != 0)
+	{
+		pslot = ctx->txbuf + (ctx->txcount * ctx->recsize);
+		rcsrec_seal(ctx, pslot, ctx->txfill);
+	}
+
+	if (ctx->txcount != 0)
+	{
+		res = rcsrec_transmit(ctx);
+	}
+
+	return res;
+}
+
+qsc_rcsrec_status qsc_rcsrec_read(qsc_rcsrec_state* ctx, uint8_t* output, size_t outlen, size_t* received)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+	assert(received != NULL);
+
+	qsc_rcsrec_status res;
+	size_t plen;
+
+	res = qsc_rcsrec_status_success;
+	*received = 0;
+
+	if (ctx->rxpend != 0)
+	{
+		/* deliver the rest of a record that was larger than the previous output array */
+		plen = qsc_intutils_min(ctx->rxpend, outlen);
+		qsc_memutils_copy(output, ctx->rxbuf + ctx->rxpos, plen);
+		ctx->rxpos += plen;
+		ctx->rxpend -= plen;
+		*received = plen;
+	}
+	else
+	{
+		/* an empty record carries no data, so keep reading until data arrives */
+		while (*received == 0 && outlen != 0 && res == qsc_rcsrec_status_success)
+		{
+			res = rcsrec_receive_record(ctx, output, outlen, received);
+		}
+	}
+
+	return res;
+}
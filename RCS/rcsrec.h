@@ -0,0 +1,218 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSREC_H
+#define QSC_RCSREC_H
+
+/**
+* \file rcsrec.h
+* \brief RCS record layer for stream sockets \n
+* Carries an authenticated byte stream over a connected TCP (or other stream) socket as a sequence of encrypted records.
+*
+* Record layout: \n
+* plain-text length (4, little-endian) | cipher-text (length) | MAC code (32 or 64) \n
+*
+* Each direction of the connection has its own expanded key, derived from the shared key with a direction label
+* as the cSHAKE customization, and its own 64-bit record sequence number. The record nonce is the session nonce
+* with the sequence number added to its upper bits, so records can not be replayed, reordered, or reflected back to the sender.
+* The length header is bound to the record as associated data.
+*
+* The send path coalesces small application writes into records of up to recsize bytes (sized to a network MTU, or to a TSO segment),
+* and sends a batch of sealed records with a single gather write (sendmsg or WSASend), in which the header, cipher-text,
+* and MAC code of every record are separate vectors; the cipher-text is never copied to join it with its MAC code.
+* The receive path reads a record directly into the caller's buffer when it fits, with a scatter read that also collects
+* the MAC code and any part of the next header that has arrived, and authenticates and decrypts it in place. \n
+* The functions use blocking sockets. Because the record layer coalesces writes itself, the socket should have TCP_NODELAY set,
+* so a flushed record is not held back by Nagle's algorithm. On Windows, Winsock must be initialized by the caller.
+*
+* Record layer example \n
+* \code
+* qsc_rcsrec_state rec;
+* size_t rlen;
+*
+* // both peers use the same key and session nonce, and opposite initiator flags
+* qsc_rcsrec_initialize(&rec, sock, key, QSC_RCS256_KEY_SIZE, nonce, true, QSC_RCSREC_RECORD_DEFAULT);
+* qsc_rcsrec_write(&rec, msg1, msg1len);
+* qsc_rcsrec_write(&rec, msg2, msg2len);
+* qsc_rcsrec_flush(&rec);
+* qsc_rcsrec_read(&rec, buffer, sizeof(buffer), &rlen);
+* qsc_rcsrec_dispose(&rec);
+* \endcode
+*/
+
+#include "common.h"
+#include "rcs.h"
+
+/*!
+* \def QSC_RCSREC_HEADER_SIZE
+* \brief The size of the record header in bytes
+*/
+#define QSC_RCSREC_HEADER_SIZE 4
+
+/*!
+* \def QSC_RCSREC_RECORD_MIN
+* \brief The minimum number of plain-text bytes in a record
+*/
+#define QSC_RCSREC_RECORD_MIN 64
+
+/*!
+* \def QSC_RCSREC_RECORD_MTU
+* \brief A record size that fits an RCS-512 record in one 1460 byte TCP segment of an Ethernet frame
+*/
+#define QSC_RCSREC_RECORD_MTU (1460 - QSC_RCSREC_HEADER_SIZE - QSC_RCS512_MAC_SIZE)
+
+/*!
+* \def QSC_RCSREC_RECORD_DEFAULT
+* \brief The default number of plain-text bytes in a record; several records fill a TSO segment
+*/
+#define QSC_RCSREC_RECORD_DEFAULT (16 * 1024)
+
+/*!
+* \def QSC_RCSREC_RECORD_MAX
+* \brief The maximum number of plain-text bytes in a record
+*/
+#define QSC_RCSREC_RECORD_MAX (1024 * 1024)
+
+/*!
+* \def QSC_RCSREC_BATCH_MAX
+* \brief The maximum number of records sent with one gather write
+*/
+#define QSC_RCSREC_BATCH_MAX 16
+
+/*!
+* \def QSC_RCSREC_BATCH_SIZE
+* \brief The number of plain-text bytes buffered for a gather write; sets the batch length for a record size
+*/
+#define QSC_RCSREC_BATCH_SIZE (256 * 1024)
+
+/*! \enum qsc_rcsrec_status
+* The record operation result
+*/
+typedef enum
+{
+	qsc_rcsrec_status_success = 0,					/*!< The operation completed */
+	qsc_rcsrec_status_socket_failure = 1,			/*!< The socket returned an error */
+	qsc_rcsrec_status_connection_closed = 2,		/*!< The peer closed the connection; at a record boundary this is the end of the stream */
+	qsc_rcsrec_status_invalid_record = 3,			/*!< The record length exceeds the record size, or the stream ended inside a record */
+	qsc_rcsrec_status_authentication_failure = 4,	/*!< A record failed authentication; the connection must be closed */
+} qsc_rcsrec_status;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+/*!
+* \typedef qsc_rcsrec_socket
+* \brief The native socket descriptor
+*/
+typedef uintptr_t qsc_rcsrec_socket;
+#else
+/*!
+* \typedef qsc_rcsrec_socket
+* \brief The native socket descriptor
+*/
+typedef int qsc_rcsrec_socket;
+#endif
+
+/*!
+* \struct qsc_rcsrec_state
+* \brief The record layer state of one connection
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_key txkey;										/*!< The expanded key of the send direction */
+	qsc_rcs_key rxkey;										/*!< The expanded key of the receive direction */
+	uint8_t nonce[QSC_RCS_NONCE_SIZE];						/*!< The session nonce */
+	uint8_t txhdr[QSC_RCSREC_BATCH_MAX][QSC_RCSREC_HEADER_SIZE];	/*!< The headers of the sealed records */
+	uint8_t txtag[QSC_RCSREC_BATCH_MAX][QSC_RCS512_MAC_SIZE];	/*!< The MAC codes of the sealed records */
+	size_t txlen[QSC_RCSREC_BATCH_MAX];						/*!< The lengths of the sealed records */
+	uint8_t rxhdr[QSC_RCSREC_HEADER_SIZE];					/*!< The header of the next received record */
+	uint8_t rxtag[QSC_RCS512_MAC_SIZE];						/*!< The MAC code of the received record */
+	uint8_t* txbuf;											/*!< The record buffers of the send batch */
+	uint8_t* rxbuf;											/*!< The buffer of a received record that is larger than the caller's buffer */
+	uint64_t txseq;											/*!< The sequence number of the next sent record */
+	uint64_t rxseq;											/*!< The sequence number of the next received record */
+	size_t maclen;											/*!< The size of the record MAC code */
+	size_t recsize;											/*!< The maximum number of plain-text bytes in a record */
+	size_t txslots;											/*!< The number of records in a send batch */
+	size_t txcount;											/*!< The number of sealed records waiting to be sent */
+	size_t txfill;											/*!< The number of plain-text bytes in the open record */
+	size_t rxhdrlen;										/*!< The number of bytes of the next header already received */
+	size_t rxpos;											/*!< The position of the undelivered plain-text in the receive buffer */
+	size_t rxpend;											/*!< The number of undelivered plain-text bytes in the receive buffer */
+	qsc_rcsrec_socket socket;								/*!< The connected socket */
+} qsc_rcsrec_state;
+
+/**
+* \brief Initialize the record layer on a connected socket.
+* The connection key and session nonce must be shared by both peers, and the session nonce must be unique for every connection using a key.
+*
+* \param ctx: [struct] The record layer state
+* \param socket: The connected stream socket
+* \param key: [const] The connection key
+* \param keylen: The key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param nonce: [const] The session nonce, QSC_RCS_NONCE_SIZE bytes
+* \param initiator: True on the peer that opened the connection, false on the peer that accepted it
+* \param recsize: The maximum number of plain-text bytes in a record, between QSC_RCSREC_RECORD_MIN and QSC_RCSREC_RECORD_MAX
+*
+* \return Returns false if a parameter is invalid or the buffers could not be allocated
+*/
+QSC_EXPORT_API bool qsc_rcsrec_initialize(qsc_rcsrec_state* ctx, qsc_rcsrec_socket socket, const uint8_t* key, size_t keylen, const uint8_t* nonce, bool initiator, size_t recsize);
+
+/**
+* \brief Dispose of the record layer state; records that have not been flushed are discarded, the socket is not closed.
+*
+* \param ctx: [struct] The record layer state
+*/
+QSC_EXPORT_API void qsc_rcsrec_dispose(qsc_rcsrec_state* ctx);
+
+/**
+* \brief Append data to the outgoing stream.
+* The data is coalesced into records, and a batch of full records is sent when the batch is complete.
+* Data in a record that is not full is held until the next write fills it, or until qsc_rcsrec_flush is called.
+*
+* \param ctx: [struct] The record layer state
+* \param data: [const] The data to send
+* \param length: The number of bytes to send
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsrec_status qsc_rcsrec_write(qsc_rcsrec_state* ctx, const uint8_t* data, size_t length);
+
+/**
+* \brief Seal the open record, and send every record that is waiting with one gather write.
+*
+* \param ctx: [struct] The record layer state
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsrec_status qsc_rcsrec_flush(qsc_rcsrec_state* ctx);
+
+/**
+* \brief Receive data from the incoming stream.
+* Returns the undelivered remainder of the last record if there is one, otherwise blocks until the next record
+* is received and authenticated; a record that fits the output array is decrypted there without an intermediate copy.
+*
+* \param ctx: [struct] The record layer state
+* \param output: The array receiving the data
+* \param outlen: The size of the output array
+* \param received: The number of bytes written to the output array
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsrec_status qsc_rcsrec_read(qsc_rcsrec_state* ctx, uint8_t* output, size_t outlen, size_t* received);
+
+#endif
@@ -0,0 +1,509 @@
+#include "rcsrec_test.h"
+#include "async.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "csp.h"
+#include "testutils.h"
+#include <stdlib.h>
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <winsock2.h>
+#	pragma comment(lib, "ws2_32.lib")
+#else
+#	include <arpa/inet.h>
+#	include <netinet/in.h>
+#	include <netinet/tcp.h>
+#	include <sys/socket.h>
+#	include <unistd.h>
+#endif
+
+#define RCSREC_TEST_LENGTH (1024 * 1024 + 13)
+#define RCSREC_TAMPER_LENGTH 3000
+#define RCSREC_TAMPER_RECORDS 3
+#define RCSREC_TAMPER_STREAM (RCSREC_TAMPER_LENGTH + (RCSREC_TAMPER_RECORDS * (QSC_RCSREC_HEADER_SIZE + QSC_RCS512_MAC_SIZE)))
+
+typedef struct
+{
+	qsc_rcsrec_state* rec;
+	const uint8_t* message;
+	size_t length;
+	qsc_rcsrec_status result;
+} rcsrec_sender_state;
+
+bool qsctest_rcsrec_loopback(qsc_rcsrec_socket sockets[2])
+{
+	struct sockaddr_in addr = { 0 };
+	int one;
+	bool res;
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	WSADATA wsd;
+	SOCKET lsock;
+	int alen;
+
+	WSAStartup(MAKEWORD(2, 2), &wsd);
+	sockets[0] = (qsc_rcsrec_socket)INVALID_SOCKET;
+	sockets[1] = (qsc_rcsrec_socket)INVALID_SOCKET;
+	lsock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	res = (lsock != INVALID_SOCKET);
+#else
+	socklen_t alen;
+	int lsock;
+
+	sockets[0] = -1;
+	sockets[1] = -1;
+	lsock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	res = (lsock >= 0);
+#endif
+
+	one = 1;
+	alen = (int)sizeof(addr);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+
+	/* listen on an ephemeral port, connect to it, and accept the connection */
+	if (res == true)
+	{
+		res = (bind(lsock, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+			listen(lsock, 1) == 0 &&
+			getsockname(lsock, (struct sockaddr*)&addr, &alen) == 0);
+
+		if (res == true)
+		{
+			sockets[0] = (qsc_rcsrec_socket)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+			res = (connect(sockets[0], (struct sockaddr*)&addr, sizeof(addr)) == 0);
+		}
+
+		if (res == true)
+		{
+			sockets[1] = (qsc_rcsrec_socket)accept(lsock, NULL, NULL);
+			res = (setsockopt(sockets[0], IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one)) == 0 &&
+				setsockopt(sockets[1], IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one)) == 0);
+		}
+
+		qsctest_rcsrec_close((qsc_rcsrec_socket)lsock);
+	}
+
+	if (res == false)
+	{
+		qsctest_rcsrec_close(sockets[0]);
+		qsctest_rcsrec_close(sockets[1]);
+	}
+
+	return res;
+}
+
+void qsctest_rcsrec_close(qsc_rcsrec_socket socket)
+{
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	if (socket != (qsc_rcsrec_socket)INVALID_SOCKET)
+	{
+		closesocket((SOCKET)socket);
+	}
+#else
+	if (socket >= 0)
+	{
+		close(socket);
+	}
+#endif
+}
+
+static void rcsrec_sender(void* state)
+{
+	rcsrec_sender_state* pss;
+	size_t plen;
+	size_t pos;
+
+	pss = (rcsrec_sender_state*)state;
+	pss->result = qsc_rcsrec_status_success;
+	pos = 0;
+
+	/* mostly small writes of random sizes, with an occasional write of several records */
+	while (pos < pss->length && pss->result == qsc_rcsrec_status_success)
+	{
+		plen = (pss->message[pos] < 8) ? 50000 : 1 + ((size_t)pss->message[pos] * 7);
+		plen = qsc_intutils_min(plen, pss->length - pos);
+		pss->result = qsc_rcsrec_write(pss->rec, pss->message + pos, plen);
+		pos += plen;
+	}
+
+	if (pss->result == qsc_rcsrec_status_success)
+	{
+		pss->result = qsc_rcsrec_flush(pss->rec);
+	}
+}
+
+static bool rcsrec_equality(size_t keylen, size_t recsize, size_t readsize)
+{
+	const uint8_t ACK[] = { 0x41, 0x43, 0x4B };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t rack[sizeof(ACK)] = { 0 };
+	qsc_rcsrec_socket socks[2];
+	qsc_rcsrec_state reca;
+	qsc_rcsrec_state recb;
+	rcsrec_sender_state sst;
+	qsc_thread thd;
+	uint8_t* dec;
+	uint8_t* msg;
+	size_t rlen;
+	size_t rtot;
+	bool status;
+
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(nonce, sizeof(nonce));
+	dec = (uint8_t*)malloc(RCSREC_TEST_LENGTH);
+	msg = (uint8_t*)malloc(RCSREC_TEST_LENGTH);
+	status = false;
+
+	if (dec != NULL && msg != NULL && qsctest_rcsrec_loopback(socks) == true)
+	{
+		status = qsc_rcsrec_initialize(&reca, socks[0], key, keylen, nonce, true, recsize);
+
+		if (qsc_rcsrec_initialize(&recb, socks[1], key, keylen, nonce, false, recsize) == false || status == false)
+		{
+			status = false;
+			qsctest_print_safe("Failure! rcsrec_equality: initialization failed -RE1 \n");
+		}
+
+		if (status == true)
+		{
+			for (size_t i = 0; i < RCSREC_TEST_LENGTH; i += QSC_CSP_SEED_MAX)
+			{
+				qsc_csp_generate(msg + i, qsc_intutils_min(QSC_CSP_SEED_MAX, RCSREC_TEST_LENGTH - i));
+			}
+
+			sst.rec = &reca;
+			sst.message = msg;
+			sst.length = RCSREC_TEST_LENGTH;
+			status = qsc_async_thread_create(&thd, rcsrec_sender, &sst);
+
+			if (status == true)
+			{
+				rtot = 0;
+
+				while (rtot < RCSREC_TEST_LENGTH && status == true)
+				{
+					status = (qsc_rcsrec_read(&recb, dec + rtot, qsc_intutils_min(readsize, RCSREC_TEST_LENGTH - rtot), &rlen) == qsc_rcsrec_status_success);
+					rtot += rlen;
+				}
+
+				if (status == false)
+				{
+					/* reset the connection, so a sender blocked on a full socket returns */
+					qsctest_rcsrec_close(socks[1]);
+					socks[1] = (qsc_rcsrec_socket)-1;
+				}
+
+				qsc_async_thread_wait(thd);
+
+				if (status == false || sst.result != qsc_rcsrec_status_success || qsc_intutils_are_equal8(dec, msg, RCSREC_TEST_LENGTH) == false)
+				{
+					qsctest_print_safe("Failure! rcsrec_equality: decryption mismatch -RE2 \n");
+					status = false;
+				}
+
+				/* the writes are coalesced, so every record but the last is full */
+				if (reca.txseq != (RCSREC_TEST_LENGTH + recsize - 1) / recsize || recb.rxseq != reca.txseq)
+				{
+					qsctest_print_safe("Failure! rcsrec_equality: the writes were not coalesced -RE3 \n");
+					status = false;
+				}
+			}
+		}
+
+		if (status == true)
+		{
+			/* the other direction, then the end of the stream */
+			if (qsc_rcsrec_write(&recb, ACK, sizeof(ACK)) != qsc_rcsrec_status_success ||
+				qsc_rcsrec_flush(&recb) != qsc_rcsrec_status_success ||
+				qsc_rcsrec_read(&reca, rack, sizeof(rack), &rlen) != qsc_rcsrec_status_success ||
+				rlen != sizeof(ACK) || qsc_intutils_are_equal8(rack, ACK, sizeof(ACK)) == false)
+			{
+				qsctest_print_safe("Failure! rcsrec_equality: reply mismatch -RE4 \n");
+				status = false;
+			}
+
+			qsctest_rcsrec_close(socks[0]);
+			socks[0] = (qsc_rcsrec_socket)-1;
+
+			if (qsc_rcsrec_read(&recb, dec, RCSREC_TEST_LENGTH, &rlen) != qsc_rcsrec_status_connection_closed)
+			{
+				qsctest_print_safe("Failure! rcsrec_equality: the end of the stream was not detected -RE5 \n");
+				status = false;
+			}
+		}
+
+		qsc_rcsrec_dispose(&reca);
+		qsc_rcsrec_dispose(&recb);
+		qsctest_rcsrec_close(socks[0]);
+		qsctest_rcsrec_close(socks[1]);
+	}
+
+	if (dec != NULL)
+	{
+		free(dec);
+	}
+
+	if (msg != NULL)
+	{
+		free(msg);
+	}
+
+	return status;
+}
+
+bool qsctest_rcsrec_equality()
+{
+	const size_t RECSIZES[] = { QSC_RCSREC_RECORD_MIN, QSC_RCSREC_RECORD_MTU, QSC_RCSREC_RECORD_DEFAULT, QSC_RCSREC_RECORD_DEFAULT, QSC_RCSREC_RECORD_MAX };
+	const size_t READSIZES[] = { 50, 100000, 1000, RCSREC_TEST_LENGTH, 4096 };
+	bool status;
+
+	status = true;
+
+	for (size_t i = 0; i < sizeof(RECSIZES) / sizeof(RECSIZES[0]); ++i)
+	{
+		if (rcsrec_equality((i % 2 == 0) ? QSC_RCS256_KEY_SIZE : QSC_RCS512_KEY_SIZE, RECSIZES[i], READSIZES[i]) == false)
+		{
+			status = false;
+		}
+	}
+
+	return status;
+}
+
+static bool rcsrec_raw_send(qsc_rcsrec_socket socket, const uint8_t* input, size_t length)
+{
+	int slen;
+	bool res;
+
+	res = true;
+
+	while (length != 0 && res == true)
+	{
+		slen = (int)send(socket, (const char*)input, (int)length, 0);
+		res = (slen > 0);
+		input += (res == true) ? (size_t)slen : 0;
+		length -= (res == true) ? (size_t)slen : 0;
+	}
+
+	return res;
+}
+
+static size_t rcsrec_capture(const uint8_t* key, size_t keylen, const uint8_t* nonce, const uint8_t* message, uint8_t* stream)
+{
+	qsc_rcsrec_socket socks[2];
+	qsc_rcsrec_state rec;
+	size_t slen;
+	int rlen;
+
+	slen = 0;
+
+	/* record the wire format of a short stream sent by the initiator */
+	if (qsctest_rcsrec_loopback(socks) == true)
+	{
+		if (qsc_rcsrec_initialize(&rec, socks[0], key, keylen, nonce, true, QSC_RCSREC_RECORD_MTU) == true)
+		{
+			if (qsc_rcsrec_write(&rec, message, RCSREC_TAMPER_LENGTH) == qsc_rcsrec_status_success &&
+				qsc_rcsrec_flush(&rec) == qsc_rcsrec_status_success)
+			{
+				qsctest_rcsrec_close(socks[0]);
+
+				do
+				{
+					rlen = (int)recv(socks[1], (char*)stream + slen, (int)(RCSREC_TAMPER_STREAM - slen), 0);
+					slen += (rlen > 0) ? (size_t)rlen : 0;
+				}
+				while (rlen > 0 && slen < RCSREC_TAMPER_STREAM);
+			}
+			else
+			{
+				qsctest_rcsrec_close(socks[0]);
+			}
+
+			qsc_rcsrec_dispose(&rec);
+		}
+		else
+		{
+			qsctest_rcsrec_close(socks[0]);
+		}
+
+		qsctest_rcsrec_close(socks[1]);
+	}
+
+	return slen;
+}
+
+static qsc_rcsrec_status rcsrec_replay(const uint8_t* key, size_t keylen, const uint8_t* nonce, const uint8_t* stream, size_t length, bool initiator, uint8_t* output, size_t* received)
+{
+	qsc_rcsrec_socket socks[2];
+	qsc_rcsrec_state rec;
+	qsc_rcsrec_status res;
+	size_t rlen;
+
+	res = qsc_rcsrec_status_socket_failure;
+	*received = 0;
+
+	/* play a recorded stream into a receiver, and read until the stream ends or is rejected */
+	if (qsctest_rcsrec_loopback(socks) == true)
+	{
+		if (qsc_rcsrec_initialize(&rec, socks[1], key, keylen, nonce, initiator, QSC_RCSREC_RECORD_MTU) == true)
+		{
+			if (rcsrec_raw_send(socks[0], stream, length) == true)
+			{
+				qsctest_rcsrec_close(socks[0]);
+				res = qsc_rcsrec_status_success;
+
+				while (res == qsc_rcsrec_status_success && *received < RCSREC_TAMPER_LENGTH)
+				{
+					res = qsc_rcsrec_read(&rec, output + *received, RCSREC_TAMPER_LENGTH - *received, &rlen);
+					*received += rlen;
+				}
+
+				if (res == qsc_rcsrec_status_success)
+				{
+					res = qsc_rcsrec_read(&rec, output, RCSREC_TAMPER_LENGTH, &rlen);
+				}
+			}
+			else
+			{
+				qsctest_rcsrec_close(socks[0]);
+			}
+
+			qsc_rcsrec_dispose(&rec);
+		}
+		else
+		{
+			qsctest_rcsrec_close(socks[0]);
+		}
+
+		qsctest_rcsrec_close(socks[1]);
+	}
+
+	return res;
+}
+
+static bool rcsrec_authentication_failure(size_t keylen)
+{
+	const size_t MACLEN = (keylen == QSC_RCS256_KEY_SIZE) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+	const size_t RECLEN = QSC_RCSREC_HEADER_SIZE + QSC_RCSREC_RECORD_MTU + MACLEN;
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t dec[RCSREC_TAMPER_LENGTH] = { 0 };
+	uint8_t msg[RCSREC_TAMPER_LENGTH] = { 0 };
+	uint8_t mod[RCSREC_TAMPER_STREAM + RCSREC_TAMPER_STREAM] = { 0 };
+	uint8_t stm[RCSREC_TAMPER_STREAM] = { 0 };
+	qsc_rcsrec_status res;
+	size_t rlen;
+	size_t slen;
+	bool status;
+
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(nonce, sizeof(nonce));
+	qsc_csp_generate(msg, sizeof(msg));
+	slen = rcsrec_capture(key, keylen, nonce, msg, stm);
+	status = true;
+
+	/* the unmodified stream is delivered, and ends cleanly */
+	res = rcsrec_replay(key, keylen, nonce, stm, slen, false, dec, &rlen);
+
+	if (slen != RCSREC_TAMPER_LENGTH + (RCSREC_TAMPER_RECORDS * (QSC_RCSREC_HEADER_SIZE + MACLEN)) ||
+		res != qsc_rcsrec_status_connection_closed || rlen != RCSREC_TAMPER_LENGTH ||
+		qsc_intutils_are_equal8(dec, msg, RCSREC_TAMPER_LENGTH) == false)
+	{
+		qsctest_print_safe("Failure! rcsrec_authentication_failure: the recorded stream was not delivered -RA1 \n");
+		status = false;
+	}
+
+	/* a modified byte in the second record */
+	qsc_memutils_copy(mod, stm, slen);
+	mod[RECLEN + QSC_RCSREC_HEADER_SIZE + 10] ^= 0x01U;
+	res = rcsrec_replay(key, keylen, nonce, mod, slen, false, dec, &rlen);
+
+	if (res != qsc_rcsrec_status_authentication_failure || rlen != QSC_RCSREC_RECORD_MTU)
+	{
+		qsctest_print_safe("Failure! rcsrec_authentication_failure: a modified record was accepted -RA2 \n");
+		status = false;
+	}
+
+	/* the first record is replayed in place of the second */
+	qsc_memutils_copy(mod, stm, RECLEN);
+	qsc_memutils_copy(mod + RECLEN, stm, slen);
+	res = rcsrec_replay(key, keylen, nonce, mod, slen + RECLEN, false, dec, &rlen);
+
+	if (res != qsc_rcsrec_status_authentication_failure || rlen != QSC_RCSREC_RECORD_MTU)
+	{
+		qsctest_print_safe("Failure! rcsrec_authentication_failure: a replayed record was accepted -RA3 \n");
+		status = false;
+	}
+
+	/* the stream is reflected back to its sender */
+	res = rcsrec_replay(key, keylen, nonce, stm, slen, true, dec, &rlen);
+
+	if (res != qsc_rcsrec_status_authentication_failure || rlen != 0)
+	{
+		qsctest_print_safe("Failure! rcsrec_authentication_failure: a reflected record was accepted -RA4 \n");
+		status = false;
+	}
+
+	/* a length header larger than the record size */
+	qsc_memutils_copy(mod, stm, slen);
+	qsc_intutils_le32to8(mod, QSC_RCSREC_RECORD_MTU + 1);
+	res = rcsrec_replay(key, keylen, nonce, mod, slen, false, dec, &rlen);
+
+	if (res != qsc_rcsrec_status_invalid_record || rlen != 0)
+	{
+		qsctest_print_safe("Failure! rcsrec_authentication_failure: an oversized record was accepted -RA5 \n");
+		status = false;
+	}
+
+	/* the stream is truncated inside the last record */
+	res = rcsrec_replay(key, keylen, nonce, stm, slen - 10, false, dec, &rlen);
+
+	if (res != qsc_rcsrec_status_invalid_record || rlen != 2 * QSC_RCSREC_RECORD_MTU)
+	{
+		qsctest_print_safe("Failure! rcsrec_authentication_failure: a truncated stream was accepted -RA6 \n");
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_rcsrec_authentication_failure()
+{
+	bool status;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	status = rcsrec_authentication_failure(QSC_RCS256_KEY_SIZE);
+
+	if (rcsrec_authentication_failure(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+void qsctest_rcsrec_run()
+{
+	if (qsctest_rcsrec_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS record layer equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS record layer equality test. \n");
+	}
+
+	if (qsctest_rcsrec_authentication_failure() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS record layer authentication failure test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS record layer authentication failure test. \n");
+	}
+}
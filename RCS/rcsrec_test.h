@@ -0,0 +1,51 @@
+/**
+* \file rcsrec_test.h
+* \brief <b>RCS Record Layer Tests</b> \n
+* Round-trip and tamper tests for the record layer over loopback TCP connections.
+* \author John Underhill
+* \date October 02, 2020
+*/
+
+#ifndef QSCTEST_RCSREC_TEST_H
+#define QSCTEST_RCSREC_TEST_H
+
+#include "common.h"
+#include "rcsrec.h"
+
+/**
+* \brief Connect a pair of TCP sockets over the loopback interface, with TCP_NODELAY set on both.
+*
+* \param sockets: The connected sockets; the connecting socket, then the accepted socket
+*
+* \return Returns true if the sockets are connected
+*/
+bool qsctest_rcsrec_loopback(qsc_rcsrec_socket sockets[2]);
+
+/**
+* \brief Close a socket.
+*
+* \param socket: The socket to close
+*/
+void qsctest_rcsrec_close(qsc_rcsrec_socket socket);
+
+/**
+* \brief Tests a stream of mixed-size writes through the record layer with several record sizes and read sizes,
+* and checks that the writes are coalesced into full records.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsrec_equality();
+
+/**
+* \brief Tests that modified, replayed, reflected, oversized, and truncated record streams are rejected.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsrec_authentication_failure();
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_rcsrec_run();
+
+#endif
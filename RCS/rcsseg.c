@@ -0,0 +1,459 @@
+#include "rcsseg.h"
+#include "async.h"
+#include "intutils.h"
+#include "memutils.h"
+
+#define RCSSEG_MAGIC_SIZE 4
+#define RCSSEG_VERSION_OFFSET 4
+#define RCSSEG_CIPHER_OFFSET 5
+#define RCSSEG_SEGMENT_OFFSET 8
+#define RCSSEG_NONCE_OFFSET 16
+#define RCSSEG_INDEX_OFFSET 8
+#define RCSSEG_FINAL_OFFSET 16
+
+static const uint8_t rcsseg_magic[RCSSEG_MAGIC_SIZE] = { 0x52, 0x43, 0x53, 0x53 };
+
+/* a contiguous run of segments, transformed by one thread */
+typedef struct
+{
+	const qsc_rcsseg_state* ctx;
+	uint8_t* output;
+	const uint8_t* input;
+	uint64_t length;
+	uint64_t first;
+	uint64_t last;
+	uint64_t count;
+	bool encrypt;
+	bool result;
+} rcsseg_worker_state;
+
+static void rcsseg_segment_nonce(const qsc_rcsseg_state* ctx, uint8_t* nonce, uint64_t index, bool final)
+{
+	/* the final flag separates the last segment from a truncation at the same index */
+	qsc_rcs_nonce_derive(nonce, ctx->nonce, index, RCSSEG_INDEX_OFFSET);
+	qsc_rcs_nonce_derive(nonce, nonce, (final == true) ? 1U : 0U, RCSSEG_FINAL_OFFSET);
+}
+
+static void rcsseg_segment_initialize(const qsc_rcsseg_state* ctx, qsc_rcs_state* state, uint64_t index, bool final, bool encryption)
+{
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+
+	rcsseg_segment_nonce(ctx, nonce, index, final);
+	qsc_rcs_stream_initialize(state, &ctx->key, nonce, encryption);
+	/* bind the header to the segment */
+	qsc_rcs_set_associated(state, ctx->header, QSC_RCSSEG_HEADER_SIZE);
+	qsc_memutils_clear(nonce, sizeof(nonce));
+}
+
+static bool rcsseg_layout(const qsc_rcsseg_state* ctx, uint64_t length, uint64_t* plainlen, uint64_t* count)
+{
+	const uint64_t FULLSEG = (uint64_t)ctx->segsize + ctx->maclen;
+	uint64_t body;
+	uint64_t rem;
+	bool res;
+
+	res = false;
+	*plainlen = 0;
+	*count = 0;
+
+	if (length >= QSC_RCSSEG_HEADER_SIZE + ctx->maclen)
+	{
+		body = length - QSC_RCSSEG_HEADER_SIZE;
+		rem = body % FULLSEG;
+		*count = body / FULLSEG;
+
+		if (rem == 0)
+		{
+			*plainlen = *count * ctx->segsize;
+			/* without authentication an empty object has no body, it is still one empty final segment */
+			*count = (*count == 0) ? 1 : *count;
+			res = true;
+		}
+		else if (rem >= ctx->maclen)
+		{
+			*plainlen = (*count * ctx->segsize) + (rem - ctx->maclen);
+			*count += 1;
+			res = true;
+		}
+	}
+
+	return res;
+}
+
+static void rcsseg_worker(void* arg)
+{
+	rcsseg_worker_state* pwrk = (rcsseg_worker_state*)arg;
+	const qsc_rcsseg_state* ctx = pwrk->ctx;
+	const uint64_t FULLSEG = (uint64_t)ctx->segsize + ctx->maclen;
+	uint8_t* tmps;
+	uint64_t i;
+	size_t slen;
+
+	pwrk->result = true;
+	tmps = NULL;
+
+	if (pwrk->output == NULL)
+	{
+		/* verification only, the segments are decrypted to a scratch buffer */
+		tmps = (uint8_t*)qsc_memutils_malloc(ctx->segsize);
+		pwrk->result = (tmps != NULL);
+	}
+
+	for (i = pwrk->first; i < pwrk->last && pwrk->result == true; ++i)
+	{
+		const bool FINAL = (i == pwrk->count - 1);
+
+		slen = (FINAL == true) ? (size_t)(pwrk->length - (i * ctx->segsize)) : ctx->segsize;
+
+		if (pwrk->encrypt == true)
+		{
+			qsc_rcsseg_encrypt_segment(ctx, pwrk->output + (i * FULLSEG), pwrk->input + (i * ctx->segsize), slen, i, FINAL);
+		}
+		else
+		{
+			pwrk->result = qsc_rcsseg_decrypt_segment(ctx, (tmps != NULL) ? tmps : pwrk->output + (i * ctx->segsize), pwrk->input + (i * FULLSEG), slen, i, FINAL);
+		}
+	}
+
+	if (tmps != NULL)
+	{
+		qsc_memutils_clear(tmps, ctx->segsize);
+		qsc_memutils_alloc_free(tmps);
+	}
+}
+
+static bool rcsseg_parallel_transform(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, uint64_t length, uint64_t count, bool encryption)
+{
+	qsc_thread threads[QSC_ASYNC_THREADS_MAX];
+	rcsseg_worker_state wrks[QSC_ASYNC_THREADS_MAX];
+	bool tstat[QSC_ASYNC_THREADS_MAX] = { 0 };
+	uint64_t first;
+	uint64_t span;
+	size_t tcnt;
+	size_t i;
+	bool res;
+
+	/* each thread transforms a contiguous run of segments */
+	tcnt = qsc_intutils_min(qsc_async_processor_count(), QSC_ASYNC_THREADS_MAX);
+	tcnt = (count < (uint64_t)tcnt) ? (size_t)count : tcnt;
+	span = count / tcnt;
+	first = 0;
+
+	for (i = 0; i < tcnt; ++i)
+	{
+		wrks[i].ctx = ctx;
+		wrks[i].output = output;
+		wrks[i].input = input;
+		wrks[i].length = length;
+		wrks[i].first = first;
+		wrks[i].last = (i == tcnt - 1) ? count : first + span;
+		wrks[i].count = count;
+		wrks[i].encrypt = encryption;
+		wrks[i].result = false;
+		first += span;
+	}
+
+	/* the calling thread transforms the first run */
+	for (i = 1; i < tcnt; ++i)
+	{
+		tstat[i] = qsc_async_thread_create(&threads[i], rcsseg_worker, &wrks[i]);
+	}
+
+	rcsseg_worker(&wrks[0]);
+	res = wrks[0].result;
+
+	for (i = 1; i < tcnt; ++i)
+	{
+		if (tstat[i] == true)
+		{
+			qsc_async_thread_wait(threads[i]);
+		}
+		else
+		{
+			/* a thread could not be created, transform its run here */
+			rcsseg_worker(&wrks[i]);
+		}
+
+		res = res && wrks[i].result;
+	}
+
+	return res;
+}
+
+void qsc_rcsseg_header_encode(uint8_t* header, size_t keylen, size_t segsize, const uint8_t* nonce)
+{
+	assert(header != NULL);
+	assert(nonce != NULL);
+	assert(keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE);
+	assert(segsize >= QSC_RCSSEG_SEGMENT_MIN && segsize <= QSC_RCSSEG_SEGMENT_MAX);
+
+	qsc_memutils_clear(header, QSC_RCSSEG_HEADER_SIZE);
+	qsc_memutils_copy(header, rcsseg_magic, RCSSEG_MAGIC_SIZE);
+	header[RCSSEG_VERSION_OFFSET] = QSC_RCSSEG_VERSION;
+	header[RCSSEG_CIPHER_OFFSET] = (uint8_t)((keylen == QSC_RCS512_KEY_SIZE) ? RCS512 : RCS256);
+	qsc_intutils_le32to8(header + RCSSEG_SEGMENT_OFFSET, (uint32_t)segsize);
+	qsc_memutils_copy(header + RCSSEG_NONCE_OFFSET, nonce, QSC_RCS_NONCE_SIZE);
+}
+
+bool qsc_rcsseg_initialize(qsc_rcsseg_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* header)
+{
+	assert(ctx != NULL);
+	assert(key != NULL);
+	assert(header != NULL);
+
+	const rcs_cipher_type CTYPE = (keylen == QSC_RCS512_KEY_SIZE) ? RCS512 : RCS256;
+	size_t segsize;
+	size_t i;
+	bool res;
+
+	res = false;
+	segsize = (size_t)qsc_intutils_le8to32(header + RCSSEG_SEGMENT_OFFSET);
+
+	if (qsc_intutils_are_equal8(header, rcsseg_magic, RCSSEG_MAGIC_SIZE) == true &&
+		header[RCSSEG_VERSION_OFFSET] == QSC_RCSSEG_VERSION &&
+		header[RCSSEG_CIPHER_OFFSET] == (uint8_t)CTYPE &&
+		(keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE) &&
+		segsize >= QSC_RCSSEG_SEGMENT_MIN && segsize <= QSC_RCSSEG_SEGMENT_MAX)
+	{
+		/* the reserved bytes must be zero */
+		res = true;
+
+		for (i = RCSSEG_CIPHER_OFFSET + 1; i < RCSSEG_SEGMENT_OFFSET; ++i)
+		{
+			res = res && (header[i] == 0);
+		}
+
+		for (i = RCSSEG_SEGMENT_OFFSET + sizeof(uint32_t); i < RCSSEG_NONCE_OFFSET; ++i)
+		{
+			res = res && (header[i] == 0);
+		}
+	}
+
+	if (res == true)
+	{
+		qsc_rcs_keyparams kp = { key, keylen, ctx->nonce, NULL, 0 };
+
+		qsc_memutils_copy(ctx->header, header, QSC_RCSSEG_HEADER_SIZE);
+		qsc_memutils_copy(ctx->nonce, header + RCSSEG_NONCE_OFFSET, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_key_expand(&ctx->key, &kp);
+#if defined(QSC_RCS_AUTHENTICATED)
+		ctx->maclen = (CTYPE == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+#else
+		ctx->maclen = 0;
+#endif
+		ctx->segsize = segsize;
+	}
+
+	return res;
+}
+
+void qsc_rcsseg_dispose(qsc_rcsseg_state* ctx)
+{
+	if (ctx != NULL)
+	{
+		qsc_rcs_key_dispose(&ctx->key);
+		qsc_memutils_clear(ctx->header, sizeof(ctx->header));
+		qsc_memutils_clear(ctx->nonce, sizeof(ctx->nonce));
+		ctx->maclen = 0;
+		ctx->segsize = 0;
+	}
+}
+
+uint64_t qsc_rcsseg_segment_count(const qsc_rcsseg_state* ctx, uint64_t length)
+{
+	assert(ctx != NULL);
+
+	uint64_t cnt;
+
+	cnt = (length + ctx->segsize - 1) / ctx->segsize;
+
+	return (cnt == 0) ? 1 : cnt;
+}
+
+uint64_t qsc_rcsseg_encrypted_size(const qsc_rcsseg_state* ctx, uint64_t length)
+{
+	assert(ctx != NULL);
+
+	return QSC_RCSSEG_HEADER_SIZE + length + (qsc_rcsseg_segment_count(ctx, length) * ctx->maclen);
+}
+
+uint64_t qsc_rcsseg_decrypted_size(const qsc_rcsseg_state* ctx, uint64_t length)
+{
+	assert(ctx != NULL);
+
+	uint64_t cnt;
+	uint64_t plen;
+
+	rcsseg_layout(ctx, length, &plen, &cnt);
+
+	return plen;
+}
+
+void qsc_rcsseg_encrypt_segment(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, size_t length, uint64_t index, bool final)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+	assert(input != NULL || length == 0);
+	assert(length <= ctx->segsize);
+
+	uint8_t empty[1] = { 0 };
+	qsc_rcs_state state;
+
+	/* an empty object has no plain-text buffer */
+	rcsseg_segment_initialize(ctx, &state, index, final, true);
+	qsc_rcs_transform(&state, output, (input != NULL) ? input : empty, length);
+	qsc_rcs_dispose(&state);
+}
+
+bool qsc_rcsseg_decrypt_segment(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, size_t length, uint64_t index, bool final)
+{
+	assert(ctx != NULL);
+	assert(output != NULL || length == 0);
+	assert(input != NULL);
+	assert(length <= ctx->segsize);
+
+	uint8_t empty[1] = { 0 };
+	qsc_rcs_state state;
+	bool res;
+
+	rcsseg_segment_initialize(ctx, &state, index, final, false);
+	res = qsc_rcs_transform(&state, (output != NULL) ? output : empty, input, length);
+	qsc_rcs_dispose(&state);
+
+	return res;
+}
+
+void qsc_rcsseg_encrypt(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, uint64_t length)
+{
+	assert(ctx != NULL);
+	assert(output != NULL);
+	assert(input != NULL || length == 0);
+
+	qsc_memutils_copy(output, ctx->header, QSC_RCSSEG_HEADER_SIZE);
+	rcsseg_parallel_transform(ctx, output + QSC_RCSSEG_HEADER_SIZE, input, length, qsc_rcsseg_segment_count(ctx, length), true);
+}
+
+bool qsc_rcsseg_decrypt(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, uint64_t length)
+{
+	assert(ctx != NULL);
+	assert(input != NULL);
+
+	uint64_t cnt;
+	uint64_t plen;
+	bool res;
+
+	res = false;
+
+	/* the container must carry the header this state was loaded with */
+	if (rcsseg_layout(ctx, length, &plen, &cnt) == true &&
+		qsc_intutils_are_equal8(input, ctx->header, QSC_RCSSEG_HEADER_SIZE) == true)
+	{
+		res = rcsseg_parallel_transform(ctx, output, input + QSC_RCSSEG_HEADER_SIZE, plen, cnt, false);
+
+		if (res == false && plen != 0)
+		{
+			qsc_memutils_clear(output, (size_t)plen);
+		}
+	}
+
+	return res;
+}
+
+bool qsc_rcsseg_verify(const qsc_rcsseg_state* ctx, const uint8_t* input, uint64_t length)
+{
+	assert(ctx != NULL);
+	assert(input != NULL);
+
+	uint64_t cnt;
+	uint64_t plen;
+	bool res;
+
+	res = false;
+
+	if (rcsseg_layout(ctx, length, &plen, &cnt) == true &&
+		qsc_intutils_are_equal8(input, ctx->header, QSC_RCSSEG_HEADER_SIZE) == true)
+	{
+		res = rcsseg_parallel_transform(ctx, NULL, input + QSC_RCSSEG_HEADER_SIZE, plen, cnt, false);
+	}
+
+	return res;
+}
+
+bool qsc_rcsseg_decrypt_range(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, uint64_t inplen, uint64_t offset, size_t length)
+{
+	assert(ctx != NULL);
+	assert(output != NULL || length == 0);
+	assert(input != NULL);
+
+	const uint64_t FULLSEG = (uint64_t)ctx->segsize + ctx->maclen;
+	uint8_t* tmps;
+	uint64_t cnt;
+	uint64_t plen;
+	uint64_t i;
+	size_t slen;
+	size_t soft;
+	size_t rlen;
+	size_t oft;
+	bool res;
+
+	res = false;
+
+	if (rcsseg_layout(ctx, inplen, &plen, &cnt) == true &&
+		qsc_intutils_are_equal8(input, ctx->header, QSC_RCSSEG_HEADER_SIZE) == true &&
+		offset <= plen && length <= plen - offset)
+	{
+		res = true;
+
+		if (length != 0)
+		{
+			tmps = (uint8_t*)qsc_memutils_malloc(ctx->segsize);
+
+			if (tmps != NULL)
+			{
+				input += QSC_RCSSEG_HEADER_SIZE;
+				oft = 0;
+
+				/* authenticate and decrypt every segment that overlaps the range */
+				for (i = offset / ctx->segsize; oft < length && res == true; ++i)
+				{
+					const bool FINAL = (i == cnt - 1);
+
+					slen = (FINAL == true) ? (size_t)(plen - (i * ctx->segsize)) : ctx->segsize;
+					soft = (i == offset / ctx->segsize) ? (size_t)(offset % ctx->segsize) : 0;
+					rlen = qsc_intutils_min(slen - soft, length - oft);
+
+					if (soft == 0 && rlen == slen)
+					{
+						/* the whole segment is in the range, decrypt it in place */
+						res = qsc_rcsseg_decrypt_segment(ctx, output + oft, input + (i * FULLSEG), slen, i, FINAL);
+					}
+					else
+					{
+						res = qsc_rcsseg_decrypt_segment(ctx, tmps, input + (i * FULLSEG), slen, i, FINAL);
+
+						if (res == true)
+						{
+							qsc_memutils_copy(output + oft, tmps + soft, rlen);
+						}
+					}
+
+					oft += rlen;
+				}
+
+				qsc_memutils_clear(tmps, ctx->segsize);
+				qsc_memutils_alloc_free(tmps);
+			}
+			else
+			{
+				res = false;
+			}
+
+			if (res == false)
+			{
+				qsc_memutils_clear(output, length);
+			}
+		}
+	}
+
+	return res;
+}
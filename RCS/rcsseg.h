@@ -0,0 +1,243 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSSEG_H
+#define QSC_RCSSEG_H
+
+/**
+* \file rcsseg.h
+* \brief RCS segmented container functions \n
+* A chunked encryption format for large objects, in which every segment is encrypted and authenticated on its own.
+*
+* The container is a header followed by a sequence of segments. Every segment holds a fixed number of plain-text bytes
+* (the last segment can be shorter), followed by its RCS MAC code. \n
+* Header layout (48 bytes): \n
+* magic (4) | version (1) | cipher type (1) | reserved (2) | segment size (4, little-endian) | reserved (4) | file nonce (32) \n
+*
+* Each segment is transformed by a stream cloned from one expanded key, with a nonce derived from the file nonce,
+* the segment index, and a final-segment flag. The header is bound to every segment as associated data.
+* A segment can not be moved to another index or another file, and because only the last segment is encrypted
+* with the final flag set, a container truncated at a segment boundary fails authentication.
+* The segments are independent, so a container is encrypted and decrypted in parallel,
+* and any byte range can be authenticated and decrypted without reading the rest of the object.
+*
+* Segmented encryption example \n
+* \code
+* uint8_t key[QSC_RCS256_KEY_SIZE] = {...};
+* uint8_t nonce[QSC_RCS_NONCE_SIZE] = {...};
+* uint8_t header[QSC_RCSSEG_HEADER_SIZE] = { 0 };
+* qsc_rcsseg_state state;
+*
+* qsc_rcsseg_header_encode(header, QSC_RCS256_KEY_SIZE, QSC_RCSSEG_SEGMENT_DEFAULT, nonce);
+* qsc_rcsseg_initialize(&state, key, sizeof(key), header);
+*
+* // the output array is qsc_rcsseg_encrypted_size(&state, msglen) bytes
+* qsc_rcsseg_encrypt(&state, cpt, msg, msglen);
+* qsc_rcsseg_dispose(&state);
+* \endcode
+*/
+
+#include "common.h"
+#include "rcs.h"
+
+/*!
+* \def QSC_RCSSEG_HEADER_SIZE
+* \brief The size of the container header in bytes
+*/
+#define QSC_RCSSEG_HEADER_SIZE 48
+
+/*!
+* \def QSC_RCSSEG_VERSION
+* \brief The container format version
+*/
+#define QSC_RCSSEG_VERSION 0x01
+
+/*!
+* \def QSC_RCSSEG_SEGMENT_DEFAULT
+* \brief The default number of plain-text bytes in a segment
+*/
+#define QSC_RCSSEG_SEGMENT_DEFAULT (64 * 1024)
+
+/*!
+* \def QSC_RCSSEG_SEGMENT_MAX
+* \brief The maximum number of plain-text bytes in a segment
+*/
+#define QSC_RCSSEG_SEGMENT_MAX (16 * 1024 * 1024)
+
+/*!
+* \def QSC_RCSSEG_SEGMENT_MIN
+* \brief The minimum number of plain-text bytes in a segment
+*/
+#define QSC_RCSSEG_SEGMENT_MIN QSC_RCS_BLOCK_SIZE
+
+/*!
+* \struct qsc_rcsseg_state
+* \brief The segmented container state; the expanded key and the container header.
+* The state is read-only after initialization, so the segment functions can be called from several threads at once.
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_key key;							/*!< The expanded cipher key */
+	uint8_t header[QSC_RCSSEG_HEADER_SIZE];		/*!< The container header */
+	uint8_t nonce[QSC_RCS_NONCE_SIZE];			/*!< The file nonce */
+	size_t maclen;								/*!< The size of the MAC code appended to each segment */
+	size_t segsize;								/*!< The number of plain-text bytes in a segment */
+} qsc_rcsseg_state;
+
+/**
+* \brief Write a container header.
+*
+* \param header: The header array, QSC_RCSSEG_HEADER_SIZE bytes
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param segsize: The number of plain-text bytes in a segment, between QSC_RCSSEG_SEGMENT_MIN and QSC_RCSSEG_SEGMENT_MAX
+* \param nonce: [const] The random file nonce, QSC_RCS_NONCE_SIZE bytes; must be unique for every container encrypted with a key
+*/
+QSC_EXPORT_API void qsc_rcsseg_header_encode(uint8_t* header, size_t keylen, size_t segsize, const uint8_t* nonce);
+
+/**
+* \brief Expand the key, and load the container header.
+*
+* \param ctx: [struct] The container state
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; must match the cipher type in the header
+* \param header: [const] The container header
+*
+* \return Returns false if the header is malformed, or does not match the key length
+*/
+QSC_EXPORT_API bool qsc_rcsseg_initialize(qsc_rcsseg_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* header);
+
+/**
+* \brief Erase the container state.
+*
+* \param ctx: [struct] The container state
+*/
+QSC_EXPORT_API void qsc_rcsseg_dispose(qsc_rcsseg_state* ctx);
+
+/**
+* \brief Get the number of segments in a container.
+* An empty object is stored as a single empty final segment.
+*
+* \param ctx: [const][struct] The container state
+* \param length: The plain-text length in bytes
+*
+* \return Returns the number of segments
+*/
+QSC_EXPORT_API uint64_t qsc_rcsseg_segment_count(const qsc_rcsseg_state* ctx, uint64_t length);
+
+/**
+* \brief Get the size of a container, including the header and the MAC codes.
+*
+* \param ctx: [const][struct] The container state
+* \param length: The plain-text length in bytes
+*
+* \return Returns the container size in bytes
+*/
+QSC_EXPORT_API uint64_t qsc_rcsseg_encrypted_size(const qsc_rcsseg_state* ctx, uint64_t length);
+
+/**
+* \brief Get the plain-text length of a container.
+*
+* \param ctx: [const][struct] The container state
+* \param length: The container size in bytes, including the header
+*
+* \return Returns the plain-text length, or zero if the container size is not valid
+*/
+QSC_EXPORT_API uint64_t qsc_rcsseg_decrypted_size(const qsc_rcsseg_state* ctx, uint64_t length);
+
+/**
+* \brief Encrypt one segment, and append its MAC code.
+* The segment can be encrypted on any thread, in any order.
+*
+* \param ctx: [const][struct] The container state
+* \param output: The output array; the segment length plus the MAC size
+* \param input: [const] The plain-text of the segment
+* \param length: The segment length; the segment size, or less for the final segment
+* \param index: The segment index
+* \param final: Set to true for the last segment of the container
+*/
+QSC_EXPORT_API void qsc_rcsseg_encrypt_segment(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, size_t length, uint64_t index, bool final);
+
+/**
+* \brief Authenticate and decrypt one segment.
+* The segment is decrypted only if its MAC code is valid.
+*
+* \param ctx: [const][struct] The container state
+* \param output: The plain-text output array
+* \param input: [const] The cipher-text of the segment, followed by its MAC code
+* \param length: The plain-text length of the segment, not including the MAC code
+* \param index: The segment index
+* \param final: Set to true for the last segment of the container
+*
+* \return Returns true if the segment is authentic
+*/
+QSC_EXPORT_API bool qsc_rcsseg_decrypt_segment(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, size_t length, uint64_t index, bool final);
+
+/**
+* \brief Encrypt an object into a container; the header followed by every segment.
+* The segments are divided between the processor cores.
+*
+* \param ctx: [const][struct] The container state
+* \param output: The container array; qsc_rcsseg_encrypted_size bytes
+* \param input: [const] The plain-text object
+* \param length: The plain-text length in bytes
+*/
+QSC_EXPORT_API void qsc_rcsseg_encrypt(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, uint64_t length);
+
+/**
+* \brief Authenticate and decrypt a container.
+* The segments are divided between the processor cores. If any segment fails authentication,
+* the output array is erased.
+*
+* \param ctx: [const][struct] The container state
+* \param output: The plain-text array; qsc_rcsseg_decrypted_size bytes
+* \param input: [const] The container, starting with the header
+* \param length: The container size in bytes
+*
+* \return Returns true if every segment is authentic and the container is complete
+*/
+QSC_EXPORT_API bool qsc_rcsseg_decrypt(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, uint64_t length);
+
+/**
+* \brief Authenticate every segment of a container, without writing the plain-text.
+* The segments are divided between the processor cores.
+*
+* \param ctx: [const][struct] The container state
+* \param input: [const] The container, starting with the header
+* \param length: The container size in bytes
+*
+* \return Returns true if every segment is authentic and the container is complete
+*/
+QSC_EXPORT_API bool qsc_rcsseg_verify(const qsc_rcsseg_state* ctx, const uint8_t* input, uint64_t length);
+
+/**
+* \brief Authenticate and decrypt a byte range of a container.
+* Only the segments that overlap the range are authenticated and decrypted.
+*
+* \param ctx: [const][struct] The container state
+* \param output: The plain-text array receiving the range
+* \param input: [const] The container, starting with the header
+* \param inplen: The container size in bytes
+* \param offset: The plain-text offset of the range
+* \param length: The number of plain-text bytes in the range
+*
+* \return Returns true if the segments in the range are authentic; false if they are not, or the range is out of bounds
+*/
+QSC_EXPORT_API bool qsc_rcsseg_decrypt_range(const qsc_rcsseg_state* ctx, uint8_t* output, const uint8_t* input, uint64_t inplen, uint64_t offset, size_t length);
+
+#endif
@@ -0,0 +1,443 @@
+#include "rcsseg_test.h"
+#include "rcsseg.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "csp.h"
+#include "testutils.h"
+#include <stdlib.h>
+
+#define RCSSEG_TEST_SEGMENT 1024
+#define RCSSEG_TEST_LENGTH (RCSSEG_TEST_SEGMENT * 100 + 17)
+#define RCSSEG_TEST_CONTAINER (QSC_RCSSEG_HEADER_SIZE + RCSSEG_TEST_LENGTH + (101 * QSC_RCS512_MAC_SIZE))
+
+static bool rcsseg_state_initialize(qsc_rcsseg_state* ctx, size_t keylen)
+{
+	uint8_t header[QSC_RCSSEG_HEADER_SIZE] = { 0 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	bool res;
+
+	qsc_csp_generate(key, sizeof(key));
+	qsc_csp_generate(nonce, sizeof(nonce));
+	qsc_rcsseg_header_encode(header, keylen, RCSSEG_TEST_SEGMENT, nonce);
+	res = qsc_rcsseg_initialize(ctx, key, keylen, header);
+
+	/* a header for the other key size is rejected */
+	if (qsc_rcsseg_initialize(ctx, key, (keylen == QSC_RCS256_KEY_SIZE) ? QSC_RCS512_KEY_SIZE : QSC_RCS256_KEY_SIZE, header) == true)
+	{
+		res = false;
+	}
+
+	if (res == true)
+	{
+		res = qsc_rcsseg_initialize(ctx, key, keylen, header);
+	}
+
+	return res;
+}
+
+static bool rcsseg_equality(size_t keylen)
+{
+	const size_t LENGTHS[] = { 0, 1, 31, RCSSEG_TEST_SEGMENT - 1, RCSSEG_TEST_SEGMENT, RCSSEG_TEST_SEGMENT + 1, RCSSEG_TEST_SEGMENT * 8, RCSSEG_TEST_LENGTH };
+	qsc_rcsseg_state ctx;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* msg;
+	uint64_t clen;
+	bool status;
+
+	status = rcsseg_state_initialize(&ctx, keylen);
+
+	if (status == false)
+	{
+		qsctest_print_safe("Failure! rcsseg_equality: header rejected -SE1 \n");
+	}
+
+	enc = (uint8_t*)malloc(RCSSEG_TEST_CONTAINER);
+	dec = (uint8_t*)malloc(RCSSEG_TEST_LENGTH);
+	msg = (uint8_t*)malloc(RCSSEG_TEST_LENGTH);
+
+	if (status == true && enc != NULL && dec != NULL && msg != NULL)
+	{
+		for (size_t i = 0; i < sizeof(LENGTHS) / sizeof(LENGTHS[0]); ++i)
+		{
+			const size_t MLEN = LENGTHS[i];
+
+			qsc_csp_generate(msg, MLEN);
+			clen = qsc_rcsseg_encrypted_size(&ctx, MLEN);
+
+			if (qsc_rcsseg_decrypted_size(&ctx, clen) != MLEN)
+			{
+				qsctest_print_safe("Failure! rcsseg_equality: size mismatch -SE2 \n");
+				status = false;
+			}
+
+			qsc_rcsseg_encrypt(&ctx, enc, msg, MLEN);
+
+			if (qsc_rcsseg_decrypt(&ctx, dec, enc, clen) == false)
+			{
+				qsctest_print_safe("Failure! rcsseg_equality: authentication failure -SE3 \n");
+				status = false;
+			}
+
+			if (qsc_intutils_are_equal8(dec, msg, MLEN) == false)
+			{
+				qsctest_print_safe("Failure! rcsseg_equality: decryption mismatch -SE4 \n");
+				status = false;
+			}
+		}
+	}
+	else
+	{
+		status = false;
+	}
+
+	qsc_rcsseg_dispose(&ctx);
+
+	if (enc != NULL)
+	{
+		free(enc);
+	}
+
+	if (dec != NULL)
+	{
+		free(dec);
+	}
+
+	if (msg != NULL)
+	{
+		free(msg);
+	}
+
+	return status;
+}
+
+static bool rcsseg_empty(size_t keylen)
+{
+	qsc_rcsseg_state ctx;
+	uint8_t enc[QSC_RCSSEG_HEADER_SIZE + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t dec[1] = { 0 };
+	uint64_t clen;
+	bool status;
+
+	status = rcsseg_state_initialize(&ctx, keylen);
+
+	if (status == true)
+	{
+		/* an empty object is the header and one empty final segment */
+		clen = qsc_rcsseg_encrypted_size(&ctx, 0);
+
+		if (qsc_rcsseg_segment_count(&ctx, 0) != 1 || clen != QSC_RCSSEG_HEADER_SIZE + ctx.maclen ||
+			qsc_rcsseg_decrypted_size(&ctx, clen) != 0)
+		{
+			qsctest_print_safe("Failure! rcsseg_empty: size mismatch -SM1 \n");
+			status = false;
+		}
+		else
+		{
+			qsc_rcsseg_encrypt(&ctx, enc, dec, 0);
+
+			if (qsc_rcsseg_decrypt(&ctx, dec, enc, clen) == false || qsc_rcsseg_verify(&ctx, enc, clen) == false)
+			{
+				qsctest_print_safe("Failure! rcsseg_empty: empty container rejected -SM2 \n");
+				status = false;
+			}
+		}
+	}
+	else
+	{
+		qsctest_print_safe("Failure! rcsseg_empty: header rejected -SM3 \n");
+	}
+
+	qsc_rcsseg_dispose(&ctx);
+
+	return status;
+}
+
+static bool rcsseg_range(size_t keylen)
+{
+	qsc_rcsseg_state ctx;
+	uint8_t* enc;
+	uint8_t* msg;
+	uint8_t* rng;
+	uint64_t clen;
+	uint32_t rnd[2];
+	size_t len;
+	size_t oft;
+	bool status;
+
+	status = rcsseg_state_initialize(&ctx, keylen);
+	enc = (uint8_t*)malloc(RCSSEG_TEST_CONTAINER);
+	msg = (uint8_t*)malloc(RCSSEG_TEST_LENGTH);
+	rng = (uint8_t*)malloc(RCSSEG_TEST_LENGTH);
+
+	if (status == true && enc != NULL && msg != NULL && rng != NULL)
+	{
+		clen = qsc_rcsseg_encrypted_size(&ctx, RCSSEG_TEST_LENGTH);
+		qsc_csp_generate(msg, RCSSEG_TEST_LENGTH);
+		qsc_rcsseg_encrypt(&ctx, enc, msg, RCSSEG_TEST_LENGTH);
+
+		/* random ranges, within a segment and across many segments */
+		for (size_t i = 0; i < 100; ++i)
+		{
+			qsc_csp_generate((uint8_t*)rnd, sizeof(rnd));
+			oft = rnd[0] % RCSSEG_TEST_LENGTH;
+			len = (i % 2 == 0) ? (rnd[1] % 100) : (rnd[1] % (RCSSEG_TEST_LENGTH - oft));
+			len = qsc_intutils_min(len, RCSSEG_TEST_LENGTH - oft);
+
+			if (qsc_rcsseg_decrypt_range(&ctx, rng, enc, clen, oft, len) == false ||
+				qsc_intutils_are_equal8(rng, msg + oft, len) == false)
+			{
+				qsctest_print_safe("Failure! rcsseg_range: range mismatch -SR1 \n");
+				status = false;
+			}
+		}
+
+		/* the tail of the object, and a range that is out of bounds */
+		if (qsc_rcsseg_decrypt_range(&ctx, rng, enc, clen, RCSSEG_TEST_LENGTH - 17, 17) == false ||
+			qsc_intutils_are_equal8(rng, msg + RCSSEG_TEST_LENGTH - 17, 17) == false)
+		{
+			qsctest_print_safe("Failure! rcsseg_range: final segment mismatch -SR2 \n");
+			status = false;
+		}
+
+		if (qsc_rcsseg_decrypt_range(&ctx, rng, enc, clen, RCSSEG_TEST_LENGTH - 16, 17) == true)
+		{
+			qsctest_print_safe("Failure! rcsseg_range: out of bounds range accepted -SR3 \n");
+			status = false;
+		}
+	}
+	else
+	{
+		status = false;
+	}
+
+	qsc_rcsseg_dispose(&ctx);
+
+	if (enc != NULL)
+	{
+		free(enc);
+	}
+
+	if (msg != NULL)
+	{
+		free(msg);
+	}
+
+	if (rng != NULL)
+	{
+		free(rng);
+	}
+
+	return status;
+}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+static bool rcsseg_authentication_failure(size_t keylen)
+{
+	const size_t MLEN = RCSSEG_TEST_SEGMENT * 8;
+	qsc_rcsseg_state ctx;
+	uint8_t* dec;
+	uint8_t* enc;
+	uint8_t* msg;
+	uint8_t* tmp;
+	uint64_t clen;
+	size_t fseg;
+	bool status;
+
+	status = rcsseg_state_initialize(&ctx, keylen);
+	dec = (uint8_t*)malloc(MLEN);
+	enc = (uint8_t*)malloc(RCSSEG_TEST_CONTAINER);
+	msg = (uint8_t*)malloc(MLEN);
+	tmp = (uint8_t*)malloc(RCSSEG_TEST_SEGMENT + QSC_RCS512_MAC_SIZE);
+
+	if (status == true && dec != NULL && enc != NULL && msg != NULL && tmp != NULL)
+	{
+		clen = qsc_rcsseg_encrypted_size(&ctx, MLEN);
+		fseg = RCSSEG_TEST_SEGMENT + ctx.maclen;
+		qsc_csp_generate(msg, MLEN);
+		qsc_rcsseg_encrypt(&ctx, enc, msg, MLEN);
+
+		/* truncated at a segment boundary */
+		if (qsc_rcsseg_decrypt(&ctx, dec, enc, clen - fseg) == true)
+		{
+			qsctest_print_safe("Failure! rcsseg_authentication_failure: truncation accepted -SA1 \n");
+			status = false;
+		}
+
+		/* a modified segment */
+		enc[QSC_RCSSEG_HEADER_SIZE + (fseg * 3) + 7] ^= 1U;
+
+		if (qsc_rcsseg_decrypt(&ctx, dec, enc, clen) == true ||
+			qsc_rcsseg_verify(&ctx, enc, clen) == true ||
+			qsc_rcsseg_decrypt_range(&ctx, dec, enc, clen, RCSSEG_TEST_SEGMENT * 3, 1) == true)
+		{
+			qsctest_print_safe("Failure! rcsseg_authentication_failure: modification accepted -SA2 \n");
+			status = false;
+		}
+
+		enc[QSC_RCSSEG_HEADER_SIZE + (fseg * 3) + 7] ^= 1U;
+
+		/* two segments swapped */
+		qsc_memutils_copy(tmp, enc + QSC_RCSSEG_HEADER_SIZE, fseg);
+		qsc_memutils_copy(enc + QSC_RCSSEG_HEADER_SIZE, enc + QSC_RCSSEG_HEADER_SIZE + fseg, fseg);
+		qsc_memutils_copy(enc + QSC_RCSSEG_HEADER_SIZE + fseg, tmp, fseg);
+
+		if (qsc_rcsseg_decrypt(&ctx, dec, enc, clen) == true)
+		{
+			qsctest_print_safe("Failure! rcsseg_authentication_failure: reordering accepted -SA3 \n");
+			status = false;
+		}
+
+		/* a modified header */
+		qsc_memutils_copy(enc + QSC_RCSSEG_HEADER_SIZE + fseg, enc + QSC_RCSSEG_HEADER_SIZE, fseg);
+		qsc_memutils_copy(enc + QSC_RCSSEG_HEADER_SIZE, tmp, fseg);
+		enc[QSC_RCSSEG_HEADER_SIZE - 1] ^= 1U;
+
+		if (qsc_rcsseg_decrypt(&ctx, dec, enc, clen) == true)
+		{
+			qsctest_print_safe("Failure! rcsseg_authentication_failure: header modification accepted -SA4 \n");
+			status = false;
+		}
+
+		enc[QSC_RCSSEG_HEADER_SIZE - 1] ^= 1U;
+
+		if (qsc_rcsseg_verify(&ctx, enc, clen) == false ||
+			qsc_rcsseg_decrypt(&ctx, dec, enc, clen) == false ||
+			qsc_intutils_are_equal8(dec, msg, MLEN) == false)
+		{
+			qsctest_print_safe("Failure! rcsseg_authentication_failure: restored container rejected -SA5 \n");
+			status = false;
+		}
+	}
+	else
+	{
+		status = false;
+	}
+
+	qsc_rcsseg_dispose(&ctx);
+
+	if (dec != NULL)
+	{
+		free(dec);
+	}
+
+	if (enc != NULL)
+	{
+		free(enc);
+	}
+
+	if (msg != NULL)
+	{
+		free(msg);
+	}
+
+	if (tmp != NULL)
+	{
+		free(tmp);
+	}
+
+	return status;
+}
+#endif
+
+bool qsctest_rcsseg_equality()
+{
+	bool status;
+
+	status = rcsseg_equality(QSC_RCS256_KEY_SIZE);
+
+	if (rcsseg_equality(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_rcsseg_empty()
+{
+	bool status;
+
+	status = rcsseg_empty(QSC_RCS256_KEY_SIZE);
+
+	if (rcsseg_empty(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_rcsseg_range()
+{
+	bool status;
+
+	status = rcsseg_range(QSC_RCS256_KEY_SIZE);
+
+	if (rcsseg_range(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_rcsseg_authentication_failure()
+{
+	bool status;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	status = rcsseg_authentication_failure(QSC_RCS256_KEY_SIZE);
+
+	if (rcsseg_authentication_failure(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+void qsctest_rcsseg_run()
+{
+	if (qsctest_rcsseg_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS segmented container equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS segmented container equality test. \n");
+	}
+
+	if (qsctest_rcsseg_empty() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS segmented container empty object test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS segmented container empty object test. \n");
+	}
+
+	if (qsctest_rcsseg_range() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS segmented container range test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS segmented container range test. \n");
+	}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	if (qsctest_rcsseg_authentication_failure() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS segmented container authentication failure test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS segmented container authentication failure test. \n");
+	}
+#endif
+}
@@ -0,0 +1,47 @@
+/**
+* \file rcsseg_test.h
+* \brief <b>RCS Segmented Container Tests</b> \n
+* Round-trip, random-access, and tamper tests for the segmented container format.
+* \author John Underhill
+* \date October 02, 2020
+*/
+
+#ifndef QSCTEST_RCSSEG_TEST_H
+#define QSCTEST_RCSSEG_TEST_H
+
+#include "common.h"
+
+/**
+* \brief Tests the container encryption and decryption round trip with empty, partial, and segment-aligned objects.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsseg_equality();
+
+/**
+* \brief Tests the encryption, decryption, and verification of an empty object.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsseg_empty();
+
+/**
+* \brief Tests the decryption of random byte ranges against the full decryption of the container.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsseg_range();
+
+/**
+* \brief Tests that truncated, modified, and reordered containers fail authentication.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsseg_authentication_failure();
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_rcsseg_run();
+
+#endif
@@ -0,0 +1,844 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	/* O_DIRECT */
+#	define _GNU_SOURCE
+#endif
+
+#include "rcsuring.h"
+
+#if defined(QSC_RCSURING_ENABLED)
+#include "async.h"
+#include "csp.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "timerex.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* a submission and completion queue pair, mapped from the kernel */
+typedef struct
+{
+	struct io_uring_sqe* sqes;
+	struct io_uring_cqe* cqes;
+	uint32_t* sqhead;
+	uint32_t* sqtail;
+	uint32_t* sqmask;
+	uint32_t* sqarray;
+	uint32_t* cqhead;
+	uint32_t* cqtail;
+	uint32_t* cqmask;
+	void* sqring;
+	void* cqring;
+	size_t sqlen;
+	size_t cqlen;
+	size_t sqelen;
+	uint32_t queued;
+	int fd;
+	bool fixed;
+} rcsuring_ring;
+
+/* a segment buffer, and the read or write in flight on it */
+typedef struct
+{
+	uint8_t* buffer;
+	uint64_t index;
+	uint64_t offset;
+	size_t expect;
+	size_t length;
+	size_t done;
+	bool writing;
+} rcsuring_slot;
+
+typedef struct
+{
+	const qsc_rcsseg_state* ctx;
+	int32_t* abort;
+	uint64_t plainlen;
+	uint64_t count;
+	uint64_t first;
+	uint64_t stride;
+	size_t depth;
+	int infd;
+	int outfd;
+	bool direct;
+	bool encrypt;
+	bool synchronous;
+	qsc_rcsfile_status status;
+} rcsuring_worker_state;
+
+static size_t rcsuring_align(size_t length)
+{
+	return (length + QSC_RCSURING_DIRECT_ALIGNMENT - 1) & ~((size_t)QSC_RCSURING_DIRECT_ALIGNMENT - 1);
+}
+
+static void rcsuring_ring_close(rcsuring_ring* ring)
+{
+	if (ring->sqes != NULL)
+	{
+		munmap(ring->sqes, ring->sqelen);
+	}
+
+	if (ring->cqring != NULL && ring->cqring != ring->sqring)
+	{
+		munmap(ring->cqring, ring->cqlen);
+	}
+
+	if (ring->sqring != NULL)
+	{
+		munmap(ring->sqring, ring->sqlen);
+	}
+
+	if (ring->fd >= 0)
+	{
+		close(ring->fd);
+	}
+
+	qsc_memutils_clear(ring, sizeof(rcsuring_ring));
+	ring->fd = -1;
+}
+
+static bool rcsuring_ring_open(rcsuring_ring* ring, uint32_t entries)
+{
+	struct io_uring_params prm;
+	void* pmap;
+	bool res;
+
+	res = false;
+	qsc_memutils_clear(ring, sizeof(rcsuring_ring));
+	qsc_memutils_clear(&prm, sizeof(prm));
+	ring->fd = (int)syscall(__NR_io_uring_setup, entries, &prm);
+
+	if (ring->fd >= 0)
+	{
+		ring->sqlen = prm.sq_off.array + (prm.sq_entries * sizeof(uint32_t));
+		ring->cqlen = prm.cq_off.cqes + (prm.cq_entries * sizeof(struct io_uring_cqe));
+		ring->sqelen = prm.sq_entries * sizeof(struct io_uring_sqe);
+
+		/* newer kernels map both rings with one call */
+		if ((prm.features & IORING_FEAT_SINGLE_MMAP) != 0)
+		{
+			ring->sqlen = (ring->cqlen > ring->sqlen) ? ring->cqlen : ring->sqlen;
+			ring->cqlen = 0;
+		}
+
+		pmap = mmap(NULL, ring->sqlen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+		ring->sqring = (pmap != MAP_FAILED) ? pmap : NULL;
+		ring->cqring = ring->sqring;
+
+		if (ring->sqring != NULL && ring->cqlen != 0)
+		{
+			pmap = mmap(NULL, ring->cqlen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+			ring->cqring = (pmap != MAP_FAILED) ? pmap : NULL;
+		}
+
+		if (ring->sqring != NULL && ring->cqring != NULL)
+		{
+			pmap = mmap(NULL, ring->sqelen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+			ring->sqes = (pmap != MAP_FAILED) ? (struct io_uring_sqe*)pmap : NULL;
+		}
+
+		if (ring->sqes != NULL)
+		{
+			ring->sqhead = (uint32_t*)((uint8_t*)ring->sqring + prm.sq_off.head);
+			ring->sqtail = (uint32_t*)((uint8_t*)ring->sqring + prm.sq_off.tail);
+			ring->sqmask = (uint32_t*)((uint8_t*)ring->sqring + prm.sq_off.ring_mask);
+			ring->sqarray = (uint32_t*)((uint8_t*)ring->sqring + prm.sq_off.array);
+			ring->cqhead = (uint32_t*)((uint8_t*)ring->cqring + prm.cq_off.head);
+			ring->cqtail = (uint32_t*)((uint8_t*)ring->cqring + prm.cq_off.tail);
+			ring->cqmask = (uint32_t*)((uint8_t*)ring->cqring + prm.cq_off.ring_mask);
+			ring->cqes = (struct io_uring_cqe*)((uint8_t*)ring->cqring + prm.cq_off.cqes);
+			res = true;
+		}
+	}
+
+	if (res == false)
+	{
+		rcsuring_ring_close(ring);
+	}
+
+	return res;
+}
+
+static void rcsuring_ring_register(rcsuring_ring* ring, rcsuring_slot* slots, size_t count, size_t buflen)
+{
+	struct iovec iov[QSC_RCSURING_DEPTH_MAX];
+	size_t i;
+
+	for (i = 0; i < count; ++i)
+	{
+		iov[i].iov_base = slots[i].buffer;
+		iov[i].iov_len = buflen;
+	}
+
+	/* fixed buffers are pinned once, instead of on every read and write;
+	   if the locked memory limit is too low, the plain read and write operations are used */
+	ring->fixed = (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iov, (unsigned int)count) == 0);
+}
+
+static void rcsuring_ring_queue(rcsuring_ring* ring, const rcsuring_slot* slot, size_t sidx, int fd)
+{
+	struct io_uring_sqe* sqe;
+	uint32_t tail;
+	uint32_t idx;
+
+	tail = *ring->sqtail;
+	idx = tail & *ring->sqmask;
+	sqe = &ring->sqes[idx];
+	qsc_memutils_clear(sqe, sizeof(struct io_uring_sqe));
+
+	if (ring->fixed == true)
+	{
+		sqe->opcode = (slot->writing == true) ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+		sqe->buf_index = (uint16_t)sidx;
+	}
+	else
+	{
+		sqe->opcode = (slot->writing == true) ? IORING_OP_WRITE : IORING_OP_READ;
+	}
+
+	sqe->fd = fd;
+	sqe->addr = (uint64_t)(uintptr_t)(slot->buffer + slot->done);
+	sqe->len = (uint32_t)(slot->length - slot->done);
+	sqe->off = slot->offset + slot->done;
+	sqe->user_data = (uint64_t)sidx;
+	ring->sqarray[idx] = idx;
+
+	/* publish the entry to the kernel */
+	__atomic_store_n(ring->sqtail, tail + 1, __ATOMIC_RELEASE);
+	++ring->queued;
+}
+
+static bool rcsuring_ring_enter(rcsuring_ring* ring, uint32_t wait)
+{
+	int ret;
+
+	do
+	{
+		ret = (int)syscall(__NR_io_uring_enter, ring->fd, ring->queued, wait, IORING_ENTER_GETEVENTS, NULL, 0);
+	}
+	while (ret < 0 && errno == EINTR);
+
+	if (ret > 0)
+	{
+		ring->queued -= (uint32_t)ret;
+	}
+
+	return (ret >= 0);
+}
+
+static void rcsuring_ring_drain(rcsuring_ring* ring, size_t outstanding)
+{
+	uint32_t head;
+	uint32_t tail;
+	int ret;
+
+	/* the kernel may still read into or write from the buffers of the submitted requests, so every completion
+	   is reaped before the ring is closed and the buffers are freed; the queued entries that were never submitted are dropped */
+	while (outstanding != 0)
+	{
+		head = *ring->cqhead;
+		tail = __atomic_load_n(ring->cqtail, __ATOMIC_ACQUIRE);
+
+		while (head != tail && outstanding != 0)
+		{
+			++head;
+			--outstanding;
+		}
+
+		__atomic_store_n(ring->cqhead, head, __ATOMIC_RELEASE);
+
+		if (outstanding != 0)
+		{
+			ret = (int)syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+
+			if (ret < 0 && errno != EINTR)
+			{
+				/* the completions are still posted to the mapped queue, so it is polled */
+				sched_yield();
+			}
+		}
+	}
+}
+
+static size_t rcsuring_segment_length(const rcsuring_worker_state* pwrk, uint64_t index)
+{
+	return (index == pwrk->count - 1) ? (size_t)(pwrk->plainlen - (index * pwrk->ctx->segsize)) : pwrk->ctx->segsize;
+}
+
+static uint64_t rcsuring_container_offset(const rcsuring_worker_state* pwrk, uint64_t index)
+{
+	return QSC_RCSSEG_HEADER_SIZE + (index * ((uint64_t)pwrk->ctx->segsize + pwrk->ctx->maclen));
+}
+
+static void rcsuring_read_setup(const rcsuring_worker_state* pwrk, rcsuring_slot* slot, uint64_t index)
+{
+	const size_t SLEN = rcsuring_segment_length(pwrk, index);
+
+	slot->index = index;
+	slot->done = 0;
+	slot->writing = false;
+
+	if (pwrk->encrypt == true)
+	{
+		/* a direct read of the final segment is rounded up to the block size, and ends short at the end of the file */
+		slot->offset = index * pwrk->ctx->segsize;
+		slot->expect = SLEN;
+		slot->length = (pwrk->direct == true) ? rcsuring_align(SLEN) : SLEN;
+	}
+	else
+	{
+		slot->offset = rcsuring_container_offset(pwrk, index);
+		slot->expect = SLEN + pwrk->ctx->maclen;
+		slot->length = slot->expect;
+	}
+}
+
+static bool rcsuring_transform(const rcsuring_worker_state* pwrk, rcsuring_slot* slot)
+{
+	const size_t SLEN = rcsuring_segment_length(pwrk, slot->index);
+	const bool FINAL = (slot->index == pwrk->count - 1);
+	bool res;
+
+	res = true;
+	slot->done = 0;
+	slot->writing = true;
+
+	/* the segment is transformed in place, and written from the buffer it was read into */
+	if (pwrk->encrypt == true)
+	{
+		qsc_rcsseg_encrypt_segment(pwrk->ctx, slot->buffer, slot->buffer, SLEN, slot->index, FINAL);
+		slot->offset = rcsuring_container_offset(pwrk, slot->index);
+		slot->expect = SLEN + pwrk->ctx->maclen;
+		slot->length = slot->expect;
+	}
+	else
+	{
+		res = qsc_rcsseg_decrypt_segment(pwrk->ctx, slot->buffer, slot->buffer, SLEN, slot->index, FINAL);
+		slot->offset = slot->index * pwrk->ctx->segsize;
+		slot->expect = (pwrk->direct == true) ? rcsuring_align(SLEN) : SLEN;
+		slot->length = slot->expect;
+
+		/* a direct write of the final segment is padded to the block size, and the file is truncated afterwards */
+		qsc_memutils_clear(slot->buffer + SLEN, slot->length - SLEN);
+	}
+
+	return res;
+}
+
+static void rcsuring_worker_fail(rcsuring_worker_state* pwrk, qsc_rcsfile_status status)
+{
+	if (pwrk->status == qsc_rcsfile_status_success)
+	{
+		pwrk->status = status;
+	}
+
+	__atomic_store_n(pwrk->abort, 1, __ATOMIC_RELAXED);
+}
+
+static bool rcsuring_worker_aborted(const rcsuring_worker_state* pwrk)
+{
+	return (__atomic_load_n(pwrk->abort, __ATOMIC_RELAXED) != 0);
+}
+
+static void rcsuring_worker_async(rcsuring_worker_state* pwrk, rcsuring_ring* ring, rcsuring_slot* slots, size_t scnt)
+{
+	struct io_uring_cqe* cqe;
+	rcsuring_slot* pslot;
+	uint64_t next;
+	uint32_t head;
+	uint32_t tail;
+	size_t inflight;
+	size_t sidx;
+	int32_t cres;
+
+	next = pwrk->first;
+	inflight = 0;
+
+	/* fill the ring with reads */
+	for (sidx = 0; sidx < scnt && next < pwrk->count; ++sidx)
+	{
+		rcsuring_read_setup(pwrk, &slots[sidx], next);
+		rcsuring_ring_queue(ring, &slots[sidx], sidx, pwrk->infd);
+		next += pwrk->stride;
+		++inflight;
+	}
+
+	while (inflight != 0)
+	{
+		if (rcsuring_ring_enter(ring, 1) == false)
+		{
+			/* wait for the submitted requests to complete before the buffers are released */
+			rcsuring_worker_fail(pwrk, qsc_rcsfile_status_read_failure);
+			rcsuring_ring_drain(ring, inflight - ring->queued);
+			break;
+		}
+
+		head = *ring->cqhead;
+		tail = __atomic_load_n(ring->cqtail, __ATOMIC_ACQUIRE);
+
+		while (head != tail)
+		{
+			cqe = &ring->cqes[head & *ring->cqmask];
+			sidx = (size_t)cqe->user_data;
+			cres = cqe->res;
+			pslot = &slots[sidx];
+			++head;
+
+			if (cres < 0)
+			{
+				rcsuring_worker_fail(pwrk, (pslot->writing == true) ? qsc_rcsfile_status_write_failure : qsc_rcsfile_status_read_failure);
+				--inflight;
+				continue;
+			}
+
+			pslot->done += (size_t)cres;
+
+			if (pslot->done < pslot->expect)
+			{
+				if (cres == 0 || rcsuring_worker_aborted(pwrk) == true)
+				{
+					/* the file ended before the segment */
+					if (cres == 0)
+					{
+						rcsuring_worker_fail(pwrk, (pslot->writing == true) ? qsc_rcsfile_status_write_failure : qsc_rcsfile_status_read_failure);
+					}
+
+					--inflight;
+				}
+				else
+				{
+					/* a short read or write, queue the remainder */
+					rcsuring_ring_queue(ring, pslot, sidx, (pslot->writing == true) ? pwrk->outfd : pwrk->infd);
+				}
+			}
+			else if (pslot->writing == false)
+			{
+				if (rcsuring_worker_aborted(pwrk) == true)
+				{
+					--inflight;
+				}
+				else if (rcsuring_transform(pwrk, pslot) == false)
+				{
+					rcsuring_worker_fail(pwrk, qsc_rcsfile_status_authentication_failure);
+					--inflight;
+				}
+				else
+				{
+					rcsuring_ring_queue(ring, pslot, sidx, pwrk->outfd);
+				}
+			}
+			else
+			{
+				/* the segment is written, reuse the buffer for the next read */
+				if (next < pwrk->count && rcsuring_worker_aborted(pwrk) == false)
+				{
+					rcsuring_read_setup(pwrk, pslot, next);
+					rcsuring_ring_queue(ring, pslot, sidx, pwrk->infd);
+					next += pwrk->stride;
+				}
+				else
+				{
+					--inflight;
+				}
+			}
+		}
+
+		__atomic_store_n(ring->cqhead, head, __ATOMIC_RELEASE);
+	}
+}
+
+static bool rcsuring_sync_io(rcsuring_slot* slot, int fd)
+{
+	ssize_t ret;
+	bool res;
+
+	res = true;
+
+	while (slot->done < slot->expect && res == true)
+	{
+		if (slot->writing == true)
+		{
+			ret = pwrite(fd, slot->buffer + slot->done, slot->length - slot->done, (off_t)(slot->offset + slot->done));
+		}
+		else
+		{
+			ret = pread(fd, slot->buffer + slot->done, slot->length - slot->done, (off_t)(slot->offset + slot->done));
+		}
+
+		if (ret > 0)
+		{
+			slot->done += (size_t)ret;
+		}
+		else if (ret == 0 || errno != EINTR)
+		{
+			res = false;
+		}
+	}
+
+	return res;
+}
+
+static void rcsuring_worker_sync(rcsuring_worker_state* pwrk, rcsuring_slot* slot)
+{
+	uint64_t i;
+
+	for (i = pwrk->first; i < pwrk->count && rcsuring_worker_aborted(pwrk) == false; i += pwrk->stride)
+	{
+		rcsuring_read_setup(pwrk, slot, i);
+
+		if (rcsuring_sync_io(slot, pwrk->infd) == false)
+		{
+			rcsuring_worker_fail(pwrk, qsc_rcsfile_status_read_failure);
+		}
+		else if (rcsuring_transform(pwrk, slot) == false)
+		{
+			rcsuring_worker_fail(pwrk, qsc_rcsfile_status_authentication_failure);
+		}
+		else if (rcsuring_sync_io(slot, pwrk->outfd) == false)
+		{
+			rcsuring_worker_fail(pwrk, qsc_rcsfile_status_write_failure);
+		}
+	}
+}
+
+static void rcsuring_worker(void* arg)
+{
+	rcsuring_worker_state* pwrk = (rcsuring_worker_state*)arg;
+	rcsuring_slot slots[QSC_RCSURING_DEPTH_MAX];
+	rcsuring_ring ring;
+	uint8_t* pbuf;
+	size_t blen;
+	size_t scnt;
+	size_t i;
+	bool async;
+
+	async = false;
+	scnt = (pwrk->synchronous == true) ? 1 : pwrk->depth;
+	blen = rcsuring_align(pwrk->ctx->segsize + pwrk->ctx->maclen);
+	/* direct I/O needs block aligned buffers, whatever the vector extensions of the build */
+	if (posix_memalign((void**)&pbuf, QSC_RCSURING_DIRECT_ALIGNMENT, blen * scnt) != 0)
+	{
+		pbuf = NULL;
+	}
+
+	if (pbuf != NULL)
+	{
+		for (i = 0; i < scnt; ++i)
+		{
+			slots[i].buffer = pbuf + (i * blen);
+		}
+
+		if (pwrk->synchronous == false && rcsuring_ring_open(&ring, (uint32_t)scnt) == true)
+		{
+			rcsuring_ring_register(&ring, slots, scnt, blen);
+			rcsuring_worker_async(pwrk, &ring, slots, scnt);
+			rcsuring_ring_close(&ring);
+			async = true;
+		}
+
+		if (async == false)
+		{
+			/* io_uring was not requested, or is not available */
+			rcsuring_worker_sync(pwrk, &slots[0]);
+		}
+
+		qsc_memutils_clear(pbuf, blen * scnt);
+		free(pbuf);
+	}
+	else
+	{
+		rcsuring_worker_fail(pwrk, qsc_rcsfile_status_write_failure);
+	}
+}
+
+static qsc_rcsfile_status rcsuring_run(const qsc_rcsseg_state* ctx, int infd, int outfd, uint64_t plainlen, bool encryption, const qsc_rcsuring_params* params)
+{
+	qsc_thread threads[QSC_ASYNC_THREADS_MAX];
+	rcsuring_worker_state wrks[QSC_ASYNC_THREADS_MAX];
+	bool tstat[QSC_ASYNC_THREADS_MAX] = { 0 };
+	qsc_rcsfile_status res;
+	uint64_t count;
+	int32_t abort;
+	size_t tcnt;
+	size_t i;
+
+	abort = 0;
+	count = qsc_rcsseg_segment_count(ctx, plainlen);
+	tcnt = (params->threads != 0) ? params->threads : qsc_async_processor_count();
+	tcnt = qsc_intutils_min(tcnt, QSC_ASYNC_THREADS_MAX);
+	tcnt = (count < (uint64_t)tcnt) ? (size_t)count : tcnt;
+
+	/* the workers take interleaved segments, so the file is read and written front to back */
+	for (i = 0; i < tcnt; ++i)
+	{
+		wrks[i].ctx = ctx;
+		wrks[i].abort = &abort;
+		wrks[i].plainlen = plainlen;
+		wrks[i].count = count;
+		wrks[i].first = i;
+		wrks[i].stride = tcnt;
+		wrks[i].depth = params->depth;
+		wrks[i].infd = infd;
+		wrks[i].outfd = outfd;
+		wrks[i].direct = params->direct;
+		wrks[i].encrypt = encryption;
+		wrks[i].synchronous = params->synchronous;
+		wrks[i].status = qsc_rcsfile_status_success;
+	}
+
+	for (i = 1; i < tcnt; ++i)
+	{
+		tstat[i] = qsc_async_thread_create(&threads[i], rcsuring_worker, &wrks[i]);
+	}
+
+	rcsuring_worker(&wrks[0]);
+	res = wrks[0].status;
+
+	for (i = 1; i < tcnt; ++i)
+	{
+		if (tstat[i] == true)
+		{
+			qsc_async_thread_wait(threads[i]);
+		}
+		else
+		{
+			rcsuring_worker(&wrks[i]);
+		}
+
+		if (res == qsc_rcsfile_status_success)
+		{
+			res = wrks[i].status;
+		}
+	}
+
+	return res;
+}
+
+static bool rcsuring_params_valid(const qsc_rcsuring_params* params, size_t keylen)
+{
+	return (params != NULL && params->depth != 0 && params->depth <= QSC_RCSURING_DEPTH_MAX &&
+		(keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE));
+}
+
+static int rcsuring_open(const char* path, int flags, bool direct)
+{
+	int fd;
+
+	fd = open(path, flags | ((direct == true) ? O_DIRECT : 0), 0600);
+
+	if (fd < 0 && direct == true && errno == EINVAL)
+	{
+		/* the file system does not support direct I/O */
+		fd = open(path, flags, 0600);
+	}
+
+	return fd;
+}
+
+static bool rcsuring_file_size(int fd, uint64_t* length, bool* regular)
+{
+	struct stat fst;
+	bool res;
+
+	res = false;
+	*length = 0;
+	*regular = false;
+
+	if (fstat(fd, &fst) == 0)
+	{
+		if (S_ISREG(fst.st_mode))
+		{
+			*length = (uint64_t)fst.st_size;
+			*regular = true;
+			res = true;
+		}
+		else if (S_ISBLK(fst.st_mode))
+		{
+			res = (ioctl(fd, BLKGETSIZE64, length) == 0);
+		}
+	}
+
+	return res;
+}
+
+static bool rcsuring_same_file(int fd, const char* path)
+{
+	struct stat sin;
+	struct stat sout;
+	bool res;
+
+	res = false;
+
+	if (fstat(fd, &sin) == 0 && stat(path, &sout) == 0)
+	{
+		res = (sin.st_dev == sout.st_dev && sin.st_ino == sout.st_ino) ||
+			(S_ISBLK(sin.st_mode) && S_ISBLK(sout.st_mode) && sin.st_rdev == sout.st_rdev);
+	}
+
+	return res;
+}
+
+static void rcsuring_statistics_set(qsc_rcsfile_statistics* stats, uint64_t length, uint64_t start)
+{
+	if (stats != NULL)
+	{
+		stats->length = length;
+		stats->nanoseconds = qsc_timerex_monotonic_nanoseconds() - start;
+	}
+}
+
+qsc_rcsfile_status qsc_rcsuring_encrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, size_t segsize, const qsc_rcsuring_params* params, qsc_rcsfile_statistics* stats)
+{
+	assert(inpath != NULL);
+	assert(outpath != NULL);
+	assert(key != NULL);
+
+	uint8_t header[QSC_RCSSEG_HEADER_SIZE] = { 0 };
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	qsc_rcsseg_state ctx;
+	qsc_rcsfile_status res;
+	uint64_t plen;
+	uint64_t start;
+	int infd;
+	int outfd;
+	bool reg;
+
+	start = qsc_timerex_monotonic_nanoseconds();
+	infd = -1;
+
+	if (rcsuring_params_valid(params, keylen) == false || segsize < QSC_RCSSEG_SEGMENT_MIN || segsize > QSC_RCSSEG_SEGMENT_MAX ||
+		(params->direct == true && segsize % QSC_RCSURING_DIRECT_ALIGNMENT != 0) ||
+		qsc_csp_generate(nonce, sizeof(nonce)) == false)
+	{
+		res = qsc_rcsfile_status_invalid_parameter;
+	}
+	else if ((infd = rcsuring_open(inpath, O_RDONLY, params->direct)) < 0 || rcsuring_file_size(infd, &plen, &reg) == false)
+	{
+		res = qsc_rcsfile_status_read_failure;
+	}
+	else
+	{
+		qsc_rcsseg_header_encode(header, keylen, segsize, nonce);
+		qsc_rcsseg_initialize(&ctx, key, keylen, header);
+		res = qsc_rcsfile_status_write_failure;
+
+		if (rcsuring_same_file(infd, outpath) == false)
+		{
+			outfd = rcsuring_open(outpath, O_WRONLY | O_CREAT | O_TRUNC, false);
+
+			if (outfd >= 0)
+			{
+				if (pwrite(outfd, header, QSC_RCSSEG_HEADER_SIZE, 0) == QSC_RCSSEG_HEADER_SIZE)
+				{
+					res = rcsuring_run(&ctx, infd, outfd, plen, true, params);
+				}
+
+				close(outfd);
+			}
+		}
+
+		rcsuring_statistics_set(stats, plen, start);
+		qsc_rcsseg_dispose(&ctx);
+	}
+
+	if (infd >= 0)
+	{
+		close(infd);
+	}
+
+	return res;
+}
+
+qsc_rcsfile_status qsc_rcsuring_decrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, const qsc_rcsuring_params* params, qsc_rcsfile_statistics* stats)
+{
+	assert(inpath != NULL);
+	assert(outpath != NULL);
+	assert(key != NULL);
+
+	uint8_t header[QSC_RCSSEG_HEADER_SIZE] = { 0 };
+	qsc_rcsseg_state ctx;
+	qsc_rcsfile_status res;
+	uint64_t clen;
+	uint64_t olen;
+	uint64_t plen;
+	uint64_t start;
+	int infd;
+	int outfd;
+	bool oreg;
+	bool reg;
+
+	start = qsc_timerex_monotonic_nanoseconds();
+	infd = -1;
+
+	if (rcsuring_params_valid(params, keylen) == false)
+	{
+		res = qsc_rcsfile_status_invalid_parameter;
+	}
+	else if ((infd = rcsuring_open(inpath, O_RDONLY, false)) < 0 || rcsuring_file_size(infd, &clen, &reg) == false)
+	{
+		res = qsc_rcsfile_status_read_failure;
+	}
+	else if (clen < QSC_RCSSEG_HEADER_SIZE || pread(infd, header, QSC_RCSSEG_HEADER_SIZE, 0) != QSC_RCSSEG_HEADER_SIZE ||
+		qsc_rcsseg_initialize(&ctx, key, keylen, header) == false)
+	{
+		res = qsc_rcsfile_status_invalid_format;
+	}
+	else
+	{
+		plen = qsc_rcsseg_decrypted_size(&ctx, clen);
+
+		if (params->direct == true && ctx.segsize % QSC_RCSURING_DIRECT_ALIGNMENT != 0)
+		{
+			res = qsc_rcsfile_status_invalid_parameter;
+		}
+		else if (qsc_rcsseg_encrypted_size(&ctx, plen) != clen)
+		{
+			/* a container that does not end on a segment and MAC code boundary was truncated or extended */
+			res = qsc_rcsfile_status_authentication_failure;
+		}
+		else if (rcsuring_same_file(infd, outpath) == true ||
+			(outfd = rcsuring_open(outpath, O_WRONLY | O_CREAT | O_TRUNC, params->direct)) < 0)
+		{
+			res = qsc_rcsfile_status_write_failure;
+		}
+		else
+		{
+			rcsuring_file_size(outfd, &olen, &oreg);
+			res = rcsuring_run(&ctx, infd, outfd, plen, false, params);
+
+			if (res == qsc_rcsfile_status_success && oreg == true && ftruncate(outfd, (off_t)plen) != 0)
+			{
+				res = qsc_rcsfile_status_write_failure;
+			}
+
+			close(outfd);
+
+			if (res != qsc_rcsfile_status_success && oreg == true)
+			{
+				remove(outpath);
+			}
+		}
+
+		rcsuring_statistics_set(stats, plen, start);
+		qsc_rcsseg_dispose(&ctx);
+	}
+
+	if (infd >= 0)
+	{
+		close(infd);
+	}
+
+	return res;
+}
+
+#endif
@@ -0,0 +1,120 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSURING_H
+#define QSC_RCSURING_H
+
+/**
+* \file rcsuring.h
+* \brief RCS io_uring file and block device pipeline (Linux) \n
+* Encrypts and decrypts files and block devices in the segmented container format (rcsseg.h),
+* overlapping the storage I/O with the cipher.
+*
+* Each worker thread owns an io_uring instance and a ring of segment buffers, registered with the kernel as fixed buffers.
+* A worker keeps up to depth segments in flight: a segment is read into its buffer, transformed in place when the read completes,
+* and written from the same buffer, while the reads and writes of the other segments proceed in the kernel.
+* The workers take interleaved segments, so the device sees one sequential stream and every core runs the cipher. \n
+* With direct I/O, the plain-text side is opened with O_DIRECT. The plain-text segment offsets are block aligned
+* when the segment size is a multiple of QSC_RCSURING_DIRECT_ALIGNMENT; the container side stays in the page cache,
+* because the header and the MAC codes leave its segment offsets unaligned. \n
+* The synchronous engine (a blocking read, transform, and write loop on each worker) is used when requested,
+* and when the kernel does not provide io_uring.
+*
+* The engine is only available on Linux, and is compiled when the kernel io_uring header is present (QSC_RCSURING_ENABLED).
+*/
+
+#include "common.h"
+#include "rcsfile.h"
+
+#if defined(QSC_SYSTEM_OS_LINUX) && defined(__has_include)
+#	if __has_include(<linux/io_uring.h>)
+	/*!
+	* \def QSC_RCSURING_ENABLED
+	* \brief The io_uring engine is available
+	*/
+#		define QSC_RCSURING_ENABLED
+#	endif
+#endif
+
+#if defined(QSC_RCSURING_ENABLED)
+
+/*!
+* \def QSC_RCSURING_DEPTH_DEFAULT
+* \brief The default number of segments in flight on each worker
+*/
+#define QSC_RCSURING_DEPTH_DEFAULT 16
+
+/*!
+* \def QSC_RCSURING_DEPTH_MAX
+* \brief The maximum number of segments in flight on each worker
+*/
+#define QSC_RCSURING_DEPTH_MAX 256
+
+/*!
+* \def QSC_RCSURING_DIRECT_ALIGNMENT
+* \brief The buffer, offset, and length alignment used with direct I/O
+*/
+#define QSC_RCSURING_DIRECT_ALIGNMENT 4096
+
+/*!
+* \struct qsc_rcsuring_params
+* \brief The pipeline parameters
+*/
+QSC_EXPORT_API typedef struct
+{
+	size_t depth;			/*!< The number of segments in flight on each worker, 1 to QSC_RCSURING_DEPTH_MAX */
+	size_t threads;			/*!< The number of worker threads; zero uses one worker for each processor core */
+	bool direct;			/*!< Open the plain-text file with O_DIRECT; the segment size must be a multiple of QSC_RCSURING_DIRECT_ALIGNMENT */
+	bool synchronous;		/*!< Use blocking reads and writes instead of io_uring */
+} qsc_rcsuring_params;
+
+/**
+* \brief Encrypt a file or block device into a segmented container.
+*
+* \param inpath: [const] The plain-text file or block device path
+* \param outpath: [const] The container file or block device path; must not be the input
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param segsize: The number of plain-text bytes in a segment, between QSC_RCSSEG_SEGMENT_MIN and QSC_RCSSEG_SEGMENT_MAX
+* \param params: [const][struct] The pipeline parameters
+* \param stats: [struct] The operation statistics; can be NULL
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsfile_status qsc_rcsuring_encrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, size_t segsize, const qsc_rcsuring_params* params, qsc_rcsfile_statistics* stats);
+
+/**
+* \brief Authenticate and decrypt a segmented container into a file or block device.
+* The segments are written as they are authenticated; if a segment fails, the pipeline stops,
+* and an output file is removed. The segments already written to a block device are not erased.
+*
+* \param inpath: [const] The container file or block device path
+* \param outpath: [const] The plain-text file or block device path; must not be the input
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param params: [const][struct] The pipeline parameters
+* \param stats: [struct] The operation statistics; can be NULL
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsfile_status qsc_rcsuring_decrypt(const char* inpath, const char* outpath, const uint8_t* key, size_t keylen, const qsc_rcsuring_params* params, qsc_rcsfile_statistics* stats);
+
+#endif
+
+#endif
@@ -0,0 +1,561 @@
+#include "rcsvol.h"
+#include "csp.h"
+#include "fileutils.h"
+#include "intutils.h"
+#include "memutils.h"
+
+#define RCSVOL_MAGIC_SIZE 4
+#define RCSVOL_VERSION_OFFSET 4
+#define RCSVOL_CIPHER_OFFSET 5
+#define RCSVOL_SECTOR_OFFSET 8
+#define RCSVOL_COUNT_OFFSET 16
+#define RCSVOL_NONCE_OFFSET 24
+#define RCSVOL_COUNTER_SIZE 8
+#define RCSVOL_INDEX_OFFSET 8
+#define RCSVOL_WRITE_OFFSET 16
+
+static const uint8_t rcsvol_magic[RCSVOL_MAGIC_SIZE] = { 0x52, 0x43, 0x53, 0x56 };
+
+static void rcsvol_clear(qsc_rcsvol_state* ctx)
+{
+	qsc_memutils_clear((uint8_t*)ctx, sizeof(qsc_rcsvol_state));
+	ctx->handle = QSC_FILEUTILS_INVALID_HANDLE;
+}
+
+static bool rcsvol_load(qsc_rcsvol_state* ctx, const uint8_t* key, size_t keylen, const uint8_t* header)
+{
+	const rcs_cipher_type CTYPE = (keylen == QSC_RCS512_KEY_SIZE) ? RCS512 : RCS256;
+	uint64_t metalen;
+	uint64_t sectors;
+	size_t i;
+	bool res;
+
+	res = false;
+	sectors = qsc_intutils_le8to64(header + RCSVOL_COUNT_OFFSET);
+
+	if (qsc_intutils_are_equal8(header, rcsvol_magic, RCSVOL_MAGIC_SIZE) == true &&
+		header[RCSVOL_VERSION_OFFSET] == QSC_RCSVOL_VERSION &&
+		header[RCSVOL_CIPHER_OFFSET] == (uint8_t)CTYPE &&
+		(keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE) &&
+		qsc_intutils_le8to32(header + RCSVOL_SECTOR_OFFSET) == QSC_RCSVOL_SECTOR_SIZE &&
+		sectors != 0 && sectors <= QSC_RCSVOL_SECTORS_MAX)
+	{
+		/* the reserved bytes must be zero */
+		res = true;
+
+		for (i = RCSVOL_CIPHER_OFFSET + 1; i < RCSVOL_SECTOR_OFFSET; ++i)
+		{
+			res = res && (header[i] == 0);
+		}
+
+		for (i = RCSVOL_SECTOR_OFFSET + sizeof(uint32_t); i < RCSVOL_COUNT_OFFSET; ++i)
+		{
+			res = res && (header[i] == 0);
+		}
+
+		for (i = RCSVOL_NONCE_OFFSET + QSC_RCS_NONCE_SIZE; i < QSC_RCSVOL_HEADER_SIZE; ++i)
+		{
+			res = res && (header[i] == 0);
+		}
+	}
+
+	if (res == true)
+	{
+		qsc_rcs_keyparams kp = { key, keylen, ctx->nonce, NULL, 0 };
+
+		qsc_memutils_copy(ctx->header, header, QSC_RCSVOL_HEADER_SIZE);
+		qsc_memutils_copy(ctx->nonce, header + RCSVOL_NONCE_OFFSET, QSC_RCS_NONCE_SIZE);
+		qsc_rcs_key_expand(&ctx->key, &kp);
+#if defined(QSC_RCS_AUTHENTICATED)
+		ctx->maclen = (CTYPE == RCS256) ? QSC_RCS256_MAC_SIZE : QSC_RCS512_MAC_SIZE;
+#else
+		ctx->maclen = 0;
+#endif
+		ctx->entrysize = RCSVOL_COUNTER_SIZE + ctx->maclen;
+		ctx->sectors = sectors;
+		/* the metadata region is padded to the sector size, so the data region stays aligned */
+		metalen = sectors * ctx->entrysize;
+		metalen = (metalen + QSC_RCSVOL_SECTOR_SIZE - 1) & ~((uint64_t)QSC_RCSVOL_SECTOR_SIZE - 1);
+		ctx->metaoffset = QSC_RCSVOL_SECTOR_SIZE;
+		ctx->dataoffset = ctx->metaoffset + metalen;
+
+		/* the batch states are vector aligned, and the sector buffer is aligned to the sector size for direct I/O */
+		ctx->states = (qsc_rcs_state*)qsc_memutils_aligned_alloc(64, QSC_RCSVOL_BATCH_MAX * sizeof(qsc_rcs_state));
+		ctx->buffer = (uint8_t*)qsc_memutils_aligned_alloc(QSC_RCSVOL_SECTOR_SIZE, QSC_RCSVOL_BATCH_MAX * QSC_RCSVOL_SECTOR_SIZE);
+		ctx->metadata = (uint8_t*)qsc_memutils_malloc(QSC_RCSVOL_BATCH_MAX * ctx->entrysize);
+		res = (ctx->states != NULL && ctx->buffer != NULL && ctx->metadata != NULL);
+	}
+
+	return res;
+}
+
+static void rcsvol_sector_initialize(const qsc_rcsvol_state* ctx, qsc_rcs_state* state, uint64_t sector, uint64_t counter, bool encryption)
+{
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+
+	/* every write of a sector takes a new counter, so a rewritten sector has a fresh nonce */
+	qsc_rcs_nonce_derive(nonce, ctx->nonce, sector, RCSVOL_INDEX_OFFSET);
+	qsc_rcs_nonce_derive(nonce, nonce, counter, RCSVOL_WRITE_OFFSET);
+
+	qsc_rcs_stream_initialize(state, &ctx->key, nonce, encryption);
+	/* bind the header to the sector */
+	qsc_rcs_set_associated(state, ctx->header, QSC_RCSVOL_HEADER_SIZE);
+	qsc_memutils_clear(nonce, sizeof(nonce));
+}
+
+static bool rcsvol_sectors_valid(const qsc_rcsvol_state* ctx, const uint64_t* sectors, size_t count)
+{
+	size_t i;
+	bool res;
+
+	res = true;
+
+	for (i = 0; i < count && res == true; ++i)
+	{
+		res = (sectors[i] < ctx->sectors);
+	}
+
+	return res;
+}
+
+static bool rcsvol_sector_listed(const uint64_t* sectors, size_t count, uint64_t sector)
+{
+	size_t i;
+	bool res;
+
+	res = false;
+
+	for (i = 0; i < count && res == false; ++i)
+	{
+		res = (sectors[i] == sector);
+	}
+
+	return res;
+}
+
+static bool rcsvol_metadata_io(qsc_rcsvol_state* ctx, const uint64_t* sectors, size_t count, bool run, bool write)
+{
+	size_t i;
+	bool res;
+
+	if (run == true)
+	{
+		/* the entries of a run are adjacent in the file */
+		res = (write == true) ?
+			qsc_fileutils_write_at(ctx->handle, ctx->metadata, count * ctx->entrysize, ctx->metaoffset + (sectors[0] * ctx->entrysize)) :
+			qsc_fileutils_read_at(ctx->handle, ctx->metadata, count * ctx->entrysize, ctx->metaoffset + (sectors[0] * ctx->entrysize));
+	}
+	else
+	{
+		res = true;
+
+		for (i = 0; i < count && res == true; ++i)
+		{
+			res = (write == true) ?
+				qsc_fileutils_write_at(ctx->handle, ctx->metadata + (i * ctx->entrysize), ctx->entrysize, ctx->metaoffset + (sectors[i] * ctx->entrysize)) :
+				qsc_fileutils_read_at(ctx->handle, ctx->metadata + (i * ctx->entrysize), ctx->entrysize, ctx->metaoffset + (sectors[i] * ctx->entrysize));
+		}
+	}
+
+	return res;
+}
+
+static bool rcsvol_data_io(qsc_rcsvol_state* ctx, const uint64_t* sectors, uint8_t* data, size_t count, bool run, bool write)
+{
+	size_t i;
+	bool res;
+
+	if (run == true)
+	{
+		res = (write == true) ?
+			qsc_fileutils_write_at(ctx->handle, data, count * QSC_RCSVOL_SECTOR_SIZE, ctx->dataoffset + (sectors[0] * QSC_RCSVOL_SECTOR_SIZE)) :
+			qsc_fileutils_read_at(ctx->handle, data, count * QSC_RCSVOL_SECTOR_SIZE, ctx->dataoffset + (sectors[0] * QSC_RCSVOL_SECTOR_SIZE));
+	}
+	else
+	{
+		res = true;
+
+		for (i = 0; i < count && res == true; ++i)
+		{
+			res = (write == true) ?
+				qsc_fileutils_write_at(ctx->handle, data + (i * QSC_RCSVOL_SECTOR_SIZE), QSC_RCSVOL_SECTOR_SIZE, ctx->dataoffset + (sectors[i] * QSC_RCSVOL_SECTOR_SIZE)) :
+				qsc_fileutils_read_at(ctx->handle, data + (i * QSC_RCSVOL_SECTOR_SIZE), QSC_RCSVOL_SECTOR_SIZE, ctx->dataoffset + (sectors[i] * QSC_RCSVOL_SECTOR_SIZE));
+		}
+	}
+
+	return res;
+}
+
+static bool rcsvol_metadata_initialize(qsc_rcsvol_state* ctx)
+{
+	qsc_rcs_state* pstates[QSC_RCSVOL_BATCH_MAX];
+	const uint8_t* inputs[QSC_RCSVOL_BATCH_MAX];
+	uint8_t* outputs[QSC_RCSVOL_BATCH_MAX];
+	uint8_t* tags[QSC_RCSVOL_BATCH_MAX];
+	size_t lengths[QSC_RCSVOL_BATCH_MAX];
+	uint64_t numbers[QSC_RCSVOL_BATCH_MAX];
+	uint64_t sector;
+	size_t bcnt;
+	size_t i;
+	bool res;
+
+	res = true;
+
+	/* every entry starts with a zero write counter, and the MAC code of an empty sector under the nonce of counter zero;
+	   no key-stream is generated with that nonce, and the first write of the sector uses counter one */
+	for (sector = 0; sector < ctx->sectors && ctx->maclen != 0 && res == true; sector += bcnt)
+	{
+		bcnt = (ctx->sectors - sector > QSC_RCSVOL_BATCH_MAX) ? QSC_RCSVOL_BATCH_MAX : (size_t)(ctx->sectors - sector);
+		qsc_memutils_clear(ctx->metadata, bcnt * ctx->entrysize);
+
+		for (i = 0; i < bcnt; ++i)
+		{
+			numbers[i] = sector + i;
+			rcsvol_sector_initialize(ctx, &ctx->states[i], numbers[i], 0, true);
+			pstates[i] = &ctx->states[i];
+			inputs[i] = ctx->buffer;
+			outputs[i] = ctx->buffer;
+			tags[i] = ctx->metadata + (i * ctx->entrysize) + RCSVOL_COUNTER_SIZE;
+			lengths[i] = 0;
+		}
+
+		qsc_rcs_transform_batch_detached(pstates, outputs, inputs, lengths, tags, NULL, bcnt);
+
+		for (i = 0; i < bcnt; ++i)
+		{
+			qsc_rcs_dispose(&ctx->states[i]);
+		}
+
+		res = rcsvol_metadata_io(ctx, numbers, bcnt, true, true);
+	}
+
+	return res;
+}
+
+static qsc_rcsvol_status rcsvol_read_batch(qsc_rcsvol_state* ctx, const uint64_t* sectors, uint8_t* output, size_t count, bool run)
+{
+	qsc_rcs_state* pstates[QSC_RCSVOL_BATCH_MAX];
+	const uint8_t* inputs[QSC_RCSVOL_BATCH_MAX];
+	uint8_t* outputs[QSC_RCSVOL_BATCH_MAX];
+	uint8_t* tags[QSC_RCSVOL_BATCH_MAX];
+	size_t lengths[QSC_RCSVOL_BATCH_MAX];
+	bool results[QSC_RCSVOL_BATCH_MAX];
+	qsc_rcsvol_status res;
+	uint64_t counter;
+	uint8_t* pent;
+	size_t bcnt;
+	size_t i;
+
+	res = qsc_rcsvol_status_read_failure;
+
+	/* the cipher-text is read into the output, and decrypted in place */
+	if (rcsvol_metadata_io(ctx, sectors, count, run, false) == true &&
+		rcsvol_data_io(ctx, sectors, output, count, run, false) == true)
+	{
+		res = qsc_rcsvol_status_success;
+		bcnt = 0;
+
+		for (i = 0; i < count; ++i)
+		{
+			pent = ctx->metadata + (i * ctx->entrysize);
+			counter = qsc_intutils_le8to64(pent);
+
+			rcsvol_sector_initialize(ctx, &ctx->states[bcnt], sectors[i], counter, false);
+			pstates[bcnt] = &ctx->states[bcnt];
+			inputs[bcnt] = output + (i * QSC_RCSVOL_SECTOR_SIZE);
+			outputs[bcnt] = output + (i * QSC_RCSVOL_SECTOR_SIZE);
+			tags[bcnt] = pent + RCSVOL_COUNTER_SIZE;
+			lengths[bcnt] = QSC_RCSVOL_SECTOR_SIZE;
+
+			if (counter == 0)
+			{
+				/* a sector that was never written reads as zeros; its entry holds the MAC code of an empty sector,
+				   which is still verified, so an entry cleared by an attacker does not erase a written sector */
+				qsc_memutils_clear(outputs[bcnt], QSC_RCSVOL_SECTOR_SIZE);
+				lengths[bcnt] = 0;
+			}
+
+			++bcnt;
+		}
+
+		if (qsc_rcs_transform_batch_detached(pstates, outputs, inputs, lengths, tags, results, bcnt) == false)
+		{
+			res = qsc_rcsvol_status_authentication_failure;
+
+			for (i = 0; i < bcnt; ++i)
+			{
+				if (results[i] == false)
+				{
+					qsc_memutils_clear(outputs[i], QSC_RCSVOL_SECTOR_SIZE);
+				}
+			}
+		}
+
+		for (i = 0; i < bcnt; ++i)
+		{
+			qsc_rcs_dispose(&ctx->states[i]);
+		}
+	}
+
+	return res;
+}
+
+static qsc_rcsvol_status rcsvol_write_batch(qsc_rcsvol_state* ctx, const uint64_t* sectors, const uint8_t* input, size_t count, bool run)
+{
+	qsc_rcs_state* pstates[QSC_RCSVOL_BATCH_MAX];
+	const uint8_t* inputs[QSC_RCSVOL_BATCH_MAX];
+	uint8_t* outputs[QSC_RCSVOL_BATCH_MAX];
+	uint8_t* tags[QSC_RCSVOL_BATCH_MAX];
+	size_t lengths[QSC_RCSVOL_BATCH_MAX];
+	qsc_rcsvol_status res;
+	uint8_t* pent;
+	size_t i;
+
+	res = qsc_rcsvol_status_write_failure;
+
+	/* the stored write counters are read, so every write of a sector takes the next nonce */
+	if (rcsvol_metadata_io(ctx, sectors, count, run, false) == true)
+	{
+		for (i = 0; i < count; ++i)
+		{
+			pent = ctx->metadata + (i * ctx->entrysize);
+			qsc_intutils_le64to8(pent, qsc_intutils_le8to64(pent) + 1);
+		}
+
+		/* the incremented counters reach the device before any cipher-text reaches the file, so a write that fails
+		   or is torn by a crash can not leave a counter that the next write of the sector takes again;
+		   until the new MAC codes are written, the sectors fail authentication */
+		if (rcsvol_metadata_io(ctx, sectors, count, run, true) == true && qsc_fileutils_sync(ctx->handle) == true)
+		{
+			for (i = 0; i < count; ++i)
+			{
+				pent = ctx->metadata + (i * ctx->entrysize);
+				rcsvol_sector_initialize(ctx, &ctx->states[i], sectors[i], qsc_intutils_le8to64(pent), true);
+				pstates[i] = &ctx->states[i];
+				inputs[i] = input + (i * QSC_RCSVOL_SECTOR_SIZE);
+				outputs[i] = ctx->buffer + (i * QSC_RCSVOL_SECTOR_SIZE);
+				tags[i] = pent + RCSVOL_COUNTER_SIZE;
+				lengths[i] = QSC_RCSVOL_SECTOR_SIZE;
+			}
+
+			qsc_rcs_transform_batch_detached(pstates, outputs, inputs, lengths, tags, NULL, count);
+
+			for (i = 0; i < count; ++i)
+			{
+				qsc_rcs_dispose(&ctx->states[i]);
+			}
+
+			if (rcsvol_data_io(ctx, sectors, ctx->buffer, count, run, true) == true &&
+				rcsvol_metadata_io(ctx, sectors, count, run, true) == true)
+			{
+				res = qsc_rcsvol_status_success;
+			}
+		}
+	}
+
+	return res;
+}
+
+static qsc_rcsvol_status rcsvol_transform(qsc_rcsvol_state* ctx, const uint64_t* list, uint64_t sector, uint8_t* output, const uint8_t* input, size_t count)
+{
+	uint64_t numbers[QSC_RCSVOL_BATCH_MAX];
+	qsc_rcsvol_status res;
+	qsc_rcsvol_status bres;
+	size_t bcnt;
+	size_t oft;
+	size_t i;
+
+	res = qsc_rcsvol_status_invalid_parameter;
+
+	if (ctx->states != NULL &&
+		((list == NULL && sector < ctx->sectors && (uint64_t)count <= ctx->sectors - sector) ||
+		(list != NULL && rcsvol_sectors_valid(ctx, list, count) == true)))
+	{
+		res = qsc_rcsvol_status_success;
+
+		for (oft = 0; oft < count; oft += bcnt)
+		{
+			bcnt = qsc_intutils_min(count - oft, QSC_RCSVOL_BATCH_MAX);
+
+			for (i = 0; i < bcnt; ++i)
+			{
+				numbers[i] = (list != NULL) ? list[oft + i] : sector + oft + i;
+
+				/* the write counters of a batch are read together, so a sector listed twice starts a new batch,
+				   and its second write takes the counter stored by the first */
+				if (list != NULL && input != NULL && rcsvol_sector_listed(numbers, i, numbers[i]) == true)
+				{
+					bcnt = i;
+					break;
+				}
+			}
+
+			bres = (input != NULL) ?
+				rcsvol_write_batch(ctx, numbers, input + (oft * QSC_RCSVOL_SECTOR_SIZE), bcnt, (list == NULL)) :
+				rcsvol_read_batch(ctx, numbers, output + (oft * QSC_RCSVOL_SECTOR_SIZE), bcnt, (list == NULL));
+
+			/* an authentication failure is reported after the other batches are read; an i/o failure stops the call */
+			if (bres != qsc_rcsvol_status_success)
+			{
+				res = bres;
+
+				if (bres != qsc_rcsvol_status_authentication_failure)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	return res;
+}
+
+qsc_rcsvol_status qsc_rcsvol_create(qsc_rcsvol_state* ctx, const char* path, const uint8_t* key, size_t keylen, uint64_t sectors)
+{
+	assert(ctx != NULL);
+	assert(path != NULL);
+	assert(key != NULL);
+
+	uint8_t hsec[QSC_RCSVOL_SECTOR_SIZE] = { 0 };
+	qsc_rcsvol_status res;
+	bool fres;
+
+	res = qsc_rcsvol_status_invalid_parameter;
+	rcsvol_clear(ctx);
+
+	if ((keylen == QSC_RCS256_KEY_SIZE || keylen == QSC_RCS512_KEY_SIZE) && sectors != 0 && sectors <= QSC_RCSVOL_SECTORS_MAX)
+	{
+		res = qsc_rcsvol_status_write_failure;
+		qsc_memutils_copy(hsec, rcsvol_magic, RCSVOL_MAGIC_SIZE);
+		hsec[RCSVOL_VERSION_OFFSET] = QSC_RCSVOL_VERSION;
+		hsec[RCSVOL_CIPHER_OFFSET] = (uint8_t)((keylen == QSC_RCS512_KEY_SIZE) ? RCS512 : RCS256);
+		qsc_intutils_le32to8(hsec + RCSVOL_SECTOR_OFFSET, QSC_RCSVOL_SECTOR_SIZE);
+		qsc_intutils_le64to8(hsec + RCSVOL_COUNT_OFFSET, sectors);
+		qsc_csp_generate(hsec + RCSVOL_NONCE_OFFSET, QSC_RCS_NONCE_SIZE);
+
+		if (rcsvol_load(ctx, key, keylen, hsec) == true)
+		{
+			const uint64_t FLEN = ctx->dataoffset + (ctx->sectors * QSC_RCSVOL_SECTOR_SIZE);
+
+			/* the data region is left as a hole; the metadata region is written with the entries of the unwritten sectors */
+			ctx->handle = qsc_fileutils_open(path, true);
+			fres = (ctx->handle != QSC_FILEUTILS_INVALID_HANDLE && qsc_fileutils_write_at(ctx->handle, hsec, sizeof(hsec), 0) == true &&
+				qsc_fileutils_truncate(ctx->handle, FLEN) == true);
+
+			if (fres == true && rcsvol_metadata_initialize(ctx) == true)
+			{
+				res = qsc_rcsvol_status_success;
+			}
+		}
+	}
+
+	if (res != qsc_rcsvol_status_success)
+	{
+		qsc_rcsvol_dispose(ctx);
+	}
+
+	return res;
+}
+
+qsc_rcsvol_status qsc_rcsvol_open(qsc_rcsvol_state* ctx, const char* path, const uint8_t* key, size_t keylen)
+{
+	assert(ctx != NULL);
+	assert(path != NULL);
+	assert(key != NULL);
+
+	uint8_t hdr[QSC_RCSVOL_HEADER_SIZE] = { 0 };
+	qsc_rcsvol_status res;
+	bool fres;
+
+	res = qsc_rcsvol_status_read_failure;
+	rcsvol_clear(ctx);
+
+	ctx->handle = qsc_fileutils_open(path, false);
+	fres = (ctx->handle != QSC_FILEUTILS_INVALID_HANDLE);
+
+	if (fres == true && qsc_fileutils_read_at(ctx->handle, hdr, sizeof(hdr), 0) == true)
+	{
+		res = qsc_rcsvol_status_invalid_format;
+
+		if (rcsvol_load(ctx, key, keylen, hdr) == true &&
+			qsc_fileutils_size(ctx->handle) >= ctx->dataoffset + (ctx->sectors * QSC_RCSVOL_SECTOR_SIZE))
+		{
+			res = qsc_rcsvol_status_success;
+		}
+	}
+
+	if (res != qsc_rcsvol_status_success)
+	{
+		qsc_rcsvol_dispose(ctx);
+	}
+
+	return res;
+}
+
+void qsc_rcsvol_dispose(qsc_rcsvol_state* ctx)
+{
+	if (ctx != NULL)
+	{
+		if (ctx->states != NULL)
+		{
+			qsc_memutils_clear((uint8_t*)ctx->states, QSC_RCSVOL_BATCH_MAX * sizeof(qsc_rcs_state));
+			qsc_memutils_aligned_free(ctx->states);
+		}
+
+		if (ctx->buffer != NULL)
+		{
+			qsc_memutils_aligned_free(ctx->buffer);
+		}
+
+		if (ctx->metadata != NULL)
+		{
+			qsc_memutils_alloc_free(ctx->metadata);
+		}
+
+		qsc_fileutils_close(&ctx->handle);
+
+		qsc_rcs_key_dispose(&ctx->key);
+		rcsvol_clear(ctx);
+	}
+}
+
+uint64_t qsc_rcsvol_sectors(const qsc_rcsvol_state* ctx)
+{
+	assert(ctx != NULL);
+
+	return ctx->sectors;
+}
+
+qsc_rcsvol_status qsc_rcsvol_read(qsc_rcsvol_state* ctx, uint64_t sector, uint8_t* output, size_t count)
+{
+	assert(ctx != NULL);
+	assert(output != NULL || count == 0);
+
+	return rcsvol_transform(ctx, NULL, sector, output, NULL, count);
+}
+
+qsc_rcsvol_status qsc_rcsvol_write(qsc_rcsvol_state* ctx, uint64_t sector, const uint8_t* input, size_t count)
+{
+	assert(ctx != NULL);
+	assert(input != NULL || count == 0);
+
+	return rcsvol_transform(ctx, NULL, sector, NULL, input, count);
+}
+
+qsc_rcsvol_status qsc_rcsvol_read_list(qsc_rcsvol_state* ctx, const uint64_t* sectors, uint8_t* output, size_t count)
+{
+	assert(ctx != NULL);
+	assert(sectors != NULL || count == 0);
+	assert(output != NULL || count == 0);
+
+	return rcsvol_transform(ctx, sectors, 0, output, NULL, count);
+}
+
+qsc_rcsvol_status qsc_rcsvol_write_list(qsc_rcsvol_state* ctx, const uint64_t* sectors, const uint8_t* input, size_t count)
+{
+	assert(ctx != NULL);
+	assert(sectors != NULL || count == 0);
+	assert(input != NULL || count == 0);
+
+	return rcsvol_transform(ctx, sectors, 0, NULL, input, count);
+}
@@ -0,0 +1,230 @@
+/* The AGPL version 3 License (AGPLv3)
+*
+* Copyright (c) 2021 Digital Freedom Defence Inc.
+* This file is part of the QSC Cryptographic library
+*
+* This program is free software : you can redistribute it and / or modify
+* it under the terms of the GNU Affero General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QSC_RCSVOL_H
+#define QSC_RCSVOL_H
+
+/**
+* \file rcsvol.h
+* \brief RCS sector-addressed volume file \n
+* An encrypted volume of fixed-size sectors, any of which can be read or rewritten in place; for virtual machine scratch disks,
+* swap, and other block storage.
+*
+* Volume layout: \n
+* header sector (4096) | metadata region | data region \n
+* Header layout (64 bytes, at the start of the header sector): \n
+* magic (4) | version (1) | cipher type (1) | reserved (2) | sector size (4, little-endian) | reserved (4) |
+* sector count (8, little-endian) | volume nonce (32) | reserved (8) \n
+* Metadata entry of a sector: \n
+* write counter (8, little-endian) | MAC code (32 or 64) \n
+*
+* The data region holds only cipher-text, at the sector size, so the sector offsets stay aligned for direct I/O;
+* the MAC codes are kept in the metadata region, one entry for each sector, padded to a whole number of header sectors. \n
+* Every write of a sector increments its write counter, and the sector is encrypted with a nonce derived from the volume nonce,
+* the sector number, and the write counter, so a sector can be rewritten any number of times without reusing a nonce.
+* The header is bound to every sector as associated data, so a sector can not be moved to another position or another volume. \n
+* A sector whose write counter is zero has never been written, and reads as zeros. Its metadata entry is written when the volume
+* is created, with the MAC code of an empty sector under the nonce of counter zero, and is verified on every read,
+* so clearing the entry of a written sector fails authentication instead of erasing the sector.
+* Like other sector-level disk encryption, the volume does not detect a sector that is rolled back to an earlier authentic version,
+* together with its metadata entry; this includes a written sector rolled back to its unwritten entry, which then reads as zeros.
+* The volume file should be kept on storage that the attacker can not roll back, since a rolled-back counter would also repeat a nonce.
+* A write first stores the incremented write counters and flushes them to the device, then the data, then the MAC codes,
+* so a write that fails or is torn by a crash leaves the counters ahead of the stored sectors, never behind them:
+* those sectors fail authentication instead of returning stale data, and the next write takes a counter that has not been used.
+*
+* The read and write functions take a run of consecutive sectors, or a list of sectors in any order, and process them in batches
+* with qsc_rcs_transform_batch_detached, which fills the vector lanes with several sectors at once.
+* A run is moved with one read or write call for the data of each batch; a read takes one metadata call, and a write takes two,
+* with one device synchronization between the counters and the data.
+* The state holds scratch buffers, so a state is used by one thread at a time; the same sector must not be written
+* through two states at once.
+*
+* Volume example \n
+* \code
+* qsc_rcsvol_state vol;
+*
+* qsc_rcsvol_create(&vol, "scratch.vol", key, QSC_RCS256_KEY_SIZE, 262144);
+* // write 16 sectors starting at sector 100, and read them back
+* qsc_rcsvol_write(&vol, 100, data, 16);
+* qsc_rcsvol_read(&vol, 100, data, 16);
+* qsc_rcsvol_dispose(&vol);
+* \endcode
+*/
+
+#include "common.h"
+#include "fileutils.h"
+#include "rcs.h"
+
+/*!
+* \def QSC_RCSVOL_SECTOR_SIZE
+* \brief The size of a sector in bytes
+*/
+#define QSC_RCSVOL_SECTOR_SIZE 4096
+
+/*!
+* \def QSC_RCSVOL_HEADER_SIZE
+* \brief The size of the volume header in bytes
+*/
+#define QSC_RCSVOL_HEADER_SIZE 64
+
+/*!
+* \def QSC_RCSVOL_VERSION
+* \brief The volume format version
+*/
+#define QSC_RCSVOL_VERSION 0x01
+
+/*!
+* \def QSC_RCSVOL_BATCH_MAX
+* \brief The number of sectors transformed in one batch
+*/
+#define QSC_RCSVOL_BATCH_MAX 64
+
+/*!
+* \def QSC_RCSVOL_SECTORS_MAX
+* \brief The largest number of sectors in a volume; 2^40 sectors, 4 PB
+*/
+#define QSC_RCSVOL_SECTORS_MAX (1ULL << 40)
+
+/*! \enum qsc_rcsvol_status
+* The volume operation result
+*/
+typedef enum
+{
+	qsc_rcsvol_status_success = 0,					/*!< The operation completed */
+	qsc_rcsvol_status_invalid_parameter = 1,		/*!< The key length or sector count is not valid, or a sector is outside the volume */
+	qsc_rcsvol_status_read_failure = 2,				/*!< The volume file could not be opened or read */
+	qsc_rcsvol_status_write_failure = 3,			/*!< The volume file could not be created or written */
+	qsc_rcsvol_status_invalid_format = 4,			/*!< The file is not a volume, or was not written with this key length */
+	qsc_rcsvol_status_authentication_failure = 5,	/*!< A sector failed authentication; its output is cleared */
+} qsc_rcsvol_status;
+
+/*!
+* \struct qsc_rcsvol_state
+* \brief The volume state; the expanded key, the header, the file handle, and the batch scratch buffers
+*/
+QSC_EXPORT_API typedef struct
+{
+	qsc_rcs_key key;							/*!< The expanded cipher key */
+	uint8_t header[QSC_RCSVOL_HEADER_SIZE];		/*!< The volume header */
+	uint8_t nonce[QSC_RCS_NONCE_SIZE];			/*!< The volume nonce */
+	qsc_rcs_state* states;						/*!< The cipher states of a batch */
+	uint8_t* buffer;							/*!< The cipher-text of a batch of written sectors */
+	uint8_t* metadata;							/*!< The metadata entries of a batch */
+	uint64_t sectors;							/*!< The number of sectors in the volume */
+	uint64_t metaoffset;						/*!< The file offset of the metadata region */
+	uint64_t dataoffset;						/*!< The file offset of the data region */
+	size_t entrysize;							/*!< The size of a metadata entry */
+	size_t maclen;								/*!< The size of a sector MAC code */
+	qsc_fileutils_handle handle;				/*!< The file handle */
+} qsc_rcsvol_state;
+
+/**
+* \brief Create a volume file, replacing an existing file, and open it.
+* The metadata region is written with an authenticated entry for every sector, and the data region is created sparse;
+* every sector reads as zeros until it is written.
+*
+* \param ctx: [struct] The volume state
+* \param path: [const] The volume file path
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; QSC_RCS256_KEY_SIZE or QSC_RCS512_KEY_SIZE
+* \param sectors: The number of sectors, between 1 and QSC_RCSVOL_SECTORS_MAX
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsvol_status qsc_rcsvol_create(qsc_rcsvol_state* ctx, const char* path, const uint8_t* key, size_t keylen, uint64_t sectors);
+
+/**
+* \brief Open an existing volume file.
+*
+* \param ctx: [struct] The volume state
+* \param path: [const] The volume file path
+* \param key: [const] The cipher key
+* \param keylen: The cipher key length; must match the cipher type in the header
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsvol_status qsc_rcsvol_open(qsc_rcsvol_state* ctx, const char* path, const uint8_t* key, size_t keylen);
+
+/**
+* \brief Close the volume file, and clear the state.
+*
+* \param ctx: [struct] The volume state
+*/
+QSC_EXPORT_API void qsc_rcsvol_dispose(qsc_rcsvol_state* ctx);
+
+/**
+* \brief Get the number of sectors in the volume.
+*
+* \param ctx: [const][struct] The volume state
+*
+* \return Returns the sector count
+*/
+QSC_EXPORT_API uint64_t qsc_rcsvol_sectors(const qsc_rcsvol_state* ctx);
+
+/**
+* \brief Authenticate and decrypt a run of consecutive sectors.
+*
+* \param ctx: [struct] The volume state
+* \param sector: The first sector number
+* \param output: The output array, count * QSC_RCSVOL_SECTOR_SIZE bytes
+* \param count: The number of sectors
+*
+* \return Returns the operation status; the output of a sector that failed authentication is cleared
+*/
+QSC_EXPORT_API qsc_rcsvol_status qsc_rcsvol_read(qsc_rcsvol_state* ctx, uint64_t sector, uint8_t* output, size_t count);
+
+/**
+* \brief Encrypt and write a run of consecutive sectors.
+*
+* \param ctx: [struct] The volume state
+* \param sector: The first sector number
+* \param input: [const] The input array, count * QSC_RCSVOL_SECTOR_SIZE bytes
+* \param count: The number of sectors
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsvol_status qsc_rcsvol_write(qsc_rcsvol_state* ctx, uint64_t sector, const uint8_t* input, size_t count);
+
+/**
+* \brief Authenticate and decrypt a list of sectors, in any order.
+*
+* \param ctx: [struct] The volume state
+* \param sectors: [const] The sector numbers
+* \param output: The output array; sector i of the list is written at i * QSC_RCSVOL_SECTOR_SIZE
+* \param count: The number of sectors
+*
+* \return Returns the operation status; the output of a sector that failed authentication is cleared
+*/
+QSC_EXPORT_API qsc_rcsvol_status qsc_rcsvol_read_list(qsc_rcsvol_state* ctx, const uint64_t* sectors, uint8_t* output, size_t count);
+
+/**
+* \brief Encrypt and write a list of sectors, in any order.
+* A sector that appears in the list more than once is written in list order, with a new write counter for each write.
+*
+* \param ctx: [struct] The volume state
+* \param sectors: [const] The sector numbers
+* \param input: [const] The input array; sector i of the list is read from i * QSC_RCSVOL_SECTOR_SIZE
+* \param count: The number of sectors
+*
+* \return Returns the operation status
+*/
+QSC_EXPORT_API qsc_rcsvol_status qsc_rcsvol_write_list(qsc_rcsvol_state* ctx, const uint64_t* sectors, const uint8_t* input, size_t count);
+
+#endif
@@ -0,0 +1,565 @@
+#include "rcsvol_test.h"
+#include "intutils.h"
+#include "memutils.h"
+#include "csp.h"
+#include "testutils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(QSC_SYSTEM_OS_POSIX)
+#	include <signal.h>
+#	include <sys/resource.h>
+#endif
+
+#define RCSVOL_TEST_PATH "rcsvol_test.vol"
+#define RCSVOL_TEST_SHORT "rcsvol_test.trn"
+#define RCSVOL_TEST_SECTORS 512
+#define RCSVOL_TEST_COUNTER 8
+
+static bool rcsvol_sector_compare(const qsc_rcsvol_state* vol, const uint8_t* key, size_t keylen, uint64_t sector, uint64_t counter, const uint8_t* plain)
+{
+	/* encrypt the sector with the single-stream transform, and compare it with the stored cipher-text, counter, and MAC code */
+	uint8_t nonce[QSC_RCS_NONCE_SIZE] = { 0 };
+	uint8_t exp[QSC_RCSVOL_SECTOR_SIZE + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t ent[RCSVOL_TEST_COUNTER + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t* pct;
+	qsc_rcs_state state;
+	qsc_rcs_key ekey;
+	size_t i;
+	bool res;
+
+	res = false;
+	pct = (uint8_t*)qsc_memutils_malloc(QSC_RCSVOL_SECTOR_SIZE);
+
+	if (pct != NULL)
+	{
+		qsc_rcs_keyparams kp = { key, keylen, nonce, NULL, 0 };
+
+		qsc_memutils_copy(nonce, vol->nonce, QSC_RCS_NONCE_SIZE);
+		qsc_memutils_clear(nonce, sizeof(uint64_t));
+
+		for (i = 0; i < sizeof(uint64_t); ++i)
+		{
+			nonce[8 + i] ^= (uint8_t)(sector >> (i * 8));
+			nonce[16 + i] ^= (uint8_t)(counter >> (i * 8));
+		}
+
+		qsc_rcs_key_expand(&ekey, &kp);
+		qsc_rcs_stream_initialize(&state, &ekey, nonce, true);
+		qsc_rcs_set_associated(&state, vol->header, QSC_RCSVOL_HEADER_SIZE);
+		qsc_rcs_transform(&state, exp, plain, QSC_RCSVOL_SECTOR_SIZE);
+		qsc_rcs_dispose(&state);
+		qsc_rcs_key_dispose(&ekey);
+
+		if (qsctest_file_read(RCSVOL_TEST_PATH, vol->dataoffset + (sector * QSC_RCSVOL_SECTOR_SIZE), pct, QSC_RCSVOL_SECTOR_SIZE) == true &&
+			qsctest_file_read(RCSVOL_TEST_PATH, vol->metaoffset + (sector * vol->entrysize), ent, vol->entrysize) == true)
+		{
+			res = (qsc_intutils_are_equal8(pct, exp, QSC_RCSVOL_SECTOR_SIZE) == true &&
+				qsc_intutils_le8to64(ent) == counter &&
+				(vol->maclen == 0 || qsc_intutils_are_equal8(ent + RCSVOL_TEST_COUNTER, exp + QSC_RCSVOL_SECTOR_SIZE, vol->maclen) == true));
+		}
+
+		qsc_memutils_alloc_free(pct);
+	}
+
+	return res;
+}
+
+static bool rcsvol_equality(size_t keylen)
+{
+	/* runs shorter than, equal to, and longer than a batch, and a list in random order */
+	const uint64_t RUNS[][2] = { { 0, 1 }, { 5, 7 }, { 20, 64 }, { 100, 130 }, { 300, 1 }, { 100, 20 } };
+	const uint64_t WLIST[] = { 511, 3, 257, 4, 256 };
+	const uint64_t RLIST[] = { 257, 511, 0, 400, 101, 3 };
+	const uint64_t DLIST[] = { 450, 200, 450 };
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	qsc_rcsvol_state vol;
+	uint8_t* model;
+	uint8_t* pdat;
+	uint8_t* buf;
+	size_t i;
+	bool status;
+
+	status = false;
+	qsc_csp_generate(key, sizeof(key));
+	model = (uint8_t*)qsc_memutils_malloc(RCSVOL_TEST_SECTORS * QSC_RCSVOL_SECTOR_SIZE);
+	buf = (uint8_t*)qsc_memutils_malloc(RCSVOL_TEST_SECTORS * QSC_RCSVOL_SECTOR_SIZE);
+
+	if (model != NULL && buf != NULL && qsc_rcsvol_create(&vol, RCSVOL_TEST_PATH, key, keylen, RCSVOL_TEST_SECTORS) == qsc_rcsvol_status_success)
+	{
+		status = true;
+		qsc_memutils_clear(model, RCSVOL_TEST_SECTORS * QSC_RCSVOL_SECTOR_SIZE);
+
+		for (i = 0; i < sizeof(RUNS) / sizeof(RUNS[0]); ++i)
+		{
+			pdat = model + (RUNS[i][0] * QSC_RCSVOL_SECTOR_SIZE);
+			qsc_csp_generate(pdat, (size_t)RUNS[i][1] * QSC_RCSVOL_SECTOR_SIZE);
+
+			if (qsc_rcsvol_write(&vol, RUNS[i][0], pdat, (size_t)RUNS[i][1]) != qsc_rcsvol_status_success)
+			{
+				qsctest_print_safe("Failure! rcsvol_equality: a run was not written -VE1 \n");
+				status = false;
+			}
+		}
+
+		for (i = 0; i < sizeof(WLIST) / sizeof(WLIST[0]); ++i)
+		{
+			qsc_csp_generate(buf + (i * QSC_RCSVOL_SECTOR_SIZE), QSC_RCSVOL_SECTOR_SIZE);
+			qsc_memutils_copy(model + (WLIST[i] * QSC_RCSVOL_SECTOR_SIZE), buf + (i * QSC_RCSVOL_SECTOR_SIZE), QSC_RCSVOL_SECTOR_SIZE);
+		}
+
+		if (qsc_rcsvol_write_list(&vol, WLIST, buf, sizeof(WLIST) / sizeof(WLIST[0])) != qsc_rcsvol_status_success)
+		{
+			qsctest_print_safe("Failure! rcsvol_equality: a list was not written -VE2 \n");
+			status = false;
+		}
+
+		/* a sector listed twice is written twice, and holds the last write */
+		for (i = 0; i < sizeof(DLIST) / sizeof(DLIST[0]); ++i)
+		{
+			qsc_csp_generate(buf + (i * QSC_RCSVOL_SECTOR_SIZE), QSC_RCSVOL_SECTOR_SIZE);
+			qsc_memutils_copy(model + (DLIST[i] * QSC_RCSVOL_SECTOR_SIZE), buf + (i * QSC_RCSVOL_SECTOR_SIZE), QSC_RCSVOL_SECTOR_SIZE);
+		}
+
+		if (qsc_rcsvol_write_list(&vol, DLIST, buf, sizeof(DLIST) / sizeof(DLIST[0])) != qsc_rcsvol_status_success ||
+			rcsvol_sector_compare(&vol, key, keylen, 450, 2, model + (450 * QSC_RCSVOL_SECTOR_SIZE)) == false)
+		{
+			qsctest_print_safe("Failure! rcsvol_equality: a repeated sector did not take a new write counter -VE9 \n");
+			status = false;
+		}
+
+		/* the whole volume in one run, with the unwritten sectors as zeros */
+		if (qsc_rcsvol_read(&vol, 0, buf, RCSVOL_TEST_SECTORS) != qsc_rcsvol_status_success ||
+			qsc_intutils_are_equal8(buf, model, RCSVOL_TEST_SECTORS * QSC_RCSVOL_SECTOR_SIZE) == false)
+		{
+			qsctest_print_safe("Failure! rcsvol_equality: the volume does not match -VE3 \n");
+			status = false;
+		}
+
+		if (qsc_rcsvol_read_list(&vol, RLIST, buf, sizeof(RLIST) / sizeof(RLIST[0])) != qsc_rcsvol_status_success)
+		{
+			qsctest_print_safe("Failure! rcsvol_equality: a list was not read -VE4 \n");
+			status = false;
+		}
+
+		for (i = 0; i < sizeof(RLIST) / sizeof(RLIST[0]); ++i)
+		{
+			if (qsc_intutils_are_equal8(buf + (i * QSC_RCSVOL_SECTOR_SIZE), model + (RLIST[i] * QSC_RCSVOL_SECTOR_SIZE), QSC_RCSVOL_SECTOR_SIZE) == false)
+			{
+				qsctest_print_safe("Failure! rcsvol_equality: a listed sector does not match -VE5 \n");
+				status = false;
+			}
+		}
+
+		/* sector 300 was written once, and sector 100 twice */
+		if (rcsvol_sector_compare(&vol, key, keylen, 300, 1, model + (300 * QSC_RCSVOL_SECTOR_SIZE)) == false ||
+			rcsvol_sector_compare(&vol, key, keylen, 100, 2, model + (100 * QSC_RCSVOL_SECTOR_SIZE)) == false)
+		{
+			qsctest_print_safe("Failure! rcsvol_equality: a stored sector does not match the transform -VE6 \n");
+			status = false;
+		}
+
+		qsc_rcsvol_dispose(&vol);
+
+		if (qsc_rcsvol_open(&vol, RCSVOL_TEST_PATH, key, keylen) != qsc_rcsvol_status_success ||
+			qsc_rcsvol_sectors(&vol) != RCSVOL_TEST_SECTORS ||
+			qsc_rcsvol_read(&vol, 0, buf, RCSVOL_TEST_SECTORS) != qsc_rcsvol_status_success ||
+			qsc_intutils_are_equal8(buf, model, RCSVOL_TEST_SECTORS * QSC_RCSVOL_SECTOR_SIZE) == false)
+		{
+			qsctest_print_safe("Failure! rcsvol_equality: the reopened volume does not match -VE7 \n");
+			status = false;
+		}
+
+		qsc_rcsvol_dispose(&vol);
+	}
+	else
+	{
+		qsctest_print_safe("Failure! rcsvol_equality: the volume could not be created -VE8 \n");
+	}
+
+	remove(RCSVOL_TEST_PATH);
+
+	if (model != NULL)
+	{
+		qsc_memutils_alloc_free(model);
+	}
+
+	if (buf != NULL)
+	{
+		qsc_memutils_alloc_free(buf);
+	}
+
+	return status;
+}
+
+static bool rcsvol_authentication(size_t keylen)
+{
+	const size_t WCNT = 8;
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t bkey[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t ent[RCSVOL_TEST_COUNTER + QSC_RCS512_MAC_SIZE] = { 0 };
+	uint8_t hsec[QSC_RCSVOL_SECTOR_SIZE] = { 0 };
+	uint64_t list[1] = { RCSVOL_TEST_SECTORS };
+	qsc_rcsvol_state vol;
+	uint64_t metaoft;
+	uint64_t dataoft;
+	size_t entsize;
+	uint8_t* model;
+	uint8_t* buf;
+	uint8_t* raw;
+	FILE* fp;
+	size_t i;
+	bool status;
+
+	status = false;
+	qsc_csp_generate(key, sizeof(key));
+	qsc_memutils_copy(bkey, key, sizeof(bkey));
+	bkey[0] ^= 0x01U;
+	model = (uint8_t*)qsc_memutils_malloc(WCNT * QSC_RCSVOL_SECTOR_SIZE);
+	buf = (uint8_t*)qsc_memutils_malloc(WCNT * QSC_RCSVOL_SECTOR_SIZE);
+	raw = (uint8_t*)qsc_memutils_malloc(2 * QSC_RCSVOL_SECTOR_SIZE);
+
+	if (model != NULL && buf != NULL && raw != NULL && qsc_rcsvol_create(&vol, RCSVOL_TEST_PATH, key, keylen, RCSVOL_TEST_SECTORS) == qsc_rcsvol_status_success)
+	{
+		status = true;
+		metaoft = vol.metaoffset;
+		dataoft = vol.dataoffset;
+		entsize = vol.entrysize;
+		qsc_csp_generate(model, WCNT * QSC_RCSVOL_SECTOR_SIZE);
+		qsc_rcsvol_write(&vol, 0, model, WCNT);
+
+		/* a rewrite of the same data takes a new nonce */
+		qsctest_file_read(RCSVOL_TEST_PATH, dataoft + (7 * QSC_RCSVOL_SECTOR_SIZE), raw, QSC_RCSVOL_SECTOR_SIZE);
+		qsc_rcsvol_write(&vol, 7, model + (7 * QSC_RCSVOL_SECTOR_SIZE), 1);
+		qsctest_file_read(RCSVOL_TEST_PATH, dataoft + (7 * QSC_RCSVOL_SECTOR_SIZE), raw + QSC_RCSVOL_SECTOR_SIZE, QSC_RCSVOL_SECTOR_SIZE);
+
+		if (qsc_intutils_are_equal8(raw, raw + QSC_RCSVOL_SECTOR_SIZE, QSC_RCSVOL_SECTOR_SIZE) == true)
+		{
+			qsctest_print_safe("Failure! rcsvol_authentication: a rewritten sector repeated its cipher-text -VA1 \n");
+			status = false;
+		}
+
+		if (qsc_rcsvol_read(&vol, RCSVOL_TEST_SECTORS - 1, buf, 2) != qsc_rcsvol_status_invalid_parameter ||
+			qsc_rcsvol_write(&vol, RCSVOL_TEST_SECTORS, model, 1) != qsc_rcsvol_status_invalid_parameter ||
+			qsc_rcsvol_read_list(&vol, list, buf, 1) != qsc_rcsvol_status_invalid_parameter)
+		{
+			qsctest_print_safe("Failure! rcsvol_authentication: a sector outside the volume was accepted -VA2 \n");
+			status = false;
+		}
+
+		qsc_rcsvol_dispose(&vol);
+
+		/* a cleared metadata entry, a modified sector, a modified MAC code, a sector moved with its metadata, and a modified write counter */
+		qsc_memutils_clear(ent, sizeof(ent));
+		qsctest_file_write(RCSVOL_TEST_PATH, metaoft + (1 * entsize), ent, entsize);
+		qsctest_file_flip(RCSVOL_TEST_PATH, dataoft + (2 * QSC_RCSVOL_SECTOR_SIZE) + 100);
+		qsctest_file_flip(RCSVOL_TEST_PATH, metaoft + (3 * entsize) + entsize - 1);
+		qsctest_file_read(RCSVOL_TEST_PATH, dataoft + (4 * QSC_RCSVOL_SECTOR_SIZE), raw, QSC_RCSVOL_SECTOR_SIZE);
+		qsctest_file_write(RCSVOL_TEST_PATH, dataoft + (5 * QSC_RCSVOL_SECTOR_SIZE), raw, QSC_RCSVOL_SECTOR_SIZE);
+		qsctest_file_read(RCSVOL_TEST_PATH, metaoft + (4 * entsize), ent, entsize);
+		qsctest_file_write(RCSVOL_TEST_PATH, metaoft + (5 * entsize), ent, entsize);
+		qsctest_file_flip(RCSVOL_TEST_PATH, metaoft + (6 * entsize));
+
+		if (qsc_rcsvol_open(&vol, RCSVOL_TEST_PATH, key, keylen) == qsc_rcsvol_status_success)
+		{
+			if (qsc_rcsvol_read(&vol, 0, buf, WCNT) != qsc_rcsvol_status_authentication_failure)
+			{
+				qsctest_print_safe("Failure! rcsvol_authentication: a modified volume was accepted -VA3 \n");
+				status = false;
+			}
+
+			for (i = 0; i < WCNT; ++i)
+			{
+				const uint8_t* pexp = (i == 1 || i == 2 || i == 3 || i == 5 || i == 6) ? hsec : model + (i * QSC_RCSVOL_SECTOR_SIZE);
+
+				/* the failed sectors are cleared, and the others are intact */
+				if (qsc_intutils_are_equal8(buf + (i * QSC_RCSVOL_SECTOR_SIZE), pexp, QSC_RCSVOL_SECTOR_SIZE) == false)
+				{
+					qsctest_print_safe("Failure! rcsvol_authentication: a sector was not isolated -VA4 \n");
+					status = false;
+				}
+			}
+
+			/* a written sector can not be erased by clearing its metadata entry */
+			if (qsc_rcsvol_read(&vol, 1, buf, 1) != qsc_rcsvol_status_authentication_failure)
+			{
+				qsctest_print_safe("Failure! rcsvol_authentication: a cleared metadata entry was accepted -VA9 \n");
+				status = false;
+			}
+
+			qsc_rcsvol_dispose(&vol);
+		}
+		else
+		{
+			status = false;
+		}
+
+		if (qsc_rcsvol_open(&vol, RCSVOL_TEST_PATH, bkey, keylen) != qsc_rcsvol_status_success ||
+			qsc_rcsvol_read(&vol, 0, buf, 1) != qsc_rcsvol_status_authentication_failure)
+		{
+			qsctest_print_safe("Failure! rcsvol_authentication: the wrong key was accepted -VA5 \n");
+			status = false;
+		}
+
+		qsc_rcsvol_dispose(&vol);
+
+		if (qsc_rcsvol_open(&vol, RCSVOL_TEST_PATH, key, (keylen == QSC_RCS256_KEY_SIZE) ? QSC_RCS512_KEY_SIZE : QSC_RCS256_KEY_SIZE) != qsc_rcsvol_status_invalid_format)
+		{
+			qsctest_print_safe("Failure! rcsvol_authentication: the wrong cipher type was accepted -VA6 \n");
+			status = false;
+		}
+
+		/* a file holding only the header sector */
+		qsctest_file_read(RCSVOL_TEST_PATH, 0, hsec, sizeof(hsec));
+		fp = fopen(RCSVOL_TEST_SHORT, "wb");
+
+		if (fp != NULL)
+		{
+			fwrite(hsec, 1, sizeof(hsec), fp);
+			fclose(fp);
+
+			if (qsc_rcsvol_open(&vol, RCSVOL_TEST_SHORT, key, keylen) != qsc_rcsvol_status_invalid_format)
+			{
+				qsctest_print_safe("Failure! rcsvol_authentication: a truncated volume was accepted -VA7 \n");
+				status = false;
+			}
+
+			remove(RCSVOL_TEST_SHORT);
+		}
+	}
+	else
+	{
+		qsctest_print_safe("Failure! rcsvol_authentication: the volume could not be created -VA8 \n");
+	}
+
+	remove(RCSVOL_TEST_PATH);
+
+	if (model != NULL)
+	{
+		qsc_memutils_alloc_free(model);
+	}
+
+	if (buf != NULL)
+	{
+		qsc_memutils_alloc_free(buf);
+	}
+
+	if (raw != NULL)
+	{
+		qsc_memutils_alloc_free(raw);
+	}
+
+	return status;
+}
+
+#if defined(QSC_SYSTEM_OS_POSIX)
+static qsc_rcsvol_status rcsvol_write_limited(qsc_rcsvol_state* vol, uint64_t sector, const uint8_t* input, uint64_t limit)
+{
+	/* the file size limit fails every write at or above the limit offset, as a full or failing device would */
+	struct rlimit prev;
+	struct rlimit lim;
+	void (*phnd)(int);
+	qsc_rcsvol_status res;
+
+	res = qsc_rcsvol_status_invalid_parameter;
+
+	if (getrlimit(RLIMIT_FSIZE, &prev) == 0)
+	{
+		lim = prev;
+		lim.rlim_cur = (rlim_t)limit;
+		phnd = signal(SIGXFSZ, SIG_IGN);
+
+		if (setrlimit(RLIMIT_FSIZE, &lim) == 0)
+		{
+			res = qsc_rcsvol_write(vol, sector, input, 1);
+			setrlimit(RLIMIT_FSIZE, &prev);
+		}
+
+		signal(SIGXFSZ, phnd);
+	}
+
+	return res;
+}
+
+static bool rcsvol_write_failure(size_t keylen)
+{
+	const uint64_t SECT = 9;
+	uint8_t key[QSC_RCS512_KEY_SIZE] = { 0 };
+	uint8_t ent[RCSVOL_TEST_COUNTER + QSC_RCS512_MAC_SIZE] = { 0 };
+	qsc_rcsvol_state vol;
+	uint8_t* model;
+	uint8_t* buf;
+	uint8_t* raw;
+	size_t i;
+	bool status;
+
+	status = false;
+	qsc_csp_generate(key, sizeof(key));
+	model = (uint8_t*)qsc_memutils_malloc(2 * QSC_RCSVOL_SECTOR_SIZE);
+	buf = (uint8_t*)qsc_memutils_malloc(QSC_RCSVOL_SECTOR_SIZE);
+	raw = (uint8_t*)qsc_memutils_malloc(2 * QSC_RCSVOL_SECTOR_SIZE);
+
+	if (model != NULL && buf != NULL && raw != NULL && qsc_rcsvol_create(&vol, RCSVOL_TEST_PATH, key, keylen, RCSVOL_TEST_SECTORS) == qsc_rcsvol_status_success)
+	{
+		status = true;
+		qsc_csp_generate(model, 2 * QSC_RCSVOL_SECTOR_SIZE);
+		qsc_rcsvol_write(&vol, SECT, model, 1);
+		qsctest_file_read(RCSVOL_TEST_PATH, vol.dataoffset + (SECT * QSC_RCSVOL_SECTOR_SIZE), raw, QSC_RCSVOL_SECTOR_SIZE);
+
+		/* a failed counter write stops the write before the data, and leaves the sector intact */
+		if (rcsvol_write_limited(&vol, SECT, model + QSC_RCSVOL_SECTOR_SIZE, vol.metaoffset) != qsc_rcsvol_status_write_failure ||
+			qsc_rcsvol_read(&vol, SECT, buf, 1) != qsc_rcsvol_status_success ||
+			qsc_intutils_are_equal8(buf, model, QSC_RCSVOL_SECTOR_SIZE) == false)
+		{
+			qsctest_print_safe("Failure! rcsvol_write_failure: a failed counter write changed the sector -VW1 \n");
+			status = false;
+		}
+
+		/* a failed data write leaves the counter it used stored, so the retry takes the next one */
+		if (rcsvol_write_limited(&vol, SECT, model + QSC_RCSVOL_SECTOR_SIZE, vol.dataoffset) != qsc_rcsvol_status_write_failure ||
+			qsctest_file_read(RCSVOL_TEST_PATH, vol.metaoffset + (SECT * vol.entrysize), ent, vol.entrysize) == false ||
+			qsc_intutils_le8to64(ent) != 2)
+		{
+			qsctest_print_safe("Failure! rcsvol_write_failure: the counter was not stored before the data -VW2 \n");
+			status = false;
+		}
+
+#if defined(QSC_RCS_AUTHENTICATED)
+		if (qsc_rcsvol_read(&vol, SECT, buf, 1) != qsc_rcsvol_status_authentication_failure)
+		{
+			qsctest_print_safe("Failure! rcsvol_write_failure: a failed write was accepted -VW3 \n");
+			status = false;
+		}
+#endif
+
+		/* the retry uses a new keystream, and the sector reads back */
+		if (qsc_rcsvol_write(&vol, SECT, model + QSC_RCSVOL_SECTOR_SIZE, 1) != qsc_rcsvol_status_success ||
+			rcsvol_sector_compare(&vol, key, keylen, SECT, 3, model + QSC_RCSVOL_SECTOR_SIZE) == false ||
+			qsc_rcsvol_read(&vol, SECT, buf, 1) != qsc_rcsvol_status_success ||
+			qsc_intutils_are_equal8(buf, model + QSC_RCSVOL_SECTOR_SIZE, QSC_RCSVOL_SECTOR_SIZE) == false)
+		{
+			qsctest_print_safe("Failure! rcsvol_write_failure: the retry was not written -VW4 \n");
+			status = false;
+		}
+
+		qsctest_file_read(RCSVOL_TEST_PATH, vol.dataoffset + (SECT * QSC_RCSVOL_SECTOR_SIZE), raw + QSC_RCSVOL_SECTOR_SIZE, QSC_RCSVOL_SECTOR_SIZE);
+
+		for (i = 0; i < QSC_RCSVOL_SECTOR_SIZE; ++i)
+		{
+			raw[i] ^= model[i];
+			raw[QSC_RCSVOL_SECTOR_SIZE + i] ^= model[QSC_RCSVOL_SECTOR_SIZE + i];
+		}
+
+		if (qsc_intutils_are_equal8(raw, raw + QSC_RCSVOL_SECTOR_SIZE, QSC_RCSVOL_SECTOR_SIZE) == true)
+		{
+			qsctest_print_safe("Failure! rcsvol_write_failure: the retry repeated the keystream -VW5 \n");
+			status = false;
+		}
+
+		qsc_rcsvol_dispose(&vol);
+	}
+	else
+	{
+		qsctest_print_safe("Failure! rcsvol_write_failure: the volume could not be created -VW6 \n");
+	}
+
+	remove(RCSVOL_TEST_PATH);
+
+	if (model != NULL)
+	{
+		qsc_memutils_alloc_free(model);
+	}
+
+	if (buf != NULL)
+	{
+		qsc_memutils_alloc_free(buf);
+	}
+
+	if (raw != NULL)
+	{
+		qsc_memutils_alloc_free(raw);
+	}
+
+	return status;
+}
+#endif
+
+bool qsctest_rcsvol_equality()
+{
+	bool status;
+
+	status = rcsvol_equality(QSC_RCS256_KEY_SIZE);
+
+	if (rcsvol_equality(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+
+	return status;
+}
+
+bool qsctest_rcsvol_authentication_failure()
+{
+	bool status;
+
+#if defined(QSC_RCS_AUTHENTICATED)
+	status = rcsvol_authentication(QSC_RCS256_KEY_SIZE);
+
+	if (rcsvol_authentication(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+bool qsctest_rcsvol_write_failure()
+{
+	bool status;
+
+#if defined(QSC_SYSTEM_OS_POSIX)
+	status = rcsvol_write_failure(QSC_RCS256_KEY_SIZE);
+
+	if (rcsvol_write_failure(QSC_RCS512_KEY_SIZE) == false)
+	{
+		status = false;
+	}
+#else
+	status = true;
+#endif
+
+	return status;
+}
+
+void qsctest_rcsvol_run()
+{
+	if (qsctest_rcsvol_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS sector volume equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS sector volume equality test. \n");
+	}
+
+	if (qsctest_rcsvol_authentication_failure() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS sector volume authentication failure test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS sector volume authentication failure test. \n");
+	}
+
+	if (qsctest_rcsvol_write_failure() == true)
+	{
+		qsctest_print_safe("Success! Passed the RCS sector volume write failure test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the RCS sector volume write failure test. \n");
+	}
+}
@@ -0,0 +1,44 @@
+/**
+* \file rcsvol_test.h
+* \brief <b>RCS Sector Volume Tests</b> \n
+* Random-access round trip and tamper tests for the sector-addressed volume, on a temporary file.
+* \author John Underhill
+* \date October 02, 2020
+*/
+
+#ifndef QSCTEST_RCSVOL_TEST_H
+#define QSCTEST_RCSVOL_TEST_H
+
+#include "common.h"
+#include "rcsvol.h"
+
+/**
+* \brief Tests runs and lists of sector writes and reads, a list with a repeated sector, rewrites, unwritten sectors, and a reopened volume,
+* and compares a stored sector with the single-stream transform.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsvol_equality();
+
+/**
+* \brief Tests that modified sectors, modified, moved, and cleared metadata, the wrong key, a truncated file,
+* and sectors outside the volume are rejected, and that a rewritten sector uses a new nonce.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsvol_authentication_failure();
+
+/**
+* \brief Tests that a write whose counter or data write fails does not repeat a keystream when it is retried;
+* the failures are made with the file size limit, so the test runs on POSIX systems.
+*
+* \return Returns true for success
+*/
+bool qsctest_rcsvol_write_failure();
+
+/**
+* \brief Run all tests.
+*/
+void qsctest_rcsvol_run();
+
+#endif
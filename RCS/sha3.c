@@ -1,4 +1,6 @@
 #include "sha3.h"
+#include "async.h"
+#include "cpuidex.h"
 #include "intutils.h"
 #include "memutils.h"
 
@@ -81,9 +83,10 @@ static size_t keccak_right_encode(uint8_t* buffer, size_t value)
 	return n + 1;
 }
 
-#if defined(QSC_SYSTEM_HAS_AVX512)
+#if defined(QSC_SYSTEM_HAS_AVX512) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
 #	if defined(QSC_KECCAK_UNROLLED_PERMUTATION)
 
+QSC_SYSTEM_TARGET("avx512f")
 void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
 {
 	assert(rounds % 2 == 0);
@@ -383,6 +386,7 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 
 #	else
 
+QSC_SYSTEM_TARGET("avx512f")
 void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
 {
 	assert(rounds % 2 == 0);
@@ -586,9 +590,10 @@ void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rou
 #	endif
 #endif
 
-#if defined(QSC_SYSTEM_HAS_AVX2)
+#if defined(QSC_SYSTEM_HAS_AVX2) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
 #	if defined(QSC_KECCAK_UNROLLED_PERMUTATION)
 
+QSC_SYSTEM_TARGET("avx2")
 void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
 {
 	assert(rounds % 2 == 0);
@@ -890,6 +895,7 @@ void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rou
 
 #	else
 
+QSC_SYSTEM_TARGET("avx2")
 void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds)
 {
 	assert(rounds % 2 == 0);
@@ -1262,6 +1268,16 @@ void qsc_keccak_absorb_key_custom(qsc_keccak_state* ctx, qsc_keccak_rate rate, c
 	qsc_keccak_permute(ctx, rounds);
 }
 
+void qsc_keccak_clone(qsc_keccak_state* output, const qsc_keccak_state* input)
+{
+	assert(output != NULL);
+	assert(input != NULL);
+
+	qsc_memutils_copy((uint8_t*)output->state, (const uint8_t*)input->state, sizeof(output->state));
+	qsc_memutils_copy(output->buffer, input->buffer, sizeof(output->buffer));
+	output->position = input->position;
+}
+
 void qsc_keccak_dispose(qsc_keccak_state* ctx)
 {
 	assert(ctx != NULL);
@@ -1481,17 +1497,161 @@ void qsc_keccak_incremental_squeeze(qsc_keccak_state* ctx, size_t rate, uint8_t*
 	}
 }
 
+#if defined(QSC_SYSTEM_HAS_AVX512) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+
+QSC_SYSTEM_TARGET("avx512f")
+static void keccak_permute_p1600v(uint64_t* state, size_t rounds)
+{
+	/* each plane of five lanes is held in one register, the lane indices select x-1, x+1 and x+2 */
+	const __m512i MOVEM1 = _mm512_set_epi64(7, 6, 5, 3, 2, 1, 0, 4);
+	const __m512i MOVEP1 = _mm512_set_epi64(7, 6, 5, 0, 4, 3, 2, 1);
+	const __m512i MOVEP2 = _mm512_set_epi64(7, 6, 5, 1, 0, 4, 3, 2);
+	const __m512i RHO0 = _mm512_set_epi64(0, 0, 0, 27, 28, 62, 1, 0);
+	const __m512i RHO1 = _mm512_set_epi64(0, 0, 0, 20, 55, 6, 44, 36);
+	const __m512i RHO2 = _mm512_set_epi64(0, 0, 0, 39, 25, 43, 10, 3);
+	const __m512i RHO3 = _mm512_set_epi64(0, 0, 0, 8, 21, 15, 45, 41);
+	const __m512i RHO4 = _mm512_set_epi64(0, 0, 0, 14, 56, 61, 2, 18);
+	/* pi: lane x of output plane y is lane (x + 3y) mod 5 of input plane x */
+	const __m512i PI0 = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+	const __m512i PI1 = _mm512_set_epi64(7, 6, 5, 2, 1, 0, 4, 3);
+	const __m512i PI2 = _mm512_set_epi64(7, 6, 5, 0, 4, 3, 2, 1);
+	const __m512i PI3 = _mm512_set_epi64(7, 6, 5, 3, 2, 1, 0, 4);
+	const __m512i PI4 = _mm512_set_epi64(7, 6, 5, 1, 0, 4, 3, 2);
+	const __mmask8 LMASK = 0x1F;
+	__m512i a0;
+	__m512i a1;
+	__m512i a2;
+	__m512i a3;
+	__m512i a4;
+	__m512i b0;
+	__m512i b1;
+	__m512i b2;
+	__m512i b3;
+	__m512i b4;
+	__m512i c;
+	__m512i d;
+
+	a0 = _mm512_maskz_loadu_epi64(LMASK, state);
+	a1 = _mm512_maskz_loadu_epi64(LMASK, state + 5);
+	a2 = _mm512_maskz_loadu_epi64(LMASK, state + 10);
+	a3 = _mm512_maskz_loadu_epi64(LMASK, state + 15);
+	a4 = _mm512_maskz_loadu_epi64(LMASK, state + 20);
+
+	for (size_t i = 0; i < rounds; ++i)
+	{
+		/* theta */
+		c = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a0, a1, a2, 0x96), a3, a4, 0x96);
+		d = _mm512_xor_si512(_mm512_permutexvar_epi64(MOVEM1, c), _mm512_rol_epi64(_mm512_permutexvar_epi64(MOVEP1, c), 1));
+
+		/* rho */
+		a0 = _mm512_rolv_epi64(_mm512_xor_si512(a0, d), RHO0);
+		a1 = _mm512_rolv_epi64(_mm512_xor_si512(a1, d), RHO1);
+		a2 = _mm512_rolv_epi64(_mm512_xor_si512(a2, d), RHO2);
+		a3 = _mm512_rolv_epi64(_mm512_xor_si512(a3, d), RHO3);
+		a4 = _mm512_rolv_epi64(_mm512_xor_si512(a4, d), RHO4);
+
+		/* pi */
+		b0 = _mm512_maskz_permutexvar_epi64(0x01, PI0, a0);
+		b0 = _mm512_mask_permutexvar_epi64(b0, 0x02, PI0, a1);
+		b0 = _mm512_mask_permutexvar_epi64(b0, 0x04, PI0, a2);
+		b0 = _mm512_mask_permutexvar_epi64(b0, 0x08, PI0, a3);
+		b0 = _mm512_mask_permutexvar_epi64(b0, 0x10, PI0, a4);
+		b1 = _mm512_maskz_permutexvar_epi64(0x01, PI1, a0);
+		b1 = _mm512_mask_permutexvar_epi64(b1, 0x02, PI1, a1);
+		b1 = _mm512_mask_permutexvar_epi64(b1, 0x04, PI1, a2);
+		b1 = _mm512_mask_permutexvar_epi64(b1, 0x08, PI1, a3);
+		b1 = _mm512_mask_permutexvar_epi64(b1, 0x10, PI1, a4);
+		b2 = _mm512_maskz_permutexvar_epi64(0x01, PI2, a0);
+		b2 = _mm512_mask_permutexvar_epi64(b2, 0x02, PI2, a1);
+		b2 = _mm512_mask_permutexvar_epi64(b2, 0x04, PI2, a2);
+		b2 = _mm512_mask_permutexvar_epi64(b2, 0x08, PI2, a3);
+		b2 = _mm512_mask_permutexvar_epi64(b2, 0x10, PI2, a4);
+		b3 = _mm512_maskz_permutexvar_epi64(0x01, PI3, a0);
+		b3 = _mm512_mask_permutexvar_epi64(b3, 0x02, PI3, a1);
+		b3 = _mm512_mask_permutexvar_epi64(b3, 0x04, PI3, a2);
+		b3 = _mm512_mask_permutexvar_epi64(b3, 0x08, PI3, a3);
+		b3 = _mm512_mask_permutexvar_epi64(b3, 0x10, PI3, a4);
+		b4 = _mm512_maskz_permutexvar_epi64(0x01, PI4, a0);
+		b4 = _mm512_mask_permutexvar_epi64(b4, 0x02, PI4, a1);
+		b4 = _mm512_mask_permutexvar_epi64(b4, 0x04, PI4, a2);
+		b4 = _mm512_mask_permutexvar_epi64(b4, 0x08, PI4, a3);
+		b4 = _mm512_mask_permutexvar_epi64(b4, 0x10, PI4, a4);
+
+		/* chi */
+		a0 = _mm512_ternarylogic_epi64(b0, _mm512_permutexvar_epi64(MOVEP1, b0), _mm512_permutexvar_epi64(MOVEP2, b0), 0xD2);
+		a1 = _mm512_ternarylogic_epi64(b1, _mm512_permutexvar_epi64(MOVEP1, b1), _mm512_permutexvar_epi64(MOVEP2, b1), 0xD2);
+		a2 = _mm512_ternarylogic_epi64(b2, _mm512_permutexvar_epi64(MOVEP1, b2), _mm512_permutexvar_epi64(MOVEP2, b2), 0xD2);
+		a3 = _mm512_ternarylogic_epi64(b3, _mm512_permutexvar_epi64(MOVEP1, b3), _mm512_permutexvar_epi64(MOVEP2, b3), 0xD2);
+		a4 = _mm512_ternarylogic_epi64(b4, _mm512_permutexvar_epi64(MOVEP1, b4), _mm512_permutexvar_epi64(MOVEP2, b4), 0xD2);
+
+		/* iota */
+		a0 = _mm512_mask_xor_epi64(a0, 0x01, a0, _mm512_set1_epi64((int64_t)KECCAK_ROUND_CONSTANTS[i]));
+	}
+
+	_mm512_mask_storeu_epi64(state, LMASK, a0);
+	_mm512_mask_storeu_epi64(state + 5, LMASK, a1);
+	_mm512_mask_storeu_epi64(state + 10, LMASK, a2);
+	_mm512_mask_storeu_epi64(state + 15, LMASK, a3);
+	_mm512_mask_storeu_epi64(state + 20, LMASK, a4);
+}
+
+#endif
+
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH) || !defined(QSC_SYSTEM_HAS_AVX512)
+
+static void keccak_permute_p1600s(uint64_t* state, size_t rounds)
+{
+#if defined(QSC_KECCAK_UNROLLED_PERMUTATION)
+	if (rounds == QSC_KECCAK_PERMUTATION_ROUNDS)
+	{
+		qsc_keccak_permute_p1600u(state);
+	}
+	else
+	{
+		qsc_keccak_permute_p1600c(state, rounds);
+	}
+#else
+	qsc_keccak_permute_p1600c(state, rounds);
+#endif
+}
+
+#endif
+
+typedef void (*keccak_permute_kernel)(uint64_t* state, size_t rounds);
+
+static keccak_permute_kernel keccak_permute_select()
+{
+#if defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+	static keccak_permute_kernel kernel = NULL;
+	keccak_permute_kernel pknl;
+
+	pknl = (keccak_permute_kernel)QSC_ASYNC_POINTER_LOAD(&kernel);
+
+	if (pknl == NULL)
+	{
+		const qsc_cpuidex_cpu_features* pfeat;
+
+		/* racing initializers select the same kernel, the pointer is published with release ordering */
+		pfeat = qsc_cpuidex_dispatch_features();
+		pknl = (pfeat->avx512f == true) ? keccak_permute_p1600v : keccak_permute_p1600s;
+		QSC_ASYNC_POINTER_STORE(&kernel, pknl);
+	}
+
+	return pknl;
+#elif defined(QSC_SYSTEM_HAS_AVX512)
+	return keccak_permute_p1600v;
+#else
+	return keccak_permute_p1600s;
+#endif
+}
+
 void qsc_keccak_permute(qsc_keccak_state* ctx, size_t rounds)
 {
 	assert(ctx != NULL);
 
 	if (ctx != NULL)
 	{
-#if defined(QSC_KECCAK_UNROLLED_PERMUTATION)
-		qsc_keccak_permute_p1600u(ctx->state)
-#else
-		qsc_keccak_permute_p1600c(ctx->state, rounds);
-#endif
+		keccak_permute_select()(ctx->state, rounds);
 	}
 }
 
@@ -4455,6 +4615,23 @@ void qsc_kmac_initialize(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint
 	qsc_keccak_absorb_key_custom(ctx, rate, key, keylen, custom, custlen, name, sizeof(name), QSC_KECCAK_PERMUTATION_ROUNDS);
 }
 
+void qsc_kmac_export(qsc_keccak_state* keystate, qsc_keccak_rate rate, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen)
+{
+	assert(keystate != NULL);
+	assert(key != NULL);
+
+	qsc_keccak_initialize_state(keystate);
+	qsc_kmac_initialize(keystate, rate, key, keylen, custom, custlen);
+}
+
+void qsc_kmac_clone(qsc_keccak_state* ctx, const qsc_keccak_state* keystate)
+{
+	assert(ctx != NULL);
+	assert(keystate != NULL);
+
+	qsc_keccak_clone(ctx, keystate);
+}
+
 void qsc_kmac_update(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_t* message, size_t msglen)
 {
 	assert(ctx != NULL);
@@ -21,7 +21,7 @@
 #define QSC_SHA3_H
 
 #include "common.h"
-#if defined(QSC_SYSTEM_AVX_INTRINSICS)
+#if defined(QSC_SYSTEM_AVX_INTRINSICS) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
 #	include "intrinsics.h"
 #endif
 
@@ -293,6 +293,15 @@ QSC_EXPORT_API void qsc_keccak_absorb_custom(qsc_keccak_state* ctx, qsc_keccak_r
 */
 QSC_EXPORT_API void qsc_keccak_absorb_key_custom(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen, const uint8_t* name, size_t namelen, size_t rounds);
 
+/**
+* \brief Copy a Keccak state into another state.
+* Used to clone a keyed state template, so the key and customization string are absorbed only once.
+*
+* \param output: [struct] The destination Keccak state
+* \param input: [const][struct] The source Keccak state
+*/
+QSC_EXPORT_API void qsc_keccak_clone(qsc_keccak_state* output, const qsc_keccak_state* input);
+
 /**
 * \brief Dispose of the Keccak state.
 *
@@ -370,6 +379,30 @@ QSC_EXPORT_API void qsc_keccak_permute_p1600c(uint64_t* state, size_t rounds);
 */
 QSC_EXPORT_API void qsc_keccak_permute_p1600u(uint64_t* state);
 
+#if defined(QSC_SYSTEM_HAS_AVX2) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+/**
+* \brief The 4-way AVX2 Keccak permute function.
+* Internal function: Permutes four interleaved state arrays, lane i of each vector belongs to state i.
+* With runtime dispatch the function is compiled for AVX2 regardless of the compiler flags, and the caller checks the cpu.
+*
+* \param state: The interleaved state array; must be initialized
+* \param rounds: The number of permutation rounds, the default and maximum is 24
+*/
+QSC_EXPORT_API void qsc_keccak_permute_p4x1600(__m256i state[QSC_KECCAK_STATE_SIZE], size_t rounds);
+#endif
+
+#if defined(QSC_SYSTEM_HAS_AVX512) || defined(QSC_SYSTEM_RUNTIME_DISPATCH)
+/**
+* \brief The 8-way AVX-512 Keccak permute function.
+* Internal function: Permutes eight interleaved state arrays, lane i of each vector belongs to state i.
+* With runtime dispatch the function is compiled for AVX-512 regardless of the compiler flags, and the caller checks the cpu.
+*
+* \param state: The interleaved state array; must be initialized
+* \param rounds: The number of permutation rounds, the default and maximum is 24
+*/
+QSC_EXPORT_API void qsc_keccak_permute_p8x1600(__m512i state[QSC_KECCAK_STATE_SIZE], size_t rounds);
+#endif
+
 /**
 * \brief The Keccak squeeze function.
 *
@@ -735,6 +768,30 @@ QSC_EXPORT_API void qsc_kmac_finalize(qsc_keccak_state* ctx, qsc_keccak_rate rat
 */
 QSC_EXPORT_API void qsc_kmac_initialize(qsc_keccak_state* ctx, qsc_keccak_rate rate, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen);
 
+/**
+* \brief Export a keyed KMAC state template.
+* The state is reset, and the key and customization string are absorbed;
+* the template is not modified by later use, and can be cloned into a live state with qsc_kmac_clone.
+*
+* \param keystate: [struct] The keyed state template
+* \param rate: The rate of absorption in bytes
+* \param key: [const] The input key byte array
+* \param keylen: The number of key bytes to process
+* \param custom: [const] The customization string
+* \param custlen: The byte length of the customization string
+*/
+QSC_EXPORT_API void qsc_kmac_export(qsc_keccak_state* keystate, qsc_keccak_rate rate, const uint8_t* key, size_t keylen, const uint8_t* custom, size_t custlen);
+
+/**
+* \brief Initialize a KMAC instance from a keyed state template.
+* The result is identical to calling qsc_kmac_initialize with the key and customization string of the template,
+* without the key absorption permutations.
+*
+* \param ctx: [struct] A reference to the keccak state
+* \param keystate: [const][struct] The keyed state template created with qsc_kmac_export
+*/
+QSC_EXPORT_API void qsc_kmac_clone(qsc_keccak_state* ctx, const qsc_keccak_state* keystate);
+
 /* KPA - Keccak-based Parallel Authentication */
 
 #if defined(QSC_SYSTEM_HAS_AVX512) || defined(QSC_SYSTEM_HAS_AVX2)
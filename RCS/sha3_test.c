@@ -1096,6 +1096,68 @@ bool qsctest_kpa_512_kat()
 	return status;
 }
 
+bool qsctest_kmac_clone_equality()
+{
+	const qsc_keccak_rate rates[3] = { qsc_keccak_rate_128, qsc_keccak_rate_256, qsc_keccak_rate_512 };
+	uint8_t cst[15] = { 0 };
+	uint8_t key[64] = { 0 };
+	uint8_t msg[300] = { 0 };
+	uint8_t exp[64] = { 0 };
+	uint8_t otp[64] = { 0 };
+	qsc_keccak_state ctx;
+	qsc_keccak_state kstate;
+	size_t i;
+	bool status;
+
+	status = true;
+
+	for (i = 0; i < sizeof(key); ++i)
+	{
+		key[i] = (uint8_t)i;
+	}
+
+	for (i = 0; i < sizeof(cst); ++i)
+	{
+		cst[i] = (uint8_t)(0xA0U + i);
+	}
+
+	for (i = 0; i < sizeof(msg); ++i)
+	{
+		msg[i] = (uint8_t)(i * 7);
+	}
+
+	for (size_t r = 0; r < 3; ++r)
+	{
+		qsc_kmac_export(&kstate, rates[r], key, sizeof(key), cst, sizeof(cst));
+
+		/* every clone of the template must match a freshly keyed instance */
+		for (size_t j = 1; j <= 3; ++j)
+		{
+			const size_t MLEN = (j * 100) - 1;
+
+			qsc_keccak_initialize_state(&ctx);
+			qsc_kmac_initialize(&ctx, rates[r], key, sizeof(key), cst, sizeof(cst));
+			qsc_kmac_update(&ctx, rates[r], msg, MLEN);
+			qsc_kmac_finalize(&ctx, rates[r], exp, sizeof(exp));
+
+			qsc_kmac_clone(&ctx, &kstate);
+			qsc_kmac_update(&ctx, rates[r], msg, MLEN);
+			qsc_kmac_finalize(&ctx, rates[r], otp, sizeof(otp));
+
+			if (qsc_intutils_are_equal8(exp, otp, sizeof(exp)) == false)
+			{
+				qsctest_print_safe("Failure! qsctest_kmac_clone_equality: output does not match the keyed instance -KC1 \n");
+				status = false;
+			}
+		}
+	}
+
+	qsc_keccak_dispose(&ctx);
+	qsc_keccak_dispose(&kstate);
+
+	return status;
+}
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 bool qsctest_kmac128x4_equality()
 {
@@ -2281,6 +2343,15 @@ void qsctest_sha3_run()
 		qsctest_print_safe("Failure! Failed the KPA-512 KAT test. \n");
 	}
 
+	if (qsctest_kmac_clone_equality() == true)
+	{
+		qsctest_print_safe("Success! Passed the KMAC template clone equality test. \n");
+	}
+	else
+	{
+		qsctest_print_safe("Failure! Failed the KMAC template clone equality test. \n");
+	}
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 
 	if (qsctest_kmac128x4_equality() == true)
@@ -163,6 +163,13 @@ bool qsctest_kpa_256_kat(void);
 */
 bool qsctest_kpa_512_kat(void);
 
+/**
+* \brief Tests KMAC instances cloned from an exported key state for equality with freshly keyed instances.
+*
+* \return Returns true for success
+*/
+bool qsctest_kmac_clone_equality(void);
+
 #if defined(QSC_SYSTEM_HAS_AVX2)
 /**
 * \brief Tests the KMAC-128 AVX2 intrinsics implementation for equality with the sequential implementation.
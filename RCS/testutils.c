@@ -145,3 +145,53 @@ bool qsctest_test_confirm(const char* message)
 
 	return res;
 }
+
+bool qsctest_file_read(const char* path, uint64_t offset, uint8_t* output, size_t length)
+{
+	FILE* fp;
+	bool res;
+
+	res = false;
+	fp = fopen(path, "rb");
+
+	if (fp != NULL)
+	{
+		res = (fseek(fp, (long)offset, SEEK_SET) == 0 && fread(output, 1, length, fp) == length);
+		fclose(fp);
+	}
+
+	return res;
+}
+
+bool qsctest_file_write(const char* path, uint64_t offset, const uint8_t* input, size_t length)
+{
+	FILE* fp;
+	bool res;
+
+	res = false;
+	fp = fopen(path, "r+b");
+
+	if (fp != NULL)
+	{
+		res = (fseek(fp, (long)offset, SEEK_SET) == 0 && fwrite(input, 1, length, fp) == length);
+		fclose(fp);
+	}
+
+	return res;
+}
+
+bool qsctest_file_flip(const char* path, uint64_t offset)
+{
+	uint8_t bval[1] = { 0 };
+	bool res;
+
+	res = qsctest_file_read(path, offset, bval, sizeof(bval));
+
+	if (res == true)
+	{
+		bval[0] ^= 0x01U;
+		res = qsctest_file_write(path, offset, bval, sizeof(bval));
+	}
+
+	return res;
+}
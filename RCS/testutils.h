@@ -68,4 +68,35 @@ void qsctest_print_double(double digit);
 */
 bool qsctest_test_confirm(const char* message);
 
+/**
+* \brief Read an array from a file position, bypassing the file format under test
+*
+* \param path: the full path to the file
+* \param offset: the file position of the first byte
+* \param output: the array receiving the bytes
+* \param length: the number of bytes to read
+* \return Returns true if all the bytes were read
+*/
+bool qsctest_file_read(const char* path, uint64_t offset, uint8_t* output, size_t length);
+
+/**
+* \brief Overwrite an array at a file position, bypassing the file format under test
+*
+* \param path: the full path to the file
+* \param offset: the file position of the first byte
+* \param input: the array to write
+* \param length: the number of bytes to write
+* \return Returns true if all the bytes were written
+*/
+bool qsctest_file_write(const char* path, uint64_t offset, const uint8_t* input, size_t length);
+
+/**
+* \brief Flip the low bit of the byte at a file position
+*
+* \param path: the full path to the file
+* \param offset: the file position of the byte
+* \return Returns true if the byte was modified
+*/
+bool qsctest_file_flip(const char* path, uint64_t offset);
+
 #endif
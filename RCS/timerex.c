@@ -1,4 +1,7 @@
 #include "timerex.h"
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+#	include <Windows.h>
+#endif
 #if defined(QSC_DEBUG_MODE)
 #	include "consoleutils.h"
 #	include "memutils.h"
@@ -158,6 +161,28 @@ uint64_t qsc_timerex_stopwatch_elapsed(clock_t start)
 	return msec;
 }
 
+uint64_t qsc_timerex_monotonic_nanoseconds()
+{
+	uint64_t nsec;
+
+#if defined(QSC_SYSTEM_OS_WINDOWS)
+	LARGE_INTEGER frq;
+	LARGE_INTEGER cnt;
+
+	QueryPerformanceFrequency(&frq);
+	QueryPerformanceCounter(&cnt);
+	nsec = ((uint64_t)(cnt.QuadPart / frq.QuadPart) * 1000000000ULL) +
+		(((uint64_t)(cnt.QuadPart % frq.QuadPart) * 1000000000ULL) / (uint64_t)frq.QuadPart);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	nsec = ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
+
+	return nsec;
+}
+
 #if defined(QSC_DEBUG_MODE)
 void qsc_timerex_print_values()
 {
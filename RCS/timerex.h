@@ -71,6 +71,15 @@ QSC_EXPORT_API clock_t qsc_timerex_stopwatch_start();
 */
 QSC_EXPORT_API uint64_t qsc_timerex_stopwatch_elapsed(clock_t start);
 
+/**
+* \brief Returns the time of a monotonic wall clock in nanoseconds.
+* Unlike the stopwatch, which measures processor time, the difference of two readings
+* is the elapsed time of an operation that runs on several threads.
+*
+* \return The monotonic clock time in nanoseconds
+*/
+QSC_EXPORT_API uint64_t qsc_timerex_monotonic_nanoseconds();
+
 #if defined(QSC_DEBUG_MODE)
 /**
 * \brief Print timer function values